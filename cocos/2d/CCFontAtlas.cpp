@@ -27,17 +27,25 @@ THE SOFTWARE.
 #include "renderer/gfx/DeviceGraphics.h"
 #include "base/ccConfig.h"
 #include <cassert>
+#include <climits>
+#include <unordered_set>
 
 #if CC_ENABLE_TTF_LABEL_RENDERER
 
 static const int PIXEL_PADDING = 2;
 
+// frames an atlas opens before evicting letters no label uses, more frames break batching
+static const int MAX_FRAME_COUNT = 4;
+// ticks an unused letter is kept before it's evicted in favor of opening a new frame
+static const uint32_t EVICT_IDLE_TICKS = 600;
+// repack once holes of evicted letters add up to a quarter of a frame, at most once every 60 ticks
+static const float DEFRAGMENT_FREE_RATIO = 0.25f;
+static const uint32_t DEFRAGMENT_INTERVAL_TICKS = 60;
+
 namespace cocos2d {
 
     FontAtlasFrame::FontAtlasFrame()
     {
-        _currentRowX = PIXEL_PADDING;
-        _currentRowY = PIXEL_PADDING;
     }
 
     FontAtlasFrame::FontAtlasFrame(FontAtlasFrame&& o)
@@ -50,9 +58,10 @@ namespace cocos2d {
 #endif
         _WIDTH = o._WIDTH;
         _HEIGHT = o._HEIGHT;
-        _currentRowX = o._currentRowX;
-        _currentRowY = o._currentRowY;
-        _currRowHeight = o._currRowHeight;
+        std::swap(_skyline, o._skyline);
+        std::swap(_freeRects, o._freeRects);
+        _usedArea = o._usedArea;
+        _freeArea = o._freeArea;
         _pixelMode = o._pixelMode;
         _texture = o._texture;
 
@@ -69,9 +78,7 @@ namespace cocos2d {
         _pixelMode = pixelMode;
         _WIDTH = width;
         _HEIGHT = height;
-        _currentRowY = PIXEL_PADDING;
-        _currentRowY = PIXEL_PADDING;
-        _currRowHeight = 0;
+        resetSpace();
 #if CC_ENABLE_CACHE_TTF_FONT_TEXTURE 
         _buffer.resize(PixelModeSize(pixelMode) * width * height);
         std::fill(_buffer.begin(), _buffer.end(), 0);
@@ -81,115 +88,298 @@ namespace cocos2d {
         getTexture(); // init texture
     }
 
+    void FontAtlasFrame::resetSpace()
+    {
+        _skyline.clear();
+        _skyline.push_back({ PIXEL_PADDING, PIXEL_PADDING, _WIDTH - PIXEL_PADDING });
+        _freeRects.clear();
+        _usedArea = 0;
+        _freeArea = 0;
+    }
+
+    void FontAtlasFrame::clear()
+    {
+        resetSpace();
+#if CC_ENABLE_CACHE_TTF_FONT_TEXTURE
+        std::fill(_buffer.begin(), _buffer.end(), 0);
+        _dirtyFlag |= DIRTY_ALL;
+#else
+        writePixels(0, 0, _WIDTH, _HEIGHT, nullptr, 0);
+#endif
+    }
+
     FontAtlasFrame::FrameResult FontAtlasFrame::append(int width, int height, std::vector<uint8_t> &data, Rect &out)
     {
 #if CC_ENABLE_CACHE_TTF_FONT_TEXTURE 
         assert(_buffer.size() > 0);
         assert(width <= _WIDTH && height <= _HEIGHT);
 #endif
-        if (!hasSpace(width, height)) {
-            return FrameResult::E_FULL;
-        }
-
-#if CC_ENABLE_CACHE_TTF_FONT_TEXTURE 
-        //update texture-data in CPU memory
-        const int pixelSize = PixelModeSize(_pixelMode);
-        uint8_t* dst = _buffer.data();
-        uint8_t* src = data.data();
-        uint8_t* dstOrigin = pixelSize * (_currentRowY * _WIDTH + _currentRowX) + dst;
-        const int BytesEachRow = pixelSize * width;
-        for (int i = 0; i < height; i++)
+        // every letter takes a cell with padding at its right and bottom
+        const int cellWidth = width + PIXEL_PADDING;
+        const int cellHeight = height + PIXEL_PADDING;
+        if (cellWidth > _WIDTH - PIXEL_PADDING || cellHeight > _HEIGHT - PIXEL_PADDING)
         {
-            memcpy(dstOrigin + i * _WIDTH * pixelSize, src + i * BytesEachRow, BytesEachRow);
+            return FrameResult::E_ERROR;
         }
 
-        if (_dirtyFlag == 0)
+        int x = 0;
+        int y = 0;
+        // holes of removed letters go first, they keep the skyline low
+        int freeIndex = findFreeRect(cellWidth, cellHeight);
+        if (freeIndex >= 0)
         {
-            _dirtyFlag |= DIRTY_RECT;
-            _dirtyRegion = Rect(_currentRowX, _currentRowY, width, height);
+            x = (int)_freeRects[freeIndex].origin.x;
+            y = (int)_freeRects[freeIndex].origin.y;
+            takeFreeRect(freeIndex, cellWidth, cellHeight);
         }
         else
         {
-            _dirtyRegion.merge(Rect(_currentRowX, _currentRowY, width, height));
+            int index = 0;
+            if (!findSkylinePosition(cellWidth, cellHeight, index, x, y))
+            {
+                return FrameResult::E_FULL;
+            }
+            addSkylineLevel(index, x, y, cellWidth, cellHeight);
         }
-#else 
-        //update GPU texture immediately
-        renderer::Texture::SubImageOption opt;
-        opt.imageData = data.data();
-        opt.x = _currentRowX;
-        opt.y = _currentRowY;
-        opt.width = width;
-        opt.height = height;
-        opt.imageDataLength = data.size();
-        _texture->updateSubImage(opt);
-#endif
+        _usedArea += cellWidth * cellHeight;
 
+        writePixels(x, y, width, height, data.data(), data.size());
 
-        out.origin.set(_currentRowX, _currentRowY);
+        out.origin.set(x, y);
         out.size.width = width;
         out.size.height = height;
-        // move cursor
-        moveToNextCursor(width, height);
         return FrameResult::SUCCESS;
+    }
 
+    void FontAtlasFrame::remove(const Rect &rect)
+    {
+        // clear the pixels, a smaller letter reusing the space must not sample the removed one
+        writePixels((int)rect.origin.x, (int)rect.origin.y, (int)rect.size.width, (int)rect.size.height, nullptr, 0);
+
+        Rect cell(rect.origin.x, rect.origin.y, rect.size.width + PIXEL_PADDING, rect.size.height + PIXEL_PADDING);
+        int area = (int)(cell.size.width * cell.size.height);
+        _usedArea -= area;
+        _freeArea += area;
+        addFreeRect(cell);
     }
 
-    bool FontAtlasFrame::hasSpace(int width, int height)
+#if CC_ENABLE_CACHE_TTF_FONT_TEXTURE
+    void FontAtlasFrame::read(const Rect &rect, std::vector<uint8_t> &out) const
     {
-        if (hasRowXSpace(width) && hasYSpace(height)) {
-            return true;
-        }
-        if (hasNextRowXSpace(width) && hasNextRowYSpace(height))
+        const int pixelSize = PixelModeSize(_pixelMode);
+        const int width = (int)rect.size.width;
+        const int height = (int)rect.size.height;
+        const int BytesEachRow = pixelSize * width;
+        out.resize(BytesEachRow * height);
+        const uint8_t* srcOrigin = _buffer.data() + pixelSize * ((int)rect.origin.y * _WIDTH + (int)rect.origin.x);
+        for (int i = 0; i < height; i++)
         {
-            moveToNextRow();
-            return true;
+            memcpy(out.data() + i * BytesEachRow, srcOrigin + i * _WIDTH * pixelSize, BytesEachRow);
         }
-        return false;
     }
+#endif
 
+    bool FontAtlasFrame::findSkylinePosition(int width, int height, int &index, int &x, int &y) const
+    {
+        int bestBottom = INT_MAX;
+        int bestWidth = INT_MAX;
+        index = -1;
+        for (int i = 0, n = (int)_skyline.size(); i < n; i++)
+        {
+            int top = fitSkyline(i, width, height);
+            if (top < 0) continue;
 
-    int FontAtlasFrame::remainRowXSpace() const 
-    { 
-        return _WIDTH - _currentRowX; 
+            // y grows downwards, the cell ending nearest to the top wins, then the narrowest level which wastes less space below
+            int bottom = top + height;
+            if (bottom < bestBottom || (bottom == bestBottom && _skyline[i].width < bestWidth))
+            {
+                bestBottom = bottom;
+                bestWidth = _skyline[i].width;
+                index = i;
+                x = _skyline[i].x;
+                y = top;
+            }
+        }
+        return index >= 0;
     }
 
-    int FontAtlasFrame::remainYSpace() const 
-    { 
-        return _HEIGHT - _currentRowY; 
-    }
+    int FontAtlasFrame::fitSkyline(int index, int width, int height) const
+    {
+        int x = _skyline[index].x;
+        if (x + width > _WIDTH) return -1;
 
-    bool FontAtlasFrame::hasRowXSpace(int x) const 
-    { 
-        return x + PIXEL_PADDING <= remainRowXSpace();
+        // the cell rests on the highest level it spans
+        int top = _skyline[index].y;
+        int widthLeft = width;
+        for (int i = index, n = (int)_skyline.size(); widthLeft > 0; i++)
+        {
+            if (i >= n) return -1;
+            top = std::max(top, _skyline[i].y);
+            if (top + height > _HEIGHT) return -1;
+            widthLeft -= _skyline[i].width;
+        }
+        return top;
     }
 
-    bool FontAtlasFrame::hasYSpace(int y) const 
+    void FontAtlasFrame::addSkylineLevel(int index, int x, int y, int width, int height)
     {
-        return y + PIXEL_PADDING <= remainYSpace();
-    }
+        SkylineNode node = { x, y + height, width };
+        _skyline.insert(_skyline.begin() + index, node);
 
-    bool FontAtlasFrame::hasNextRowXSpace(int x) const 
-    { 
-        return x + PIXEL_PADDING <= _WIDTH;
+        // shrink or drop the levels covered by the new one
+        for (std::size_t i = index + 1; i < _skyline.size();)
+        {
+            int right = _skyline[i - 1].x + _skyline[i - 1].width;
+            if (_skyline[i].x >= right) break;
+
+            int shrink = right - _skyline[i].x;
+            _skyline[i].x += shrink;
+            _skyline[i].width -= shrink;
+            if (_skyline[i].width > 0) break;
+            _skyline.erase(_skyline.begin() + i);
+        }
+
+        // merge neighbors of the same level
+        for (std::size_t i = 1; i < _skyline.size();)
+        {
+            if (_skyline[i - 1].y == _skyline[i].y)
+            {
+                _skyline[i - 1].width += _skyline[i].width;
+                _skyline.erase(_skyline.begin() + i);
+            }
+            else
+            {
+                i++;
+            }
+        }
     }
 
-    bool FontAtlasFrame::hasNextRowYSpace(int y) const 
-    { 
-        return y + PIXEL_PADDING <= remainYSpace() - _currRowHeight;
+    int FontAtlasFrame::findFreeRect(int width, int height) const
+    {
+        // best area fit
+        int best = -1;
+        float bestArea = 0.0f;
+        for (int i = 0, n = (int)_freeRects.size(); i < n; i++)
+        {
+            const Rect &rect = _freeRects[i];
+            if (rect.size.width < width || rect.size.height < height) continue;
+
+            float area = rect.size.width * rect.size.height;
+            if (best < 0 || area < bestArea)
+            {
+                best = i;
+                bestArea = area;
+            }
+        }
+        return best;
     }
 
+    void FontAtlasFrame::takeFreeRect(int index, int width, int height)
+    {
+        Rect rect = _freeRects[index];
+        _freeRects[index] = _freeRects.back();
+        _freeRects.pop_back();
+        _freeArea -= width * height;
+
+        // split the rest along the shorter side, which keeps the bigger piece usable
+        float restWidth = rect.size.width - width;
+        float restHeight = rect.size.height - height;
+        Rect right, bottom;
+        if (restWidth < restHeight)
+        {
+            right.setRect(rect.origin.x + width, rect.origin.y, restWidth, height);
+            bottom.setRect(rect.origin.x, rect.origin.y + height, rect.size.width, restHeight);
+        }
+        else
+        {
+            right.setRect(rect.origin.x + width, rect.origin.y, restWidth, rect.size.height);
+            bottom.setRect(rect.origin.x, rect.origin.y + height, width, restHeight);
+        }
+
+        // pieces too small for any letter stay counted as free area until the frame is cleared
+        if (right.size.width > PIXEL_PADDING && right.size.height > PIXEL_PADDING)
+        {
+            _freeRects.push_back(right);
+        }
+        if (bottom.size.width > PIXEL_PADDING && bottom.size.height > PIXEL_PADDING)
+        {
+            _freeRects.push_back(bottom);
+        }
+    }
 
-    void FontAtlasFrame::moveToNextRow()
+    void FontAtlasFrame::addFreeRect(Rect rect)
     {
-        _currentRowY += _currRowHeight + PIXEL_PADDING;
-        _currentRowX = PIXEL_PADDING;
-        _currRowHeight = 0;
+        // merge with holes sharing a whole edge, neighbors of a row often go together
+        for (std::size_t i = 0; i < _freeRects.size();)
+        {
+            const Rect &o = _freeRects[i];
+            bool sameRow = o.origin.y == rect.origin.y && o.size.height == rect.size.height &&
+                (o.getMaxX() == rect.origin.x || rect.getMaxX() == o.origin.x);
+            bool sameColumn = o.origin.x == rect.origin.x && o.size.width == rect.size.width &&
+                (o.getMaxY() == rect.origin.y || rect.getMaxY() == o.origin.y);
+            if (sameRow || sameColumn)
+            {
+                rect.merge(o);
+                _freeRects[i] = _freeRects.back();
+                _freeRects.pop_back();
+                i = 0;
+            }
+            else
+            {
+                i++;
+            }
+        }
+        _freeRects.push_back(rect);
     }
 
-    void FontAtlasFrame::moveToNextCursor(int width, int height)
+    void FontAtlasFrame::writePixels(int x, int y, int width, int height, const uint8_t *data, std::size_t length)
     {
-        _currRowHeight = std::max(_currRowHeight, height);
-        _currentRowX += width + PIXEL_PADDING;
+        const int pixelSize = PixelModeSize(_pixelMode);
+        const int BytesEachRow = pixelSize * width;
+        assert(!data || length >= (std::size_t)(BytesEachRow * height));
+
+#if CC_ENABLE_CACHE_TTF_FONT_TEXTURE 
+        //update texture-data in CPU memory
+        uint8_t* dstOrigin = pixelSize * (y * _WIDTH + x) + _buffer.data();
+        for (int i = 0; i < height; i++)
+        {
+            if (data)
+            {
+                memcpy(dstOrigin + i * _WIDTH * pixelSize, data + i * BytesEachRow, BytesEachRow);
+            }
+            else
+            {
+                memset(dstOrigin + i * _WIDTH * pixelSize, 0, BytesEachRow);
+            }
+        }
+
+        if (_dirtyFlag == 0)
+        {
+            _dirtyFlag |= DIRTY_RECT;
+            _dirtyRegion = Rect(x, y, width, height);
+        }
+        else
+        {
+            _dirtyRegion.merge(Rect(x, y, width, height));
+        }
+#else 
+        //update GPU texture immediately
+        std::vector<uint8_t> zeros;
+        if (!data)
+        {
+            zeros.resize(BytesEachRow * height, 0);
+            data = zeros.data();
+            length = zeros.size();
+        }
+        renderer::Texture::SubImageOption opt;
+        opt.imageData = const_cast<uint8_t*>(data);
+        opt.x = x;
+        opt.y = y;
+        opt.width = width;
+        opt.height = height;
+        opt.imageDataLength = (uint32_t)length;
+        _texture->updateSubImage(opt);
+#endif
     }
 
     renderer::Texture2D * FontAtlasFrame::getTexture()
@@ -266,78 +456,208 @@ namespace cocos2d {
 
     bool FontAtlas::init()
     {
-        _textureFrame.reinit(_pixelMode, _width, _height);
+        _frames.clear();
         _letterMap.clear();
+        _unusedLetters.clear();
+        _pinnedLetters.clear();
+        addFrame();
         return true;
     }
 
-    bool FontAtlas::prepareLetter(unsigned long ch, std::shared_ptr<GlyphBitmap> bitmap)
+    int FontAtlas::addFrame()
     {
+        _frames.emplace_back();
+        _frames.back().reinit(_pixelMode, _width, _height);
+        return (int)_frames.size() - 1;
+    }
 
-        if (_letterMap.find(ch) != _letterMap.end())
+    bool FontAtlas::prepareLetter(unsigned long ch, std::shared_ptr<GlyphBitmap> bitmap)
+    {
+        auto it = _letterMap.find(ch);
+        if (it != _letterMap.end())
         {
+            touchLetter(it->second);
             return true;
         }
 
         Rect rect;
-        FontAtlasFrame::FrameResult ret = _textureFrame.append(bitmap->getWidth(), bitmap->getHeight(), bitmap->getData(), rect);
-
-        switch (ret) {
-        case FontAtlasFrame::FrameResult::E_ERROR:
-            //TODO: ERROR LOG
-            assert(false);
+        int frameIdx = appendLetter(bitmap->getWidth(), bitmap->getHeight(), bitmap->getData(), rect);
+        if (frameIdx < 0)
+        {
+            //TODO: ERROR LOG, the letter is larger than a frame
             return false;
-        case FontAtlasFrame::FrameResult::E_FULL:
-            // Allocate a new frame & add bitmap the frame
-            _buffers.push_back(std::move(_textureFrame));
-            _textureBufferIndex += 1;
-            _textureFrame.reinit(_pixelMode, _width, _height);
-            return prepareLetter(ch, bitmap);
-        case FontAtlasFrame::FrameResult::SUCCESS:
-            addLetterDef(ch, bitmap, rect);
-            return true;
-        default:
-            //TODO: LOG
-            assert(false);
         }
-        return false;
+        addLetterDef(ch, bitmap, rect, frameIdx);
+        return true;
+    }
+
+    int FontAtlas::appendLetter(int width, int height, std::vector<uint8_t> &data, Rect &out)
+    {
+        if (width + 2 * PIXEL_PADDING > _width || height + 2 * PIXEL_PADDING > _height)
+        {
+            return -1;
+        }
+
+        for (int i = 0, n = (int)_frames.size(); i < n; i++)
+        {
+            if (_frames[i].append(width, height, data, out) == FontAtlasFrame::FrameResult::SUCCESS)
+            {
+                return i;
+            }
+        }
+
+        // letters unused for a while go before opening a new frame
+        int frameIdx = appendAfterEviction(width, height, data, out, EVICT_IDLE_TICKS);
+        if (frameIdx >= 0)
+        {
+            return frameIdx;
+        }
+
+        // out of frames, any unused letter goes except those of the current tick,
+        // the frame limit is only exceeded when all letters are in use
+        if ((int)_frames.size() >= MAX_FRAME_COUNT)
+        {
+            frameIdx = appendAfterEviction(width, height, data, out, 1);
+            if (frameIdx >= 0)
+            {
+                return frameIdx;
+            }
+        }
+
+        frameIdx = addFrame();
+        if (_frames[frameIdx].append(width, height, data, out) == FontAtlasFrame::FrameResult::SUCCESS)
+        {
+            return frameIdx;
+        }
+        return -1;
+    }
+
+    int FontAtlas::appendAfterEviction(int width, int height, std::vector<uint8_t> &data, Rect &out, uint32_t idleTicks)
+    {
+        while (!_unusedLetters.empty())
+        {
+            auto it = _letterMap.find(_unusedLetters.front());
+            assert(it != _letterMap.end());
+            FontLetterDefinition &def = it->second;
+            // the list is in order of use, the rest are used more recently
+            if (_tick - def.usedTick < idleTicks)
+            {
+                return -1;
+            }
+
+            int frameIdx = def.textureID;
+            _frames[frameIdx].remove(def.atlasRect);
+            _unusedLetters.pop_front();
+            _letterMap.erase(it);
+            _evictedLetters++;
+
+            if (_frames[frameIdx].append(width, height, data, out) == FontAtlasFrame::FrameResult::SUCCESS)
+            {
+                return frameIdx;
+            }
+        }
+        return -1;
     }
 
-    void FontAtlas::addLetterDef(unsigned long ch, std::shared_ptr<GlyphBitmap> bitmap, const Rect& rect)
+    void FontAtlas::addLetterDef(unsigned long ch, std::shared_ptr<GlyphBitmap> bitmap, const Rect& rect, int frameIdx)
     {
         assert(bitmap->getPixelMode() == _pixelMode);
 
         auto& def = _letterMap[ch];
         def.validate = true;
-        def.textureID = _textureBufferIndex;
         def.xAdvance = bitmap->getXAdvance();
         def.rect = bitmap->getRect();
-        def.texX = (rect.origin.x - 0.5f) / _textureFrame.getWidth();
-        def.texY = (rect.origin.y -0.5f)/ _textureFrame.getHeight();
-        def.texWidth = (rect.size.width + 1.0f) / _textureFrame.getWidth();
-        def.texHeight = (rect.size.height + 1.0f) / _textureFrame.getHeight();
         def.outline = bitmap->getOutline();
+        setLetterRect(def, rect, frameIdx);
+
+        // no label uses a new letter yet
+        def.refCount = 0;
+        def.usedTick = _tick;
+        def.unusedIter = _unusedLetters.insert(_unusedLetters.end(), ch);
+    }
+
+    void FontAtlas::setLetterRect(FontLetterDefinition &def, const Rect &rect, int frameIdx)
+    {
+        def.textureID = frameIdx;
+        def.atlasRect = rect;
+        def.texX = (rect.origin.x - 0.5f) / _width;
+        def.texY = (rect.origin.y -0.5f)/ _height;
+        def.texWidth = (rect.size.width + 1.0f) / _width;
+        def.texHeight = (rect.size.height + 1.0f) / _height;
+    }
+
+    void FontAtlas::touchLetter(FontLetterDefinition &def)
+    {
+        def.usedTick = _tick;
+        if (def.refCount == 0)
+        {
+            // most recently used goes last
+            auto &letters = def.pinned ? _pinnedLetters : _unusedLetters;
+            letters.splice(letters.end(), letters, def.unusedIter);
+        }
     }
 
     bool FontAtlas::prepareLetters(const std::u32string &text, cocos2d::FontFreeType *font)
     {
-        bool ok = true;
-        for (int i = 0; i < text.length(); i++) 
+        // letters of text already in the atlas must not be evicted by this batch
+        for (std::size_t i = 0; i < text.length(); i++)
         {
             auto it = _letterMap.find(text[i]);
-            if(it == _letterMap.end())
+            if (it != _letterMap.end())
             {
-                auto glyph = font->getGlyphBitmap(text[i], _useSDF);
-                ok &= prepareLetter(text[i], glyph);
+                touchLetter(it->second);
+            }
+        }
+
+        std::vector<unsigned long> letters;
+        collectMissingLetters(text, letters);
+        if (letters.empty() || !font)
+        {
+            return true;
+        }
+
+        std::vector<std::shared_ptr<GlyphBitmap>> bitmaps;
+        font->getGlyphBitmaps(letters, _useSDF, bitmaps);
+        return prepareLetters(letters, bitmaps);
+    }
+
+    bool FontAtlas::prepareLetters(const std::vector<unsigned long> &letters, const std::vector<std::shared_ptr<GlyphBitmap>> &bitmaps)
+    {
+        assert(letters.size() == bitmaps.size());
+
+        // packing and the texture update stay on this thread, dirty rows are uploaded once by getTexture
+        bool ok = true;
+        for (std::size_t i = 0, n = std::min(letters.size(), bitmaps.size()); i < n; i++)
+        {
+            if (bitmaps[i])
+            {
+                ok &= prepareLetter(letters[i], bitmaps[i]);
             }
         }
         return ok;
     }
 
+    void FontAtlas::collectMissingLetters(const std::u32string &text, std::vector<unsigned long> &out) const
+    {
+        std::unordered_set<unsigned long> added;
+        for (std::size_t i = 0; i < text.length(); i++)
+        {
+            unsigned long ch = text[i];
+            if (_letterMap.find(ch) == _letterMap.end() && added.insert(ch).second)
+            {
+                out.push_back(ch);
+            }
+        }
+    }
+
     FontLetterDefinition* FontAtlas::getOrLoad(unsigned long ch, cocos2d::FontFreeType* font)
     {
         auto it = _letterMap.find(ch);
-        if (it != _letterMap.end()) return &it->second;
+        if (it != _letterMap.end())
+        {
+            touchLetter(it->second);
+            return &it->second;
+        }
 
         if (font) {
             auto bitmap = font->getGlyphBitmap(ch, _useSDF);
@@ -350,12 +670,198 @@ namespace cocos2d {
         return nullptr;
     }
 
+    void FontAtlas::retainLetters(const std::vector<unsigned long> &letters)
+    {
+        for (auto ch : letters)
+        {
+            auto it = _letterMap.find(ch);
+            if (it == _letterMap.end()) continue;
+
+            auto &def = it->second;
+            if (def.refCount++ == 0)
+            {
+                if (def.pinned)
+                {
+                    _pinnedLetters.erase(def.unusedIter);
+                    def.pinned = false;
+                }
+                else
+                {
+                    _unusedLetters.erase(def.unusedIter);
+                }
+            }
+            def.usedTick = _tick;
+        }
+    }
+
+    void FontAtlas::pinLetters(const std::vector<unsigned long> &letters)
+    {
+        for (auto ch : letters)
+        {
+            auto it = _letterMap.find(ch);
+            if (it == _letterMap.end()) continue;
+
+            auto &def = it->second;
+            if (def.refCount == 0 && !def.pinned)
+            {
+                _pinnedLetters.splice(_pinnedLetters.end(), _unusedLetters, def.unusedIter);
+                def.pinned = true;
+                def.usedTick = _tick;
+            }
+        }
+    }
+
+    void FontAtlas::unpinLetters()
+    {
+        for (auto ch : _pinnedLetters)
+        {
+            _letterMap[ch].pinned = false;
+        }
+        _unusedLetters.splice(_unusedLetters.end(), _pinnedLetters);
+    }
+
+    void FontAtlas::unpinIdleLetters(uint32_t idleTicks)
+    {
+        // iterators stay valid across splice, they point into the unused list afterwards
+        while (!_pinnedLetters.empty())
+        {
+            auto &def = _letterMap[_pinnedLetters.front()];
+            if (_tick - def.usedTick < idleTicks)
+            {
+                break;
+            }
+            def.pinned = false;
+            _unusedLetters.splice(_unusedLetters.end(), _pinnedLetters, def.unusedIter);
+        }
+    }
+
+    void FontAtlas::releaseLetters(const std::vector<unsigned long> &letters)
+    {
+        for (auto ch : letters)
+        {
+            auto it = _letterMap.find(ch);
+            if (it == _letterMap.end() || it->second.refCount <= 0) continue;
+
+            auto &def = it->second;
+            def.usedTick = _tick;
+            if (--def.refCount == 0)
+            {
+                def.unusedIter = _unusedLetters.insert(_unusedLetters.end(), ch);
+            }
+        }
+    }
+
+    void FontAtlas::endFrame()
+    {
+        _tick++;
+        unpinIdleLetters(EVICT_IDLE_TICKS);
+#if CC_ENABLE_CACHE_TTF_FONT_TEXTURE
+        if (_tick - _lastDefragmentTick >= DEFRAGMENT_INTERVAL_TICKS && needsDefragment())
+        {
+            defragment();
+        }
+#endif
+    }
+
+#if CC_ENABLE_CACHE_TTF_FONT_TEXTURE
+    bool FontAtlas::needsDefragment() const
+    {
+        int freeArea = 0;
+        for (auto &frame : _frames)
+        {
+            freeArea += frame.getFreeArea();
+        }
+        return freeArea >= DEFRAGMENT_FREE_RATIO * _width * _height;
+    }
+
+    void FontAtlas::defragment()
+    {
+        // tallest letters first keep the skyline flat
+        std::vector<FontLetterDefinition*> letters;
+        letters.reserve(_letterMap.size());
+        for (auto &it : _letterMap)
+        {
+            letters.push_back(&it.second);
+        }
+        std::sort(letters.begin(), letters.end(), [](const FontLetterDefinition *a, const FontLetterDefinition *b) {
+            if (a->atlasRect.size.height != b->atlasRect.size.height)
+            {
+                return a->atlasRect.size.height > b->atlasRect.size.height;
+            }
+            return a->atlasRect.size.width > b->atlasRect.size.width;
+        });
+
+        std::vector<std::vector<uint8_t>> pixels(letters.size());
+        for (std::size_t i = 0; i < letters.size(); i++)
+        {
+            _frames[letters[i]->textureID].read(letters[i]->atlasRect, pixels[i]);
+        }
+
+        // textures are kept, they are uploaded once by getTexture
+        for (auto &frame : _frames)
+        {
+            frame.clear();
+        }
+
+        int lastFrame = 0;
+        for (std::size_t i = 0; i < letters.size(); i++)
+        {
+            int width = (int)letters[i]->atlasRect.size.width;
+            int height = (int)letters[i]->atlasRect.size.height;
+            Rect rect;
+            int frameIdx = 0;
+            int frameCount = (int)_frames.size();
+            while (frameIdx < frameCount && _frames[frameIdx].append(width, height, pixels[i], rect) != FontAtlasFrame::FrameResult::SUCCESS)
+            {
+                frameIdx++;
+            }
+            if (frameIdx == frameCount)
+            {
+                frameIdx = addFrame();
+                _frames[frameIdx].append(width, height, pixels[i], rect);
+            }
+            setLetterRect(*letters[i], rect, frameIdx);
+            lastFrame = std::max(lastFrame, frameIdx);
+        }
+
+        // frames left empty at the end are released
+        while ((int)_frames.size() > lastFrame + 1)
+        {
+            _frames.pop_back();
+        }
+
+        _lastDefragmentTick = _tick;
+        _defragmentCount++;
+        _version++;
+    }
+#endif
+
+    FontAtlas::Stats FontAtlas::getStats() const
+    {
+        Stats stats;
+        stats.pageCount = (int)_frames.size();
+        stats.letterCount = (int)_letterMap.size();
+        stats.unusedLetterCount = (int)_unusedLetters.size();
+        stats.evictedLetters = _evictedLetters;
+        stats.defragmentCount = _defragmentCount;
+
+        float usedArea = 0.0f;
+        for (auto &frame : _frames)
+        {
+            usedArea += frame.getUsedArea();
+        }
+        if (stats.pageCount > 0)
+        {
+            stats.occupancy = usedArea / ((float)_width * _height * stats.pageCount);
+        }
+        return stats;
+    }
 
     FontAtlasFrame& FontAtlas::frameAt(int idx)
     {
-        return idx == _textureBufferIndex ? _textureFrame : _buffers.at(idx);
+        return _frames.at(idx);
     }
 
 }
 
-#endif
+#endif
\ No newline at end of file
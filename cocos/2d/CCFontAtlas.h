@@ -28,6 +28,7 @@ THE SOFTWARE.
 
 #include <unordered_map>
 #include <algorithm>
+#include <list>
 
 #include "base/ccConfig.h"
 #if CC_ENABLE_TTF_LABEL_RENDERER
@@ -49,6 +50,15 @@ namespace cocos2d {
         float xAdvance = 0;
         int outline = 0;
         bool validate = false;
+
+        // bookkeeping of FontAtlas, rect in pixels of the page and the labels using the letter
+        Rect atlasRect;
+        int refCount = 0;
+        // kept off the unused list until a label retains it or it's idle for long
+        bool pinned = false;
+        uint32_t usedTick = 0;
+        // position in the pinned list while pinned, in the unused list otherwise
+        std::list<uint64_t>::iterator unusedIter;
     };
 
     class FontAtlasFrame
@@ -69,10 +79,30 @@ namespace cocos2d {
         void reinit(PixelMode mode, int width, int height);
         FrameResult append(int width, int height, std::vector<uint8_t> &, Rect &out);
 
+        /**
+         * Gives the space of a letter back, it's reused by letters fitting in it until the frame is cleared.
+         */
+        void remove(const Rect &rect);
+
+        /**
+         * Removes all letters, the texture is kept.
+         */
+        void clear();
+
+#if CC_ENABLE_CACHE_TTF_FONT_TEXTURE
+        /**
+         * Copies the pixels of a letter out of the frame.
+         */
+        void read(const Rect &rect, std::vector<uint8_t> &out) const;
+#endif
 
         float getWidth() const { return _WIDTH; }
         float getHeight() const { return _HEIGHT; }
 
+        // area taken by letters and area of removed letters not reused yet, padding included
+        int getUsedArea() const { return _usedArea; }
+        int getFreeArea() const { return _freeArea; }
+
         renderer::Texture2D* getTexture();
 
     private:
@@ -82,17 +112,21 @@ namespace cocos2d {
             DIRTY_ALL= 2,
         };
 
-        bool hasSpace(int width, int height);
-
-        int remainRowXSpace() const;
-        int remainYSpace() const;
-        bool hasRowXSpace(int x) const;
-        bool hasYSpace(int y) const;
-        bool hasNextRowXSpace(int x) const;
-        bool hasNextRowYSpace(int y) const;
+        // top of the used space over [x, x + width)
+        struct SkylineNode {
+            int x;
+            int y;
+            int width;
+        };
 
-        void moveToNextRow();
-        void moveToNextCursor(int width, int height);
+        bool findSkylinePosition(int width, int height, int &index, int &x, int &y) const;
+        int fitSkyline(int index, int width, int height) const;
+        void resetSpace();
+        void addSkylineLevel(int index, int x, int y, int width, int height);
+        int findFreeRect(int width, int height) const;
+        void takeFreeRect(int index, int width, int height);
+        void addFreeRect(Rect rect);
+        void writePixels(int x, int y, int width, int height, const uint8_t *data, std::size_t length);
 
 #if CC_ENABLE_CACHE_TTF_FONT_TEXTURE
         mutable std::vector<uint8_t> _buffer;
@@ -102,9 +136,10 @@ namespace cocos2d {
 
         int _WIDTH = 0;
         int _HEIGHT = 0;
-        int _currentRowY = 0;
-        int _currentRowX = 0;
-        int _currRowHeight = 0;
+        std::vector<SkylineNode> _skyline;
+        std::vector<Rect> _freeRects;
+        int _usedArea = 0;
+        int _freeArea = 0;
         PixelMode _pixelMode = PixelMode::A8;
         renderer::Texture2D *_texture = nullptr;
         
@@ -115,6 +150,17 @@ namespace cocos2d {
 
     public:
 
+        struct Stats {
+            int pageCount = 0;
+            int letterCount = 0;
+            // letters no label uses, they are evicted least recently used first
+            int unusedLetterCount = 0;
+            // area of the letters over area of the pages
+            float occupancy = 0.0f;
+            uint32_t evictedLetters = 0;
+            uint32_t defragmentCount = 0;
+        };
+
         FontAtlas(PixelMode mode, int width, int height, bool hasoutline);
         virtual ~FontAtlas();
 
@@ -122,20 +168,83 @@ namespace cocos2d {
 
         bool prepareLetter(unsigned long ch, std::shared_ptr<GlyphBitmap> bitmap);
 
+        /**
+         * Rasterizes the missing letters of text in parallel, then packs them in text order.
+         */
         bool prepareLetters(const std::u32string &text, cocos2d::FontFreeType *font);
 
+        /**
+         * Packs a batch of glyphs rasterized elsewhere, letters already in the atlas or without glyph are skipped.
+         */
+        bool prepareLetters(const std::vector<unsigned long> &letters, const std::vector<std::shared_ptr<GlyphBitmap>> &bitmaps);
+
+        /**
+         * Appends the letters of text which are not in the atlas yet, every letter once.
+         */
+        void collectMissingLetters(const std::u32string &text, std::vector<unsigned long> &out) const;
+
+        bool hasOutline() const { return _useSDF; }
+
         FontLetterDefinition* getOrLoad(unsigned long ch, FontFreeType* font);
 
+        /**
+         * Letters used by a label are never evicted, every retain must be paired with a release.
+         */
+        void retainLetters(const std::vector<unsigned long> &letters);
+        void releaseLetters(const std::vector<unsigned long> &letters);
+
+        /**
+         * Letters not used by any label yet are kept from eviction until the first label retains them,
+         * or until they are not used for as long as an unused letter is kept.
+         */
+        void pinLetters(const std::vector<unsigned long> &letters);
+        /**
+         * Pinned letters become unused ones right away, so they are evicted like any letter no label uses.
+         */
+        void unpinLetters();
+
+        /**
+         * Called once between two frames, advances the LRU clock and repacks the pages once they are fragmented.
+         */
+        void endFrame();
+
+        /**
+         * Increased whenever letters move in the atlas, layouts built with an older version must be updated,
+         * TTFLabelAtlasCache::tick updates the labels of the atlas right after the move.
+         */
+        uint32_t getVersion() const { return _version; }
+
+        Stats getStats() const;
+
+        int getFrameCount() const { return (int)_frames.size(); }
         FontAtlasFrame& frameAt(int idx);
     private:
 
-        void addLetterDef(unsigned long ch, std::shared_ptr<GlyphBitmap> bitmap, const Rect& rect);
+        void addLetterDef(unsigned long ch, std::shared_ptr<GlyphBitmap> bitmap, const Rect& rect, int frameIdx);
+        void setLetterRect(FontLetterDefinition &def, const Rect &rect, int frameIdx);
+        void touchLetter(FontLetterDefinition &def);
+        void unpinIdleLetters(uint32_t idleTicks);
 
-        std::unordered_map<uint64_t, FontLetterDefinition> _letterMap;
+        int appendLetter(int width, int height, std::vector<uint8_t> &data, Rect &out);
+        int appendAfterEviction(int width, int height, std::vector<uint8_t> &data, Rect &out, uint32_t idleTicks);
+        int addFrame();
+#if CC_ENABLE_CACHE_TTF_FONT_TEXTURE
+        bool needsDefragment() const;
+        void defragment();
+#endif
 
-        FontAtlasFrame   _textureFrame;
-        std::vector<FontAtlasFrame> _buffers;
-        int _textureBufferIndex = 0;
+        std::unordered_map<uint64_t, FontLetterDefinition> _letterMap;
+        // letters with zero reference count, least recently used first
+        std::list<uint64_t> _unusedLetters;
+        // pinned letters, least recently used first
+        std::list<uint64_t> _pinnedLetters;
+
+        std::vector<FontAtlasFrame> _frames;
+        uint32_t _tick = 0;
+        uint32_t _lastDefragmentTick = 0;
+        uint32_t _version = 0;
+        uint32_t _evictedLetters = 0;
+        uint32_t _defragmentCount = 0;
         int _width = 0;
         int _height = 0;
         PixelMode _pixelMode = PixelMode::A8;
@@ -24,10 +24,12 @@ THE SOFTWARE.
 
 #include "CCFontFreetype.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include "platform/CCFileUtils.h"
 #include "platform/CCDevice.h"
-#include "external/sources/edtaa3func/edtaa3func.h"
+#include "renderer/scene/JobSystem.hpp"
 #include "base/ccConfig.h"
 
 #if CC_ENABLE_TTF_LABEL_RENDERER
@@ -44,6 +46,9 @@ THE SOFTWARE.
 #define SCALE_BY_DPI(x) (int)(x)
 #endif
 
+// glyphs of a job chunk, a distance map takes far longer than loading a face from the pool
+#define FFT_GLYPH_JOB_GRAIN 4
+
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
 // `thread_local` can not compile on iOS 9.0 below device
 #   define FFT_SDF_TMP_VECTOR (__IPHONE_OS_VERSION_MIN_REQUIRED >= 90000)
@@ -54,16 +59,24 @@ THE SOFTWARE.
 #if FFT_SDF_TMP_VECTOR
 namespace {
     //cache vector in thread
-    thread_local std::vector<short> xdistV;
-    thread_local std::vector<short> ydistV;
-    thread_local std::vector<double> gxV;
-    thread_local std::vector<double> gyV;
-    thread_local std::vector<double> dataV;
-    thread_local std::vector<double> outsideV;
-    thread_local std::vector<double> insideV;
+    thread_local std::vector<short> tl_xdistV;
+    thread_local std::vector<short> tl_ydistV;
+    thread_local std::vector<float> tl_gxV;
+    thread_local std::vector<float> tl_gyV;
+    thread_local std::vector<float> tl_dataV;
+    thread_local std::vector<float> tl_outsideV;
+    thread_local std::vector<float> tl_insideV;
 }
 #endif
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define FFT_SDF_USE_SSE 1
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define FFT_SDF_USE_NEON 1
+#endif
+
 namespace cocos2d {
 
     class FontFreeTypeLibrary {
@@ -79,8 +92,12 @@ namespace cocos2d {
 
         FT_Library * get() { return &_library; }
 
+        // FT_New_Face and FT_Done_Face modify the library, they must not run concurrently
+        std::mutex& getMutex() { return _mutex; }
+
     private:
         FT_Library _library;
+        std::mutex _mutex;
     };
 
     namespace {
@@ -102,109 +119,313 @@ namespace cocos2d {
             }
         }
 
+        const float SDF_FAR = 1000000.0f;
+        // the 8 bits output saturates at 128 / 16 = 8 pixels, farther background pixels only need to stay farther
+        const float SDF_SATURATE = 10.0f;
+        const float SDF_EPSILON = 1e-3f;
+        // largest magnitude of edgeDistance, 0.5 * (gx + gy) of a diagonal edge
+        const float SDF_EDGE_BOUND = 0.7072f;
+
+        /**
+         * Distance from the center of an edge pixel to the edge, estimated from its coverage a and the
+         * edge direction (gx, gy), which is a unit vector or zero.
+         */
+        inline float edgeDistance(float gx, float gy, float a)
+        {
+            if (gx == 0.0f || gy == 0.0f)
+            {
+                return 0.5f - a;
+            }
+
+            // symmetric in sign and transposition, so move to the first octant
+            gx = fabsf(gx);
+            gy = fabsf(gy);
+            if (gx < gy) std::swap(gx, gy);
+
+            float a1 = 0.5f * gy / gx;
+            if (a < a1)
+            {
+                return 0.5f * (gx + gy) - sqrtf(2.0f * gx * gy * a);
+            }
+            if (a < 1.0f - a1)
+            {
+                return (0.5f - a) * gx;
+            }
+            return -0.5f * (gx + gy) + sqrtf(2.0f * gx * gy * (1.0f - a));
+        }
+
+        // normalized gradient of the edge pixels, other pixels keep a zero gradient
+        void computeGradient(const float *img, int w, int h, float *gx, float *gy)
+        {
+            const float SQRT2 = 1.4142136f;
+            for (int y = 1; y < h - 1; y++)
+            {
+                for (int x = 1, k = y * w + 1; x < w - 1; x++, k++)
+                {
+                    if (img[k] <= 0.0f || img[k] >= 1.0f) continue;
+
+                    float dx = -img[k - w - 1] - SQRT2 * img[k - 1] - img[k + w - 1] + img[k - w + 1] + SQRT2 * img[k + 1] + img[k + w + 1];
+                    float dy = -img[k - w - 1] - SQRT2 * img[k - w] - img[k - w + 1] + img[k + w - 1] + SQRT2 * img[k + w] + img[k + w + 1];
+                    float length = dx * dx + dy * dy;
+                    if (length > 0.0f)
+                    {
+                        length = 1.0f / sqrtf(length);
+                        dx *= length;
+                        dy *= length;
+                    }
+                    gx[k] = dx;
+                    gy[k] = dy;
+                }
+            }
+        }
+
+        /**
+         * Anti-aliased Euclidean distance transform with one pair of 8 point sequential sweeps (8SSEDT), scalar code.
+         * Every pixel keeps the vector to its closest edge pixel, the distance is the length of that vector plus
+         * the sub pixel distance of the edge estimated from coverage, the metric of EDTAA3 by Gustavson & Strand.
+         * Unlike EDTAA3 it does not iterate until no distance changes, so it only approximates it: a pixel whose
+         * closest edge can not be reached in one pair of sweeps keeps a longer distance. tools/sdf-compare checks
+         * the 8 bits output against the converged EDTAA3 of external/sources/edtaa3func within a max error.
+         */
+        class DistanceTransform
+        {
+        public:
+            DistanceTransform(const float *img, const float *gx, const float *gy, int w, int h, short *xdist, short *ydist, float *dist)
+                : _img(img), _gx(gx), _gy(gy), _w(w), _h(h), _xdist(xdist), _ydist(ydist), _dist(dist)
+            {
+            }
+
+            void run()
+            {
+                for (int i = 0, n = _w * _h; i < n; i++)
+                {
+                    _xdist[i] = 0;
+                    _ydist[i] = 0;
+                    float a = _img[i];
+                    if (a <= 0.0f)
+                    {
+                        _dist[i] = SDF_SATURATE;
+                    }
+                    else if (a < 1.0f)
+                    {
+                        _dist[i] = edgeDistance(_gx[i], _gy[i], a);
+                    }
+                    else
+                    {
+                        _dist[i] = 0.0f;
+                    }
+                }
+
+                // a single pair of sweeps, a further pass only moves distances below the 8 bits precision
+                const int w = _w;
+
+                // top down, propagate from above and left, then from right
+                for (int y = 1; y < _h; y++)
+                {
+                    int i = y * w;
+                    relax(i, -w, 0, -1);
+                    relax(i, -w + 1, 1, -1);
+                    for (i++; i < y * w + w - 1; i++)
+                    {
+                        if (_dist[i] <= 0.0f) continue;
+                        relax(i, -1, -1, 0);
+                        relax(i, -w - 1, -1, -1);
+                        relax(i, -w, 0, -1);
+                        relax(i, -w + 1, 1, -1);
+                    }
+                    relax(i, -1, -1, 0);
+                    relax(i, -w - 1, -1, -1);
+                    relax(i, -w, 0, -1);
+                    for (i = y * w + w - 2; i >= y * w; i--)
+                    {
+                        relax(i, 1, 1, 0);
+                    }
+                }
+
+                // bottom up, propagate from below and right, then from left
+                for (int y = _h - 2; y >= 0; y--)
+                {
+                    int i = y * w + w - 1;
+                    relax(i, w, 0, 1);
+                    relax(i, w - 1, -1, 1);
+                    for (i--; i > y * w; i--)
+                    {
+                        if (_dist[i] <= 0.0f) continue;
+                        relax(i, 1, 1, 0);
+                        relax(i, w + 1, 1, 1);
+                        relax(i, w, 0, 1);
+                        relax(i, w - 1, -1, 1);
+                    }
+                    relax(i, 1, 1, 0);
+                    relax(i, w + 1, 1, 1);
+                    relax(i, w, 0, 1);
+                    for (i = y * w + 1; i < y * w + w; i++)
+                    {
+                        relax(i, -1, -1, 0);
+                    }
+                }
+            }
+
+        private:
+            // (xi, yi) is the vector from a pixel to the edge pixel closest
+            inline float distance(int closest, int xi, int yi) const
+            {
+                float a = _img[closest];
+                if (a <= 0.0f) return SDF_FAR;
+                if (a > 1.0f) a = 1.0f;
+
+                if (xi == 0 && yi == 0)
+                {
+                    return edgeDistance(_gx[closest], _gy[closest], a);
+                }
+                // far from the edge, the direction to it is a better estimate than the local gradient
+                float di = sqrtf((float)(xi * xi + yi * yi));
+                float inv = 1.0f / di;
+                return di + edgeDistance(xi * inv, yi * inv, a);
+            }
+
+            // tries the closest edge pixel of the neighbor at offset (ox, oy)
+            inline void relax(int i, int offset, int ox, int oy)
+            {
+                float old = _dist[i];
+                if (old <= 0.0f) return;
+
+                int c = i + offset;
+                int cx = _xdist[c];
+                int cy = _ydist[c];
+                int closest = c - cx - cy * _w;
+                // most neighbors share the closest edge pixel, which gives the current distance again
+                if (closest == i - _xdist[i] - _ydist[i] * _w) return;
+
+                int xi = cx - ox;
+                int yi = cy - oy;
+                float limit = old - SDF_EPSILON;
+                // the edge distance is within +-SDF_EDGE_BOUND, so a far candidate is rejected without a square root
+                float bound = limit + SDF_EDGE_BOUND;
+                if ((xi | yi) != 0 && bound > 0.0f && (float)(xi * xi + yi * yi) >= bound * bound) return;
+
+                float d = distance(closest, xi, yi);
+                if (d < limit)
+                {
+                    _xdist[i] = (short)xi;
+                    _ydist[i] = (short)yi;
+                    _dist[i] = d;
+                }
+            }
+
+            const float *_img;
+            const float *_gx;
+            const float *_gy;
+            int _w;
+            int _h;
+            short *_xdist;
+            short *_ydist;
+            float *_dist;
+        };
+
+        /**
+         * Bipolar distance to 8 bits, 128 - (outside - inside) * 16 clamped to [0, 255], negative distances count as 0.
+         */
+        void quantizeDistance(const float *outside, const float *inside, uint8_t *out, long count)
+        {
+            long i = 0;
+#if FFT_SDF_USE_SSE
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 mid = _mm_set1_ps(128.0f);
+            const __m128 scale = _mm_set1_ps(16.0f);
+            const __m128 maxValue = _mm_set1_ps(255.0f);
+            for (; i + 8 <= count; i += 8)
+            {
+                __m128 d0 = _mm_sub_ps(_mm_max_ps(_mm_loadu_ps(outside + i), zero), _mm_max_ps(_mm_loadu_ps(inside + i), zero));
+                __m128 d1 = _mm_sub_ps(_mm_max_ps(_mm_loadu_ps(outside + i + 4), zero), _mm_max_ps(_mm_loadu_ps(inside + i + 4), zero));
+                d0 = _mm_min_ps(_mm_max_ps(_mm_sub_ps(mid, _mm_mul_ps(d0, scale)), zero), maxValue);
+                d1 = _mm_min_ps(_mm_max_ps(_mm_sub_ps(mid, _mm_mul_ps(d1, scale)), zero), maxValue);
+                __m128i words = _mm_packs_epi32(_mm_cvttps_epi32(d0), _mm_cvttps_epi32(d1));
+                _mm_storel_epi64((__m128i *)(out + i), _mm_packus_epi16(words, words));
+            }
+#elif FFT_SDF_USE_NEON
+            const float32x4_t zero = vdupq_n_f32(0.0f);
+            const float32x4_t mid = vdupq_n_f32(128.0f);
+            const float32x4_t maxValue = vdupq_n_f32(255.0f);
+            for (; i + 8 <= count; i += 8)
+            {
+                float32x4_t d0 = vsubq_f32(vmaxq_f32(vld1q_f32(outside + i), zero), vmaxq_f32(vld1q_f32(inside + i), zero));
+                float32x4_t d1 = vsubq_f32(vmaxq_f32(vld1q_f32(outside + i + 4), zero), vmaxq_f32(vld1q_f32(inside + i + 4), zero));
+                d0 = vminq_f32(vmaxq_f32(vmlsq_n_f32(mid, d0, 16.0f), zero), maxValue);
+                d1 = vminq_f32(vmaxq_f32(vmlsq_n_f32(mid, d1, 16.0f), zero), maxValue);
+                int16x8_t words = vcombine_s16(vmovn_s32(vcvtq_s32_f32(d0)), vmovn_s32(vcvtq_s32_f32(d1)));
+                vst1_u8(out + i, vqmovun_s16(words));
+            }
+#endif
+            for (; i < count; i++)
+            {
+                float dist = 128.0f - (std::max(outside[i], 0.0f) - std::max(inside[i], 0.0f)) * 16.0f;
+                if (dist < 0.0f) dist = 0.0f;
+                if (dist > 255.0f) dist = 255.0f;
+                out[i] = (uint8_t)dist;
+            }
+        }
+
         std::vector<uint8_t> makeDistanceMap(unsigned char *img, long width, long height, int distanceMapSpread)
         {
-            long pixelAmount = (width + 2 * distanceMapSpread) * (height + 2 * distanceMapSpread);
+            long outWidth = width + 2 * distanceMapSpread;
+            long outHeight = height + 2 * distanceMapSpread;
+            long pixelAmount = outWidth * outHeight;
 
 #if FFT_SDF_TMP_VECTOR
+            std::vector<short> &xdistV = tl_xdistV;
+            std::vector<short> &ydistV = tl_ydistV;
+            std::vector<float> &gxV = tl_gxV;
+            std::vector<float> &gyV = tl_gyV;
+            std::vector<float> &dataV = tl_dataV;
+            std::vector<float> &outsideV = tl_outsideV;
+            std::vector<float> &insideV = tl_insideV;
+#else
+            std::vector<short> xdistV, ydistV;
+            std::vector<float> gxV, gyV, dataV, outsideV, insideV;
+#endif
             xdistV.resize(pixelAmount);
             ydistV.resize(pixelAmount);
-            gxV.resize(pixelAmount);
-            gyV.resize(pixelAmount);
-            dataV.resize(pixelAmount);
+            gxV.assign(pixelAmount, 0.0f);
+            gyV.assign(pixelAmount, 0.0f);
+            dataV.assign(pixelAmount, 0.0f);
             outsideV.resize(pixelAmount);
             insideV.resize(pixelAmount);
 
-            std::fill(gxV.begin(), gxV.end(), 0.0);
-            std::fill(gyV.begin(), gyV.end(), 0.0);
-            std::fill(dataV.begin(), dataV.end(), 0.0);
-            std::fill(outsideV.begin(), outsideV.end(), 0.0);
-            std::fill(insideV.begin(), insideV.end(), 0.0);
-
-            short * xdist = xdistV.data();
-            short * ydist = ydistV.data();
-            double * gx = gxV.data();
-            double * gy = gyV.data();
-            double * data = dataV.data();
-            double * outside = outsideV.data();
-            double * inside = insideV.data();
-#else
-            short * xdist = (short *)malloc(pixelAmount * sizeof(short));
-            short * ydist = (short *)malloc(pixelAmount * sizeof(short));
-            double * gx = (double *)calloc(pixelAmount, sizeof(double));
-            double * gy = (double *)calloc(pixelAmount, sizeof(double));
-            double * data = (double *)calloc(pixelAmount, sizeof(double));
-            double * outside = (double *)calloc(pixelAmount, sizeof(double));
-            double * inside = (double *)calloc(pixelAmount, sizeof(double));
-#endif
-            long i, j;
+            short *xdist = xdistV.data();
+            short *ydist = ydistV.data();
+            float *gx = gxV.data();
+            float *gy = gyV.data();
+            float *data = dataV.data();
 
-            // Convert img into double (data) rescale image levels between 0 and 1
-            long outWidth = width + 2 * distanceMapSpread;
-            for (i = 0; i < width; ++i)
+            // rescale image levels between 0 and 1 into the padded buffer
+            const float levelScale = 1.0f / 255.0f;
+            for (long j = 0; j < height; ++j)
             {
-                for (j = 0; j < height; ++j)
+                float *row = data + (j + distanceMapSpread) * outWidth + distanceMapSpread;
+                const unsigned char *src = img + j * width;
+                for (long i = 0; i < width; ++i)
                 {
-                    data[(j + distanceMapSpread) * outWidth + distanceMapSpread + i] = img[j * width + i] / 255.0;
+                    row[i] = src[i] * levelScale;
                 }
             }
 
-            width += 2 * distanceMapSpread;
-            height += 2 * distanceMapSpread;
-
-            // Transform background (outside contour, in areas of 0's)   
-            computegradient(data, (int)width, (int)height, gx, gy);
-            edtaa3(data, gx, gy, (int)width, (int)height, xdist, ydist, outside);
-            for (i = 0; i < pixelAmount; i++)
-                if (outside[i] < 0.0)
-                    outside[i] = 0.0;
-
-            // Transform foreground (inside contour, in areas of 1's)   
-            for (i = 0; i < pixelAmount; i++)
-                data[i] = 1 - data[i];
-            computegradient(data, (int)width, (int)height, gx, gy);
-            edtaa3(data, gx, gy, (int)width, (int)height, xdist, ydist, inside);
-            for (i = 0; i < pixelAmount; i++)
-                if (inside[i] < 0.0)
-                    inside[i] = 0.0;
-
-            // The bipolar distance field is now outside-inside
-            double dist;
-            /* Single channel 8-bit output (bad precision and range, but simple) */
-            std::vector<uint8_t> out;
-            out.resize(pixelAmount);
-            for (i = 0; i < pixelAmount; i++)
+            // the gradient of the inverted image only flips sign, and the edge distance ignores the sign
+            computeGradient(data, (int)outWidth, (int)outHeight, gx, gy);
+
+            // background, outside contour in areas of 0's
+            DistanceTransform(data, gx, gy, (int)outWidth, (int)outHeight, xdist, ydist, outsideV.data()).run();
+
+            // foreground, inside contour in areas of 1's
+            for (long i = 0; i < pixelAmount; i++)
             {
-                dist = outside[i] - inside[i];
-                dist = 128.0 - dist * 16;
-                if (dist < 0) dist = 0;
-                if (dist > 255) dist = 255;
-                out[i] = (unsigned char)dist;
+                data[i] = 1.0f - data[i];
             }
-            /* Dual channel 16-bit output (more complicated, but good precision and range) */
-            /*unsigned char *out = (unsigned char *) malloc( pixelAmount * 3 * sizeof(unsigned char) );
-            for( i=0; i< pixelAmount; i++)
-            {
-                dist = outside[i] - inside[i];
-                dist = 128.0 - dist*16;
-                if( dist < 0.0 ) dist = 0.0;
-                if( dist >= 256.0 ) dist = 255.999;
-                // R channel is a copy of the original grayscale image
-                out[3*i] = img[i];
-                // G channel is fraction
-                out[3*i + 1] = (unsigned char) ( 256 - (dist - floor(dist)* 256.0 ));
-                // B channel is truncated integer part
-                out[3*i + 2] = (unsigned char)dist;
-            }*/
-#if !FFT_SDF_TMP_VECTOR
-            free(xdist);
-            free(ydist);
-            free(gx);
-            free(gy);
-            free(data);
-            free(outside);
-            free(inside);
-#endif
+            DistanceTransform(data, gx, gy, (int)outWidth, (int)outHeight, xdist, ydist, insideV.data()).run();
+
+            /* Single channel 8-bit output (bad precision and range, but simple) */
+            std::vector<uint8_t> out(pixelAmount);
+            quantizeDistance(outsideV.data(), insideV.data(), out.data(), pixelAmount);
             return out;
         }
 
@@ -218,6 +439,7 @@ namespace cocos2d {
         if (!_ftLibrary)
         {
             _ftLibrary = std::make_shared< FontFreeTypeLibrary>();
+            _sFTLibrary = _ftLibrary;
         }
 
         _fontName = fontName;
@@ -235,6 +457,14 @@ namespace cocos2d {
     {
         //CCLOG("~FontFreeType");
         if (_stroker) FT_Stroker_Done(_stroker);
+
+        // a library is done with the face it holds
+        for (auto library : _poolLibraries)
+        {
+            FT_Done_FreeType(library);
+        }
+
+        std::lock_guard<std::mutex> lock(_ftLibrary->getMutex());
         if (_face) FT_Done_Face(_face);
     }
 
@@ -247,10 +477,13 @@ namespace cocos2d {
     {
         _fontData = FileUtils::getInstance()->getDataFromFile(_fontName);
 
-        if (FT_New_Memory_Face(getFTLibrary(), _fontData.getBytes(), _fontData.getSize(), 0, &_face))
         {
-            cocos2d::log("[error] failed to parse font %s", _fontName.c_str());
-            return false;
+            std::lock_guard<std::mutex> lock(_ftLibrary->getMutex());
+            if (FT_New_Memory_Face(getFTLibrary(), _fontData.getBytes(), _fontData.getSize(), 0, &_face))
+            {
+                cocos2d::log("[error] failed to parse font %s", _fontName.c_str());
+                return false;
+            }
         }
 
         if (FT_Select_Charmap(_face, _encoding))
@@ -275,9 +508,7 @@ namespace cocos2d {
             }
         }
 
-        int fontSizeInPoints = (int)(64.0f * _fontSize);
-
-        if (FT_Set_Char_Size(_face, fontSizeInPoints, fontSizeInPoints, _dpi, _dpi))
+        if (!setupFace(_face))
         {
             return false;
         }
@@ -287,6 +518,58 @@ namespace cocos2d {
         return true;
     }
 
+    bool FontFreeType::setupFace(FT_Face face)
+    {
+        if (FT_Select_Charmap(face, _encoding))
+        {
+            return false;
+        }
+
+        int fontSizeInPoints = (int)(64.0f * _fontSize);
+
+        return FT_Set_Char_Size(face, fontSizeInPoints, fontSizeInPoints, _dpi, _dpi) == 0;
+    }
+
+    FT_Face FontFreeType::acquireFace()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_faceMutex);
+            if (!_freeFaces.empty())
+            {
+                FT_Face face = _freeFaces.back();
+                _freeFaces.pop_back();
+                return face;
+            }
+        }
+
+        if (!_face) return nullptr;
+
+        // faces of the pool share the font data loaded by loadFont but not the library, before FreeType 2.6
+        // the faces of a library render through one raster pool and can't be used on different threads
+        FT_Library library = nullptr;
+        if (FT_Init_FreeType(&library))
+        {
+            return nullptr;
+        }
+
+        FT_Face face = nullptr;
+        if (FT_New_Memory_Face(library, _fontData.getBytes(), _fontData.getSize(), 0, &face) || !setupFace(face))
+        {
+            FT_Done_FreeType(library);
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(_faceMutex);
+        _poolLibraries.push_back(library);
+        return face;
+    }
+
+    void FontFreeType::releaseFace(FT_Face face)
+    {
+        std::lock_guard<std::mutex> lock(_faceMutex);
+        _freeFaces.push_back(face);
+    }
+
     int FontFreeType::getHorizontalKerningForChars(uint64_t a, uint64_t b) const
     {
         auto idx1 = FT_Get_Char_Index(_face, static_cast<FT_ULong>(a));
@@ -331,20 +614,49 @@ namespace cocos2d {
 
     std::shared_ptr<GlyphBitmap> FontFreeType::getGlyphBitmap(unsigned long ch, bool hasOutline)
     {
-        return hasOutline ? getSDFGlyphBitmap(ch) : getNormalGlyphBitmap(ch);
+        return hasOutline ? getSDFGlyphBitmap(_face, ch) : getNormalGlyphBitmap(_face, ch);
     }
 
+    void FontFreeType::getGlyphBitmaps(const std::vector<unsigned long>& chars, bool hasOutline, std::vector<std::shared_ptr<GlyphBitmap>>& out)
+    {
+        out.assign(chars.size(), nullptr);
+        if (chars.empty()) return;
+
+        auto jobSystem = renderer::JobSystem::getInstance();
+        if (!jobSystem)
+        {
+            rasterizeGlyphs(chars.data(), chars.size(), hasOutline, out.data());
+            return;
+        }
 
-    std::shared_ptr<GlyphBitmap> FontFreeType::getNormalGlyphBitmap(unsigned long ch)
+        jobSystem->parallelFor(chars.size(), FFT_GLYPH_JOB_GRAIN, [&](std::size_t begin, std::size_t end, int tid) {
+            rasterizeGlyphs(chars.data() + begin, end - begin, hasOutline, out.data() + begin);
+        });
+    }
+
+    void FontFreeType::rasterizeGlyphs(const unsigned long* chars, std::size_t count, bool hasOutline, std::shared_ptr<GlyphBitmap>* out)
     {
-        if (!_face) return nullptr;
+        FT_Face face = acquireFace();
+        if (!face) return;
+
+        for (std::size_t i = 0; i < count; i++)
+        {
+            out[i] = hasOutline ? getSDFGlyphBitmap(face, chars[i]) : getNormalGlyphBitmap(face, chars[i]);
+        }
+        releaseFace(face);
+    }
+
+
+    std::shared_ptr<GlyphBitmap> FontFreeType::getNormalGlyphBitmap(FT_Face face, unsigned long ch)
+    {
+        if (!face) return nullptr;
         const auto load_char_flag = FT_LOAD_RENDER | FT_LOAD_NO_AUTOHINT;
-        if (FT_Load_Char(_face, static_cast<FT_ULong>(ch), load_char_flag))
+        if (FT_Load_Char(face, static_cast<FT_ULong>(ch), load_char_flag))
         {
             return nullptr;
         }
 
-        auto& metrics = _face->glyph->metrics;
+        auto& metrics = face->glyph->metrics;
         int x = SCALE_BY_DPI(metrics.horiBearingX >> 6);
         int y = SCALE_BY_DPI(-(metrics.horiBearingY >> 6));
         int w = SCALE_BY_DPI(metrics.width >> 6);
@@ -353,7 +665,7 @@ namespace cocos2d {
         int adv = SCALE_BY_DPI(metrics.horiAdvance >> 6);
 
 
-        auto& bitmap = _face->glyph->bitmap;
+        auto& bitmap = face->glyph->bitmap;
         int bmWidth = bitmap.width;
         int bmHeight = bitmap.rows;
         PixelMode mode = FTtoPixelModel(static_cast<FT_Pixel_Mode>(bitmap.pixel_mode));
@@ -363,16 +675,16 @@ namespace cocos2d {
         return std::shared_ptr<GlyphBitmap>(ret);
     }
 
-    std::shared_ptr<GlyphBitmap> FontFreeType::getSDFGlyphBitmap(unsigned long ch)
+    std::shared_ptr<GlyphBitmap> FontFreeType::getSDFGlyphBitmap(FT_Face face, unsigned long ch)
     {
-        if (!_face) return nullptr;
+        if (!face) return nullptr;
         const auto load_char_flag = FT_LOAD_RENDER | FT_LOAD_NO_AUTOHINT;
-        if (FT_Load_Char(_face, static_cast<FT_ULong>(ch), load_char_flag))
+        if (FT_Load_Char(face, static_cast<FT_ULong>(ch), load_char_flag))
         {
             return nullptr;
         }
 
-        auto& metrics = _face->glyph->metrics;
+        auto& metrics = face->glyph->metrics;
         int x = SCALE_BY_DPI(metrics.horiBearingX >> 6);
         int y = SCALE_BY_DPI(-(metrics.horiBearingY >> 6));
         int w = SCALE_BY_DPI(metrics.width >> 6);
@@ -380,7 +692,7 @@ namespace cocos2d {
 
         int adv = SCALE_BY_DPI(metrics.horiAdvance >> 6);
 
-        auto& bitmap = _face->glyph->bitmap;
+        auto& bitmap = face->glyph->bitmap;
         int bmWidth = bitmap.width;
         int bmHeight = bitmap.rows;
         PixelMode mode = FTtoPixelModel(static_cast<FT_Pixel_Mode>(bitmap.pixel_mode));
@@ -33,6 +33,7 @@ THE SOFTWARE.
 
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -69,10 +70,25 @@ namespace cocos2d {
 
         std::shared_ptr<GlyphBitmap> getGlyphBitmap(unsigned long ch, bool hasOutline = false);
 
+        /**
+         * Rasterizes a batch of glyphs on the job system, every lane renders with a face of its own.
+         * out[i] is null if chars[i] has no glyph. It must be called on the cocos thread.
+         */
+        void getGlyphBitmaps(const std::vector<unsigned long>& chars, bool hasOutline, std::vector<std::shared_ptr<GlyphBitmap>>& out);
+
+        /**
+         * Rasterizes glyphs serially with a face taken from the face pool, it can be called on any thread.
+         */
+        void rasterizeGlyphs(const unsigned long* chars, std::size_t count, bool hasOutline, std::shared_ptr<GlyphBitmap>* out);
+
     private:
 
-        std::shared_ptr<GlyphBitmap> getNormalGlyphBitmap(unsigned long ch);
-        std::shared_ptr<GlyphBitmap> getSDFGlyphBitmap(unsigned long ch);
+        std::shared_ptr<GlyphBitmap> getNormalGlyphBitmap(FT_Face face, unsigned long ch);
+        std::shared_ptr<GlyphBitmap> getSDFGlyphBitmap(FT_Face face, unsigned long ch);
+
+        bool setupFace(FT_Face face);
+        FT_Face acquireFace();
+        void releaseFace(FT_Face face);
 
         std::shared_ptr<FontFreeTypeLibrary> _ftLibrary;
         //weak reference
@@ -87,6 +103,12 @@ namespace cocos2d {
         FT_Face    _face = { 0 };
         FT_Encoding _encoding = FT_ENCODING_UNICODE;
 
+        // a FT_Face can only be used by one thread at a time, _face belongs to the cocos thread
+        // and worker threads take faces of the same font from the pool, each with a library of its own
+        std::mutex _faceMutex;
+        std::vector<FT_Face> _freeFaces;
+        std::vector<FT_Library> _poolLibraries;
+
         int _dpi = 72;
     };
 
@@ -477,6 +477,7 @@ namespace cocos2d {
         if(!_fontAtlas) {
             return false;
         }
+        _fontAtlas->addLayout(this);
         _fontScale = fontSize / _fontAtlas->getFontSize();
         _groups = std::make_shared<TextRenderGroup>();
         if (info->shadowBlur >= 0)
@@ -496,6 +497,24 @@ namespace cocos2d {
 
     LabelLayout::~LabelLayout()
     {
+        if (_fontAtlas)
+        {
+            _fontAtlas->removeLayout(this);
+            _fontAtlas->getFontAtlas()->releaseLetters(_letters);
+        }
+    }
+
+    bool LabelLayout::isAtlasChanged() const
+    {
+        return _fontAtlas && _fontAtlas->getFontAtlas()->getVersion() != _atlasVersion;
+    }
+
+    void LabelLayout::onAtlasChanged()
+    {
+        if (_renderer && isAtlasChanged())
+        {
+            _renderer->onAtlasChanged();
+        }
     }
 
 
@@ -556,6 +575,8 @@ namespace cocos2d {
 
         atlas->prepareLetters(_u32string, ttf);
 
+        std::vector<unsigned long> letters;
+
         for (int i = 0; i < _u32string.size(); i++)
         {
             auto ch = _u32string[i];
@@ -575,6 +596,7 @@ namespace cocos2d {
 
             letterDef = atlas->getOrLoad(ch, ttf);
             if (!letterDef) continue;
+            letters.push_back(ch);
             
             letterRect = letterDef->rect;
             letterRect.origin *= _fontScale;
@@ -626,8 +648,17 @@ namespace cocos2d {
                 Rect letterTexture(underline->texX, underline->texY, underline->texWidth, underline->texHeight);
                 splitRectIntoThreeParts(underline->textureID, letterRect, letterRectInline, letterTexture, space);
             }
+            letters.push_back('_');
         }
 
+        // retain before release, letters in both sets must not become unused in between
+        std::sort(letters.begin(), letters.end());
+        letters.erase(std::unique(letters.begin(), letters.end()), letters.end());
+        atlas->retainLetters(letters);
+        atlas->releaseLetters(_letters);
+        _letters.swap(letters);
+        _atlasVersion = atlas->getVersion();
+
         Vec2 newCenter;
         Vec2 delta;
         // default value in LabelOverflow::None mode
@@ -133,6 +133,16 @@ namespace cocos2d {
 
         bool isInited() const { return _inited; }
 
+        /**
+         * Letters of the layout moved in the font atlas, it must be updated before rendering.
+         */
+        bool isAtlasChanged() const;
+
+        /**
+         * Called by the font atlas once letters moved, the label is laid out and filled again.
+         */
+        void onAtlasChanged();
+
         void fillAssembler(renderer::CustomAssembler *assembeler, renderer::EffectVariant *effect);
 
     private:
@@ -158,6 +168,10 @@ namespace cocos2d {
 
         std::vector<TextRowSpace> _textSpace;
 
+        // letters retained in the font atlas and the atlas version they are laid out with
+        std::vector<unsigned long> _letters;
+        uint32_t _atlasVersion = 0;
+
         std::shared_ptr<TextRenderGroup> _groups;
         std::shared_ptr<TextRenderGroup> _shadowGroups;
         LabelRenderer *_renderer = nullptr;
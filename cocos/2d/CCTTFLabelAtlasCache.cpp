@@ -22,9 +22,15 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #include "CCTTFLabelAtlasCache.h"
+#include "CCLabelLayout.h"
 
 #include "platform/CCFileUtils.h"
+#include "platform/CCApplication.h"
+#include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
+#include "base/ccUTF8.h"
 
+#include <atomic>
 #include <cmath>
 #include "base/ccConfig.h"
 #if CC_ENABLE_TTF_LABEL_RENDERER
@@ -34,6 +40,12 @@ THE SOFTWARE.
 
 #define FTT_TEXTURE_SIZE 1024
 
+// letters of a prewarm task and the most tasks a prewarm is split into
+#define FTT_PREWARM_TASK_LETTERS 16
+#define FTT_PREWARM_MAX_TASKS 4
+
+#define FTT_TICK_KEY "TTFLabelAtlasCache::tick"
+
 namespace cocos2d {
 
     namespace {
@@ -82,24 +94,59 @@ namespace cocos2d {
         return true;
     }
 
+    void TTFLabelAtals::notifyAtlasChanged()
+    {
+        // a layout may be released by the update of another one
+        std::vector<LabelLayout*> layouts(_layouts.begin(), _layouts.end());
+        for (auto *layout : layouts)
+        {
+            if (_layouts.find(layout) != _layouts.end())
+            {
+                layout->onAtlasChanged();
+            }
+        }
+    }
+
     TTFLabelAtlasCache * TTFLabelAtlasCache::getInstance()
     {
         if (!_instance)
         {
             _instance = new TTFLabelAtlasCache();
+            // font atlases evict and repack letters between frames
+            auto *app = Application::getInstance();
+            if (app)
+            {
+                app->getScheduler()->schedule([](float) {
+                    if (_instance) _instance->tick();
+                }, _instance, 0.0f, false, FTT_TICK_KEY);
+            }
         }
         return _instance;
     }
 
     void TTFLabelAtlasCache::destroyInstance()
     {
+        auto *app = Application::getInstance();
+        if (_instance && app)
+        {
+            app->getScheduler()->unschedule(FTT_TICK_KEY, _instance);
+        }
         delete _instance;
         _instance = nullptr;
     }
 
     void TTFLabelAtlasCache::reset()
     {
+        // labels may keep a prewarmed atlas alive, its letters no label used are evictable from now on
+        for (auto &it : _prewarmed)
+        {
+            if (it.second.atlas && it.second.atlas->_fontAtlas)
+            {
+                it.second.atlas->_fontAtlas->unpinLetters();
+            }
+        }
         _cache.clear();
+        _prewarmed.clear();
     }
 
     std::shared_ptr<TTFLabelAtals> TTFLabelAtlasCache::load(const std::string &font, float fontSizeF, LabelLayoutInfo *info)
@@ -141,6 +188,123 @@ namespace cocos2d {
     }
 
 
+    bool TTFLabelAtlasCache::prewarm(const std::string &font, float fontSize, bool hasOutline, const std::string &text)
+    {
+        LabelLayoutInfo keyInfo;
+        keyInfo.outlineSize = hasOutline ? 1.0f : 0.0f;
+        std::string key = cacheKeyFor(font, mapFontSize(fontSize), &keyInfo);
+
+        auto &prewarmed = _prewarmed[key];
+        if (!prewarmed.atlas)
+        {
+            prewarmed.info.reset(new LabelLayoutInfo(keyInfo));
+            prewarmed.atlas = load(font, fontSize, prewarmed.info.get());
+            if (!prewarmed.atlas)
+            {
+                _prewarmed.erase(key);
+                return false;
+            }
+        }
+
+        std::u32string u32text;
+        StringUtils::UTF8ToUTF32(text, u32text);
+
+        struct PrewarmJob {
+            std::vector<unsigned long> letters;
+            std::vector<std::shared_ptr<GlyphBitmap>> bitmaps;
+            std::atomic<int> remainTasks;
+        };
+        auto job = std::make_shared<PrewarmJob>();
+        std::shared_ptr<FontAtlas> fontAtlas = prewarmed.atlas->_fontAtlas;
+        std::shared_ptr<FontFreeType> ttf = prewarmed.atlas->_ttfFont;
+        fontAtlas->collectMissingLetters(u32text, job->letters);
+        if (job->letters.empty())
+        {
+            return true;
+        }
+
+        std::size_t letterNum = job->letters.size();
+        job->bitmaps.resize(letterNum);
+        int taskNum = (int)std::min<std::size_t>((letterNum + FTT_PREWARM_TASK_LETTERS - 1) / FTT_PREWARM_TASK_LETTERS, FTT_PREWARM_MAX_TASKS);
+        job->remainTasks.store(taskNum);
+
+        // the atlas and the font are captured, so the job outlives a reset of the cache
+        bool outline = fontAtlas->hasOutline();
+        for (int i = 0; i < taskNum; i++)
+        {
+            std::size_t begin = letterNum * i / taskNum;
+            std::size_t end = letterNum * (i + 1) / taskNum;
+            ThreadPool::getDefaultThreadPool()->pushTask([job, fontAtlas, ttf, outline, begin, end](int tid) {
+                ttf->rasterizeGlyphs(job->letters.data() + begin, end - begin, outline, job->bitmaps.data() + begin);
+                if (job->remainTasks.fetch_sub(1) == 1)
+                {
+                    Application::getInstance()->getScheduler()->performFunctionInCocosThread([job, fontAtlas]() {
+                        // no label uses them yet, they are not evicted before one does or they are idle for long
+                        fontAtlas->prepareLetters(job->letters, job->bitmaps);
+                        fontAtlas->pinLetters(job->letters);
+                    });
+                }
+            });
+        }
+        return true;
+    }
+
+    void TTFLabelAtlasCache::tick()
+    {
+        std::vector<std::shared_ptr<TTFLabelAtals>> changed;
+        for (auto &it : _cache)
+        {
+#if CC_TTF_LABELATLAS_ENABLE_GC
+            std::shared_ptr<TTFLabelAtals> atlas = it.second.lock();
+#else
+            std::shared_ptr<TTFLabelAtals> &atlas = it.second;
+#endif
+            if (atlas && atlas->_fontAtlas)
+            {
+                uint32_t version = atlas->_fontAtlas->getVersion();
+                atlas->_fontAtlas->endFrame();
+                if (atlas->_fontAtlas->getVersion() != version)
+                {
+                    changed.push_back(atlas);
+                }
+            }
+        }
+
+        // updating labels may load atlases, so it's done out of the loop over the cache
+        for (auto &atlas : changed)
+        {
+            atlas->notifyAtlasChanged();
+        }
+    }
+
+    FontAtlas::Stats TTFLabelAtlasCache::getStats() const
+    {
+        FontAtlas::Stats total;
+        float usedPages = 0.0f;
+        for (auto &it : _cache)
+        {
+#if CC_TTF_LABELATLAS_ENABLE_GC
+            std::shared_ptr<TTFLabelAtals> atlas = it.second.lock();
+#else
+            const std::shared_ptr<TTFLabelAtals> &atlas = it.second;
+#endif
+            if (!atlas || !atlas->_fontAtlas) continue;
+
+            FontAtlas::Stats stats = atlas->_fontAtlas->getStats();
+            total.pageCount += stats.pageCount;
+            total.letterCount += stats.letterCount;
+            total.unusedLetterCount += stats.unusedLetterCount;
+            total.evictedLetters += stats.evictedLetters;
+            total.defragmentCount += stats.defragmentCount;
+            usedPages += stats.occupancy * stats.pageCount;
+        }
+        if (total.pageCount > 0)
+        {
+            total.occupancy = usedPages / total.pageCount;
+        }
+        return total;
+    }
+
     std::string TTFLabelAtlasCache::cacheKeyFor(const std::string &font, int fontSize, LabelLayoutInfo * info)
     {
         char keybuffer[512] = { 0 };
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "2d/CCFontAtlas.h"
 
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 
 #include "base/ccConfig.h"
@@ -38,6 +39,7 @@ THE SOFTWARE.
 namespace cocos2d {
 
     class TTFLabelAtlasCache;
+    class LabelLayout;
     struct LabelLayoutInfo;
 
     // font atlas of specific size font
@@ -54,13 +56,23 @@ namespace cocos2d {
 
         bool init();
 
+        /**
+         * Layouts using the atlas, they are updated once its letters move.
+         */
+        void addLayout(LabelLayout *layout) { _layouts.insert(layout); }
+        void removeLayout(LabelLayout *layout) { _layouts.erase(layout); }
+
     private:
+        void notifyAtlasChanged();
+
         std::string _fontName;
         float _fontSize = 0.f;
         //weak reference
         LabelLayoutInfo *_info =  nullptr;
         std::shared_ptr<FontAtlas> _fontAtlas;
         std::shared_ptr<FontFreeType> _ttfFont;
+        //weak references
+        std::unordered_set<LabelLayout*> _layouts;
         
         friend class TTFLabelAtlasCache;
     };
@@ -77,6 +89,28 @@ namespace cocos2d {
 
         void unload(TTFLabelAtals *);
 
+        /**
+         * Rasterizes the letters of text on background threads, they are packed into the atlas on the cocos thread
+         * once all of them are done. A prewarmed atlas is kept until reset, its prewarmed letters until a label uses them,
+         * they are idle for as long as unused letters are kept or the cache is reset.
+         * @param font Font file path.
+         * @param fontSize Size the atlas is created with, it's max(fontSize, fontSizeRetina) of a label.
+         * @param hasOutline Prewarms the distance field atlas used by labels with outline or bold.
+         * @param text Letters to rasterize, in UTF-8.
+         */
+        bool prewarm(const std::string &font, float fontSize, bool hasOutline, const std::string &text);
+
+        /**
+         * Ends the frame of all font atlases, scheduled every frame on the cocos thread once the cache is created.
+         * Labels of an atlas which is repacked are refilled right away, they may not render again on their own.
+         */
+        void tick();
+
+        /**
+         * Stats of all font atlases in use added up, the occupancy is over all of their pages.
+         */
+        FontAtlas::Stats getStats() const;
+
     protected:
 
         std::string cacheKeyFor(const std::string &font, int fontSize, LabelLayoutInfo *info);
@@ -89,6 +123,13 @@ namespace cocos2d {
         std::unordered_map< std::string, std::shared_ptr< TTFLabelAtals>> _cache;
 #endif
 
+        // prewarmed atlases and the layout info they are created with
+        struct PrewarmedAtlas {
+            std::unique_ptr<LabelLayoutInfo> info;
+            std::shared_ptr<TTFLabelAtals> atlas;
+        };
+        std::unordered_map<std::string, PrewarmedAtlas> _prewarmed;
+
     };
 
 }
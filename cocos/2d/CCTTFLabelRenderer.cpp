@@ -116,9 +116,10 @@ namespace cocos2d {
 
             doRender();            
         }
-        else if (_cfg->updateFlags & UPDATE_CONTENT)
+        else if ((_cfg->updateFlags & UPDATE_CONTENT) || _stringLayout->isAtlasChanged())
         {
-            std::string text = getString();            // update content only
+            // update content only, also when the font atlas is repacked
+            std::string text = getString();
             if (_stringLayout->isInited())
             {
                 _stringLayout->setString(text, true);
@@ -138,6 +139,19 @@ namespace cocos2d {
         }
     }
 
+    void LabelRenderer::onAtlasChanged()
+    {
+        if (!_stringLayout || !_stringLayout->isInited()) return;
+
+        // the old uv and textures are kept until the next render otherwise
+        _stringLayout->setString(getString(), true);
+        doRender();
+        if (_nodeProxy && _nodeProxy->getAssembler())
+        {
+            _nodeProxy->getAssembler()->enableDirty(AssemblerBase::VERTICES_DIRTY);
+        }
+    }
+
     std::string LabelRenderer::getString() {
         se::Value str;
         assert(_selfObj);
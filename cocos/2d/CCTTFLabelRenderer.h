@@ -78,6 +78,11 @@ namespace cocos2d {
         void setJsComponent(se::Object *component);
         
         se::Object *getJsComponent() const {return _componentObj;}
+
+        /**
+         * Letters of the layout moved in the font atlas, the assembler is refilled without waiting for render.
+         */
+        void onAtlasChanged();
         
     private:
 
@@ -18,6 +18,7 @@ cocos2d.cpp \
 platform/CCFileUtils.cpp \
 platform/CCImage.cpp \
 platform/CCSAXParser.cpp \
+platform/CCFileMapping.cpp \
 $(MATHNEONFILE) \
 math/CCGeometry.cpp \
 math/CCVertex.cpp \
@@ -125,6 +126,7 @@ renderer/gfx/FrameBuffer.cpp \
 renderer/gfx/GFX.cpp \
 renderer/gfx/GraphicsHandle.cpp \
 renderer/gfx/IndexBuffer.cpp \
+renderer/gfx/NullGraphics.cpp \
 renderer/gfx/Program.cpp \
 renderer/gfx/RenderBuffer.cpp \
 renderer/gfx/RenderTarget.cpp \
@@ -167,7 +169,9 @@ renderer/scene/RenderFlow.cpp \
 renderer/scene/StencilManager.cpp \
 renderer/scene/MemPool.cpp \
 renderer/scene/NodeMemPool.cpp \
-renderer/scene/ParallelTask.cpp \
+renderer/scene/JobSystem.cpp \
+renderer/scene/Profiler.cpp \
+renderer/scene/StaticBatch.cpp \
 renderer/memop/RecyclePool.hpp \
 renderer/renderer/EffectVariant.cpp \
 renderer/renderer/EffectBase.cpp \
@@ -24,6 +24,7 @@
  ****************************************************************************/
 #include "base/CCLog.h"
 #include <stdio.h>
+#include <stdarg.h>
 #include <new>
 #include <algorithm>
 #include <string.h>
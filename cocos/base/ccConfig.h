@@ -38,6 +38,43 @@ THE SOFTWARE.
 
 // disable module if you didn't need it, this will reduce package size
 
+// the linux target is headless, it has no audio device, video player or web view
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+#ifndef USE_VIDEO
+#define USE_VIDEO 0
+#endif
+
+#ifndef USE_WEB_VIEW
+#define USE_WEB_VIEW 0
+#endif
+
+#ifndef USE_AUDIO
+#define USE_AUDIO 0
+#endif
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+/** @def USE_GFX_NULL
+ * If enabled, the GL entry points are implemented by renderer/gfx/NullGraphics.cpp instead of a GL driver.
+ * Nothing is drawn, draws, state changes and uploaded bytes are counted, see cocos2d::renderer::NullGraphics.
+ * Enabled by default on linux, which runs without a GL context.
+ */
+#ifndef USE_GFX_NULL
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+#define USE_GFX_NULL 1
+#else
+#define USE_GFX_NULL 0
+#endif
+#endif
+
+/** @def USE_RENDER_PROFILER
+ * If enabled, the native render pipeline is instrumented with scoped timers and counters, see cocos2d::renderer::Profiler.
+ * Recording is turned on at runtime, while it's off every scope only checks a flag.
+ * Set it to 0 to compile the instrumentation out.
+ */
+#ifndef USE_RENDER_PROFILER
+#define USE_RENDER_PROFILER 1
+#endif
+
 #ifndef USE_GFX_RENDERER
 #define USE_GFX_RENDERER 1
 #endif
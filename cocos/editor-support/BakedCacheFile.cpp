@@ -0,0 +1,221 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#include "BakedCacheFile.h"
+#include "platform/CCFileUtils.h"
+#include "platform/CCFileMapping.h"
+#include "base/CCData.h"
+#include <stdio.h>
+#include <string.h>
+
+USING_NS_CC;
+
+namespace {
+    const std::size_t SectionAlign = 16;
+    
+    inline std::size_t alignSize (std::size_t size) {
+        return (size + SectionAlign - 1) & ~(SectionAlign - 1);
+    }
+}
+
+MIDDLEWARE_BEGIN
+
+uint64_t hashBytes (const void* data, std::size_t size, uint64_t seed)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint64_t hash = seed;
+    for (std::size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint64_t hashString (const std::string& str, uint64_t seed)
+{
+    // length first, so that a list of strings never hashes like their concatenation
+    uint32_t len = (uint32_t)str.size();
+    return hashBytes(str.data(), str.size(), hashBytes(&len, sizeof(len), seed));
+}
+
+std::shared_ptr<BakedCacheFile> BakedCacheFile::open (const std::string& path, uint32_t magic, uint32_t version, uint64_t contentHash)
+{
+    auto fileUtils = FileUtils::getInstance();
+    if (path.empty() || !fileUtils->isFileExist(path))
+    {
+        return nullptr;
+    }
+    
+    std::string fullPath = fileUtils->fullPathForFilename(path);
+    std::shared_ptr<BakedCacheFile> file(new BakedCacheFile());
+    file->_data = mapFile(fullPath, sizeof(Header), file->_size);
+    file->_mapped = file->_data != nullptr;
+    
+    if (!file->_data)
+    {
+        Data data = fileUtils->getDataFromFile(fullPath);
+        if (data.getSize() < (ssize_t)sizeof(Header))
+        {
+            return nullptr;
+        }
+        ssize_t size = 0;
+        file->_data = data.takeBuffer(&size);
+        file->_size = (std::size_t)size;
+    }
+    
+    if (!file->validate(magic, version, contentHash))
+    {
+        return nullptr;
+    }
+    return file;
+}
+
+BakedCacheFile::~BakedCacheFile ()
+{
+    if (!_data) return;
+    if (_mapped)
+    {
+        unmapFile(_data, _size);
+        _data = nullptr;
+        return;
+    }
+    free(_data);
+    _data = nullptr;
+}
+
+bool BakedCacheFile::validate (uint32_t magic, uint32_t version, uint64_t contentHash) const
+{
+    if (_size < sizeof(Header)) return false;
+    
+    const Header* header = (const Header*)_data;
+    if (header->magic != magic || header->version != version || header->contentHash != contentHash)
+    {
+        return false;
+    }
+    if (header->fileSize != _size)
+    {
+        return false;
+    }
+    
+    uint64_t tableEnd = sizeof(Header) + (uint64_t)header->sectionCount * sizeof(Section);
+    if (tableEnd > _size) return false;
+    
+    const Section* sections = (const Section*)(_data + sizeof(Header));
+    for (uint32_t i = 0; i < header->sectionCount; i++)
+    {
+        const Section& section = sections[i];
+        if (section.offset % SectionAlign != 0 || section.offset < tableEnd)
+        {
+            return false;
+        }
+        if ((uint64_t)section.offset + section.size > _size)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t BakedCacheFile::getSectionCount () const
+{
+    return ((const Header*)_data)->sectionCount;
+}
+
+const uint8_t* BakedCacheFile::getSection (uint32_t index, std::size_t& size) const
+{
+    if (index >= getSectionCount()) return nullptr;
+    const Section& section = ((const Section*)(_data + sizeof(Header)))[index];
+    size = section.size;
+    return _data + section.offset;
+}
+
+BakedCacheWriter::BakedCacheWriter (uint32_t magic, uint32_t version, uint64_t contentHash)
+{
+    memset(&_header, 0, sizeof(_header));
+    _header.magic = magic;
+    _header.version = version;
+    _header.contentHash = contentHash;
+}
+
+void BakedCacheWriter::addSection (const void* data, std::size_t size)
+{
+    BakedCacheFile::Section section;
+    // relative to the first section until save
+    section.offset = (uint32_t)_data.size();
+    section.size = (uint32_t)size;
+    _sections.push_back(section);
+    
+    if (size > 0)
+    {
+        _data.insert(_data.end(), (const uint8_t*)data, (const uint8_t*)data + size);
+    }
+    _data.resize(alignSize(_data.size()), 0);
+}
+
+bool BakedCacheWriter::save (const std::string& path) const
+{
+    std::size_t tableSize = sizeof(BakedCacheFile::Header) + _sections.size() * sizeof(BakedCacheFile::Section);
+    std::size_t dataOffset = alignSize(tableSize);
+    if (dataOffset + _data.size() > UINT32_MAX)
+    {
+        return false;
+    }
+    
+    BakedCacheFile::Header header = _header;
+    header.sectionCount = (uint32_t)_sections.size();
+    header.fileSize = (uint32_t)(dataOffset + _data.size());
+    
+    std::vector<BakedCacheFile::Section> sections = _sections;
+    for (auto& section : sections)
+    {
+        section.offset += (uint32_t)dataOffset;
+    }
+    
+    auto fileUtils = FileUtils::getInstance();
+    std::string tmpPath = path + ".tmp";
+    FILE* fp = fopen(fileUtils->getSuitableFOpen(tmpPath).c_str(), "wb");
+    if (!fp)
+    {
+        return false;
+    }
+    
+    static const uint8_t padding[SectionAlign] = {0};
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    ok = ok && (sections.empty() || fwrite(sections.data(), sizeof(BakedCacheFile::Section), sections.size(), fp) == sections.size());
+    ok = ok && (dataOffset == tableSize || fwrite(padding, 1, dataOffset - tableSize, fp) == dataOffset - tableSize);
+    ok = ok && (_data.empty() || fwrite(_data.data(), 1, _data.size(), fp) == _data.size());
+    ok = (fclose(fp) == 0) && ok;
+    
+    if (ok)
+    {
+        ok = fileUtils->renameFile(tmpPath, path);
+    }
+    if (!ok)
+    {
+        fileUtils->removeFile(tmpPath);
+    }
+    return ok;
+}
+
+MIDDLEWARE_END
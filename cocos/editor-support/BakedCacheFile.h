@@ -0,0 +1,128 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+#pragma once
+#include "MiddlewareMacro.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+
+MIDDLEWARE_BEGIN
+
+/**
+ * 64 bit FNV-1a hash, used as the content hash of baked cache files.
+ * Pass the result of a previous call as seed to hash several blocks.
+ */
+uint64_t hashBytes (const void* data, std::size_t size, uint64_t seed = 0xcbf29ce484222325ULL);
+uint64_t hashString (const std::string& str, uint64_t seed = 0xcbf29ce484222325ULL);
+
+/**
+ * A baked cache file, the header is followed by a section table and the sections.
+ * Every section starts at a 16 bytes aligned offset, so arrays of plain structs can be used in place.
+ * The file is mapped if it lives in the file system, or read into memory if it's packed, e.g. in apk.
+ * A file whose magic, version, content hash or layout does not match is rejected.
+ */
+class BakedCacheFile
+{
+public:
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t contentHash;
+        uint32_t sectionCount;
+        uint32_t fileSize;
+    };
+    
+    struct Section
+    {
+        uint32_t offset;
+        uint32_t size;
+    };
+    
+    /**
+     * @brief Opens a file.
+     * @return nullptr if the file does not exist or is not valid.
+     */
+    static std::shared_ptr<BakedCacheFile> open (const std::string& path, uint32_t magic, uint32_t version, uint64_t contentHash);
+    
+    ~BakedCacheFile ();
+    
+    uint32_t getSectionCount () const;
+    /**
+     * @brief Gets a section, size is in bytes.
+     * @return nullptr if the section does not exist.
+     */
+    const uint8_t* getSection (uint32_t index, std::size_t& size) const;
+    /**
+     * @brief Gets a section as an array of T.
+     * @return nullptr if the section does not exist or its size is not a multiple of T.
+     */
+    template <typename T>
+    const T* getArray (uint32_t index, std::size_t& count) const
+    {
+        std::size_t size = 0;
+        const uint8_t* data = getSection(index, size);
+        if (!data || size % sizeof(T) != 0) return nullptr;
+        count = size / sizeof(T);
+        return (const T*)data;
+    }
+private:
+    BakedCacheFile () {}
+    bool validate (uint32_t magic, uint32_t version, uint64_t contentHash) const;
+private:
+    uint8_t* _data = nullptr;
+    std::size_t _size = 0;
+    bool _mapped = false;
+};
+
+/**
+ * Writes a baked cache file section by section.
+ * The sections are built in memory, so save may run in any thread.
+ */
+class BakedCacheWriter
+{
+public:
+    BakedCacheWriter (uint32_t magic, uint32_t version, uint64_t contentHash);
+    
+    void addSection (const void* data, std::size_t size);
+    template <typename T>
+    void addArray (const T* data, std::size_t count)
+    {
+        addSection(data, count * sizeof(T));
+    }
+    
+    /**
+     * @brief Writes the file to a temporary file next to path and renames it, so readers never see a partial file.
+     * @return false if the file can not be written.
+     */
+    bool save (const std::string& path) const;
+private:
+    BakedCacheFile::Header _header;
+    std::vector<BakedCacheFile::Section> _sections;
+    std::vector<uint8_t> _data;
+};
+
+MIDDLEWARE_END
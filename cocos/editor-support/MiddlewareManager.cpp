@@ -24,10 +24,18 @@
 #include "MiddlewareManager.h"
 #include "base/CCGLUtils.h"
 #include "scripting/js-bindings/jswrapper/SeApi.h"
+#include "renderer/scene/JobSystem.hpp"
+#include "renderer/scene/Profiler.hpp"
 #include <algorithm>
 
 MIDDLEWARE_BEGIN
-    
+
+namespace {
+    // editors per job chunk, a skeleton pose is cheap so keep chunks coarse
+    const std::size_t TransformJobGrain = 8;
+}
+
+
 MiddlewareManager* MiddlewareManager::_instance = nullptr;
 
 MiddlewareManager::MiddlewareManager()
@@ -61,47 +69,68 @@ MeshBuffer* MiddlewareManager::getMeshBuffer(int format)
 
 void MiddlewareManager::_clearRemoveList()
 {
-    for (std::size_t i = 0; i < _removeList.size(); i++)
+    if (_removeSet.empty()) return;
+    
+    auto it = std::remove_if(_updateList.begin(), _updateList.end(), [this](IMiddleware* editor)
     {
-        auto editor = _removeList[i];
-        auto it = std::find(_updateList.begin(), _updateList.end(), editor);
-        if (it != _updateList.end())
-        {
-            _updateList.erase(it);
-        }
-    }
+        return _removeSet.find(editor) != _removeSet.end();
+    });
+    _updateList.erase(it, _updateList.end());
     
-    _removeList.clear();
+    _removeSet.clear();
 }
 
 void MiddlewareManager::update(float dt)
 {
     isUpdating = true;
     
-    for (std::size_t i = 0, n = _updateList.size(); i < n; i++)
+    // animation state may dispatch script events, so keep it on this thread
     {
-        auto editor = _updateList[i];
-        if (_removeList.size() > 0)
+        RENDER_PROFILE_SCOPE(MIDDLEWARE_UPDATE);
+        for (std::size_t i = 0, n = _updateList.size(); i < n; i++)
         {
-            auto removeIt = std::find(_removeList.begin(), _removeList.end(), editor);
-            if (removeIt == _removeList.end())
+            auto editor = _updateList[i];
+            if (!_isRemoved(editor))
             {
                 editor->update(dt);
             }
         }
-        else
+    }
+    
+    // _removeSet is only modified by script, it's read only while the job runs
+    auto updateTransform = [this, dt](std::size_t begin, std::size_t end, int tid)
+    {
+        RENDER_PROFILE_SCOPE(MIDDLEWARE_TRANSFORM);
+        for (std::size_t i = begin; i < end; i++)
         {
-            editor->update(dt);
+            auto editor = _updateList[i];
+            if (!_isRemoved(editor))
+            {
+                editor->updateTransform(dt);
+            }
         }
+    };
+    
+    auto jobSystem = cocos2d::renderer::JobSystem::getInstance();
+    if (jobSystem)
+    {
+        jobSystem->parallelFor(_updateList.size(), TransformJobGrain, updateTransform);
+    }
+    else
+    {
+        updateTransform(0, _updateList.size(), 0);
     }
     
     isUpdating = false;
+    _transformClaims.clear();
     
     _clearRemoveList();
 }
 
 void MiddlewareManager::render(float dt)
 {
+    RENDER_PROFILE_SCOPE(MIDDLEWARE_RENDER);
+    
     for (auto it : _mbMap)
     {
         auto buffer = it.second;
@@ -119,16 +148,7 @@ void MiddlewareManager::render(float dt)
     {
         auto editor = _updateList[i];
         uint32_t renderOrder = maxRenderOrder;
-        if (_removeList.size() > 0)
-        {
-            auto removeIt = std::find(_removeList.begin(), _removeList.end(), editor);
-            if (removeIt == _removeList.end())
-            {
-                editor->render(dt);
-                renderOrder = editor->getRenderOrder();
-            }
-        }
-        else
+        if (!_isRemoved(editor))
         {
             editor->render(dt);
             renderOrder = editor->getRenderOrder();
@@ -169,16 +189,14 @@ void MiddlewareManager::render(float dt)
 
 void MiddlewareManager::addTimer(IMiddleware* editor)
 {
+    // removed and added again in one traverse, it's still in the list
+    _removeSet.erase(editor);
+    
     auto it0 = std::find(_updateList.begin(), _updateList.end(), editor);
     if (it0 != _updateList.end()) {
         return;
     }
     
-    auto it1 = std::find(_removeList.begin(), _removeList.end(), editor);
-    if (it1 != _removeList.end())
-    {
-        _removeList.erase(it1);
-    }
     _updateList.push_back(editor);
 }
 
@@ -186,7 +204,7 @@ void MiddlewareManager::removeTimer(IMiddleware* editor)
 {
     if (isUpdating || isRendering)
     {
-        _removeList.push_back(editor);
+        _removeSet.insert(editor);
     }
     else
     {
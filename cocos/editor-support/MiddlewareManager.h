@@ -26,6 +26,7 @@
 #include "MeshBuffer.h"
 #include <map>
 #include <vector>
+#include <unordered_set>
 #include "base/CCRef.h"
 #include "MiddlewareMacro.h"
 
@@ -39,6 +40,12 @@ public:
     IMiddleware() {}
     virtual ~IMiddleware() {}
     virtual void update(float dt) = 0;
+    /**
+     * Pose computation that only touches the middleware's own data, such as bone world transform.
+     * It's called after every update of the frame and may run on worker threads,
+     * so it must not call into script, dispatch events or write any shared object.
+     */
+    virtual void updateTransform(float dt) {}
     virtual void render(float dt) = 0;
     virtual uint32_t getRenderOrder() const = 0;
 };
@@ -76,7 +83,8 @@ public:
     }
     
     /**
-     * @brief update all elements
+     * @brief update all elements, update is called serially in list order,
+     * then updateTransform is spread over the job system if there is one.
      * @param[in] dt Delta time.
      */
     void update(float dt);
@@ -100,6 +108,18 @@ public:
     
     MeshBuffer* getMeshBuffer(int format);
     
+    /**
+     * @brief Claims the updateTransform work of an object several elements share, such as a shared skeleton.
+     * Only the first claim in an update succeeds, so the object is computed once, on one lane.
+     * It must be called from IMiddleware::update.
+     * @param[in] object The shared object.
+     * @return true if the caller should compute the object in its updateTransform.
+     */
+    bool claimTransform(void* object)
+    {
+        return _transformClaims.insert(object).second;
+    }
+    
     MiddlewareManager();
     ~MiddlewareManager();
     
@@ -108,9 +128,16 @@ public:
     bool isUpdating = false;
 private:
     void _clearRemoveList();
+    bool _isRemoved(IMiddleware* editor) const
+    {
+        return !_removeSet.empty() && _removeSet.find(editor) != _removeSet.end();
+    }
 private:
     std::vector<IMiddleware*> _updateList;
-    std::vector<IMiddleware*> _removeList;
+    // editors removed while traversing, they are skipped and erased once the traverse is finished
+    std::unordered_set<IMiddleware*> _removeSet;
+    // shared objects claimed in the current update, see claimTransform
+    std::unordered_set<void*> _transformClaims;
     std::map<int, MeshBuffer*> _mbMap;
     
     static MiddlewareManager* _instance;
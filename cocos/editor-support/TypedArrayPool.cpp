@@ -25,6 +25,7 @@
 #include "base/CCLog.h"
 #include "base/ccMacros.h"
 #include <functional>
+#include <math.h>
 #include "MiddlewareMacro.h"
 
 #define POOL_DEBUG 0
@@ -22,14 +22,96 @@
 */
 
 #include "ArmatureCache.h"
+#include "ArmatureCacheMgr.h"
 #include "CCFactory.h"
+#include "CCTextureAtlasData.h"
+#include "BakedCacheFile.h"
 #include "base/ccTypes.h"
+#include "base/CCThreadPool.h"
 #include "renderer/gfx/Texture.h"
+#include <algorithm>
+#include <stdio.h>
 
 USING_NS_CC;
 USING_NS_MW;
 using namespace cocos2d::renderer;
 
+namespace {
+    // baked cache file layout, bump the version whenever a record changes
+    const uint32_t DiskCacheMagic = 0x434b4244;
+    const uint32_t DiskCacheVersion = 1;
+
+    enum DiskCacheSection {
+        SectionInfo = 0,
+        SectionFrames,
+        SectionSegments,
+        SectionBones,
+        SectionColors,
+        SectionVertices,
+        SectionIndices,
+        SectionCount
+    };
+
+    struct DiskCacheInfo {
+        uint32_t frameCount;
+        float totalTime;
+        uint32_t textureCount;
+        uint32_t vertexSize;
+    };
+
+    // vertex and index ranges are in bytes
+    struct DiskFrameRecord {
+        uint32_t boneOffset;
+        uint32_t boneCount;
+        uint32_t colorOffset;
+        uint32_t colorCount;
+        uint32_t segmentOffset;
+        uint32_t segmentCount;
+        uint32_t vertexOffset;
+        uint32_t vertexSize;
+        uint32_t indexOffset;
+        uint32_t indexSize;
+    };
+
+    struct DiskSegmentRecord {
+        uint32_t textureIndex;
+        int32_t blendMode;
+        uint32_t indexCount;
+        uint32_t vertexFloatCount;
+    };
+
+    struct DiskBoneRecord {
+        float m[16];
+    };
+
+    struct DiskColorRecord {
+        float r, g, b, a;
+        uint32_t vertexFloatOffset;
+    };
+
+    inline bool inRange(uint32_t offset, uint32_t count, std::size_t total)
+    {
+        return (uint64_t)offset + count <= total;
+    }
+
+    std::string sanitizeFileName(const std::string& name)
+    {
+        std::string result = name;
+        for (auto& c : result)
+        {
+            bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+            if (!valid) c = '_';
+        }
+        return result;
+    }
+
+    ThreadPool* getSaveThreadPool()
+    {
+        static ThreadPool* pool = ThreadPool::newSingleThreadPool();
+        return pool;
+    }
+}
+
 DRAGONBONES_NAMESPACE_BEGIN
 
 float ArmatureCache::FrameTime = 1.0f / 60.0f;
@@ -148,6 +230,8 @@ void ArmatureCache::AnimationData::reset()
     _frames.clear();
     _isComplete = false;
     _totalTime = 0.0f;
+    _diskCachePath = "";
+    _diskCacheHash = 0;
 }
 
 bool ArmatureCache::AnimationData::needUpdate(int toFrameIdx) const 
@@ -184,6 +268,9 @@ std::size_t ArmatureCache::AnimationData::getFrameCount() const
 }
 
 ArmatureCache::ArmatureCache(const std::string& armatureName, const std::string& armatureKey, const std::string& atlasUUID)
+: _armatureName(armatureName)
+, _armatureKey(armatureKey)
+, _atlasUUID(atlasUUID)
 {
     _armatureDisplay = dragonBones::CCFactory::getFactory()->buildArmatureDisplay(armatureName, armatureKey, "", atlasUUID);
     if (_armatureDisplay) 
@@ -264,6 +351,11 @@ void ArmatureCache::updateToFrame(const std::string& animationName, int toFrameI
         _curAnimationName = animationName;
     }
 
+    if (loadAnimationData(animationData))
+    {
+        return;
+    }
+
     auto armature = _armatureDisplay->getArmature();
     auto animation = armature->getAnimation();
 
@@ -282,6 +374,246 @@ void ArmatureCache::updateToFrame(const std::string& animationName, int toFrameI
             animationData->_isComplete = true;
         }
     } while (animationData->needUpdate(toFrameIdx));
+
+    if (!animationData->needUpdate(-1))
+    {
+        saveAnimationData(animationData);
+    }
+}
+
+const std::vector<middleware::Texture2D*>& ArmatureCache::getDiskCacheTextures()
+{
+    if (_diskCacheTexturesReady) return _diskCacheTextures;
+    _diskCacheTexturesReady = true;
+
+    auto atlases = CCFactory::getFactory()->getTextureAtlasData(_atlasUUID);
+    if (!atlases) return _diskCacheTextures;
+    for (auto atlas : *atlases)
+    {
+        auto texture = static_cast<CCTextureAtlasData*>(atlas)->getRenderTexture();
+        if (texture && std::find(_diskCacheTextures.begin(), _diskCacheTextures.end(), texture) == _diskCacheTextures.end())
+        {
+            _diskCacheTextures.push_back(texture);
+        }
+    }
+    return _diskCacheTextures;
+}
+
+uint64_t ArmatureCache::getDiskCacheHash()
+{
+    uint64_t hash = CCFactory::getFactory()->getDragonBonesDataHash(_armatureKey);
+    if (hash == 0) return 0;
+
+    // the atlas json is not kept by the factory, its parsed regions are hashed instead
+    auto atlases = CCFactory::getFactory()->getTextureAtlasData(_atlasUUID);
+    if (!atlases) return 0;
+    for (auto atlas : *atlases)
+    {
+        float atlasInfo[] = { (float)atlas->width, (float)atlas->height, atlas->scale };
+        hash = middleware::hashString(atlas->name, hash);
+        hash = middleware::hashBytes(atlasInfo, sizeof(atlasInfo), hash);
+        for (auto& it : atlas->textures)
+        {
+            auto textureData = it.second;
+            auto& region = textureData->region;
+            float regionInfo[] = { region.x, region.y, region.width, region.height, textureData->rotated ? 1.0f : 0.0f };
+            hash = middleware::hashString(it.first, hash);
+            hash = middleware::hashBytes(regionInfo, sizeof(regionInfo), hash);
+        }
+    }
+    return hash;
+}
+
+bool ArmatureCache::loadAnimationData(AnimationData* animationData)
+{
+    // a bake may stop halfway, it's never replaced by the file
+    if (animationData->getFrameCount() > 0) return false;
+    animationData->_diskCachePath = "";
+    animationData->_diskCacheHash = 0;
+
+    const std::string& dir = ArmatureCacheMgr::getInstance()->getDiskCachePath();
+    if (dir.empty()) return false;
+    uint64_t contentHash = getDiskCacheHash();
+    if (contentHash == 0) return false;
+
+    uint64_t key = middleware::hashString(animationData->_animationName);
+    key = middleware::hashString(_armatureName, key);
+    float params[] = { FrameTime, MaxCacheTime };
+    key = middleware::hashBytes(params, sizeof(params), key);
+
+    char fileName[32] = {0};
+    snprintf(fileName, sizeof(fileName), "_%016llx.dbc", (unsigned long long)key);
+    std::string path = dir;
+    if (path.back() != '/') path += '/';
+    animationData->_diskCachePath = path + sanitizeFileName(_armatureKey) + fileName;
+    animationData->_diskCacheHash = middleware::hashBytes(&key, sizeof(key), contentHash);
+
+    auto file = middleware::BakedCacheFile::open(animationData->_diskCachePath, DiskCacheMagic, DiskCacheVersion, animationData->_diskCacheHash);
+    if (!file || file->getSectionCount() != SectionCount) return false;
+
+    std::size_t count = 0;
+    const DiskCacheInfo* info = file->getArray<DiskCacheInfo>(SectionInfo, count);
+    if (!info || count != 1 || info->frameCount == 0 || info->vertexSize != sizeof(middleware::V2F_T2F_C4B)) return false;
+
+    auto& textures = getDiskCacheTextures();
+    if (info->textureCount != textures.size()) return false;
+
+    std::size_t frameCount = 0, segmentCount = 0, boneCount = 0, colorCount = 0, vertexBytes = 0, indexBytes = 0;
+    auto frames = file->getArray<DiskFrameRecord>(SectionFrames, frameCount);
+    auto segments = file->getArray<DiskSegmentRecord>(SectionSegments, segmentCount);
+    auto bones = file->getArray<DiskBoneRecord>(SectionBones, boneCount);
+    auto colors = file->getArray<DiskColorRecord>(SectionColors, colorCount);
+    auto vertices = file->getArray<char>(SectionVertices, vertexBytes);
+    auto indices = file->getArray<char>(SectionIndices, indexBytes);
+    if (!frames || !segments || !bones || !colors || !vertices || !indices) return false;
+    if (frameCount != info->frameCount) return false;
+
+    // the renderer walks the frames without checks, so every range is validated before anything is built
+    for (std::size_t i = 0; i < frameCount; i++)
+    {
+        const DiskFrameRecord& frame = frames[i];
+        if (!inRange(frame.boneOffset, frame.boneCount, boneCount) ||
+            !inRange(frame.colorOffset, frame.colorCount, colorCount) ||
+            !inRange(frame.segmentOffset, frame.segmentCount, segmentCount) ||
+            !inRange(frame.vertexOffset, frame.vertexSize, vertexBytes) ||
+            !inRange(frame.indexOffset, frame.indexSize, indexBytes))
+        {
+            return false;
+        }
+        if (frame.segmentCount > 0 && frame.colorCount == 0) return false;
+        uint64_t segVertexFloats = 0, segIndexCount = 0;
+        for (uint32_t j = frame.segmentOffset, m = frame.segmentOffset + frame.segmentCount; j < m; j++)
+        {
+            if (segments[j].textureIndex >= textures.size()) return false;
+            segVertexFloats += segments[j].vertexFloatCount;
+            segIndexCount += segments[j].indexCount;
+        }
+        if (segVertexFloats * sizeof(float) != frame.vertexSize || segIndexCount * sizeof(unsigned short) != frame.indexSize) return false;
+    }
+
+    // frames keep their own objects and buffers, so the file is copied and closed
+    for (std::size_t i = 0; i < frameCount; i++)
+    {
+        const DiskFrameRecord& frame = frames[i];
+        FrameData* frameData = animationData->buildFrameData(i);
+        for (uint32_t j = 0; j < frame.boneCount; j++)
+        {
+            BoneData* boneData = frameData->buildBoneData(j);
+            memcpy(boneData->globalTransformMatrix.m, bones[frame.boneOffset + j].m, sizeof(DiskBoneRecord));
+        }
+        for (uint32_t j = 0; j < frame.colorCount; j++)
+        {
+            const DiskColorRecord& src = colors[frame.colorOffset + j];
+            ColorData* colorData = frameData->buildColorData(j);
+            colorData->color = Color4F(src.r, src.g, src.b, src.a);
+            colorData->vertexFloatOffset = src.vertexFloatOffset;
+        }
+        for (uint32_t j = 0; j < frame.segmentCount; j++)
+        {
+            const DiskSegmentRecord& src = segments[frame.segmentOffset + j];
+            SegmentData* segmentData = frameData->buildSegmentData(j);
+            segmentData->setTexture(textures[src.textureIndex]);
+            segmentData->blendMode = src.blendMode;
+            segmentData->indexCount = src.indexCount;
+            segmentData->vertexFloatCount = src.vertexFloatCount;
+        }
+        if (frame.vertexSize > 0)
+        {
+            frameData->vb.writeBytes(vertices + frame.vertexOffset, frame.vertexSize);
+        }
+        if (frame.indexSize > 0)
+        {
+            frameData->ib.writeBytes(indices + frame.indexOffset, frame.indexSize);
+        }
+    }
+
+    animationData->_totalTime = info->totalTime;
+    animationData->_isComplete = true;
+    return true;
+}
+
+void ArmatureCache::saveAnimationData(AnimationData* animationData)
+{
+    if (!ArmatureCacheMgr::getInstance()->isDiskCacheSaveEnabled() || animationData->_diskCachePath.empty()) return;
+
+    auto& textures = getDiskCacheTextures();
+    std::vector<DiskFrameRecord> frames;
+    std::vector<DiskSegmentRecord> segments;
+    std::vector<DiskBoneRecord> bones;
+    std::vector<DiskColorRecord> colors;
+    std::vector<char> vertices;
+    std::vector<char> indices;
+
+    for (std::size_t i = 0, n = animationData->getFrameCount(); i < n; i++)
+    {
+        FrameData* frameData = animationData->_frames[i];
+        DiskFrameRecord frame;
+        frame.boneOffset = (uint32_t)bones.size();
+        frame.boneCount = (uint32_t)frameData->_bones.size();
+        frame.colorOffset = (uint32_t)colors.size();
+        frame.colorCount = (uint32_t)frameData->_colors.size();
+        frame.segmentOffset = (uint32_t)segments.size();
+        frame.segmentCount = (uint32_t)frameData->_segments.size();
+        frame.vertexOffset = (uint32_t)vertices.size();
+        frame.vertexSize = (uint32_t)frameData->vb.length();
+        frame.indexOffset = (uint32_t)indices.size();
+        frame.indexSize = (uint32_t)frameData->ib.length();
+        frames.push_back(frame);
+
+        for (auto boneData : frameData->_bones)
+        {
+            DiskBoneRecord bone;
+            memcpy(bone.m, boneData->globalTransformMatrix.m, sizeof(bone.m));
+            bones.push_back(bone);
+        }
+        for (auto colorData : frameData->_colors)
+        {
+            DiskColorRecord color;
+            color.r = colorData->color.r;
+            color.g = colorData->color.g;
+            color.b = colorData->color.b;
+            color.a = colorData->color.a;
+            color.vertexFloatOffset = (uint32_t)colorData->vertexFloatOffset;
+            colors.push_back(color);
+        }
+        for (auto segmentData : frameData->_segments)
+        {
+            auto it = std::find(textures.begin(), textures.end(), segmentData->getTexture());
+            // a texture outside of the atlas can not be found again on next launch
+            if (it == textures.end()) return;
+            DiskSegmentRecord segment;
+            segment.textureIndex = (uint32_t)(it - textures.begin());
+            segment.blendMode = segmentData->blendMode;
+            segment.indexCount = (uint32_t)segmentData->indexCount;
+            segment.vertexFloatCount = (uint32_t)segmentData->vertexFloatCount;
+            segments.push_back(segment);
+        }
+        const char* vb = (const char*)frameData->vb.getBuffer();
+        vertices.insert(vertices.end(), vb, vb + frameData->vb.length());
+        const char* ib = (const char*)frameData->ib.getBuffer();
+        indices.insert(indices.end(), ib, ib + frameData->ib.length());
+    }
+    if (frames.empty()) return;
+
+    DiskCacheInfo info;
+    info.frameCount = (uint32_t)frames.size();
+    info.totalTime = animationData->_totalTime;
+    info.textureCount = (uint32_t)textures.size();
+    info.vertexSize = sizeof(middleware::V2F_T2F_C4B);
+
+    auto writer = std::make_shared<middleware::BakedCacheWriter>(DiskCacheMagic, DiskCacheVersion, animationData->_diskCacheHash);
+    writer->addArray(&info, 1);
+    writer->addArray(frames.data(), frames.size());
+    writer->addArray(segments.data(), segments.size());
+    writer->addArray(bones.data(), bones.size());
+    writer->addArray(colors.data(), colors.size());
+    writer->addArray(vertices.data(), vertices.size());
+    writer->addArray(indices.data(), indices.size());
+
+    std::string path = animationData->_diskCachePath;
+    getSaveThreadPool()->pushTask([writer, path](int /*tid*/) {
+        writer->save(path);
+    });
 }
 
 void ArmatureCache::renderAnimationFrame(AnimationData* animationData) 
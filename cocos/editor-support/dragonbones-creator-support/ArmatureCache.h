@@ -114,6 +114,9 @@ public:
         bool _isComplete = false;
         float _totalTime = 0.0f;
         std::vector<FrameData*> _frames;
+        // baked cache file of the current bake, empty if disk cache is disabled
+        std::string _diskCachePath = "";
+        uint64_t _diskCacheHash = 0;
     };
 
     ArmatureCache(const std::string& armatureName, const std::string& armatureKey, const std::string& atlasUUID);
@@ -130,6 +133,11 @@ public:
 private:
     void renderAnimationFrame(AnimationData* animationData);
     void traverseArmature(Armature* armature, float parentOpacity = 1.0f);
+    // chooses the baked cache file of the animation data, and loads it if it exists
+    bool loadAnimationData(AnimationData* animationData);
+    void saveAnimationData(AnimationData* animationData);
+    const std::vector<cocos2d::middleware::Texture2D*>& getDiskCacheTextures();
+    uint64_t getDiskCacheHash();
 public:
     static float FrameTime;
     static float MaxCacheTime;
@@ -149,6 +157,12 @@ private:
     cocos2d::renderer::BlendFactor _curBlendDst;
     std::string _curAnimationName = "";
     std::map<std::string, AnimationData*> _animationCaches;
+    std::string _armatureName = "";
+    std::string _armatureKey = "";
+    std::string _atlasUUID = "";
+    // render textures of the atlas, baked cache files store indices into it
+    std::vector<cocos2d::middleware::Texture2D*> _diskCacheTextures;
+    bool _diskCacheTexturesReady = false;
 };
 
 DRAGONBONES_NAMESPACE_END
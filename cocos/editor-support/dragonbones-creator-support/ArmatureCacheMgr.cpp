@@ -22,6 +22,7 @@
 */
 
 #include "ArmatureCacheMgr.h"
+#include "platform/CCFileUtils.h"
 
 DRAGONBONES_NAMESPACE_BEGIN
 
@@ -54,4 +55,14 @@ void ArmatureCacheMgr::removeArmatureCache(const std::string& uuid)
     }
 }
 
+void ArmatureCacheMgr::setDiskCachePath(const std::string& path)
+{
+    _diskCachePath = path;
+    // a relative path may point into the packed resources, which are read only
+    if (!path.empty() && path[0] == '/')
+    {
+        cocos2d::FileUtils::getInstance()->createDirectory(path);
+    }
+}
+
 DRAGONBONES_NAMESPACE_END
\ No newline at end of file
@@ -49,9 +49,19 @@ public:
 
     void removeArmatureCache(const std::string& armatureKey);
     ArmatureCache* buildArmatureCache(const std::string& armatureName, const std::string& armatureKey, const std::string& atlasUUID);
+
+    // Baked animations are loaded from this directory instead of being baked again,
+    // empty path disables the disk cache.
+    void setDiskCachePath(const std::string& path);
+    const std::string& getDiskCachePath() const { return _diskCachePath; }
+    // Writes every animation baked at runtime to the disk cache path, it can also be used to generate the files at build time.
+    void setDiskCacheSaveEnabled(bool enabled) { _diskCacheSaveEnabled = enabled; }
+    bool isDiskCacheSaveEnabled() const { return _diskCacheSaveEnabled; }
 private:
     static ArmatureCacheMgr* _instance;
     cocos2d::Map<std::string, ArmatureCache*> _caches;
+    std::string _diskCachePath = "";
+    bool _diskCacheSaveEnabled = false;
 };
 
 DRAGONBONES_NAMESPACE_END
\ No newline at end of file
@@ -25,6 +25,7 @@
 #include "dragonbones-creator-support/CCArmatureDisplay.h"
 #include "dragonbones-creator-support/CCSlot.h"
 #include "platform/CCFileUtils.h"
+#include "BakedCacheFile.h"
 
 USING_NS_CC;
 
@@ -104,6 +105,7 @@ DragonBonesData* CCFactory::loadDragonBonesData(const std::string& filePath, con
         if (pos != std::string::npos)
         {
             const auto data = cocos2d::FileUtils::getInstance()->getStringFromFile(filePath);
+            setDragonBonesDataHash(name, data.data(), data.size(), scale);
 
             return parseDragonBonesData(data.c_str(), name, scale);
         }
@@ -113,6 +115,7 @@ DragonBonesData* CCFactory::loadDragonBonesData(const std::string& filePath, con
             cocos2d::FileUtils::getInstance()->getContents(fullpath, &cocos2dData);
             const auto binary = (unsigned char*)malloc(sizeof(unsigned char)* cocos2dData.getSize());
             memcpy(binary, cocos2dData.getBytes(), cocos2dData.getSize());
+            setDragonBonesDataHash(name, binary, (std::size_t)cocos2dData.getSize(), scale);
             const auto data = parseDragonBonesData((char*)binary, name, scale);
 
             return data;
@@ -143,12 +146,15 @@ DragonBonesData* CCFactory::parseDragonBonesDataByPath(const std::string& filePa
             cocos2d::FileUtils::getInstance()->getContents(fullpath, &cocos2dData);
             const auto binary = (unsigned char*)malloc(sizeof(unsigned char)* cocos2dData.getSize());
             memcpy(binary, cocos2dData.getBytes(), cocos2dData.getSize());
+            setDragonBonesDataHash(name, binary, (std::size_t)cocos2dData.getSize(), scale);
             
             return parseDragonBonesData((char*)binary, name, scale);
         }
     }
     else
     {
+        // the path is the json content itself
+        setDragonBonesDataHash(name, filePath.data(), filePath.size(), scale);
         return parseDragonBonesData(filePath.c_str(), name, scale);
     }
     
@@ -172,6 +178,31 @@ void CCFactory::removeDragonBonesDataByUUID(const std::string& uuid, bool dispos
             it++;
         }
     }
+
+    for (auto it = _dragonBonesDataHashes.begin(); it != _dragonBonesDataHashes.end(); )
+    {
+        if (it->first.find(uuid) != std::string::npos)
+        {
+            it = _dragonBonesDataHashes.erase(it);
+        }
+        else
+        {
+            it++;
+        }
+    }
+}
+
+uint64_t CCFactory::getDragonBonesDataHash(const std::string& name) const
+{
+    auto it = _dragonBonesDataHashes.find(name);
+    return it != _dragonBonesDataHashes.end() ? it->second : 0;
+}
+
+void CCFactory::setDragonBonesDataHash(const std::string& name, const void* data, std::size_t size, float scale)
+{
+    if (name.empty()) return;
+    uint64_t hash = middleware::hashBytes(data, size);
+    _dragonBonesDataHashes[name] = middleware::hashBytes(&scale, sizeof(scale), hash);
 }
 
 TextureAtlasData* CCFactory::loadTextureAtlasData(const std::string& filePath, const std::string& name, float scale)
@@ -92,6 +92,8 @@ public:
     
 protected:
     std::string _prevPath;
+    // hash of the raw data and scale of every parsed DragonBonesData, keyed by name
+    std::map<std::string, uint64_t> _dragonBonesDataHashes;
 
 public:
     /**
@@ -266,6 +268,13 @@ public:
     
     CCTextureAtlasData* getTextureAtlasDataByIndex(const std::string& name, int textureIndex) const;
     DragonBonesData* parseDragonBonesDataByPath(const std::string& filePath, const std::string& name = "", float scale = 1.0f);
+    /**
+     * Gets the hash of the raw data a DragonBonesData is parsed from, 0 if the data is unknown.
+     * Baked armature caches on disk are only valid for the same hash.
+     */
+    uint64_t getDragonBonesDataHash(const std::string& name) const;
+private:
+    void setDragonBonesDataHash(const std::string& name, const void* data, std::size_t size, float scale);
 };
 
 DRAGONBONES_NAMESPACE_END
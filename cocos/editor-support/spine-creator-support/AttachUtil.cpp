@@ -140,9 +140,10 @@ namespace spine {
         _attachedNodes.resize(lastValidIdx + 1);
     }
     
-    void CacheModeAttachUtil::syncAttachedNode(cocos2d::renderer::NodeProxy* skeletonNode, SkeletonCache::FrameData* frameData)
+    void CacheModeAttachUtil::syncAttachedNode(cocos2d::renderer::NodeProxy* skeletonNode, const SkeletonCache::FrameData* frameData)
     {
         static cocos2d::Mat4 nodeWorldMat;
+        static cocos2d::Mat4 boneMat;
         if (!skeletonNode || !_attachedRootNode) return;
         if (!_attachedRootNode->isValid())
         {
@@ -154,7 +155,7 @@ namespace spine {
         auto& rootMatrix = skeletonNode->getWorldMatrix();
         _attachedRootNode->updateWorldMatrix(rootMatrix);
         
-        auto& bonesData = frameData->getBones();
+        auto bonesData = frameData->getBones();
         auto boneCount = frameData->getBoneCount();
         int lastValidIdx = -1;
         for (int i = 0, n = (int)_attachedNodes.size(); i < n; i++)
@@ -176,10 +177,10 @@ namespace spine {
                 lastValidIdx = i;
                 continue;
             }
-            auto bone = bonesData[i];
+            bonesData[i].toMat4(boneMat);
             boneNode->enableVisit(true);
             
-            cocos2d::Mat4::multiply(_attachedRootNode->getWorldMatrix(), bone->globalTransformMatrix, &nodeWorldMat);
+            cocos2d::Mat4::multiply(_attachedRootNode->getWorldMatrix(), boneMat, &nodeWorldMat);
             boneNode->updateWorldMatrix(nodeWorldMat);
             lastValidIdx = i;
         }
@@ -68,6 +68,6 @@ namespace spine {
     public:
         CacheModeAttachUtil() {}
         virtual ~CacheModeAttachUtil() {}
-        void syncAttachedNode(cocos2d::renderer::NodeProxy* skeletonNode, SkeletonCache::FrameData* frameData);
+        void syncAttachedNode(cocos2d::renderer::NodeProxy* skeletonNode, const SkeletonCache::FrameData* frameData);
     };
 }
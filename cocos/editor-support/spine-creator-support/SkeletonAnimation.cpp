@@ -150,11 +150,31 @@ void SkeletonAnimation::update (float deltaTime) {
         deltaTime *= _timeScale * GlobalTimeScale;
         if (_ownsSkeleton) _skeleton->update(deltaTime);
         _state->update(deltaTime);
+        // listeners fired by apply see the new pose, they compute the world transform first
+        _isTransformDirty = true;
         _state->apply(*_skeleton);
-        _skeleton->updateWorldTransform();
+        
+        auto mgr = cocos2d::middleware::MiddlewareManager::getInstance();
+        if (!mgr->isUpdating) {
+            updateWorldTransformIfDirty();
+        } else if (!_ownsSkeleton && _isTransformDirty && !mgr->claimTransform(_skeleton)) {
+            // a shared skeleton is computed once, by the lane of its first user in this frame
+            _isTransformDirty = false;
+        }
+        // otherwise bones only depend on this skeleton, let the manager compute them in parallel
     }
 }
 
+void SkeletonAnimation::updateTransform (float deltaTime) {
+    updateWorldTransformIfDirty();
+}
+
+void SkeletonAnimation::updateWorldTransformIfDirty () {
+    if (!_isTransformDirty) return;
+    _isTransformDirty = false;
+    if (_skeleton) _skeleton->updateWorldTransform();
+}
+
 void SkeletonAnimation::setAnimationStateData (AnimationStateData* stateData) {
     CCASSERT(stateData, "stateData cannot be null.");
 
@@ -244,6 +264,7 @@ void SkeletonAnimation::clearTrack (int trackIndex) {
 }
 
 void SkeletonAnimation::onAnimationStateEvent (TrackEntry* entry, EventType type, Event* event) {
+    updateWorldTransformIfDirty();
     switch (type) {
     case EventType_Start:
         if (_startListener) _startListener(entry);
@@ -268,6 +289,7 @@ void SkeletonAnimation::onAnimationStateEvent (TrackEntry* entry, EventType type
 
 void SkeletonAnimation::onTrackEntryEvent (TrackEntry* entry, EventType type, Event* event) {
     if (!entry->getRendererObject()) return;
+    updateWorldTransformIfDirty();
     _TrackEntryListeners* listeners = (_TrackEntryListeners*)entry->getRendererObject();
     switch (type) {
     case EventType_Start:
@@ -62,6 +62,7 @@ public:
     }
 
     virtual void update (float deltaTime) override;
+    virtual void updateTransform (float deltaTime) override;
 
     void setAnimationStateData (AnimationStateData* stateData);
     void setMix (const std::string& fromAnimation, const std::string& toAnimation, float duration);
@@ -103,8 +104,12 @@ CC_CONSTRUCTOR_ACCESS:
 public:
     static float GlobalTimeScale;
 protected:
+    void updateWorldTransformIfDirty ();
+    
     AnimationState*       _state = nullptr;
     bool                    _ownsAnimationStateData = false;
+    // world transform is deferred to updateTransform while the middleware manager is updating
+    bool                    _isTransformDirty = false;
     StartListener           _startListener = nullptr;
     InterruptListener       _interruptListener = nullptr;
     EndListener             _endListener = nullptr;
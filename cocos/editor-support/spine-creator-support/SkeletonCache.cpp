@@ -28,102 +28,198 @@
  *****************************************************************************/
 
 #include "SkeletonCache.h"
+#include "SkeletonCacheMgr.h"
+#include "SkeletonDataMgr.h"
 #include "spine-creator-support/AttachmentVertices.h"
 #include "renderer/gfx/Texture.h"
+#include "platform/CCApplication.h"
+#include "base/CCScheduler.h"
+#include "base/CCThreadPool.h"
+#include <algorithm>
+#include <stdio.h>
 
 USING_NS_CC;
 USING_NS_MW;
 using namespace cocos2d::renderer;
 
-namespace spine {
+namespace {
+    // bakes are short and mostly issued in bursts when a scene is loaded
+    const int BakeThreadNum = 2;
     
-    float SkeletonCache::FrameTime = 1.0f / 60.0f;
-    float SkeletonCache::MaxCacheTime = 120.0f;
+    ThreadPool* getBakeThreadPool () {
+        static ThreadPool* pool = ThreadPool::newFixedThreadPool(BakeThreadNum);
+        return pool;
+    }
     
-    SkeletonCache::SegmentData::SegmentData () {
-        
+    // baked cache file layout, bump the version whenever a record or FrameData changes
+    const uint32_t DiskCacheMagic = 0x434b5053;
+    const uint32_t DiskCacheVersion = 1;
+    
+    enum DiskCacheSection {
+        SectionInfo = 0,
+        SectionFrames,
+        SectionSegments,
+        SectionBones,
+        SectionColors,
+        SectionVertices,
+        SectionIndices,
+        SectionCount
+    };
+    
+    struct DiskCacheInfo {
+        uint32_t frameCount;
+        uint32_t quantized;
+        float totalTime;
+        uint32_t textureCount;
+        // bones and colors are used in place, so their layout must match this build
+        uint32_t boneSize;
+        uint32_t colorSize;
+        uint32_t vertexSize;
+    };
+    
+    struct DiskFrameRecord {
+        uint32_t boneOffset;
+        uint32_t boneCount;
+        uint32_t colorOffset;
+        uint32_t colorCount;
+        uint32_t segmentOffset;
+        uint32_t segmentCount;
+        uint32_t vertexOffset;
+        uint32_t vertexCount;
+        uint32_t indexOffset;
+        uint32_t indexCount;
+    };
+    
+    struct DiskSegmentRecord {
+        uint32_t textureIndex;
+        int32_t indexCount;
+        int32_t vertexCount;
+        int32_t blendMode;
+    };
+    
+    inline bool inRange (uint32_t offset, uint32_t count, std::size_t total) {
+        return (uint64_t)offset + count <= total;
     }
     
-    SkeletonCache::SegmentData::~SegmentData () {
-        CC_SAFE_RELEASE_NULL(_texture);
+    std::string sanitizeFileName (const std::string& name) {
+        std::string result = name;
+        for (auto& c : result) {
+            bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_';
+            if (!valid) c = '_';
+        }
+        return result;
     }
     
-    void SkeletonCache::SegmentData::setTexture (cocos2d::middleware::Texture2D* value) {
-        CC_SAFE_RETAIN(value);
-        CC_SAFE_RELEASE(_texture);
-        _texture = value;
+    inline uint16_t quantizeUV (float value) {
+        return (uint16_t)(std::min(std::max(value, 0.0f), 1.0f) * 65535.0f + 0.5f);
     }
     
-    cocos2d::middleware::Texture2D* SkeletonCache::SegmentData::getTexture () const {
-        return _texture;
+    template <typename T>
+    inline void freeVector (std::vector<T>& vec) {
+        std::vector<T>().swap(vec);
     }
     
-    SkeletonCache::FrameData::FrameData () {
-        
+    template <typename T>
+    inline void shrinkVector (std::vector<T>& vec) {
+        if (vec.capacity() > vec.size()) {
+            std::vector<T>(vec.begin(), vec.end()).swap(vec);
+        }
     }
     
-    SkeletonCache::FrameData::~FrameData () {
-        for (std::size_t i = 0, c = _bones.size(); i < c; i++)
-        {
-            delete _bones[i];
+    // A private skeleton baking one animation in a worker thread, it's created and destroyed in the cocos thread.
+    // AnimationState::update and apply still allocate and free in the worker, e.g. growing the event queue
+    // and per timeline arrays, through the spine extension, see Cocos2dExtension::_free for what that relies on.
+    class BakeTask : public spine::AnimationStateListenerObject {
+    public:
+        BakeTask (spine::Skeleton* source) {
+            spine::SkeletonData* skeletonData = source->getData();
+            skeleton = new (__FILE__, __LINE__) spine::Skeleton(skeletonData);
+            skeleton->setSkin(source->getSkin());
+            auto& sourceSlots = source->getSlots();
+            auto& slots = skeleton->getSlots();
+            for (std::size_t i = 0, n = slots.size(); i < n; i++) {
+                slots[i]->setAttachment(sourceSlots[i]->getAttachment());
+            }
+            skeleton->getColor().set(source->getColor());
+            skeleton->setX(source->getX());
+            skeleton->setY(source->getY());
+            skeleton->setScaleX(source->getScaleX());
+            skeleton->setScaleY(source->getScaleY());
+            
+            state = new (__FILE__, __LINE__) spine::AnimationState(new (__FILE__, __LINE__) spine::AnimationStateData(skeletonData));
+            state->setListener(this);
+            clipper = new (__FILE__, __LINE__) spine::SkeletonClipping();
+            data = new spine::SkeletonCache::AnimationData();
         }
-        _bones.clear();
         
-        for (std::size_t i = 0, c = _colors.size(); i < c; i++) {
-            delete _colors[i];
+        virtual ~BakeTask () {
+            delete data;
+            delete clipper;
+            delete state->getData();
+            delete state;
+            delete skeleton;
         }
-        _colors.clear();
         
-        for (std::size_t i = 0, c = _segments.size(); i < c; i++) {
-            delete _segments[i];
+        virtual void callback (spine::AnimationState* state, spine::EventType type, spine::TrackEntry* entry, spine::Event* event) override {
+            if (type == spine::EventType_Complete) {
+                isComplete = true;
+            }
         }
-        _segments.clear();
-    }
+    public:
+        spine::Skeleton* skeleton = nullptr;
+        spine::AnimationState* state = nullptr;
+        spine::SkeletonClipping* clipper = nullptr;
+        spine::SkeletonCache::AnimationData* data = nullptr;
+        IOBuffer vb;
+        IOBuffer ib;
+        bool isComplete = false;
+    };
+}
+
+namespace spine {
     
-    SkeletonCache::BoneData* SkeletonCache::FrameData::buildBoneData(std::size_t index)
-    {
-        if (index > _bones.size()) return nullptr;
-        if (index == _bones.size()) {
-            BoneData* boneData = new BoneData;
-            _bones.push_back(boneData);
-        }
-        return _bones[index];
+    float SkeletonCache::FrameTime = 1.0f / 60.0f;
+    float SkeletonCache::MaxCacheTime = 120.0f;
+    bool SkeletonCache::BakeInBackground = true;
+    bool SkeletonCache::QuantizeVertices = false;
+    
+    void SkeletonCache::BoneData::toMat4 (cocos2d::Mat4& out) const {
+        out.setIdentity();
+        auto& matm = out.m;
+        matm[0] = a;
+        matm[1] = c;
+        matm[4] = b;
+        matm[5] = d;
+        matm[12] = worldX;
+        matm[13] = worldY;
     }
     
-    std::size_t SkeletonCache::FrameData::getBoneCount() const
-    {
-        return _bones.size();
+    const SkeletonCache::BoneData* SkeletonCache::FrameData::getBones () const {
+        auto& mapped = _animation->_mapped;
+        return (mapped.file ? mapped.bones : _animation->_bones.data()) + _boneOffset;
     }
-
     
-    SkeletonCache::ColorData* SkeletonCache::FrameData::buildColorData (std::size_t index) {
-        if (index > _colors.size()) return nullptr;
-        if (index == _colors.size()) {
-            ColorData* colorData = new ColorData;
-            _colors.push_back(colorData);
-        }
-        return _colors[index];
+    const SkeletonCache::ColorData* SkeletonCache::FrameData::getColors () const {
+        auto& mapped = _animation->_mapped;
+        return (mapped.file ? mapped.colors : _animation->_colors.data()) + _colorOffset;
     }
     
-    std::size_t SkeletonCache::FrameData::getColorCount () const {
-        return _colors.size();
+    const SkeletonCache::SegmentData* SkeletonCache::FrameData::getSegments () const {
+        return _animation->_segments.data() + _segmentOffset;
     }
     
-    SkeletonCache::SegmentData* SkeletonCache::FrameData::buildSegmentData (std::size_t index) {
-        if (index > _segments.size()) return nullptr;
-        if (index == _segments.size()) {
-            SegmentData* segmentData = new SegmentData;
-            _segments.push_back(segmentData);
-        }
-        return _segments[index];
+    const uint8_t* SkeletonCache::FrameData::getVertices () const {
+        auto& mapped = _animation->_mapped;
+        return (mapped.file ? mapped.vertices : _animation->_vertices.data()) + _vertexOffset * _animation->getVertexSize();
     }
     
-    std::size_t SkeletonCache::FrameData::getSegmentCount () const {
-        return _segments.size();
+    const unsigned short* SkeletonCache::FrameData::getIndices () const {
+        auto& mapped = _animation->_mapped;
+        return (mapped.file ? mapped.indices : _animation->_indices.data()) + _indexOffset;
     }
 
     SkeletonCache::AnimationData::AnimationData () {
-        
+        _isQuantized = QuantizeVertices;
     }
 
     SkeletonCache::AnimationData::~AnimationData () {
@@ -131,34 +227,140 @@ namespace spine {
     }
     
     void SkeletonCache::AnimationData::reset () {
-        for (std::size_t i = 0, c = _frames.size(); i < c; i++) {
-            delete _frames[i];
-        }
-        _frames.clear();
+        releaseTextures();
+        freeVector(_frames);
+        freeVector(_bones);
+        freeVector(_colors);
+        freeVector(_segments);
+        freeVector(_vertices);
+        freeVector(_indices);
+        _mapped = MappedStorage();
+        _diskCachePath = "";
+        _diskCacheHash = 0;
         _isComplete = false;
+        _isBaking = false;
+        _isQuantized = QuantizeVertices;
         _totalTime = 0.0f;
+        _version++;
     }
     
     bool SkeletonCache::AnimationData::needUpdate (int toFrameIdx) const {
         return !_isComplete && _totalTime <= MaxCacheTime && (toFrameIdx == -1 || _frames.size() < toFrameIdx + 1);
     }
     
-    SkeletonCache::FrameData* SkeletonCache::AnimationData::buildFrameData (std::size_t frameIdx) {
-        if (frameIdx > _frames.size()) {
-            return nullptr;
+    std::size_t SkeletonCache::AnimationData::getVertexSize () const {
+        return _isQuantized ? sizeof(QuantizedVertex) : sizeof(V2F_T2F_C4B_C4B);
+    }
+    
+    std::size_t SkeletonCache::AnimationData::getMemorySize () const {
+        return _frames.capacity() * sizeof(FrameData) +
+            _bones.capacity() * sizeof(BoneData) +
+            _colors.capacity() * sizeof(ColorData) +
+            _segments.capacity() * sizeof(SegmentData) +
+            _vertices.capacity() +
+            _indices.capacity() * sizeof(unsigned short);
+    }
+    
+    SkeletonCache::FrameData* SkeletonCache::AnimationData::beginFrame () {
+        _frames.emplace_back();
+        FrameData* frameData = &_frames.back();
+        frameData->_animation = this;
+        frameData->_boneOffset = (uint32_t)_bones.size();
+        frameData->_colorOffset = (uint32_t)_colors.size();
+        frameData->_segmentOffset = (uint32_t)_segments.size();
+        frameData->_vertexOffset = (uint32_t)(_vertices.size() / getVertexSize());
+        frameData->_indexOffset = (uint32_t)_indices.size();
+        return frameData;
+    }
+    
+    void SkeletonCache::AnimationData::endFrame (FrameData* frameData, const IOBuffer& vb, const IOBuffer& ib) {
+        frameData->_boneCount = (uint32_t)_bones.size() - frameData->_boneOffset;
+        frameData->_colorCount = (uint32_t)_colors.size() - frameData->_colorOffset;
+        frameData->_segmentCount = (uint32_t)_segments.size() - frameData->_segmentOffset;
+        
+        std::size_t vertexCount = vb.length() / sizeof(V2F_T2F_C4B_C4B);
+        const V2F_T2F_C4B_C4B* srcVertices = (const V2F_T2F_C4B_C4B*)vb.getBuffer();
+        if (_isQuantized) {
+            std::size_t pos = _vertices.size();
+            _vertices.resize(pos + vertexCount * sizeof(QuantizedVertex));
+            QuantizedVertex* dstVertices = (QuantizedVertex*)(_vertices.data() + pos);
+            for (std::size_t i = 0; i < vertexCount; i++) {
+                dstVertices[i].x = srcVertices[i].vertex.x;
+                dstVertices[i].y = srcVertices[i].vertex.y;
+                dstVertices[i].u = quantizeUV(srcVertices[i].texCoord.u);
+                dstVertices[i].v = quantizeUV(srcVertices[i].texCoord.v);
+            }
+        } else if (vertexCount > 0) {
+            _vertices.insert(_vertices.end(), (const uint8_t*)srcVertices, (const uint8_t*)(srcVertices + vertexCount));
+        }
+        frameData->_vertexCount = (uint32_t)vertexCount;
+        
+        std::size_t indexCount = ib.length() / sizeof(unsigned short);
+        if (indexCount > 0) {
+            const unsigned short* srcIndices = (const unsigned short*)ib.getBuffer();
+            _indices.insert(_indices.end(), srcIndices, srcIndices + indexCount);
+        }
+        frameData->_indexCount = (uint32_t)indexCount;
+    }
+    
+    void SkeletonCache::AnimationData::addTexture (cocos2d::middleware::Texture2D* texture) {
+        if (std::find(_textures.begin(), _textures.end(), texture) == _textures.end()) {
+            _textures.push_back(texture);
         }
-        if (frameIdx == _frames.size()) {
-            auto frameData = new FrameData();
-            _frames.push_back(frameData);
+    }
+    
+    void SkeletonCache::AnimationData::holdTextures () {
+        for (std::size_t n = _textures.size(); _heldTextureCount < n; _heldTextureCount++) {
+            CC_SAFE_RETAIN(_textures[_heldTextureCount]);
         }
-        return _frames[frameIdx];
     }
     
-    SkeletonCache::FrameData* SkeletonCache::AnimationData::getFrameData (std::size_t frameIdx) const {
+    void SkeletonCache::AnimationData::releaseTextures () {
+        for (std::size_t i = 0; i < _heldTextureCount; i++) {
+            CC_SAFE_RELEASE(_textures[i]);
+        }
+        _textures.clear();
+        _heldTextureCount = 0;
+    }
+    
+    void SkeletonCache::AnimationData::shrink () {
+        shrinkVector(_frames);
+        shrinkVector(_bones);
+        shrinkVector(_colors);
+        shrinkVector(_segments);
+        shrinkVector(_vertices);
+        shrinkVector(_indices);
+        for (auto& frameData : _frames) {
+            frameData._animation = this;
+        }
+    }
+    
+    void SkeletonCache::AnimationData::swap (AnimationData& other) {
+        std::swap(_isComplete, other._isComplete);
+        std::swap(_isQuantized, other._isQuantized);
+        std::swap(_totalTime, other._totalTime);
+        _frames.swap(other._frames);
+        _bones.swap(other._bones);
+        _colors.swap(other._colors);
+        _segments.swap(other._segments);
+        _vertices.swap(other._vertices);
+        _indices.swap(other._indices);
+        std::swap(_mapped, other._mapped);
+        _textures.swap(other._textures);
+        std::swap(_heldTextureCount, other._heldTextureCount);
+        for (auto& frameData : _frames) {
+            frameData._animation = this;
+        }
+        for (auto& frameData : other._frames) {
+            frameData._animation = &other;
+        }
+    }
+    
+    const SkeletonCache::FrameData* SkeletonCache::AnimationData::getFrameData (std::size_t frameIdx) const {
         if (frameIdx >= _frames.size()) {
             return nullptr;
         }
-        return _frames[frameIdx];
+        return &_frames[frameIdx];
     }
     
     std::size_t SkeletonCache::AnimationData::getFrameCount () const {
@@ -209,7 +411,85 @@ namespace spine {
         _skeleton->updateWorldTransform();
     }
     
+    bool SkeletonCache::bakeAsync (const std::string& animationName) {
+        if (!_skeleton) return false;
+        
+        AnimationData* animationData = getAnimationData(animationName);
+        if (!animationData || animationData->_isComplete) return false;
+        if (animationData->_isBaking) return true;
+        if (loadAnimationData(animationData) || !BakeInBackground) return false;
+        
+        animationData->_isBaking = true;
+        uint32_t version = animationData->_version;
+        
+        // the file is written by the worker, the texture table is copied since it's only compared by address
+        std::string diskCachePath = "";
+        uint64_t diskCacheHash = animationData->_diskCacheHash;
+        std::vector<middleware::Texture2D*> diskCacheTextures;
+        if (SkeletonCacheMgr::getInstance()->isDiskCacheSaveEnabled()) {
+            diskCachePath = animationData->_diskCachePath;
+            diskCacheTextures = getDiskCacheTextures();
+        }
+        
+        BakeTask* task = new BakeTask(_skeleton);
+        task->data->_animationName = animationName;
+        task->state->setAnimation(0, animationName.c_str(), false);
+        
+        // the first frame is baked here and published at once, so the animation holds on it instead of
+        // drawing nothing until the worker is done, it's baked into the task too which the result replaces
+        task->skeleton->update(FrameTime);
+        task->state->update(FrameTime);
+        task->state->apply(*task->skeleton);
+        task->skeleton->updateWorldTransform();
+        bakeFrame(animationData, task->skeleton, task->clipper, task->vb, task->ib);
+        animationData->_totalTime += FrameTime;
+        animationData->holdTextures();
+        bakeFrame(task->data, task->skeleton, task->clipper, task->vb, task->ib);
+        task->data->_totalTime += FrameTime;
+        
+        // keep the cache alive until the result is published, the bake of one animation is shared by all of its users
+        retain();
+        getBakeThreadPool()->pushTask([this, task, animationName, version, diskCachePath, diskCacheHash, diskCacheTextures](int /*tid*/) {
+            AnimationData* data = task->data;
+            while (!task->isComplete && data->_totalTime <= MaxCacheTime) {
+                task->skeleton->update(FrameTime);
+                task->state->update(FrameTime);
+                task->state->apply(*task->skeleton);
+                task->skeleton->updateWorldTransform();
+                bakeFrame(data, task->skeleton, task->clipper, task->vb, task->ib);
+                data->_totalTime += FrameTime;
+            }
+            
+            // an animation longer than MaxCacheTime is cut, so that it still loops
+            data->_isComplete = true;
+            data->shrink();
+            
+            if (!diskCachePath.empty()) {
+                BakedCacheWriter writer(DiskCacheMagic, DiskCacheVersion, diskCacheHash);
+                if (writeAnimationData(data, diskCacheTextures, writer)) {
+                    writer.save(diskCachePath);
+                }
+            }
+            
+            Application::getInstance()->getScheduler()->performFunctionInCocosThread([this, task, animationName, version]() {
+                AnimationData* animationData = getAnimationData(animationName);
+                if (animationData && animationData->_version == version) {
+                    animationData->swap(*task->data);
+                    animationData->holdTextures();
+                    animationData->_isBaking = false;
+                }
+                delete task;
+                release();
+            });
+        });
+        return true;
+    }
+    
     void SkeletonCache::updateToFrame (const std::string& animationName, int toFrameIdx/*= -1*/) {
+        if (bakeAsync(animationName)) {
+            return;
+        }
+        
         auto it = _animationCaches.find(animationName);
         if (it == _animationCaches.end()) {
             return;
@@ -235,16 +515,240 @@ namespace spine {
             renderAnimationFrame(animationData);
             animationData->_totalTime += FrameTime;
         } while (animationData->needUpdate(toFrameIdx));
+        
+        if (animationData->isComplete()) {
+            animationData->shrink();
+            saveAnimationData(animationData);
+        }
     }
     
-    void SkeletonCache::renderAnimationFrame (AnimationData* animationData) {
-        std::size_t frameIndex = animationData->getFrameCount();
-        FrameData* frameData = animationData->buildFrameData(frameIndex);
+    const std::vector<middleware::Texture2D*>& SkeletonCache::getDiskCacheTextures () {
+        if (_diskCacheTexturesReady || !_skeleton) return _diskCacheTextures;
+        _diskCacheTexturesReady = true;
         
-        if (!_skeleton) return;
+        // skins and their attachments keep the order of the skeleton data, so the table is stable between launches
+        auto& skins = _skeleton->getData()->getSkins();
+        for (std::size_t i = 0, n = skins.size(); i < n; i++) {
+            auto entries = skins[i]->getAttachments();
+            while (entries.hasNext()) {
+                Attachment* attachment = entries.next()._attachment;
+                AttachmentVertices* attachmentVertices = nullptr;
+                if (!attachment) continue;
+                if (attachment->getRTTI().isExactly(RegionAttachment::rtti)) {
+                    attachmentVertices = (AttachmentVertices*)((RegionAttachment*)attachment)->getRendererObject();
+                } else if (attachment->getRTTI().isExactly(MeshAttachment::rtti)) {
+                    attachmentVertices = (AttachmentVertices*)((MeshAttachment*)attachment)->getRendererObject();
+                }
+                if (!attachmentVertices || !attachmentVertices->_texture) continue;
+                
+                auto texture = attachmentVertices->_texture;
+                if (std::find(_diskCacheTextures.begin(), _diskCacheTextures.end(), texture) == _diskCacheTextures.end()) {
+                    _diskCacheTextures.push_back(texture);
+                }
+            }
+        }
+        return _diskCacheTextures;
+    }
+    
+    bool SkeletonCache::loadAnimationData (AnimationData* animationData) {
+        // a bake in the cocos thread may stop halfway, it's never replaced by the file
+        if (!_skeleton || animationData->_frames.size() > 0) return false;
+        animationData->_diskCachePath = "";
+        animationData->_diskCacheHash = 0;
+        
+        const std::string& dir = SkeletonCacheMgr::getInstance()->getDiskCachePath();
+        uint64_t contentHash = SkeletonDataMgr::getInstance()->getContentHash(_uuid);
+        if (dir.empty() || contentHash == 0) return false;
+        
+        // the frames depend on the pose the bake starts from and on the bake settings, as well as the skeleton data
+        uint64_t key = hashString(animationData->_animationName);
+        Skin* skin = _skeleton->getSkin();
+        key = hashString(skin ? skin->getName().buffer() : "", key);
+        auto& slots = _skeleton->getSlots();
+        for (std::size_t i = 0, n = slots.size(); i < n; i++) {
+            Attachment* attachment = slots[i]->getAttachment();
+            key = hashString(attachment ? attachment->getName().buffer() : "", key);
+        }
+        auto& color = _skeleton->getColor();
+        float params[] = {
+            color.r, color.g, color.b, color.a,
+            _skeleton->getX(), _skeleton->getY(), _skeleton->getScaleX(), _skeleton->getScaleY(),
+            FrameTime, MaxCacheTime, QuantizeVertices ? 1.0f : 0.0f
+        };
+        key = hashBytes(params, sizeof(params), key);
+        
+        char fileName[32] = {0};
+        snprintf(fileName, sizeof(fileName), "_%016llx.skc", (unsigned long long)key);
+        std::string path = dir;
+        if (path.back() != '/') path += '/';
+        animationData->_diskCachePath = path + sanitizeFileName(_uuid) + fileName;
+        animationData->_diskCacheHash = hashBytes(&key, sizeof(key), contentHash);
+        
+        auto file = BakedCacheFile::open(animationData->_diskCachePath, DiskCacheMagic, DiskCacheVersion, animationData->_diskCacheHash);
+        if (!file || file->getSectionCount() != SectionCount) return false;
+        
+        std::size_t count = 0;
+        const DiskCacheInfo* info = file->getArray<DiskCacheInfo>(SectionInfo, count);
+        if (!info || count != 1 || info->frameCount == 0) return false;
+        std::size_t vertexSize = info->quantized ? sizeof(QuantizedVertex) : sizeof(V2F_T2F_C4B_C4B);
+        if (info->boneSize != sizeof(BoneData) || info->colorSize != sizeof(ColorData) || info->vertexSize != vertexSize) return false;
+        
+        auto& textures = getDiskCacheTextures();
+        if (info->textureCount != textures.size()) return false;
+        
+        std::size_t frameCount = 0, segmentCount = 0, boneCount = 0, colorCount = 0, vertexBytes = 0, indexCount = 0;
+        auto frames = file->getArray<DiskFrameRecord>(SectionFrames, frameCount);
+        auto segments = file->getArray<DiskSegmentRecord>(SectionSegments, segmentCount);
+        auto bones = file->getArray<BoneData>(SectionBones, boneCount);
+        auto colors = file->getArray<ColorData>(SectionColors, colorCount);
+        auto vertices = file->getArray<uint8_t>(SectionVertices, vertexBytes);
+        auto indices = file->getArray<unsigned short>(SectionIndices, indexCount);
+        if (!frames || !segments || !bones || !colors || !vertices || !indices) return false;
+        if (frameCount != info->frameCount || vertexBytes % vertexSize != 0) return false;
+        std::size_t vertexCount = vertexBytes / vertexSize;
+        
+        // the renderer walks the frames without checks, so every range is validated once here
+        for (std::size_t i = 0; i < frameCount; i++) {
+            const DiskFrameRecord& frame = frames[i];
+            if (!inRange(frame.boneOffset, frame.boneCount, boneCount) ||
+                !inRange(frame.colorOffset, frame.colorCount, colorCount) ||
+                !inRange(frame.segmentOffset, frame.segmentCount, segmentCount) ||
+                !inRange(frame.vertexOffset, frame.vertexCount, vertexCount) ||
+                !inRange(frame.indexOffset, frame.indexCount, indexCount)) {
+                return false;
+            }
+            uint64_t segVertexCount = 0, segIndexCount = 0;
+            for (uint32_t j = frame.segmentOffset, m = frame.segmentOffset + frame.segmentCount; j < m; j++) {
+                const DiskSegmentRecord& segment = segments[j];
+                if (segment.textureIndex >= textures.size() || segment.indexCount < 0 || segment.vertexCount < 0) return false;
+                segVertexCount += segment.vertexCount;
+                segIndexCount += segment.indexCount;
+            }
+            if (segVertexCount != frame.vertexCount || segIndexCount != frame.indexCount) return false;
+        }
+        
+        // frames and segments are small and hold pointers, they are rebuilt, everything else stays in the file
+        animationData->_frames.resize(frameCount);
+        for (std::size_t i = 0; i < frameCount; i++) {
+            const DiskFrameRecord& src = frames[i];
+            FrameData& dst = animationData->_frames[i];
+            dst._animation = animationData;
+            dst._boneOffset = src.boneOffset;
+            dst._boneCount = src.boneCount;
+            dst._colorOffset = src.colorOffset;
+            dst._colorCount = src.colorCount;
+            dst._segmentOffset = src.segmentOffset;
+            dst._segmentCount = src.segmentCount;
+            dst._vertexOffset = src.vertexOffset;
+            dst._vertexCount = src.vertexCount;
+            dst._indexOffset = src.indexOffset;
+            dst._indexCount = src.indexCount;
+        }
+        
+        animationData->_segments.resize(segmentCount);
+        for (std::size_t i = 0; i < segmentCount; i++) {
+            const DiskSegmentRecord& src = segments[i];
+            SegmentData& dst = animationData->_segments[i];
+            dst.texture = textures[src.textureIndex];
+            dst.indexCount = src.indexCount;
+            dst.vertexCount = src.vertexCount;
+            dst.blendMode = src.blendMode;
+            animationData->addTexture(dst.texture);
+        }
+        
+        auto& mapped = animationData->_mapped;
+        mapped.file = file;
+        mapped.bones = bones;
+        mapped.colors = colors;
+        mapped.vertices = vertices;
+        mapped.indices = indices;
+        
+        animationData->_isQuantized = info->quantized != 0;
+        animationData->_totalTime = info->totalTime;
+        animationData->_isComplete = true;
+        animationData->holdTextures();
+        return true;
+    }
+    
+    void SkeletonCache::saveAnimationData (AnimationData* animationData) {
+        if (!SkeletonCacheMgr::getInstance()->isDiskCacheSaveEnabled() || animationData->_diskCachePath.empty()) return;
+        
+        // serialized here, the animation data may be reset before the worker runs
+        auto writer = std::make_shared<BakedCacheWriter>(DiskCacheMagic, DiskCacheVersion, animationData->_diskCacheHash);
+        if (!writeAnimationData(animationData, getDiskCacheTextures(), *writer)) return;
+        
+        std::string path = animationData->_diskCachePath;
+        getBakeThreadPool()->pushTask([writer, path](int /*tid*/) {
+            writer->save(path);
+        });
+    }
+    
+    bool SkeletonCache::writeAnimationData (const AnimationData* animationData, const std::vector<middleware::Texture2D*>& textures,
+                                            BakedCacheWriter& writer) {
+        if (!animationData->_isComplete || animationData->isMapped() || animationData->_frames.empty()) return false;
+        
+        std::vector<DiskSegmentRecord> segments(animationData->_segments.size());
+        for (std::size_t i = 0, n = segments.size(); i < n; i++) {
+            const SegmentData& src = animationData->_segments[i];
+            auto it = std::find(textures.begin(), textures.end(), src.texture);
+            // a texture outside of the skeleton data can not be found again on next launch
+            if (it == textures.end()) return false;
+            DiskSegmentRecord& dst = segments[i];
+            dst.textureIndex = (uint32_t)(it - textures.begin());
+            dst.indexCount = src.indexCount;
+            dst.vertexCount = src.vertexCount;
+            dst.blendMode = src.blendMode;
+        }
+        
+        std::vector<DiskFrameRecord> frames(animationData->_frames.size());
+        for (std::size_t i = 0, n = frames.size(); i < n; i++) {
+            const FrameData& src = animationData->_frames[i];
+            DiskFrameRecord& dst = frames[i];
+            dst.boneOffset = src._boneOffset;
+            dst.boneCount = src._boneCount;
+            dst.colorOffset = src._colorOffset;
+            dst.colorCount = src._colorCount;
+            dst.segmentOffset = src._segmentOffset;
+            dst.segmentCount = src._segmentCount;
+            dst.vertexOffset = src._vertexOffset;
+            dst.vertexCount = src._vertexCount;
+            dst.indexOffset = src._indexOffset;
+            dst.indexCount = src._indexCount;
+        }
+        
+        DiskCacheInfo info;
+        info.frameCount = (uint32_t)frames.size();
+        info.quantized = animationData->_isQuantized ? 1 : 0;
+        info.totalTime = animationData->_totalTime;
+        info.textureCount = (uint32_t)textures.size();
+        info.boneSize = sizeof(BoneData);
+        info.colorSize = sizeof(ColorData);
+        info.vertexSize = (uint32_t)animationData->getVertexSize();
+        
+        writer.addArray(&info, 1);
+        writer.addArray(frames.data(), frames.size());
+        writer.addArray(segments.data(), segments.size());
+        writer.addArray(animationData->_bones.data(), animationData->_bones.size());
+        writer.addArray(animationData->_colors.data(), animationData->_colors.size());
+        writer.addArray(animationData->_vertices.data(), animationData->_vertices.size());
+        writer.addArray(animationData->_indices.data(), animationData->_indices.size());
+        return true;
+    }
+    
+    void SkeletonCache::renderAnimationFrame (AnimationData* animationData) {
+        bakeFrame(animationData, _skeleton, _clipper, _bakeVB, _bakeIB);
+        animationData->holdTextures();
+    }
+    
+    void SkeletonCache::bakeFrame (AnimationData* animationData, Skeleton* skeleton, SkeletonClipping* clipper,
+                                   IOBuffer& vb, IOBuffer& ib) {
+        FrameData* frameData = animationData->beginFrame();
+        vb.reset();
+        ib.reset();
         
         // If opacity is 0,then return.
-        if (_skeleton->getColor().a == 0) {
+        if (!skeleton || skeleton->getColor().a == 0) {
+            animationData->endFrame(frameData, vb, ib);
             return;
         }
         
@@ -255,8 +759,9 @@ namespace spine {
         Color4F darkColor;
         
         AttachmentVertices* attachmentVertices = nullptr;
-        middleware::IOBuffer& vb = frameData->vb;
-        middleware::IOBuffer& ib = frameData->ib;
+        auto& bonesData = animationData->_bones;
+        auto& colorsData = animationData->_colors;
+        auto& segmentsData = animationData->_segments;
         
         // vertex size int bytes with two color
         int vbs2 = sizeof(V2F_T2F_C4B_C4B);
@@ -270,29 +775,27 @@ namespace spine {
         GLuint preTextureIndex = -1;
         GLuint curTextureIndex = -1;
         
-        int preISegWritePos = -1;
         int curISegLen = 0;
         int curVSegLen = 0;
         
-        int materialLen = 0;
         Slot* slot = nullptr;
         
         middleware::Texture2D* texture = nullptr;
         
         auto flush = [&]() {
             // fill pre segment count field
-            if (preISegWritePos != -1) {
-                SegmentData* preSegmentData = frameData->buildSegmentData(materialLen - 1);
-                preSegmentData->indexCount = curISegLen;
-                preSegmentData->vertexFloatCount = curVSegLen;
+            if (segmentsData.size() > frameData->_segmentOffset) {
+                SegmentData& preSegmentData = segmentsData.back();
+                preSegmentData.indexCount = curISegLen;
+                preSegmentData.vertexCount = curVSegLen;
             }
             
-            SegmentData* segmentData = frameData->buildSegmentData(materialLen);
-            segmentData->setTexture(texture);
-            segmentData->blendMode = slot->getData().getBlendMode();
+            segmentsData.emplace_back();
+            SegmentData& segmentData = segmentsData.back();
+            segmentData.texture = texture;
+            segmentData.blendMode = slot->getData().getBlendMode();
+            animationData->addTexture(texture);
             
-            // save new segment count pos field
-            preISegWritePos = (int)ib.getCurPos() / sizeof(unsigned short);
             // reset pre blend mode to current
             preBlendMode = (int)slot->getData().getBlendMode();
             // reset pre texture index to current
@@ -301,36 +804,33 @@ namespace spine {
             curISegLen = 0;
             // reset vertex segmentation count
             curVSegLen = 0;
-            // material length increased
-            materialLen++;
         };
         
-        auto& bones = _skeleton->getBones();
+        auto& bones = skeleton->getBones();
         for (std::size_t i = 0, n = bones.size(); i < n; i++) {
             auto& bone = bones[i];
-            auto boneCount = frameData->getBoneCount();
-            BoneData* boneData = frameData->buildBoneData(boneCount);
-            auto& matm = boneData->globalTransformMatrix.m;
-            matm[0] = bone->getA();
-            matm[1] = bone->getC();
-            matm[4] = bone->getB();
-            matm[5] = bone->getD();
-            matm[12] = bone->getWorldX();
-            matm[13] = bone->getWorldY();
-        }
-        
-        auto& drawOrder = _skeleton->getDrawOrder();
+            bonesData.emplace_back();
+            BoneData& boneData = bonesData.back();
+            boneData.a = bone->getA();
+            boneData.b = bone->getB();
+            boneData.c = bone->getC();
+            boneData.d = bone->getD();
+            boneData.worldX = bone->getWorldX();
+            boneData.worldY = bone->getWorldY();
+        }
+        
+        auto& drawOrder = skeleton->getDrawOrder();
         for (size_t i = 0, n = drawOrder.size(); i < n; ++i) {
             slot = drawOrder[i];
             
             if (!slot->getAttachment()) {
-                _clipper->clipEnd(*slot);
+                clipper->clipEnd(*slot);
                 continue;
             }
             
             // Early exit if slot is invisible
             if (slot->getColor().a == 0) {
-                _clipper->clipEnd(*slot);
+                clipper->clipEnd(*slot);
                 continue;
             }
             
@@ -342,7 +842,7 @@ namespace spine {
                 
                 // Early exit if attachment is invisible
                 if (attachment->getColor().a == 0) {
-                    _clipper->clipEnd(*slot);
+                    clipper->clipEnd(*slot);
                     continue;
                 }
                 
@@ -372,7 +872,7 @@ namespace spine {
                 
                 // Early exit if attachment is invisible
                 if (attachment->getColor().a == 0) {
-                    _clipper->clipEnd(*slot);
+                    clipper->clipEnd(*slot);
                     continue;
                 }
                 
@@ -398,23 +898,23 @@ namespace spine {
                 
             } else if (slot->getAttachment()->getRTTI().isExactly(ClippingAttachment::rtti)) {
                 ClippingAttachment* clip = (ClippingAttachment*)slot->getAttachment();
-                _clipper->clipStart(*slot, clip);
+                clipper->clipStart(*slot, clip);
                 continue;
             } else {
-                _clipper->clipEnd(*slot);
+                clipper->clipEnd(*slot);
                 continue;
             }
             
-            color.a = _skeleton->getColor().a * slot->getColor().a * color.a * 255;
+            color.a = skeleton->getColor().a * slot->getColor().a * color.a * 255;
             // skip rendering if the color of this attachment is 0
             if (color.a == 0) {
-                _clipper->clipEnd(*slot);
+                clipper->clipEnd(*slot);
                 continue;
             }
             
-            float red = _skeleton->getColor().r * color.r * 255;
-            float green = _skeleton->getColor().g * color.g * 255;
-            float blue = _skeleton->getColor().b * color.b * 255;
+            float red = skeleton->getColor().r * color.r * 255;
+            float green = skeleton->getColor().g * color.g * 255;
+            float blue = skeleton->getColor().b * color.b * 255;
             
             color.r = red * slot->getColor().r;
             color.g = green * slot->getColor().g;
@@ -434,38 +934,37 @@ namespace spine {
             if (preColor != color || preDarkColor != darkColor) {
                 preColor = color;
                 preDarkColor = darkColor;
-                auto colorCount = frameData->getColorCount();
-                if (colorCount > 0) {
-                    ColorData* preColorData = frameData->buildColorData(colorCount - 1);
-                    preColorData->vertexFloatOffset = (int) vb.getCurPos() / sizeof(float);
+                if (colorsData.size() > frameData->_colorOffset) {
+                    colorsData.back().vertexEnd = (int)(vb.getCurPos() / vbs2);
                 }
-                ColorData* colorData = frameData->buildColorData(colorCount);
-                colorData->finalColor = color;
-                colorData->darkColor = darkColor;
+                colorsData.emplace_back();
+                ColorData& colorData = colorsData.back();
+                colorData.finalColor = color;
+                colorData.darkColor = darkColor;
             }
             
             // Two color tint logic
-            if (_clipper->isClipping()) {
-                _clipper->clipTriangles((float*)&trianglesTwoColor.verts[0].vertex, trianglesTwoColor.indices, trianglesTwoColor.indexCount, (float*)&trianglesTwoColor.verts[0].texCoord, vs2);
+            if (clipper->isClipping()) {
+                clipper->clipTriangles((float*)&trianglesTwoColor.verts[0].vertex, trianglesTwoColor.indices, trianglesTwoColor.indexCount, (float*)&trianglesTwoColor.verts[0].texCoord, vs2);
                 
-                if (_clipper->getClippedTriangles().size() == 0) {
-                    _clipper->clipEnd(*slot);
+                if (clipper->getClippedTriangles().size() == 0) {
+                    clipper->clipEnd(*slot);
                     continue;
                 }
                 
-                trianglesTwoColor.vertCount = (int)_clipper->getClippedVertices().size() >> 1;
+                trianglesTwoColor.vertCount = (int)clipper->getClippedVertices().size() >> 1;
                 vbSize = trianglesTwoColor.vertCount * sizeof(V2F_T2F_C4B_C4B);
                 vb.checkSpace(vbSize, true);
                 trianglesTwoColor.verts = (V2F_T2F_C4B_C4B*)vb.getCurBuffer();
                 
-                trianglesTwoColor.indexCount = (int)_clipper->getClippedTriangles().size();
+                trianglesTwoColor.indexCount = (int)clipper->getClippedTriangles().size();
                 ibSize = trianglesTwoColor.indexCount * sizeof(unsigned short);
                 ib.checkSpace(ibSize, true);
                 trianglesTwoColor.indices = (unsigned short*)ib.getCurBuffer();
-                memcpy(trianglesTwoColor.indices, _clipper->getClippedTriangles().buffer(), sizeof(unsigned short) * _clipper->getClippedTriangles().size());
+                memcpy(trianglesTwoColor.indices, clipper->getClippedTriangles().buffer(), sizeof(unsigned short) * clipper->getClippedTriangles().size());
                 
-                float* verts = _clipper->getClippedVertices().buffer();
-                float* uvs = _clipper->getClippedUVs().buffer();
+                float* verts = clipper->getClippedVertices().buffer();
+                float* uvs = clipper->getClippedUVs().buffer();
                 
                 for (int v = 0, vn = trianglesTwoColor.vertCount, vv = 0; v < vn; ++v, vv += 2) {
                     V2F_T2F_C4B_C4B* vertex = trianglesTwoColor.verts + v;
@@ -504,7 +1003,7 @@ namespace spine {
             }
             
             if (vbSize > 0 && ibSize > 0) {
-                auto vertexOffset = curVSegLen / vs2;
+                auto vertexOffset = curVSegLen;
                 
                 if (vertexOffset > 0) {
                     unsigned short* ibBuffer = (unsigned short*)ib.getCurBuffer();
@@ -517,25 +1016,25 @@ namespace spine {
                 
                 // Record this turn index segmentation count,it will store in material buffer in the end.
                 curISegLen += ibSize / sizeof(unsigned short);
-                curVSegLen += vbSize / sizeof(float);
+                curVSegLen += vbSize / vbs2;
             }
             
-            _clipper->clipEnd(*slot);
+            clipper->clipEnd(*slot);
         } // End slot traverse
         
-        _clipper->clipEnd();
+        clipper->clipEnd();
         
-        if (preISegWritePos != -1) {
-            SegmentData* preSegmentData = frameData->buildSegmentData(materialLen - 1);
-            preSegmentData->indexCount = curISegLen;
-            preSegmentData->vertexFloatCount = curVSegLen;
+        if (segmentsData.size() > frameData->_segmentOffset) {
+            SegmentData& preSegmentData = segmentsData.back();
+            preSegmentData.indexCount = curISegLen;
+            preSegmentData.vertexCount = curVSegLen;
         }
         
-        auto colorCount = frameData->getColorCount();
-        if (colorCount > 0) {
-            ColorData* preColorData = frameData->buildColorData(colorCount - 1);
-            preColorData->vertexFloatOffset = (int) vb.getCurPos() / sizeof(float);
+        if (colorsData.size() > frameData->_colorOffset) {
+            colorsData.back().vertexEnd = (int)(vb.getCurPos() / vbs2);
         }
+        
+        animationData->endFrame(frameData, vb, ib);
     }
     
     void SkeletonCache::onAnimationStateEvent (TrackEntry* entry, EventType type, Event* event) {
@@ -31,95 +31,150 @@
 
 #include "SkeletonAnimation.h"
 #include "IOBuffer.h"
+#include "BakedCacheFile.h"
 #include "middleware-adapter.h"
 #include <vector>
+#include <memory>
 
 namespace spine {
     class SkeletonCache: public SkeletonAnimation {
     public:
         struct SegmentData {
-            friend class SkeletonCache;
-            
-            SegmentData ();
-            ~SegmentData ();
-            
-            void setTexture (cocos2d::middleware::Texture2D* value);
-            cocos2d::middleware::Texture2D* getTexture () const;
+            cocos2d::middleware::Texture2D* getTexture () const {
+                return texture;
+            }
         public:
+            // retained by the owner animation data
+            cocos2d::middleware::Texture2D* texture = nullptr;
             int indexCount = 0;
-            int vertexFloatCount = 0;
+            int vertexCount = 0;
             int blendMode = 0;
-        private:
-            cocos2d::middleware::Texture2D* _texture = nullptr;
         };
         
+        // only the 2D affine part of the bone world transform is cached
         struct BoneData {
-            cocos2d::Mat4 globalTransformMatrix;
+            void toMat4 (cocos2d::Mat4& out) const;
+        public:
+            float a = 1.0f;
+            float b = 0.0f;
+            float c = 0.0f;
+            float d = 1.0f;
+            float worldX = 0.0f;
+            float worldY = 0.0f;
         };
         
         struct ColorData {
             cocos2d::Color4F finalColor;
             cocos2d::Color4F darkColor;
-            int vertexFloatOffset = 0;
+            // the color is used until this vertex index, counted from the first vertex of the frame
+            int vertexEnd = 0;
+        };
+        
+        // quantized vertex, position keeps full precision, uv is stored as 16 bit unorm,
+        // colors are rebuilt from the color data of the frame
+        struct QuantizedVertex {
+            float x;
+            float y;
+            uint16_t u;
+            uint16_t v;
         };
         
+        struct AnimationData;
+        
+        // a view of one frame inside the storage of its animation data
         struct FrameData {
             friend class SkeletonCache;
             
-            FrameData ();
-            ~FrameData ();
+            const BoneData* getBones () const;
+            std::size_t getBoneCount () const { return _boneCount; }
             
-            const std::vector<BoneData*>& getBones() const
-            {
-                return _bones;
-            }
-            std::size_t getBoneCount() const;
+            const ColorData* getColors () const;
+            std::size_t getColorCount () const { return _colorCount; }
             
-            const std::vector<ColorData*>& getColors () const {
-                return _colors;
-            }
-            std::size_t getColorCount () const;
+            const SegmentData* getSegments () const;
+            std::size_t getSegmentCount () const { return _segmentCount; }
             
-            const std::vector<SegmentData*>& getSegments () const {
-                return _segments;
-            }
-            std::size_t getSegmentCount () const;
-        private:
-            // if segment data is empty, it will build new one.
-            SegmentData* buildSegmentData (std::size_t index);
-            // if color data is empty, it will build new one.
-            ColorData* buildColorData (std::size_t index);
-            // if bone data is empty, it will build new one.
-            BoneData* buildBoneData(std::size_t index);
+            // vertices are V2F_T2F_C4B_C4B, or QuantizedVertex if the animation data is quantized
+            const uint8_t* getVertices () const;
+            std::size_t getVertexCount () const { return _vertexCount; }
             
-            std::vector<BoneData*> _bones;
-            std::vector<ColorData*> _colors;
-            std::vector<SegmentData*> _segments;
-        public:
-            cocos2d::middleware::IOBuffer ib;
-            cocos2d::middleware::IOBuffer vb;
+            // indices are relative to the first vertex of their segment
+            const unsigned short* getIndices () const;
+            std::size_t getIndexCount () const { return _indexCount; }
+        private:
+            const AnimationData* _animation = nullptr;
+            uint32_t _boneOffset = 0;
+            uint32_t _boneCount = 0;
+            uint32_t _colorOffset = 0;
+            uint32_t _colorCount = 0;
+            uint32_t _segmentOffset = 0;
+            uint32_t _segmentCount = 0;
+            uint32_t _vertexOffset = 0;
+            uint32_t _vertexCount = 0;
+            uint32_t _indexOffset = 0;
+            uint32_t _indexCount = 0;
         };
         
+        // all frames of an animation share one storage for each kind of data
         struct AnimationData {
             friend class SkeletonCache;
+            friend struct FrameData;
             
             AnimationData ();
             ~AnimationData ();
             void reset ();
             
-            FrameData* getFrameData (std::size_t frameIdx) const;
+            const FrameData* getFrameData (std::size_t frameIdx) const;
             std::size_t getFrameCount () const;
             
             bool isComplete () const { return _isComplete; }
+            bool isBaking () const { return _isBaking; }
+            bool isQuantized () const { return _isQuantized; }
             bool needUpdate (int toFrameIdx) const;
+            // vertex size in bytes
+            std::size_t getVertexSize () const;
+            // baked bytes, without the frame independent overhead
+            std::size_t getMemorySize () const;
         private:
-            // if frame is empty, it will build new one.
-            FrameData* buildFrameData (std::size_t frameIdx);
+            FrameData* beginFrame ();
+            void endFrame (FrameData* frameData, const cocos2d::middleware::IOBuffer& vb, const cocos2d::middleware::IOBuffer& ib);
+            void addTexture (cocos2d::middleware::Texture2D* texture);
+            // retains the textures added since last call, it must run in the cocos thread
+            void holdTextures ();
+            void releaseTextures ();
+            void shrink ();
+            void swap (AnimationData& other);
+            bool isMapped () const { return _mapped.file != nullptr; }
         private:
             std::string _animationName = "";
             bool _isComplete = false;
+            bool _isBaking = false;
+            bool _isQuantized = false;
+            // increased by reset, a background bake of an older version is dropped
+            uint32_t _version = 0;
             float _totalTime = 0.0f;
-            std::vector<FrameData*> _frames;
+            std::vector<FrameData> _frames;
+            std::vector<BoneData> _bones;
+            std::vector<ColorData> _colors;
+            std::vector<SegmentData> _segments;
+            std::vector<uint8_t> _vertices;
+            std::vector<unsigned short> _indices;
+            std::vector<cocos2d::middleware::Texture2D*> _textures;
+            std::size_t _heldTextureCount = 0;
+            
+            // bones, colors, vertices and indices loaded from a baked cache file are used in place,
+            // the vectors above stay empty while the file is mapped
+            struct MappedStorage {
+                std::shared_ptr<cocos2d::middleware::BakedCacheFile> file;
+                const BoneData* bones = nullptr;
+                const ColorData* colors = nullptr;
+                const uint8_t* vertices = nullptr;
+                const unsigned short* indices = nullptr;
+            };
+            MappedStorage _mapped;
+            // baked cache file of the current bake, empty if disk cache is disabled
+            std::string _diskCachePath = "";
+            uint64_t _diskCacheHash = 0;
         };
         
         SkeletonCache ();
@@ -132,6 +187,9 @@ namespace spine {
         virtual void onAnimationStateEvent (TrackEntry* entry, EventType type, Event* event) override;
         
         void updateToFrame (const std::string& animationName, int toFrameIdx = -1);
+        // Starts to bake the whole animation in a worker thread if BakeInBackground is true,
+        // returns true while the animation is baking.
+        bool bakeAsync (const std::string& animationName);
         // if animation data is empty, it will build new one.
         AnimationData* buildAnimationData (const std::string& animationName);
         AnimationData* getAnimationData (const std::string& animationName);
@@ -139,11 +197,29 @@ namespace spine {
         void resetAnimationData(const std::string& animationName);
     private:
         void renderAnimationFrame (AnimationData* animationData);
+        // chooses the baked cache file of the animation data, and loads it if it exists
+        bool loadAnimationData (AnimationData* animationData);
+        void saveAnimationData (AnimationData* animationData);
+        const std::vector<cocos2d::middleware::Texture2D*>& getDiskCacheTextures ();
+        static bool writeAnimationData (const AnimationData* animationData, const std::vector<cocos2d::middleware::Texture2D*>& textures,
+                                        cocos2d::middleware::BakedCacheWriter& writer);
+        static void bakeFrame (AnimationData* animationData, Skeleton* skeleton, SkeletonClipping* clipper,
+                               cocos2d::middleware::IOBuffer& vb, cocos2d::middleware::IOBuffer& ib);
     public:
         static float FrameTime;
         static float MaxCacheTime;
+        // bake animations in a worker thread, the animation holds on its first frame until all frames are ready
+        static bool BakeInBackground;
+        // store vertices as QuantizedVertex, it halves the vertex memory
+        static bool QuantizeVertices;
     private:
         std::string _curAnimationName = "";
         std::map<std::string, AnimationData*> _animationCaches;
+        // scratch buffers of the frame being baked in the cocos thread
+        cocos2d::middleware::IOBuffer _bakeVB;
+        cocos2d::middleware::IOBuffer _bakeIB;
+        // all textures the skeleton data refers to, baked cache files store indices into it
+        std::vector<cocos2d::middleware::Texture2D*> _diskCacheTextures;
+        bool _diskCacheTexturesReady = false;
     };
 }
@@ -106,6 +106,11 @@ namespace spine {
         
         if (!_animationData) return;
         
+        // the frames are baked in background, the animation holds on the first frame until they are ready
+        if (!_animationData->isComplete() && _skeletonCache->bakeAsync(_animationName)) {
+            return;
+        }
+        
         if (_accTime <= 0.00001 && _playCount == 0) {
             if (_startListener) {
                 _startListener(_animationName);
@@ -153,12 +158,14 @@ namespace spine {
         assembler->setUseModel(!_batch);
         
         if (!_animationData) return;
-        SkeletonCache::FrameData* frameData = _animationData->getFrameData(_curFrameIndex);
+        const SkeletonCache::FrameData* frameData = _animationData->getFrameData(_curFrameIndex);
         if (!frameData) return;
         
-        auto& segments = frameData->getSegments();
-        auto& colors = frameData->getColors();
-        if (segments.size() == 0 || colors.size() == 0) return;
+        auto segments = frameData->getSegments();
+        auto segLen = frameData->getSegmentCount();
+        auto colors = frameData->getColors();
+        auto colorLen = frameData->getColorCount();
+        if (segLen == 0 || colorLen == 0) return;
         
         auto mgr = MiddlewareManager::getInstance();
         if (!mgr->isRendering) return;
@@ -169,8 +176,10 @@ namespace spine {
         middleware::MeshBuffer* mb = mgr->getMeshBuffer(vertexFormat);
         middleware::IOBuffer& vb = mb->getVB();
         middleware::IOBuffer& ib = mb->getIB();
-        const auto& srcVB = frameData->vb;
-        const auto& srcIB = frameData->ib;
+        const uint8_t* srcVB = frameData->getVertices();
+        const unsigned short* srcIB = frameData->getIndices();
+        bool isQuantized = _animationData->isQuantized();
+        const float uvScale = 1.0f / 65535.0f;
         
         // vertex size int bytes with one color
         int vbs1 = sizeof(V2F_T2F_C4B);
@@ -186,20 +195,18 @@ namespace spine {
         
         const cocos2d::Mat4& nodeWorldMat = _nodeProxy->getWorldMatrix();
 
-        int colorOffset = 0;
-        SkeletonCache::ColorData* nowColor = colors[colorOffset++];
-        auto maxVFOffset = nowColor->vertexFloatOffset;
+        std::size_t colorOffset = 0;
+        const SkeletonCache::ColorData* nowColor = &colors[colorOffset++];
+        auto maxVertexIndex = nowColor->vertexEnd;
         
         Color4B finalColor;
         Color4B darkColor;
         float tempR = 0.0f, tempG = 0.0f, tempB = 0.0f, tempA = 0.0f;
         float multiplier = 1.0f;
-        int srcVertexBytesOffset = 0;
-        int srcVertexBytes = 0;
+        int srcVertexIndex = 0;
         int vertexBytes = 0;
         int vertexFloats = 0;
-        int tintBytes = 0;
-        int srcIndexBytesOffset = 0;
+        int srcIndexOffset = 0;
         int indexBytes = 0;
         GLuint textureHandle = 0;
         double effectHash = 0;
@@ -220,7 +227,7 @@ namespace spine {
             needColor = true;
         }
         
-        auto handleColor = [&](SkeletonCache::ColorData* colorData){
+        auto handleColor = [&](const SkeletonCache::ColorData* colorData){
             tempA = colorData->finalColor.a * _nodeColor.a;
             multiplier = _premultipliedAlpha ? tempA / 255 : 1;
             tempR = _nodeColor.r * multiplier;
@@ -240,30 +247,48 @@ namespace spine {
         
         handleColor(nowColor);
         
-        for (std::size_t segIndex = 0, segLen = segments.size(); segIndex < segLen; segIndex++) {
-            auto segment = segments[segIndex];
-            srcVertexBytes = segment->vertexFloatCount * sizeof(float);
-            if (!_useTint) {
-                tintBytes = segment->vertexFloatCount / vs2 * sizeof(float);
-                vertexBytes = srcVertexBytes - tintBytes;
-                vertexFloats = vertexBytes / sizeof(float);
-            } else {
-                vertexBytes = srcVertexBytes;
-                vertexFloats = segment->vertexFloatCount;
+        // color runs are sorted by vertex, moves to the run of the vertex
+        auto seekColor = [&](int vertexIndex){
+            while (vertexIndex >= maxVertexIndex && colorOffset < colorLen) {
+                nowColor = &colors[colorOffset++];
+                handleColor(nowColor);
+                maxVertexIndex = nowColor->vertexEnd;
             }
+        };
+        
+        for (std::size_t segIndex = 0; segIndex < segLen; segIndex++) {
+            auto segment = &segments[segIndex];
+            vertexBytes = segment->vertexCount * vbs;
+            vertexFloats = segment->vertexCount * vs;
 
             // fill vertex buffer
             vb.checkSpace(vertexBytes, true);
             dstVertexOffset = (int)vb.getCurPos() / vbs;
             dstVertexBuffer = (float*)vb.getCurBuffer();
             dstColorBuffer = (unsigned int*)vb.getCurBuffer();
-            if (!_useTint) {
-                char* srcBuffer = (char*)srcVB.getBuffer() + srcVertexBytesOffset;
-                for (std::size_t srcBufferIdx = 0; srcBufferIdx < srcVertexBytes; srcBufferIdx += vbs2) {
+            if (isQuantized) {
+                // quantized vertices carry no color, they always take the color of their run
+                const SkeletonCache::QuantizedVertex* srcVertex = (const SkeletonCache::QuantizedVertex*)srcVB + srcVertexIndex;
+                for (auto vertexIndex = 0; vertexIndex < segment->vertexCount; vertexIndex++) {
+                    seekColor(srcVertexIndex + vertexIndex);
+                    float* dstVertex = dstVertexBuffer + vertexIndex * vs;
+                    dstVertex[0] = srcVertex[vertexIndex].x;
+                    dstVertex[1] = srcVertex[vertexIndex].y;
+                    dstVertex[2] = srcVertex[vertexIndex].u * uvScale;
+                    dstVertex[3] = srcVertex[vertexIndex].v * uvScale;
+                    memcpy(dstVertex + 4, &finalColor, sizeof(finalColor));
+                    if (_useTint) {
+                        memcpy(dstVertex + 5, &darkColor, sizeof(darkColor));
+                    }
+                }
+                vb.move(vertexBytes);
+            } else if (!_useTint) {
+                const char* srcBuffer = (const char*)srcVB + srcVertexIndex * vbs2;
+                for (std::size_t srcBufferIdx = 0, srcBytes = segment->vertexCount * vbs2; srcBufferIdx < srcBytes; srcBufferIdx += vbs2) {
                     vb.writeBytes(srcBuffer + srcBufferIdx, vbs);
                 }
             } else {
-                vb.writeBytes((char*)srcVB.getBuffer() + srcVertexBytesOffset, vertexBytes);
+                vb.writeBytes((const char*)srcVB + srcVertexIndex * vbs2, vertexBytes);
             }
             
             // batch handle
@@ -281,45 +306,37 @@ namespace spine {
             }
             
             // handle vertex color
-            if (needColor) {
-                int srcVertexFloatOffset = srcVertexBytesOffset / sizeof(float);
+            if (needColor && !isQuantized) {
+                int vertexIndex = srcVertexIndex;
                 if (_useTint) {
-                    for (auto colorIndex = 0; colorIndex < vertexFloats; colorIndex += vs, srcVertexFloatOffset += vs2)
+                    for (auto colorIndex = 0; colorIndex < vertexFloats; colorIndex += vs, vertexIndex++)
                     {
-                        if (srcVertexFloatOffset >= maxVFOffset) {
-                            nowColor = colors[colorOffset++];
-                            handleColor(nowColor);
-                            maxVFOffset = nowColor->vertexFloatOffset;
-                        }
+                        seekColor(vertexIndex);
                         memcpy(dstColorBuffer + colorIndex + 4, &finalColor, sizeof(finalColor));
                         memcpy(dstColorBuffer + colorIndex + 5, &darkColor, sizeof(darkColor));
                     }
                 } else {
-                    for (auto colorIndex = 0; colorIndex < vertexFloats; colorIndex += vs, srcVertexFloatOffset += vs2)
+                    for (auto colorIndex = 0; colorIndex < vertexFloats; colorIndex += vs, vertexIndex++)
                     {
-                        if (srcVertexFloatOffset >= maxVFOffset) {
-                            nowColor = colors[colorOffset++];
-                            handleColor(nowColor);
-                            maxVFOffset = nowColor->vertexFloatOffset;
-                        }
+                        seekColor(vertexIndex);
                         memcpy(dstColorBuffer + colorIndex + 4, &finalColor, sizeof(finalColor));
                     }
                 }
             }
             
-            // move src vertex buffer offset
-            srcVertexBytesOffset += srcVertexBytes;
+            // move src vertex offset
+            srcVertexIndex += segment->vertexCount;
             
             // fill index buffer
             indexBytes = segment->indexCount * sizeof(unsigned short);
             ib.checkSpace(indexBytes, true);
             assembler->updateIARange(segIndex, (int)ib.getCurPos() / sizeof(unsigned short), segment->indexCount);
             dstIndexBuffer = (unsigned short*)ib.getCurBuffer();
-            ib.writeBytes((char*)srcIB.getBuffer() + srcIndexBytesOffset, indexBytes);
+            ib.writeBytes((const char*)(srcIB + srcIndexOffset), indexBytes);
             for (auto indexPos = 0; indexPos < segment->indexCount; indexPos ++) {
                 dstIndexBuffer[indexPos] += dstVertexOffset;
             }
-            srcIndexBytesOffset += indexBytes;
+            srcIndexOffset += segment->indexCount;
             
             // set assembler glvb and glib
             assembler->updateIABuffer(segIndex, mb->getGLVB(), mb->getGLIB());
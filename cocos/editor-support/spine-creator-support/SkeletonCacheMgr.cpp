@@ -28,6 +28,7 @@
  *****************************************************************************/
 
 #include "SkeletonCacheMgr.h"
+#include "platform/CCFileUtils.h"
 
 namespace spine {
     SkeletonCacheMgr* SkeletonCacheMgr::_instance = nullptr;
@@ -48,4 +49,12 @@ namespace spine {
             _caches.erase(it);
         }
     }
+    
+    void SkeletonCacheMgr::setDiskCachePath (const std::string& path) {
+        _diskCachePath = path;
+        // a relative path may point into the packed resources, which are read only
+        if (!path.empty() && path[0] == '/') {
+            cocos2d::FileUtils::getInstance()->createDirectory(path);
+        }
+    }
 }
@@ -51,9 +51,19 @@ public:
     
     void removeSkeletonCache (const std::string& uuid);
     SkeletonCache* buildSkeletonCache (const std::string& uuid);
+    
+    // Baked animations are loaded from this directory instead of being baked again,
+    // empty path disables the disk cache.
+    void setDiskCachePath (const std::string& path);
+    const std::string& getDiskCachePath () const { return _diskCachePath; }
+    // Writes every animation baked at runtime to the disk cache path, it can also be used to generate the files at build time.
+    void setDiskCacheSaveEnabled (bool enabled) { _diskCacheSaveEnabled = enabled; }
+    bool isDiskCacheSaveEnabled () const { return _diskCacheSaveEnabled; }
 private:
     static SkeletonCacheMgr* _instance;
     cocos2d::Map<std::string, SkeletonCache*> _caches;
+    std::string _diskCachePath = "";
+    bool _diskCacheSaveEnabled = false;
 };
 
 }
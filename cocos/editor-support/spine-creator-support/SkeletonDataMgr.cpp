@@ -60,6 +60,7 @@ public:
     Atlas *atlas = nullptr;
     AttachmentLoader *attachmentLoader = nullptr;
     std::vector<int> texturesIndex;
+    uint64_t contentHash = 0;
 };
 
 } // namespace spine
@@ -71,7 +72,7 @@ bool SkeletonDataMgr::hasSkeletonData (const std::string& uuid) {
     return it != _dataMap.end();
 }
 
-void SkeletonDataMgr::setSkeletonData (const std::string& uuid, SkeletonData* data, Atlas* atlas, AttachmentLoader* attachmentLoader, const std::vector<int>& texturesIndex) {
+void SkeletonDataMgr::setSkeletonData (const std::string& uuid, SkeletonData* data, Atlas* atlas, AttachmentLoader* attachmentLoader, const std::vector<int>& texturesIndex, uint64_t contentHash) {
     auto it = _dataMap.find(uuid);
     if (it != _dataMap.end()) {
         releaseByUUID(uuid);
@@ -81,9 +82,18 @@ void SkeletonDataMgr::setSkeletonData (const std::string& uuid, SkeletonData* da
     info->atlas = atlas;
     info->attachmentLoader = attachmentLoader;
     info->texturesIndex = texturesIndex;
+    info->contentHash = contentHash;
     _dataMap[uuid] = info;
 }
 
+uint64_t SkeletonDataMgr::getContentHash (const std::string& uuid) {
+    auto dataIt = _dataMap.find(uuid);
+    if (dataIt == _dataMap.end()) {
+        return 0;
+    }
+    return dataIt->second->contentHash;
+}
+
 SkeletonData* SkeletonDataMgr::retainByUUID (const std::string& uuid) {
     auto dataIt = _dataMap.find(uuid);
     if (dataIt == _dataMap.end()) {
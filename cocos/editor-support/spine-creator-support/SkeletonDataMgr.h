@@ -63,7 +63,9 @@ public:
     SkeletonDataMgr () {}
     virtual ~SkeletonDataMgr () {}
     bool hasSkeletonData (const std::string& uuid);
-    void setSkeletonData (const std::string& uuid, SkeletonData* data, Atlas* atlas, AttachmentLoader* attachmentLoader, const std::vector<int>& texturesIndex);
+    // contentHash identifies the source data of the skeleton, 0 disables the baked caches on disk
+    void setSkeletonData (const std::string& uuid, SkeletonData* data, Atlas* atlas, AttachmentLoader* attachmentLoader, const std::vector<int>& texturesIndex, uint64_t contentHash = 0);
+    uint64_t getContentHash (const std::string& uuid);
     SkeletonData* retainByUUID (const std::string& uuid);
     void releaseByUUID (const std::string& uuid);
     
@@ -146,7 +146,7 @@ void Cocos2dTextureLoader::unload(void* texture) {
     }
 }
 
-Cocos2dExtension::Cocos2dExtension() : DefaultSpineExtension() { }
+Cocos2dExtension::Cocos2dExtension() : DefaultSpineExtension(), _threadId(std::this_thread::get_id()) { }
     
 Cocos2dExtension::~Cocos2dExtension() { }
 
@@ -165,7 +165,16 @@ SpineExtension *spine::getDefaultExtension () {
     return new Cocos2dExtension();
 }
 
+// Spine memory may be allocated and freed off the cocos thread: SkeletonCache bakes animations in worker
+// threads with private skeletons and animation states, and their update and apply allocate through this
+// extension. That's safe as long as
+// - the default allocator stays thread safe, it's malloc, realloc and free;
+// - a worker only touches the spine objects of its own bake task, skeleton data is only read;
+// - script objects are only bound to spine objects created in the cocos thread, so the dispose callback,
+//   which calls into the script engine, is skipped for memory freed by any other thread.
 void Cocos2dExtension::_free(void *mem, const char *file, int line) {
-    _spineObjectDisposeCallback(mem);
+    if (std::this_thread::get_id() == _threadId) {
+        _spineObjectDisposeCallback(mem);
+    }
     DefaultSpineExtension::_free(mem, file, line);
 }
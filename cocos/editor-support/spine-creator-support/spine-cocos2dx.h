@@ -37,6 +37,7 @@
 #include "spine-creator-support/SkeletonCacheAnimation.h"
 #include "spine-creator-support/AttachUtil.h"
 #include "middleware-adapter.h"
+#include <thread>
 
 namespace spine {
     typedef cocos2d::middleware::Texture2D* (*CustomTextureLoader)(const char* path);
@@ -70,6 +71,9 @@ namespace spine {
         virtual void _free(void *mem, const char *file, int line);
     protected:
         virtual char *_readFile(const String &path, int *length);
+    private:
+        // spine objects are only bound to script objects in this thread, others may allocate and free too
+        std::thread::id _threadId;
     };
     
     typedef void (*SpineObjectDisposeCallback)(void*);
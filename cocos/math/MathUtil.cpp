@@ -60,6 +60,9 @@ This file was modified to fit the cocos2d-x project
 #define INCLUDE_SSE
 #endif
 
+// scalar code is included first, simd code falls back to it for the remainders of batches
+#include "math/MathUtil.inl"
+
 #ifdef INCLUDE_NEON32
 #include "math/MathUtilNeon.inl"
 #endif
@@ -72,8 +75,6 @@ This file was modified to fit the cocos2d-x project
 #include "math/MathUtilSSE.inl"
 #endif
 
-#include "math/MathUtil.inl"
-
 NS_CC_MATH_BEGIN
 
 void MathUtil::smooth(float* x, float target, float elapsedTime, float responseTime)
@@ -277,6 +278,70 @@ void MathUtil::crossVec3(const float* v1, const float* v2, float* dst)
 #endif
 }
 
+void MathUtil::composeTRSBatch(const float* trs, const uint8_t* is3D, const uint32_t* indices, size_t count, float* dst)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::composeTRSBatch(trs, is3D, indices, count, dst);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::composeTRSBatch(trs, is3D, indices, count, dst);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::composeTRSBatch(trs, is3D, indices, count, dst);
+    else MathUtilC::composeTRSBatch(trs, is3D, indices, count, dst);
+#elif defined (USE_SSE)
+    MathUtilSSE::composeTRSBatch(trs, is3D, indices, count, dst);
+#else
+    MathUtilC::composeTRSBatch(trs, is3D, indices, count, dst);
+#endif
+}
+
+void MathUtil::transformVertices2D(const float* m, float* vertices, size_t stride, size_t count)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::transformVertices2D(m, vertices, stride, count);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformVertices2D(m, vertices, stride, count);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformVertices2D(m, vertices, stride, count);
+    else MathUtilC::transformVertices2D(m, vertices, stride, count);
+#elif defined (USE_SSE)
+    MathUtilSSE::transformVertices2D(m, vertices, stride, count);
+#else
+    MathUtilC::transformVertices2D(m, vertices, stride, count);
+#endif
+}
+
+void MathUtil::transformVertices3D(const float* m, float* vertices, size_t stride, size_t count)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::transformVertices3D(m, vertices, stride, count);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformVertices3D(m, vertices, stride, count);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformVertices3D(m, vertices, stride, count);
+    else MathUtilC::transformVertices3D(m, vertices, stride, count);
+#elif defined (USE_SSE)
+    MathUtilSSE::transformVertices3D(m, vertices, stride, count);
+#else
+    MathUtilC::transformVertices3D(m, vertices, stride, count);
+#endif
+}
+
+void MathUtil::offsetIndices(const uint16_t* src, size_t count, uint16_t offset, uint16_t* dst)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::offsetIndices(src, count, offset, dst);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::offsetIndices(src, count, offset, dst);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::offsetIndices(src, count, offset, dst);
+    else MathUtilC::offsetIndices(src, count, offset, dst);
+#elif defined (USE_SSE)
+    MathUtilSSE::offsetIndices(src, count, offset, dst);
+#else
+    MathUtilC::offsetIndices(src, count, offset, dst);
+#endif
+}
+
 void MathUtil::combineHash(size_t& seed, const size_t& v)
 {
     seed ^= v + 0x9e3779b9 + (seed<<6) + (seed>>2);
@@ -96,6 +96,55 @@ public:
      * @param v
      */
     static void combineHash(size_t& seed, const size_t& v);
+
+    /**
+     * Composes a batch of matrices as translate * rotate * scale.
+     *
+     * Every element of trs holds 10 floats: position xyz, rotation quaternion xyzw and scale xyz,
+     * every element of dst holds a column major 4x4 matrix. Only the elements listed in indices
+     * are composed. When is3D of an element is 0, position z is treated as 0 and scale z as 1.
+     *
+     * @param trs the translation, rotation and scale array.
+     * @param is3D the 3D flag array.
+     * @param indices the indices of elements to compose.
+     * @param count the count of indices.
+     * @param dst the matrix array.
+     */
+    static void composeTRSBatch(const float* trs, const uint8_t* is3D, const uint32_t* indices, size_t count, float* dst);
+
+    /**
+     * Transforms the xy positions of a batch of vertices by m in place, z is treated as 0 and w as 1.
+     *
+     * Only the first two floats of every vertex are written, so a third attribute float
+     * following the position is left untouched.
+     *
+     * @param m the column major 4x4 matrix.
+     * @param vertices the position of the first vertex.
+     * @param stride the float count between two vertices.
+     * @param count the vertex count.
+     */
+    static void transformVertices2D(const float* m, float* vertices, size_t stride, size_t count);
+
+    /**
+     * Transforms the xyz positions of a batch of vertices by m in place, w is treated as 1 and the
+     * result is divided by its w when it isn't 0, the same as Vec3::transformMat4.
+     *
+     * @param m the column major 4x4 matrix.
+     * @param vertices the position of the first vertex.
+     * @param stride the float count between two vertices.
+     * @param count the vertex count.
+     */
+    static void transformVertices3D(const float* m, float* vertices, size_t stride, size_t count);
+
+    /**
+     * Copies a batch of indices and adds offset to every one of them.
+     *
+     * @param src the source indices.
+     * @param count the index count.
+     * @param offset the value added to every index.
+     * @param dst the destination indices.
+     */
+    static void offsetIndices(const uint16_t* src, size_t count, uint16_t offset, uint16_t* dst);
 private:
     //Indicates that if neon is enabled
     static bool isNeon32Enabled();
@@ -42,6 +42,14 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+    
+    inline static void composeTRSBatch(const float* trs, const uint8_t* is3D, const uint32_t* indices, size_t count, float* dst);
+    
+    inline static void transformVertices2D(const float* m, float* vertices, size_t stride, size_t count);
+    
+    inline static void transformVertices3D(const float* m, float* vertices, size_t stride, size_t count);
+    
+    inline static void offsetIndices(const uint16_t* src, size_t count, uint16_t offset, uint16_t* dst);
 };
 
 inline void MathUtilC::addMatrix(const float* m, float scalar, float* dst)
@@ -215,4 +223,87 @@ inline void MathUtilC::crossVec3(const float* v1, const float* v2, float* dst)
     dst[2] = z;
 }
 
+inline void MathUtilC::composeTRSBatch(const float* trs, const uint8_t* is3D, const uint32_t* indices, size_t count, float* dst)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t index = indices[i];
+        const float* t = trs + index * 10;
+        float* m = dst + index * 16;
+        
+        float z = 0.0f, sz = 1.0f;
+        if (is3D[index])
+        {
+            z = t[2];
+            sz = t[9];
+        }
+        
+        float x2 = t[3] + t[3];
+        float y2 = t[4] + t[4];
+        float z2 = t[5] + t[5];
+        
+        float xx2 = t[3] * x2;
+        float yy2 = t[4] * y2;
+        float zz2 = t[5] * z2;
+        float xy2 = t[3] * y2;
+        float xz2 = t[3] * z2;
+        float yz2 = t[4] * z2;
+        float wx2 = t[6] * x2;
+        float wy2 = t[6] * y2;
+        float wz2 = t[6] * z2;
+        
+        m[0] = (1.0f - yy2 - zz2) * t[7];
+        m[1] = (xy2 + wz2) * t[7];
+        m[2] = (xz2 - wy2) * t[7];
+        m[3] = 0.0f;
+        
+        m[4] = (xy2 - wz2) * t[8];
+        m[5] = (1.0f - xx2 - zz2) * t[8];
+        m[6] = (yz2 + wx2) * t[8];
+        m[7] = 0.0f;
+        
+        m[8] = (xz2 + wy2) * sz;
+        m[9] = (yz2 - wx2) * sz;
+        m[10] = (1.0f - xx2 - yy2) * sz;
+        m[11] = 0.0f;
+        
+        m[12] = t[0];
+        m[13] = t[1];
+        m[14] = z;
+        m[15] = 1.0f;
+    }
+}
+
+inline void MathUtilC::transformVertices2D(const float* m, float* vertices, size_t stride, size_t count)
+{
+    for (size_t i = 0; i < count; ++i, vertices += stride)
+    {
+        float x = vertices[0], y = vertices[1];
+        vertices[0] = x * m[0] + y * m[4] + m[12];
+        vertices[1] = x * m[1] + y * m[5] + m[13];
+    }
+}
+
+inline void MathUtilC::transformVertices3D(const float* m, float* vertices, size_t stride, size_t count)
+{
+    for (size_t i = 0; i < count; ++i, vertices += stride)
+    {
+        float x = vertices[0], y = vertices[1], z = vertices[2];
+        float rhw = m[3] * x + m[7] * y + m[11] * z + m[15];
+        rhw = rhw ? 1 / rhw : 1;
+        
+        vertices[0] = (m[0] * x + m[4] * y + m[8] * z + m[12]) * rhw;
+        vertices[1] = (m[1] * x + m[5] * y + m[9] * z + m[13]) * rhw;
+        vertices[2] = (m[2] * x + m[6] * y + m[10] * z + m[14]) * rhw;
+    }
+}
+
+inline void MathUtilC::offsetIndices(const uint16_t* src, size_t count, uint16_t offset, uint16_t* dst)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        dst[i] = src[i] + offset;
+    }
+}
+
 NS_CC_MATH_END
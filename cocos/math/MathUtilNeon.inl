@@ -17,6 +17,8 @@
 
  This file was modified to fit the cocos2d-x project
  */
+#include <arm_neon.h>
+
 NS_CC_MATH_BEGIN
 
 class MathUtilNeon
@@ -41,6 +43,14 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+    
+    inline static void composeTRSBatch(const float* trs, const uint8_t* is3D, const uint32_t* indices, size_t count, float* dst);
+    
+    inline static void transformVertices2D(const float* m, float* vertices, size_t stride, size_t count);
+    
+    inline static void transformVertices3D(const float* m, float* vertices, size_t stride, size_t count);
+    
+    inline static void offsetIndices(const uint16_t* src, size_t count, uint16_t offset, uint16_t* dst);
 };
 
 inline void MathUtilNeon::addMatrix(const float* m, float scalar, float* dst)
@@ -268,4 +278,142 @@ inline void MathUtilNeon::crossVec3(const float* v1, const float* v2, float* dst
                  );
 }
 
+inline void MathUtilNeon::composeTRSBatch(const float* trs, const uint8_t* is3D, const uint32_t* indices, size_t count, float* dst)
+{
+    // gather 4 elements into one lane each, then transpose the results back to matrices
+    float soa[10][4] __attribute__((aligned(16)));
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        for (int k = 0; k < 4; ++k)
+        {
+            uint32_t index = indices[i + k];
+            const float* t = trs + index * 10;
+            soa[0][k] = t[0];
+            soa[1][k] = t[1];
+            soa[3][k] = t[3];
+            soa[4][k] = t[4];
+            soa[5][k] = t[5];
+            soa[6][k] = t[6];
+            soa[7][k] = t[7];
+            soa[8][k] = t[8];
+            // 2D elements skip position z and scale z
+            if (is3D[index])
+            {
+                soa[2][k] = t[2];
+                soa[9][k] = t[9];
+            }
+            else
+            {
+                soa[2][k] = 0.0f;
+                soa[9][k] = 1.0f;
+            }
+        }
+        
+        float32x4_t qx = vld1q_f32(soa[3]);
+        float32x4_t qy = vld1q_f32(soa[4]);
+        float32x4_t qz = vld1q_f32(soa[5]);
+        float32x4_t qw = vld1q_f32(soa[6]);
+        float32x4_t sx = vld1q_f32(soa[7]);
+        float32x4_t sy = vld1q_f32(soa[8]);
+        float32x4_t sz = vld1q_f32(soa[9]);
+        
+        float32x4_t x2 = vaddq_f32(qx, qx);
+        float32x4_t y2 = vaddq_f32(qy, qy);
+        float32x4_t z2 = vaddq_f32(qz, qz);
+        
+        float32x4_t xx2 = vmulq_f32(qx, x2);
+        float32x4_t yy2 = vmulq_f32(qy, y2);
+        float32x4_t zz2 = vmulq_f32(qz, z2);
+        float32x4_t xy2 = vmulq_f32(qx, y2);
+        float32x4_t xz2 = vmulq_f32(qx, z2);
+        float32x4_t yz2 = vmulq_f32(qy, z2);
+        float32x4_t wx2 = vmulq_f32(qw, x2);
+        float32x4_t wy2 = vmulq_f32(qw, y2);
+        float32x4_t wz2 = vmulq_f32(qw, z2);
+        
+        float32x4_t cols[4][4];
+        cols[0][0] = vmulq_f32(vsubq_f32(vsubq_f32(one, yy2), zz2), sx);
+        cols[0][1] = vmulq_f32(vaddq_f32(xy2, wz2), sx);
+        cols[0][2] = vmulq_f32(vsubq_f32(xz2, wy2), sx);
+        cols[0][3] = zero;
+        
+        cols[1][0] = vmulq_f32(vsubq_f32(xy2, wz2), sy);
+        cols[1][1] = vmulq_f32(vsubq_f32(vsubq_f32(one, xx2), zz2), sy);
+        cols[1][2] = vmulq_f32(vaddq_f32(yz2, wx2), sy);
+        cols[1][3] = zero;
+        
+        cols[2][0] = vmulq_f32(vaddq_f32(xz2, wy2), sz);
+        cols[2][1] = vmulq_f32(vsubq_f32(yz2, wx2), sz);
+        cols[2][2] = vmulq_f32(vsubq_f32(vsubq_f32(one, xx2), yy2), sz);
+        cols[2][3] = zero;
+        
+        cols[3][0] = vld1q_f32(soa[0]);
+        cols[3][1] = vld1q_f32(soa[1]);
+        cols[3][2] = vld1q_f32(soa[2]);
+        cols[3][3] = one;
+        
+        for (int c = 0; c < 4; ++c)
+        {
+            float32x4x2_t t01 = vtrnq_f32(cols[c][0], cols[c][1]);
+            float32x4x2_t t23 = vtrnq_f32(cols[c][2], cols[c][3]);
+            vst1q_f32(dst + indices[i] * 16 + c * 4, vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0])));
+            vst1q_f32(dst + indices[i + 1] * 16 + c * 4, vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1])));
+            vst1q_f32(dst + indices[i + 2] * 16 + c * 4, vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0])));
+            vst1q_f32(dst + indices[i + 3] * 16 + c * 4, vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1])));
+        }
+    }
+    
+    MathUtilC::composeTRSBatch(trs, is3D, indices + i, count - i, dst);
+}
+
+inline void MathUtilNeon::transformVertices2D(const float* m, float* vertices, size_t stride, size_t count)
+{
+    // only the xy rows of the matrix are needed
+    const float32x2_t c0 = vld1_f32(m);
+    const float32x2_t c1 = vld1_f32(m + 4);
+    const float32x2_t c3 = vld1_f32(m + 12);
+    for (size_t i = 0; i < count; ++i, vertices += stride)
+    {
+        float32x2_t v = vld1_f32(vertices);
+        float32x2_t r = vadd_f32(vadd_f32(vmul_lane_f32(c0, v, 0), vmul_lane_f32(c1, v, 1)), c3);
+        vst1_f32(vertices, r);
+    }
+}
+
+inline void MathUtilNeon::transformVertices3D(const float* m, float* vertices, size_t stride, size_t count)
+{
+    const float32x4_t c0 = vld1q_f32(m);
+    const float32x4_t c1 = vld1q_f32(m + 4);
+    const float32x4_t c2 = vld1q_f32(m + 8);
+    const float32x4_t c3 = vld1q_f32(m + 12);
+    for (size_t i = 0; i < count; ++i, vertices += stride)
+    {
+        float32x2_t xy = vld1_f32(vertices);
+        float32x4_t r = vaddq_f32(vmulq_lane_f32(c0, xy, 0), vmulq_lane_f32(c1, xy, 1));
+        r = vaddq_f32(vaddq_f32(r, vmulq_n_f32(c2, vertices[2])), c3);
+        
+        // w of 0 keeps the point as it is
+        float w = vgetq_lane_f32(r, 3);
+        r = vmulq_n_f32(r, w ? 1 / w : 1);
+        
+        vst1_f32(vertices, vget_low_f32(r));
+        vst1q_lane_f32(vertices + 2, r, 2);
+    }
+}
+
+inline void MathUtilNeon::offsetIndices(const uint16_t* src, size_t count, uint16_t offset, uint16_t* dst)
+{
+    const uint16x8_t o = vdupq_n_u16(offset);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        vst1q_u16(dst + i, vaddq_u16(vld1q_u16(src + i), o));
+    }
+    MathUtilC::offsetIndices(src + i, count - i, offset, dst + i);
+}
+
 NS_CC_MATH_END
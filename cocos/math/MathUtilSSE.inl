@@ -1,3 +1,7 @@
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 NS_CC_MATH_BEGIN
 
 #ifdef __SSE__
@@ -151,6 +155,174 @@ void MathUtil::transformVec4(const __m128 m[4], const __m128& v, __m128& dst)
                      );
 }
 
+class MathUtilSSE
+{
+public:
+    inline static void composeTRSBatch(const float* trs, const uint8_t* is3D, const uint32_t* indices, size_t count, float* dst);
+    
+    inline static void transformVertices2D(const float* m, float* vertices, size_t stride, size_t count);
+    
+    inline static void transformVertices3D(const float* m, float* vertices, size_t stride, size_t count);
+    
+    inline static void offsetIndices(const uint16_t* src, size_t count, uint16_t offset, uint16_t* dst);
+};
+
+inline void MathUtilSSE::composeTRSBatch(const float* trs, const uint8_t* is3D, const uint32_t* indices, size_t count, float* dst)
+{
+    // gather 4 elements into one lane each, then transpose the results back to matrices
+    alignas(16) float soa[10][4];
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        for (int k = 0; k < 4; ++k)
+        {
+            uint32_t index = indices[i + k];
+            const float* t = trs + index * 10;
+            soa[0][k] = t[0];
+            soa[1][k] = t[1];
+            soa[3][k] = t[3];
+            soa[4][k] = t[4];
+            soa[5][k] = t[5];
+            soa[6][k] = t[6];
+            soa[7][k] = t[7];
+            soa[8][k] = t[8];
+            // 2D elements skip position z and scale z
+            if (is3D[index])
+            {
+                soa[2][k] = t[2];
+                soa[9][k] = t[9];
+            }
+            else
+            {
+                soa[2][k] = 0.0f;
+                soa[9][k] = 1.0f;
+            }
+        }
+        
+        __m128 qx = _mm_load_ps(soa[3]);
+        __m128 qy = _mm_load_ps(soa[4]);
+        __m128 qz = _mm_load_ps(soa[5]);
+        __m128 qw = _mm_load_ps(soa[6]);
+        __m128 sx = _mm_load_ps(soa[7]);
+        __m128 sy = _mm_load_ps(soa[8]);
+        __m128 sz = _mm_load_ps(soa[9]);
+        
+        __m128 x2 = _mm_add_ps(qx, qx);
+        __m128 y2 = _mm_add_ps(qy, qy);
+        __m128 z2 = _mm_add_ps(qz, qz);
+        
+        __m128 xx2 = _mm_mul_ps(qx, x2);
+        __m128 yy2 = _mm_mul_ps(qy, y2);
+        __m128 zz2 = _mm_mul_ps(qz, z2);
+        __m128 xy2 = _mm_mul_ps(qx, y2);
+        __m128 xz2 = _mm_mul_ps(qx, z2);
+        __m128 yz2 = _mm_mul_ps(qy, z2);
+        __m128 wx2 = _mm_mul_ps(qw, x2);
+        __m128 wy2 = _mm_mul_ps(qw, y2);
+        __m128 wz2 = _mm_mul_ps(qw, z2);
+        
+        __m128 c0 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, yy2), zz2), sx);
+        __m128 c1 = _mm_mul_ps(_mm_add_ps(xy2, wz2), sx);
+        __m128 c2 = _mm_mul_ps(_mm_sub_ps(xz2, wy2), sx);
+        __m128 c3 = zero;
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_storeu_ps(dst + indices[i] * 16, c0);
+        _mm_storeu_ps(dst + indices[i + 1] * 16, c1);
+        _mm_storeu_ps(dst + indices[i + 2] * 16, c2);
+        _mm_storeu_ps(dst + indices[i + 3] * 16, c3);
+        
+        c0 = _mm_mul_ps(_mm_sub_ps(xy2, wz2), sy);
+        c1 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, xx2), zz2), sy);
+        c2 = _mm_mul_ps(_mm_add_ps(yz2, wx2), sy);
+        c3 = zero;
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_storeu_ps(dst + indices[i] * 16 + 4, c0);
+        _mm_storeu_ps(dst + indices[i + 1] * 16 + 4, c1);
+        _mm_storeu_ps(dst + indices[i + 2] * 16 + 4, c2);
+        _mm_storeu_ps(dst + indices[i + 3] * 16 + 4, c3);
+        
+        c0 = _mm_mul_ps(_mm_add_ps(xz2, wy2), sz);
+        c1 = _mm_mul_ps(_mm_sub_ps(yz2, wx2), sz);
+        c2 = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(one, xx2), yy2), sz);
+        c3 = zero;
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_storeu_ps(dst + indices[i] * 16 + 8, c0);
+        _mm_storeu_ps(dst + indices[i + 1] * 16 + 8, c1);
+        _mm_storeu_ps(dst + indices[i + 2] * 16 + 8, c2);
+        _mm_storeu_ps(dst + indices[i + 3] * 16 + 8, c3);
+        
+        c0 = _mm_load_ps(soa[0]);
+        c1 = _mm_load_ps(soa[1]);
+        c2 = _mm_load_ps(soa[2]);
+        c3 = one;
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_storeu_ps(dst + indices[i] * 16 + 12, c0);
+        _mm_storeu_ps(dst + indices[i + 1] * 16 + 12, c1);
+        _mm_storeu_ps(dst + indices[i + 2] * 16 + 12, c2);
+        _mm_storeu_ps(dst + indices[i + 3] * 16 + 12, c3);
+    }
+    
+    MathUtilC::composeTRSBatch(trs, is3D, indices + i, count - i, dst);
+}
+
+inline void MathUtilSSE::transformVertices2D(const float* m, float* vertices, size_t stride, size_t count)
+{
+    // every vertex is one column combination, only the low two lanes are stored back
+    const __m128 c0 = _mm_loadu_ps(m);
+    const __m128 c1 = _mm_loadu_ps(m + 4);
+    const __m128 c3 = _mm_loadu_ps(m + 12);
+    for (size_t i = 0; i < count; ++i, vertices += stride)
+    {
+        __m128 x = _mm_load1_ps(vertices);
+        __m128 y = _mm_load1_ps(vertices + 1);
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, x), _mm_mul_ps(c1, y)), c3);
+        _mm_storel_pi((__m64*)vertices, r);
+    }
+}
+
+inline void MathUtilSSE::transformVertices3D(const float* m, float* vertices, size_t stride, size_t count)
+{
+    const __m128 c0 = _mm_loadu_ps(m);
+    const __m128 c1 = _mm_loadu_ps(m + 4);
+    const __m128 c2 = _mm_loadu_ps(m + 8);
+    const __m128 c3 = _mm_loadu_ps(m + 12);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    for (size_t i = 0; i < count; ++i, vertices += stride)
+    {
+        __m128 x = _mm_load1_ps(vertices);
+        __m128 y = _mm_load1_ps(vertices + 1);
+        __m128 z = _mm_load1_ps(vertices + 2);
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, x), _mm_mul_ps(c1, y)), _mm_mul_ps(c2, z)), c3);
+        
+        // w of 0 keeps the point as it is
+        __m128 w = _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3));
+        __m128 valid = _mm_cmpneq_ps(w, zero);
+        __m128 rhw = _mm_or_ps(_mm_and_ps(valid, _mm_div_ps(one, w)), _mm_andnot_ps(valid, one));
+        r = _mm_mul_ps(r, rhw);
+        
+        _mm_storel_pi((__m64*)vertices, r);
+        _mm_store_ss(vertices + 2, _mm_movehl_ps(r, r));
+    }
+}
+
+inline void MathUtilSSE::offsetIndices(const uint16_t* src, size_t count, uint16_t offset, uint16_t* dst)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i o = _mm_set1_epi16((short)offset);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_add_epi16(v, o));
+    }
+#endif
+    MathUtilC::offsetIndices(src + i, count - i, offset, dst + i);
+}
+
 #endif
 
 
@@ -27,6 +27,19 @@
 #include <set>
 #include <curl/curl.h>
 #include <deque>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <io.h>
+#define CC_CURL_FSEEK(fp, offset, origin) _fseeki64(fp, offset, origin)
+#define CC_CURL_FTRUNCATE(fp, size) _chsize_s(_fileno(fp), size)
+#else
+#include <unistd.h>
+#define CC_CURL_FSEEK(fp, offset, origin) fseeko(fp, (off_t)(offset), origin)
+#define CC_CURL_FTRUNCATE(fp, size) ftruncate(fileno(fp), (off_t)(size))
+#endif
 
 #include "base/CCScheduler.h"
 #include "platform/CCFileUtils.h"
@@ -42,6 +55,24 @@
 #define CC_CURL_POLL_TIMEOUT_MS 50
 #endif
 
+// files from servers accepting ranges are downloaded in segments if every segment gets this size at least
+#ifndef CC_CURL_MIN_SEGMENT_SIZE
+#define CC_CURL_MIN_SEGMENT_SIZE (4 * 1024 * 1024)
+#endif
+
+#ifndef CC_CURL_MAX_SEGMENT_COUNT
+#define CC_CURL_MAX_SEGMENT_COUNT 4
+#endif
+
+// interval of saving the segment journal while segments are running
+#ifndef CC_CURL_JOURNAL_INTERVAL_MS
+#define CC_CURL_JOURNAL_INTERVAL_MS 1000
+#endif
+
+#define CC_CURL_JOURNAL_SUFFIX ".journal"
+#define CC_CURL_JOURNAL_MAGIC 0x4a444343 // "CCDJ"
+#define CC_CURL_JOURNAL_VERSION 1
+
 namespace cocos2d { namespace network {
     using namespace std;
 
@@ -58,6 +89,17 @@ namespace cocos2d { namespace network {
     public:
         int serialId;
 
+        // one HTTP Range request of a segmented download, [begin, end) of the file
+        struct Segment
+        {
+            DownloadTaskCURL* owner;
+            int64_t begin;
+            int64_t end;
+            int64_t received;
+            CURL*   handle;
+            bool    rangeChecked;
+        };
+
         DownloadTaskCURL()
         : serialId(_sSerialId++)
         , _fp(nullptr)
@@ -95,6 +137,8 @@ namespace cocos2d { namespace network {
             _fileName = filename;
             _tempFileName = filename;
             _tempFileName.append(tempSuffix);
+            _journalFileName = _tempFileName;
+            _journalFileName.append(CC_CURL_JOURNAL_SUFFIX);
 
             if (_sStoragePathSet.end() != _sStoragePathSet.find(_tempFileName))
             {
@@ -175,14 +219,15 @@ namespace cocos2d { namespace network {
             }
             else
             {
+                // the buffer is sized by content length, grow it only if the server sends more
                 ret = size * count;
-                auto cap = _buf.capacity();
-                auto bufSize = _buf.size();
-                if (cap < bufSize + ret)
+                size_t bufSize = _buf.size();
+                if (bufSize < _bufOffset + ret)
                 {
-                    _buf.reserve(bufSize * 2);
+                    _buf.resize(std::max(_bufOffset + ret, bufSize * 2));
                 }
-                _buf.insert(_buf.end() , buffer, buffer + ret);
+                memcpy(_buf.data() + _bufOffset, buffer, ret);
+                _bufOffset += ret;
             }
             if (ret)
             {
@@ -192,6 +237,35 @@ namespace cocos2d { namespace network {
             return ret;
         }
 
+        size_t writeSegmentProc(Segment& segment, unsigned char *buffer, size_t size, size_t count)
+        {
+            lock_guard<mutex> lock(_mutex);
+            size_t len = size * count;
+            if (!_fp || segment.received + (int64_t)len > segment.end - segment.begin)
+            {
+                // more data than requested, abort the transfer
+                return 0;
+            }
+
+            // positioned write, segments of a task are all written from the thread proc
+            int64_t offset = segment.begin + segment.received;
+            if (_filePos != offset && 0 != CC_CURL_FSEEK(_fp, offset, SEEK_SET))
+            {
+                _filePos = -1;
+                return 0;
+            }
+            size_t ret = fwrite(buffer, 1, len, _fp);
+            _filePos = offset + ret;
+            if (ret)
+            {
+                segment.received += ret;
+                _bytesReceived += ret;
+                _totalBytesReceived += ret;
+                _journalDirty = true;
+            }
+            return ret;
+        }
+
     private:
         friend class DownloaderCURL;
 
@@ -218,8 +292,17 @@ namespace cocos2d { namespace network {
         string _fileName;
         string _tempFileName;
         vector<unsigned char> _buf;
+        size_t _bufOffset;
         FILE*  _fp;
 
+        // segmented download, only used in thread proc
+        string          _journalFileName;
+        vector<Segment> _segments;
+        bool            _segmented;
+        bool            _journalDirty;
+        int64_t         _filePos;
+        chrono::steady_clock::time_point _journalTime;
+
         void _initInternal()
         {
             _acceptRanges = (false);
@@ -231,6 +314,87 @@ namespace cocos2d { namespace network {
             _errCodeInternal = (CURLE_OK);
             _header.resize(0);
             _header.reserve(384);   // pre alloc header string buffer
+            _bufOffset = 0;
+            _segments.clear();
+            _segmented = false;
+            _journalDirty = false;
+            _filePos = -1;
+        }
+
+        // journal: magic, version, total size, segment count, then begin, end and received of each segment
+        bool _loadJournalProc(int64_t totalSize)
+        {
+            _segments.clear();
+            FILE* fp = fopen(FileUtils::getInstance()->getSuitableFOpen(_journalFileName).c_str(), "rb");
+            if (!fp)
+            {
+                return false;
+            }
+
+            uint32_t head[2] = {0};
+            int64_t fileSize = 0;
+            uint32_t count = 0;
+            bool ok = fread(head, sizeof(head), 1, fp) == 1
+                    && head[0] == CC_CURL_JOURNAL_MAGIC && head[1] == CC_CURL_JOURNAL_VERSION
+                    && fread(&fileSize, sizeof(fileSize), 1, fp) == 1 && fileSize == totalSize
+                    && fread(&count, sizeof(count), 1, fp) == 1 && count > 0 && count <= CC_CURL_MAX_SEGMENT_COUNT + 1;
+
+            int64_t expectedBegin = 0;
+            for (uint32_t i = 0; ok && i < count; ++i)
+            {
+                int64_t range[3] = {0};
+                ok = fread(range, sizeof(range), 1, fp) == 1
+                    && range[0] == expectedBegin && range[1] > range[0] && range[1] <= totalSize
+                    && range[2] >= 0 && range[2] <= range[1] - range[0];
+                if (ok)
+                {
+                    _segments.push_back({this, range[0], range[1], range[2], nullptr, false});
+                    expectedBegin = range[1];
+                }
+            }
+            fclose(fp);
+
+            // segments must cover the whole file
+            if (!ok || expectedBegin != totalSize)
+            {
+                _segments.clear();
+                return false;
+            }
+            return true;
+        }
+
+        bool _saveJournalProc()
+        {
+            // the data must reach the file before the journal claims it
+            if (_fp)
+            {
+                fflush(_fp);
+            }
+            _journalDirty = false;
+            _journalTime = chrono::steady_clock::now();
+
+            auto util = FileUtils::getInstance();
+            string tempJournal = _journalFileName + ".tmp";
+            FILE* fp = fopen(util->getSuitableFOpen(tempJournal).c_str(), "wb");
+            if (!fp)
+            {
+                return false;
+            }
+
+            uint32_t head[2] = {CC_CURL_JOURNAL_MAGIC, CC_CURL_JOURNAL_VERSION};
+            uint32_t count = (uint32_t)_segments.size();
+            bool ok = fwrite(head, sizeof(head), 1, fp) == 1
+                    && fwrite(&_totalBytesExpected, sizeof(_totalBytesExpected), 1, fp) == 1
+                    && fwrite(&count, sizeof(count), 1, fp) == 1;
+            for (auto& segment : _segments)
+            {
+                int64_t range[3] = {segment.begin, segment.end, segment.received};
+                ok = ok && fwrite(range, sizeof(range), 1, fp) == 1;
+            }
+            ok = (0 == fclose(fp)) && ok;
+
+            // replace the journal at once, a torn journal would be taken for a finished download
+            return ok && util->renameFile(tempJournal, _journalFileName);
         }
     };
     int DownloadTaskCURL::_sSerialId;
@@ -330,6 +494,23 @@ namespace cocos2d { namespace network {
             return coTask->writeDataProc((unsigned char *)buffer, size, count);
         }
 
+        static size_t _outputSegmentCallbackProc(void *buffer, size_t size, size_t count, void *userdata)
+        {
+            DownloadTaskCURL::Segment& segment = *((DownloadTaskCURL::Segment*)userdata);
+            if (!segment.rangeChecked)
+            {
+                // a server ignoring the range answers 200 with the whole file, which can't go to the segment offset
+                long httpResponseCode = 0;
+                curl_easy_getinfo(segment.handle, CURLINFO_RESPONSE_CODE, &httpResponseCode);
+                if (206 != httpResponseCode)
+                {
+                    return 0;
+                }
+                segment.rangeChecked = true;
+            }
+            return segment.owner->writeSegmentProc(segment, (unsigned char *)buffer, size, count);
+        }
+
         // this function designed call in work thread
         // the curl handle destroyed in _threadProc
         // handle inited for get header
@@ -435,19 +616,54 @@ namespace cocos2d { namespace network {
 
                 // get current file size
                 int64_t fileSize = 0;
-                if (acceptRanges && coTask._tempFileName.length())
+                bool journalLoaded = false;
+                if (coTask._tempFileName.length())
                 {
-                    fileSize = FileUtils::getInstance()->getFileSize(coTask._tempFileName);
+                    auto util = FileUtils::getInstance();
+                    bool hasJournal = util->isFileExist(coTask._journalFileName);
+                    if (acceptRanges && hasJournal)
+                    {
+                        journalLoaded = coTask._loadJournalProc((int64_t)contentLen);
+                    }
+
+                    if (hasJournal && !journalLoaded)
+                    {
+                        // the temp file was preallocated by a segmented download, its size tells nothing
+                        util->removeFile(coTask._journalFileName);
+                        fclose(coTask._fp);
+                        coTask._fp = fopen(util->getSuitableFOpen(coTask._tempFileName).c_str(), "wb");
+                        if (nullptr == coTask._fp)
+                        {
+                            coTask.setErrorProc(DownloadTask::ERROR_FILE_OP_FAILED, 0, "Can't reset temp file.");
+                            break;
+                        }
+                    }
+                    else if (acceptRanges)
+                    {
+                        fileSize = util->getFileSize(coTask._tempFileName);
+                    }
                 }
 
                 // set header info to coTask
                 lock_guard<mutex> lock(coTask._mutex);
                 coTask._totalBytesExpected = (int64_t)contentLen;
                 coTask._acceptRanges = acceptRanges;
-                if (acceptRanges && fileSize > 0)
+                if (journalLoaded)
+                {
+                    for (auto& segment : coTask._segments)
+                    {
+                        coTask._totalBytesReceived += segment.received;
+                    }
+                }
+                else if (acceptRanges && fileSize > 0)
                 {
                     coTask._totalBytesReceived = fileSize;
                 }
+                else if (0 == coTask._tempFileName.length() && contentLen > 0)
+                {
+                    // data task, write into a buffer of the content size
+                    coTask._buf.resize((size_t)contentLen);
+                }
                 coTask._headerAchieved = true;
             } while (0);
 
@@ -458,6 +674,187 @@ namespace cocos2d { namespace network {
             return coTask._headerAchieved;
         }
 
+        // large files from servers accepting ranges are downloaded in segments
+        bool _shouldSegmentProc(const DownloadTaskCURL& coTask)
+        {
+            if (nullptr == coTask._fp || false == coTask._acceptRanges)
+            {
+                return false;
+            }
+            return coTask._segments.size() || coTask._totalBytesExpected >= 2 * (int64_t)CC_CURL_MIN_SEGMENT_SIZE;
+        }
+
+        // split the bytes not in the temp file yet into segments, preallocate the file and start a transfer per segment
+        bool _startSegmentsProc(CURLM* curlmHandle, TaskWrapper& wrapper, unordered_map<CURL*, TaskWrapper>& coTaskMap)
+        {
+            DownloadTaskCURL& coTask = *wrapper.second;
+            int64_t totalSize = coTask._totalBytesExpected;
+
+            if (coTask._segments.empty())
+            {
+                // bytes of a former single stream download make a finished segment
+                int64_t done = coTask._totalBytesReceived;
+                if (done > 0)
+                {
+                    coTask._segments.push_back({&coTask, 0, done, done, nullptr, false});
+                }
+                int64_t remain = totalSize - done;
+                int64_t count = std::max((int64_t)1, std::min((int64_t)CC_CURL_MAX_SEGMENT_COUNT, remain / (int64_t)CC_CURL_MIN_SEGMENT_SIZE));
+                for (int64_t i = 0; i < count; ++i)
+                {
+                    int64_t begin = done + remain * i / count;
+                    int64_t end = done + remain * (i + 1) / count;
+                    coTask._segments.push_back({&coTask, begin, end, 0, nullptr, false});
+                }
+            }
+
+            // journal first, a preallocated temp file without journal would look finished
+            fclose(coTask._fp);
+            coTask._fp = fopen(FileUtils::getInstance()->getSuitableFOpen(coTask._tempFileName).c_str(), "r+b");
+            coTask._filePos = -1;
+            if (nullptr == coTask._fp
+                || false == coTask._saveJournalProc()
+                || 0 != CC_CURL_FTRUNCATE(coTask._fp, totalSize))
+            {
+                coTask.setErrorProc(DownloadTask::ERROR_FILE_OP_FAILED, 0, "Can't prepare file for segmented download.");
+                _abortSegmentsProc(curlmHandle, coTask, coTaskMap);
+                return false;
+            }
+
+            for (auto& segment : coTask._segments)
+            {
+                if (segment.received == segment.end - segment.begin)
+                {
+                    continue;
+                }
+
+                CURL* curlHandle = curl_easy_init();
+                if (nullptr == curlHandle)
+                {
+                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, 0, "Alloc curl handle failed.");
+                    _abortSegmentsProc(curlmHandle, coTask, coTaskMap);
+                    return false;
+                }
+
+                _initCurlHandleProc(curlHandle, wrapper, true);
+                // each segment asks for its own range instead of resuming the whole file
+                char range[64] = {0};
+                snprintf(range, sizeof(range), "%lld-%lld", (long long)(segment.begin + segment.received), (long long)(segment.end - 1));
+                curl_easy_setopt(curlHandle, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)0);
+                curl_easy_setopt(curlHandle, CURLOPT_RANGE, range);
+                curl_easy_setopt(curlHandle, CURLOPT_WRITEFUNCTION, DownloaderCURL::Impl::_outputSegmentCallbackProc);
+                curl_easy_setopt(curlHandle, CURLOPT_WRITEDATA, &segment);
+                segment.handle = curlHandle;
+                segment.rangeChecked = false;
+
+                CURLMcode mcode = curl_multi_add_handle(curlmHandle, curlHandle);
+                if (CURLM_OK != mcode)
+                {
+                    curl_easy_cleanup(curlHandle);
+                    segment.handle = nullptr;
+                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
+                    _abortSegmentsProc(curlmHandle, coTask, coTaskMap);
+                    return false;
+                }
+                DLLOG("    _threadProc task create segment curl handle:%p range:%s", curlHandle, range);
+                coTaskMap[curlHandle] = wrapper;
+            }
+            coTask._segmented = true;
+            return true;
+        }
+
+        // stop running segments of a failed task, the temp file and journal are kept to resume from
+        void _abortSegmentsProc(CURLM* curlmHandle, DownloadTaskCURL& coTask, unordered_map<CURL*, TaskWrapper>& coTaskMap)
+        {
+            for (auto& segment : coTask._segments)
+            {
+                if (segment.handle)
+                {
+                    curl_multi_remove_handle(curlmHandle, segment.handle);
+                    curl_easy_cleanup(segment.handle);
+                    coTaskMap.erase(segment.handle);
+                    segment.handle = nullptr;
+                }
+            }
+
+            if (coTask._fp)
+            {
+                coTask._saveJournalProc();
+                // closed here so the unfinished temp file isn't renamed to the storage path
+                fclose(coTask._fp);
+                coTask._fp = nullptr;
+            }
+        }
+
+        // a segment transfer is done, returns true if the whole task is finished
+        bool _segmentDoneProc(CURLM* curlmHandle, CURL* curlHandle, CURLcode errCode, TaskWrapper& wrapper, unordered_map<CURL*, TaskWrapper>& coTaskMap)
+        {
+            DownloadTaskCURL& coTask = *wrapper.second;
+            bool running = false;
+            bool failed = false;
+            for (auto& segment : coTask._segments)
+            {
+                if (segment.handle == curlHandle)
+                {
+                    segment.handle = nullptr;
+                    if (CURLE_OK != errCode)
+                    {
+                        coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, errCode, curl_easy_strerror(errCode));
+                        failed = true;
+                    }
+                    else if (segment.received != segment.end - segment.begin)
+                    {
+                        char buf[256] = {0};
+                        snprintf(buf, sizeof(buf)
+                                 , "When request url(%s) segment, received %lld of %lld bytes"
+                                 , wrapper.first->requestURL.c_str()
+                                 , (long long)segment.received
+                                 , (long long)(segment.end - segment.begin));
+                        coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, CURLE_OK, buf);
+                        failed = true;
+                    }
+                }
+                else if (segment.handle)
+                {
+                    running = true;
+                }
+            }
+
+            if (failed)
+            {
+                _abortSegmentsProc(curlmHandle, coTask, coTaskMap);
+                return true;
+            }
+
+            if (running)
+            {
+                coTask._saveJournalProc();
+                return false;
+            }
+
+            // all segments done, the temp file is renamed in main thread
+            fflush(coTask._fp);
+            FileUtils::getInstance()->removeFile(coTask._journalFileName);
+            return true;
+        }
+
+        void _finishTaskProc(TaskWrapper& wrapper)
+        {
+            // remove from _processSet
+            {
+                lock_guard<mutex> lock(_processMutex);
+                if (_processSet.end() != _processSet.find(wrapper)) {
+                    _processSet.erase(wrapper);
+                }
+            }
+
+            // add to finishedQueue
+            {
+                lock_guard<mutex> lock(_finishedMutex);
+                _finishedQueue.push_back(wrapper);
+            }
+        }
+
         void _threadProc()
         {
             DLLOG("++++DownloaderCURL::Impl::_threadProc begin %p", this);
@@ -558,7 +955,22 @@ namespace cocos2d { namespace network {
 
                             // remove from multi-handle
                             curl_multi_remove_handle(curlmHandle, curlHandle);
+
+                            if (wrapper.second->_segmented)
+                            {
+                                bool finished = _segmentDoneProc(curlmHandle, curlHandle, errCode, wrapper, coTaskMap);
+                                curl_easy_cleanup(curlHandle);
+                                coTaskMap.erase(curlHandle);
+                                if (false == finished)
+                                {
+                                    continue;
+                                }
+                                _finishTaskProc(wrapper);
+                                continue;
+                            }
+
                             bool reinited = false;
+                            bool segmented = false;
                             do
                             {
                                 if (CURLE_OK != errCode)
@@ -589,8 +1001,21 @@ namespace cocos2d { namespace network {
                                 {
                                     // the file has download complete
                                     // break to move this task to finish queue
+                                    if (wrapper.second->_segments.size())
+                                    {
+                                        FileUtils::getInstance()->removeFile(wrapper.second->_journalFileName);
+                                    }
+                                    break;
+                                }
+
+                                // large file, the header handle is done and every segment gets its own handle
+                                if (_shouldSegmentProc(*wrapper.second))
+                                {
+                                    // the error info has been set in _startSegmentsProc if failed
+                                    segmented = _startSegmentsProc(curlmHandle, wrapper, coTaskMap);
                                     break;
                                 }
+
                                 // reinit curl handle for download content
                                 curl_easy_reset(curlHandle);
                                 _initCurlHandleProc(curlHandle, wrapper, true);
@@ -613,21 +1038,25 @@ namespace cocos2d { namespace network {
                            // remove from coTaskMap
                             coTaskMap.erase(curlHandle);
 
-                            // remove from _processSet
+                            if (segmented)
                             {
-                                lock_guard<mutex> lock(_processMutex);
-                                if (_processSet.end() != _processSet.find(wrapper)) {
-                                    _processSet.erase(wrapper);
-                                }
-                            }
-
-                            // add to finishedQueue
-                            {
-                                lock_guard<mutex> lock(_finishedMutex);
-                                _finishedQueue.push_back(wrapper);
+                                continue;
                             }
+                            _finishTaskProc(wrapper);
                         }
                     } while(m);
+
+                    // keep journals of segmented downloads close to the written data
+                    auto now = chrono::steady_clock::now();
+                    for (auto& item : coTaskMap)
+                    {
+                        DownloadTaskCURL& coTask = *item.second.second;
+                        if (coTask._segmented && coTask._journalDirty
+                            && now - coTask._journalTime >= chrono::milliseconds(CC_CURL_JOURNAL_INTERVAL_MS))
+                        {
+                            coTask._saveJournalProc();
+                        }
+                    }
                 }
 
                 // process tasks in _requestList
@@ -714,7 +1143,7 @@ namespace cocos2d { namespace network {
         _transferDataToBuffer = [this](void *buf, int64_t len)->int64_t
         {
             DownloadTaskCURL& coTask = *_currTask;
-            int64_t dataLen = coTask._buf.size();
+            int64_t dataLen = coTask._bufOffset;
             if (len < dataLen)
             {
                 return 0;
@@ -722,6 +1151,7 @@ namespace cocos2d { namespace network {
 
             memcpy(buf, coTask._buf.data(), dataLen);
             coTask._buf.resize(0);
+            coTask._bufOffset = 0;
             return dataLen;
         };
 
@@ -870,6 +1300,9 @@ namespace cocos2d { namespace network {
                 } while (0);
 
             }
+            // the data buffer was sized by content length, drop the bytes not received
+            coTask._buf.resize(coTask._bufOffset);
+
             // needn't lock coTask here, because tasks has removed form _impl
             onTaskFinish(task, coTask._errCode, coTask._errCodeInternal, coTask._errDescription, coTask._buf);
             DLLOG("    DownloaderCURL: finish Task: Id(%d)", coTask.serialId);
@@ -27,6 +27,9 @@
 
 #include "network/HttpClient.h"
 #include <queue>
+#include <unordered_set>
+#include <algorithm>
+#include <chrono>
 #include <errno.h>
 #include <curl/curl.h>
 #include "platform/CCFileUtils.h"
@@ -42,8 +45,6 @@ typedef int int32_t;
 
 static HttpClient* _httpClient = nullptr; // pointer to singleton
 
-typedef size_t (*write_callback)(void *ptr, size_t size, size_t nmemb, void *stream);
-
 // Callback function used by libcurl for collect response data
 static size_t writeData(void *ptr, size_t size, size_t nmemb, void *stream)
 {
@@ -70,97 +71,17 @@ static size_t writeHeaderData(void *ptr, size_t size, size_t nmemb, void *stream
     return sizes;
 }
 
+// curl_multi_poll and curl_multi_wakeup are available since 7.68.0
+#if LIBCURL_VERSION_NUM >= 0x074400
+#define HTTP_CURL_HAS_WAKEUP 1
+#else
+#define HTTP_CURL_HAS_WAKEUP 0
+#endif
 
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPutTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processDeleteTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-// int processDownloadTask(HttpRequest *task, write_callback callback, void *stream, int32_t *errorCode);
-
-// Worker thread
-void HttpClient::networkThread()
-{
-    increaseThreadCount();
-
-    while (true)
-    {
-        HttpRequest *request;
-
-        // step 1: send http request if the requestQueue isn't empty
-        {
-            std::lock_guard<std::mutex> lock(_requestQueueMutex);
-            while (_requestQueue.empty())
-            {
-                _sleepCondition.wait(_requestQueueMutex);
-            }
-            request = _requestQueue.at(0);
-            _requestQueue.erase(0);
-        }
-
-        if (request == _requestSentinel) {
-            break;
-        }
-
-        // step 2: libcurl sync access
-        
-        // Create a HttpResponse object, the default setting is http access failed
-        HttpResponse *response = new (std::nothrow) HttpResponse(request);
-
-        processResponse(response, _responseMessage);
-
-
-        // add response packet into queue
-        _responseQueueMutex.lock();
-        _responseQueue.pushBack(response);
-        _responseQueueMutex.unlock();
-
-        _schedulerMutex.lock();
-        if (auto sche = _scheduler.lock())
-        {
-            sche->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
-        }
-        _schedulerMutex.unlock();
-    }
-    
-    // cleanup: if worker thread received quit signal, clean up un-completed request queue
-    _requestQueueMutex.lock();
-    _requestQueue.clear();
-    _requestQueueMutex.unlock();
-
-    _responseQueueMutex.lock();
-    _responseQueue.clear();
-    _responseQueueMutex.unlock();
-
-    decreaseThreadCountAndMayDeleteThis();
-}
-
-// Worker thread
-void HttpClient::networkThreadAlone(HttpRequest* request, HttpResponse* response)
-{
-    increaseThreadCount();
-
-    char responseMessage[RESPONSE_BUFFER_SIZE] = { 0 };
-    processResponse(response, responseMessage);
-
-    _schedulerMutex.lock();
-    if (auto sche = _scheduler.lock())
-    {
-        sche->performFunctionInCocosThread([this, response, request]{
-            const ccHttpRequestCallback& callback = request->getResponseCallback();
-
-            if (callback != nullptr)
-            {
-                callback(this, response);
-            }
-            response->release();
-            // do not release in other thread
-            request->release();
-        });
-    }
-    _schedulerMutex.unlock();
-
-    decreaseThreadCountAndMayDeleteThis();
-}
+// Without curl_multi_wakeup new requests are picked up at this interval while transfers are running
+static const int HTTP_POLL_INTERVAL_MS = 10;
+// Easy handles kept for reuse after their transfers completed
+static const size_t HTTP_MAX_IDLE_HANDLES = 16;
 
 //Configure curl's timeout property
 static bool configureCURL(HttpClient* client, HttpRequest* request, CURL* handle, char* errorBuffer)
@@ -174,11 +95,13 @@ static bool configureCURL(HttpClient* client, HttpRequest* request, CURL* handle
     if (code != CURLE_OK) {
         return false;
     }
-    code = curl_easy_setopt(handle, CURLOPT_TIMEOUT, request->getTimeout());
+    // the timeout is a float in seconds, curl reads a long from the variadic argument
+    long timeoutMs = (long)(request->getTimeout() * 1000);
+    code = curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, timeoutMs);
     if (code != CURLE_OK) {
         return false;
     }
-    code = curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, request->getTimeout());
+    code = curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, timeoutMs);
     if (code != CURLE_OK) {
         return false;
     }
@@ -202,28 +125,35 @@ static bool configureCURL(HttpClient* client, HttpRequest* request, CURL* handle
     return true;
 }
 
-class CURLRaii
+/**
+ * @brief One request in flight on the multi handle.
+ * The easy handle is borrowed from the pool of the network thread and goes back to it once the transfer is done,
+ * so live connections, DNS entries and TLS sessions are reused by later requests.
+ */
+class HttpTransfer
 {
-    /// Instance of CURL
-    CURL *_curl;
-    /// Keeps custom header data
-    curl_slist *_headers;
 public:
-    CURLRaii()
-        : _curl(curl_easy_init())
+    HttpTransfer(HttpRequest* request, HttpResponse* response, CURL* curl)
+        : _request(request)
+        , _response(response)
+        , _curl(curl)
         , _headers(nullptr)
     {
+        memset(_errorBuffer, 0, sizeof(_errorBuffer));
     }
 
-    ~CURLRaii()
+    ~HttpTransfer()
     {
-        if (_curl)
-            curl_easy_cleanup(_curl);
         /* free the linked list for header data */
         if (_headers)
             curl_slist_free_all(_headers);
     }
 
+    HttpRequest* getRequest() const { return _request; }
+    HttpResponse* getResponse() const { return _response; }
+    CURL* getHandle() const { return _curl; }
+    char* getErrorBuffer() { return _errorBuffer; }
+
     template <class T>
     bool setOption(CURLoption option, T data)
     {
@@ -231,20 +161,17 @@ public:
     }
 
     /**
-     * @brief Inits CURL instance for common usage
-     * @param request Null not allowed
-     * @param callback Response write callback
-     * @param stream Response write stream
+     * @brief Sets up the easy handle for the request
+     * @param share The share handle of DNS, TLS session and cookie data
+     * @param http2 Whether HTTP/2 is preferred
      */
-    bool init(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, write_callback headerCallback, void* headerStream, char* errorBuffer)
+    bool init(HttpClient* client, CURLSH* share, bool http2)
     {
-        if (!_curl)
-            return false;
-        if (!configureCURL(client, request, _curl, errorBuffer))
+        if (!configureCURL(client, _request, _curl, _errorBuffer))
             return false;
 
         /* get custom header data (if set) */
-        std::vector<std::string> headers=request->getHeaders();
+        std::vector<std::string> headers=_request->getHeaders();
         if(!headers.empty())
         {
             /* append custom headers one by one */
@@ -264,73 +191,328 @@ public:
             }
         }
 
-        return setOption(CURLOPT_URL, request->getUrl())
-                && setOption(CURLOPT_WRITEFUNCTION, callback)
-                && setOption(CURLOPT_WRITEDATA, stream)
-                && setOption(CURLOPT_HEADERFUNCTION, headerCallback)
-                && setOption(CURLOPT_HEADERDATA, headerStream);
-        
-    }
+        if (share && !setOption(CURLOPT_SHARE, share))
+            return false;
 
-    /// @param responseCode Null not allowed
-    bool perform(long *responseCode)
-    {
-        if (CURLE_OK != curl_easy_perform(_curl))
+        if (http2)
+        {
+#if LIBCURL_VERSION_NUM >= 0x072f00
+            // fall back to HTTP/1.1 silently if the server or libcurl build has no HTTP/2
+            setOption(CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+#endif
+#if LIBCURL_VERSION_NUM >= 0x072b00
+            // wait for a connection to multiplex on instead of opening a new one
+            setOption(CURLOPT_PIPEWAIT, 1L);
+#endif
+        }
+
+        bool ok = setOption(CURLOPT_PRIVATE, this)
+                && setOption(CURLOPT_URL, _request->getUrl())
+                && setOption(CURLOPT_WRITEFUNCTION, writeData)
+                && setOption(CURLOPT_WRITEDATA, _response->getResponseData())
+                && setOption(CURLOPT_HEADERFUNCTION, writeHeaderData)
+                && setOption(CURLOPT_HEADERDATA, _response->getResponseHeader());
+        if (!ok)
             return false;
-        CURLcode code = curl_easy_getinfo(_curl, CURLINFO_RESPONSE_CODE, responseCode);
-        if (code != CURLE_OK || !(*responseCode >= 200 && *responseCode < 300)) {
-            CCLOGERROR("Curl curl_easy_getinfo failed: %s", curl_easy_strerror(code));
+
+        switch (_request->getRequestType())
+        {
+        case HttpRequest::Type::GET: // HTTP GET
+            return setOption(CURLOPT_FOLLOWLOCATION, 1L);
+
+        case HttpRequest::Type::POST: // HTTP POST
+            return setOption(CURLOPT_POST, 1L)
+                && setOption(CURLOPT_POSTFIELDS, _request->getRequestData())
+                && setOption(CURLOPT_POSTFIELDSIZE, (long)_request->getRequestDataSize());
+
+        case HttpRequest::Type::PUT:
+            return setOption(CURLOPT_CUSTOMREQUEST, "PUT")
+                && setOption(CURLOPT_POSTFIELDS, _request->getRequestData())
+                && setOption(CURLOPT_POSTFIELDSIZE, (long)_request->getRequestDataSize());
+
+        case HttpRequest::Type::DELETE:
+            return setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
+                && setOption(CURLOPT_FOLLOWLOCATION, 1L);
+
+        default:
+            CCASSERT(false, "CCHttpClient: unknown request type, only GET, POST, PUT or DELETE is supported");
             return false;
         }
-        // Get some mor data.
-        
-        return true;
     }
+
+    /// @param result Result of the transfer, CURLE_OK if it completed
+    void finish(CURLcode result)
+    {
+        long responseCode = -1;
+        bool succeed = false;
+        if (result == CURLE_OK)
+        {
+            CURLcode code = curl_easy_getinfo(_curl, CURLINFO_RESPONSE_CODE, &responseCode);
+            succeed = code == CURLE_OK && responseCode >= 200 && responseCode < 300;
+            if (!succeed) {
+                CCLOGERROR("Curl curl_easy_getinfo failed: %s", curl_easy_strerror(code));
+            }
+        }
+
+        // write data to HttpResponse
+        _response->setResponseCode(responseCode);
+        _response->setSucceed(succeed);
+        if (!succeed)
+        {
+            _response->setErrorBuffer(_errorBuffer);
+        }
+    }
+
+private:
+    HttpRequest* _request;
+    HttpResponse* _response;
+    /// Instance of CURL
+    CURL* _curl;
+    /// Keeps custom header data
+    curl_slist* _headers;
+    char _errorBuffer[CURL_ERROR_SIZE];
 };
 
-//Process Get Request
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+static void wakeupMulti(void* multi)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+#if HTTP_CURL_HAS_WAKEUP
+    if (multi)
+    {
+        curl_multi_wakeup((CURLM*)multi);
+    }
+#endif
 }
 
-//Process POST Request
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+// Worker thread, drives all transfers on one multi handle
+void HttpClient::networkThread()
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_POST, 1)
-            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
+    increaseThreadCount();
 
-//Process PUT Request
-static int processPutTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
-{
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "PUT")
-            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
+    CURLM* multi = curl_multi_init();
+    CURLSH* share = curl_share_init();
+    if (share)
+    {
+        // only this thread touches the share handle, so no lock callbacks are needed
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
+    }
+#if LIBCURL_VERSION_NUM >= 0x072b00
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
 
-//Process DELETE Request
-static int processDeleteTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
-{
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    _requestQueueMutex.lock();
+    _multiHandle = multi;
+    _requestQueueMutex.unlock();
+
+    if (!multi)
+    {
+        CCLOGERROR("HttpClient: curl_multi_init failed");
+    }
+
+    std::vector<CURL*> idleHandles;
+    std::vector<HttpRequest*> requests;
+    std::unordered_set<HttpTransfer*> transfers;
+    int maxConnectionsPerHost = -1;
+
+    auto releaseHandle = [&](HttpTransfer* transfer) {
+        CURL* curl = transfer->getHandle();
+        curl_multi_remove_handle(multi, curl);
+        delete transfer;
+
+        // write the shared cookies back to the cookie file as a finished easy handle would do
+        if (!getCookieFilename().empty())
+        {
+            curl_easy_setopt(curl, CURLOPT_COOKIELIST, "FLUSH");
+        }
+
+        if (idleHandles.size() < HTTP_MAX_IDLE_HANDLES)
+        {
+            curl_easy_reset(curl);
+            idleHandles.push_back(curl);
+        }
+        else
+        {
+            curl_easy_cleanup(curl);
+        }
+    };
+
+    auto pushResponse = [this](HttpResponse* response) {
+        // add response packet into queue
+        _responseQueueMutex.lock();
+        _responseQueue.pushBack(response);
+        _responseQueueMutex.unlock();
+
+        _schedulerMutex.lock();
+        if (auto sche = _scheduler.lock())
+        {
+            sche->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
+        }
+        _schedulerMutex.unlock();
+    };
+
+    bool quit = false;
+    while (multi)
+    {
+        // step 1: take new requests, sleep if there is nothing to transfer
+        {
+            std::lock_guard<std::mutex> lock(_requestQueueMutex);
+            while (_requestQueue.empty() && transfers.empty())
+            {
+                _sleepCondition.wait(_requestQueueMutex);
+            }
+            for (auto request : _requestQueue)
+            {
+                if (request == _requestSentinel)
+                {
+                    quit = true;
+                    break;
+                }
+                requests.push_back(request);
+            }
+            // requests are still retained by send
+            _requestQueue.clear();
+        }
+
+        if (quit)
+        {
+            break;
+        }
+
+        int maxPerHost = getMaxConnectionsPerHost();
+        if (maxPerHost != maxConnectionsPerHost)
+        {
+            maxConnectionsPerHost = maxPerHost;
+            curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)std::max(maxPerHost, 0));
+        }
+
+        // step 2: start transfers of new requests
+        bool http2 = isHttp2Enabled();
+        for (auto request : requests)
+        {
+            // Create a HttpResponse object, the default setting is http access failed
+            HttpResponse *response = new (std::nothrow) HttpResponse(request);
+
+            CURL* curl = nullptr;
+            if (!idleHandles.empty())
+            {
+                curl = idleHandles.back();
+                idleHandles.pop_back();
+            }
+            else
+            {
+                curl = curl_easy_init();
+            }
+
+            if (!curl)
+            {
+                response->setSucceed(false);
+                response->setErrorBuffer("Curl curl_easy_init failed");
+                pushResponse(response);
+                continue;
+            }
+
+            HttpTransfer* transfer = new HttpTransfer(request, response, curl);
+            if (!transfer->init(this, share, http2) || curl_multi_add_handle(multi, curl) != CURLM_OK)
+            {
+                transfer->finish(CURLE_FAILED_INIT);
+                releaseHandle(transfer);
+                pushResponse(response);
+                continue;
+            }
+            transfers.insert(transfer);
+        }
+        requests.clear();
+
+        if (transfers.empty())
+        {
+            continue;
+        }
+
+        // step 3: drive transfers and collect finished ones
+        int runningHandles = 0;
+        curl_multi_perform(multi, &runningHandles);
+
+        CURLMsg* msg = nullptr;
+        int msgq = 0;
+        while ((msg = curl_multi_info_read(multi, &msgq)) != nullptr)
+        {
+            if (msg->msg != CURLMSG_DONE)
+            {
+                continue;
+            }
+
+            HttpTransfer* transfer = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char**)&transfer);
+            CURLcode result = msg->data.result;
+            HttpResponse* response = transfer->getResponse();
+            transfer->finish(result);
+            transfers.erase(transfer);
+            releaseHandle(transfer);
+
+            pushResponse(response);
+        }
+
+        if (!transfers.empty())
+        {
+#if HTTP_CURL_HAS_WAKEUP
+            curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+#else
+            int numfds = 0;
+            curl_multi_wait(multi, nullptr, 0, HTTP_POLL_INTERVAL_MS, &numfds);
+            if (numfds == 0)
+            {
+                // older curl returns at once if no socket is ready to wait on yet, e.g. while resolving
+                std::this_thread::sleep_for(std::chrono::milliseconds(HTTP_POLL_INTERVAL_MS));
+            }
+#endif
+        }
+    }
+
+    _requestQueueMutex.lock();
+    _multiHandle = nullptr;
+    _requestQueueMutex.unlock();
+
+    // cleanup: abort transfers still running, their callbacks are never invoked,
+    // so the retain of send is released here as dispatchResponseCallbacks would do
+    for (auto transfer : transfers)
+    {
+        CURL* curl = transfer->getHandle();
+        curl_multi_remove_handle(multi, curl);
+        curl_easy_cleanup(curl);
+        transfer->getResponse()->release();
+        transfer->getRequest()->release();
+        delete transfer;
+    }
+    // requests taken together with the quit signal are never started
+    for (auto request : requests)
+    {
+        request->release();
+    }
+    requests.clear();
+    if (multi)
+    {
+        curl_multi_cleanup(multi);
+    }
+    for (auto curl : idleHandles)
+    {
+        curl_easy_cleanup(curl);
+    }
+    if (share)
+    {
+        curl_share_cleanup(share);
+    }
+
+    // cleanup: if worker thread received quit signal, clean up un-completed request queue
+    _requestQueueMutex.lock();
+    _requestQueue.clear();
+    _requestQueueMutex.unlock();
+
+    _responseQueueMutex.lock();
+    _responseQueue.clear();
+    _responseQueueMutex.unlock();
+
+    decreaseThreadCountAndMayDeleteThis();
 }
 
 // HttpClient implementation
@@ -367,6 +549,7 @@ void HttpClient::destroyInstance()
 
     thiz->_requestQueueMutex.lock();
     thiz->_requestQueue.pushBack(thiz->_requestSentinel);
+    wakeupMulti(thiz->_multiHandle);
     thiz->_requestQueueMutex.unlock();
 
     thiz->_sleepCondition.notify_one();
@@ -448,6 +631,7 @@ void HttpClient::send(HttpRequest* request)
 
     _requestQueueMutex.lock();
     _requestQueue.pushBack(request);
+    wakeupMulti(_multiHandle);
     _requestQueueMutex.unlock();
 
     // Notify thread start to work
@@ -456,17 +640,25 @@ void HttpClient::send(HttpRequest* request)
 
 void HttpClient::sendImmediate(HttpRequest* request)
 {
+    if (false == lazyInitThreadSemaphore())
+    {
+        return;
+    }
+
     if(!request)
     {
         return;
     }
 
     request->retain();
-    // Create a HttpResponse object, the default setting is http access failed
-    HttpResponse *response = new (std::nothrow) HttpResponse(request);
 
-    auto t = std::thread(&HttpClient::networkThreadAlone, this, request, response);
-    t.detach();
+    // transfers run concurrently, so jumping the queue is enough to not wait for other requests
+    _requestQueueMutex.lock();
+    _requestQueue.insert(0, request);
+    wakeupMulti(_multiHandle);
+    _requestQueueMutex.unlock();
+
+    _sleepCondition.notify_one();
 }
 
 // Poll and notify main thread if responses exists in queue
@@ -500,74 +692,6 @@ void HttpClient::dispatchResponseCallbacks()
     }
 }
 
-// Process Response
-void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
-{
-    auto request = response->getHttpRequest();
-    long responseCode = -1;
-    int retValue = 0;
-
-    // Process the request -> get response packet
-    switch (request->getRequestType())
-    {
-    case HttpRequest::Type::GET: // HTTP GET
-        retValue = processGetTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    case HttpRequest::Type::POST: // HTTP POST
-        retValue = processPostTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    case HttpRequest::Type::PUT:
-        retValue = processPutTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    case HttpRequest::Type::DELETE:
-        retValue = processDeleteTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    default:
-        CCASSERT(false, "CCHttpClient: unknown request type, only GET, POST, PUT or DELETE is supported");
-        break;
-    }
-
-    // write data to HttpResponse
-    response->setResponseCode(responseCode);
-    if (retValue != 0)
-    {
-        response->setSucceed(false);
-        response->setErrorBuffer(responseMessage);
-    }
-    else
-    {
-        response->setSucceed(true);
-    }
-}
-
 void HttpClient::increaseThreadCount()
 {
     _threadCountMutex.lock();
@@ -29,6 +29,7 @@
 #define __CCHTTPCLIENT_H__
 
 #include <thread>
+#include <atomic>
 #include <condition_variable>
 #include "base/CCVector.h"
 #include "network/HttpRequest.h"
@@ -149,6 +150,36 @@ public:
      */
     CC_DEPRECATED_ATTRIBUTE int getTimeoutForRead();
 
+    /**
+     * Set the max connection count to a single host, more requests to the host wait for a free connection.
+     * Only the curl based client on desktop platforms honors it.
+     *
+     * @param value the max connection count to a single host, 0 means no limit. Default is 6.
+     */
+    void setMaxConnectionsPerHost(int value) { _maxConnectionsPerHost = value; }
+
+    /**
+     * Get the max connection count to a single host.
+     *
+     * @return int the max connection count to a single host.
+     */
+    int getMaxConnectionsPerHost() const { return _maxConnectionsPerHost; }
+
+    /**
+     * Enable HTTP/2, requests to the same host are multiplexed over one connection if the server supports it.
+     * Only the curl based client on desktop platforms honors it.
+     *
+     * @param enabled whether HTTP/2 is used. Default is false.
+     */
+    void setHttp2Enabled(bool enabled) { _http2Enabled = enabled; }
+
+    /**
+     * Get whether HTTP/2 is enabled.
+     *
+     * @return bool whether HTTP/2 is enabled.
+     */
+    bool isHttp2Enabled() const { return _http2Enabled; }
+
     HttpCookie* getCookie() const {return _cookie; }
 
     std::mutex& getCookieFileMutex() {return _cookieFileMutex;}
@@ -207,6 +238,12 @@ private:
     char _responseMessage[RESPONSE_BUFFER_SIZE];
 
     HttpRequest* _requestSentinel;
+
+    std::atomic<int> _maxConnectionsPerHost{6};
+    std::atomic<bool> _http2Enabled{false};
+
+    // curl multi handle of the network thread, guarded by _requestQueueMutex
+    void* _multiHandle = nullptr;
 };
 
 } // namespace network
@@ -234,6 +234,16 @@ void WebSocket::closeAllConnections()
     }
 }
 
+bool WebSocket::retainMessageData(const Data& data)
+{
+    // Received bytes are owned by NSData/NSString, they're only valid in onMessage
+    return false;
+}
+
+void WebSocket::releaseMessageData(void* ext)
+{
+}
+
 WebSocket::WebSocket()
 : _impl(nil)
 {
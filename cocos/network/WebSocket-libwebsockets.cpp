@@ -53,6 +53,10 @@
 
 #define WS_RX_BUFFER_SIZE (65536)
 #define WS_RESERVE_RECEIVE_BUFFER_SIZE (4096)
+// received messages are packed into pooled buffers of this size, larger messages get a dedicated buffer
+#define WS_RECEIVE_POOL_BUFFER_SIZE (65536)
+#define WS_RECEIVE_POOL_MAX_BUFFERS (8)
+#define WS_RECEIVE_MESSAGE_ALIGN (8)
 
 #define  LOG_TAG    "WebSocket.cpp"
 
@@ -177,6 +181,8 @@ static void printWebSocketLog(int level, const char *line)
 #endif // #if COCOS2D_DEBUG > 0
 }
 
+class WsReceiveBuffer;
+
 class WebSocketImpl
 {
 public:
@@ -209,6 +215,7 @@ private:
 
     int onClientWritable();
     int onClientReceivedData(void* in, ssize_t len);
+    bool reserveReceiveBuffer(size_t len);
     int onConnectionOpened();
     int onConnectionError();
     int onConnectionClosed();
@@ -220,7 +227,9 @@ private:
     cocos2d::network::WebSocket::State _readyState;
     std::mutex  _readyStateMutex;
     std::string _url;
-    std::vector<char> _receivedData;
+    // The buffer the message being received is written to, the message starts at _receivedOffset.
+    WsReceiveBuffer* _receiveBuffer;
+    size_t _receivedOffset;
 
     struct lws* _wsInstance;
     struct lws_protocols* _lwsProtocols;
@@ -332,6 +341,133 @@ private:
 
 unsigned int WsMessage::__id = 0;
 
+/**
+ *  @brief A reference counted buffer which received messages are packed into.
+ *  Every message delivered to Cocos thread holds a reference of the buffer it lives in, so the bytes
+ *  could be handed to script without copying. Buffers go back to a pool once the last reference is released,
+ *  release could be invoked on any thread.
+ */
+class WsReceiveBuffer
+{
+public:
+    // Gets a buffer which is able to hold at least capacity bytes, its reference count is 1.
+    static WsReceiveBuffer* create(size_t capacity);
+
+    void retain() { _refCount.fetch_add(1, std::memory_order_relaxed); }
+    void release();
+
+    char* getData() { return _data; }
+    size_t getCapacity() const { return _capacity; }
+    size_t getUsed() const { return _used; }
+    size_t getRemain() const { return _capacity - _used; }
+
+    // The following methods are only invoked by the websocket thread which owns the buffer for writing.
+    void append(const void* data, size_t len)
+    {
+        memcpy(_data + _used, data, len);
+        _used += len;
+    }
+    void align()
+    {
+        _used = std::min(_capacity, (_used + WS_RECEIVE_MESSAGE_ALIGN - 1) & ~(size_t)(WS_RECEIVE_MESSAGE_ALIGN - 1));
+    }
+
+private:
+    WsReceiveBuffer(size_t capacity);
+    ~WsReceiveBuffer();
+
+    std::atomic<int> _refCount;
+    size_t _capacity;
+    size_t _used;
+    char* _data;
+
+    static std::mutex& getPoolMutex();
+    static std::vector<WsReceiveBuffer*>& getPool();
+};
+
+WsReceiveBuffer::WsReceiveBuffer(size_t capacity)
+: _refCount(1)
+, _capacity(capacity)
+, _used(0)
+, _data((char*)malloc(capacity))
+{
+}
+
+WsReceiveBuffer::~WsReceiveBuffer()
+{
+    free(_data);
+}
+
+std::mutex& WsReceiveBuffer::getPoolMutex()
+{
+    // never destroyed, script garbage collection may release buffers very late while exiting
+    static std::mutex* mutex = new (std::nothrow) std::mutex();
+    return *mutex;
+}
+
+std::vector<WsReceiveBuffer*>& WsReceiveBuffer::getPool()
+{
+    static std::vector<WsReceiveBuffer*>* pool = new (std::nothrow) std::vector<WsReceiveBuffer*>();
+    return *pool;
+}
+
+WsReceiveBuffer* WsReceiveBuffer::create(size_t capacity)
+{
+    if (capacity <= WS_RECEIVE_POOL_BUFFER_SIZE)
+    {
+        std::lock_guard<std::mutex> lk(getPoolMutex());
+        auto& pool = getPool();
+        if (!pool.empty())
+        {
+            WsReceiveBuffer* buffer = pool.back();
+            pool.pop_back();
+            buffer->_refCount.store(1, std::memory_order_relaxed);
+            buffer->_used = 0;
+            return buffer;
+        }
+        capacity = WS_RECEIVE_POOL_BUFFER_SIZE;
+    }
+
+    WsReceiveBuffer* buffer = new (std::nothrow) WsReceiveBuffer(capacity);
+    if (buffer != nullptr && buffer->_data == nullptr)
+    {
+        delete buffer;
+        buffer = nullptr;
+    }
+    return buffer;
+}
+
+void WsReceiveBuffer::release()
+{
+    if (_refCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    if (_capacity == WS_RECEIVE_POOL_BUFFER_SIZE)
+    {
+        std::lock_guard<std::mutex> lk(getPoolMutex());
+        auto& pool = getPool();
+        if (pool.size() < WS_RECEIVE_POOL_MAX_BUFFERS)
+        {
+            pool.push_back(this);
+            return;
+        }
+    }
+    delete this;
+}
+
+// A complete message waiting to be delivered to Cocos thread, it holds a reference of its buffer.
+// An open/error/close notification has no buffer, it's queued with the messages to keep their order.
+struct WsReceivedMessage
+{
+    WebSocketImpl* ws = nullptr;
+    std::shared_ptr<std::atomic<bool>> isDestroyed;
+    WsReceiveBuffer* buffer = nullptr;
+    size_t offset = 0;
+    ssize_t len = 0;
+    bool isBinary = false;
+    std::function<void()> notify;
+};
+
 /**
  *  @brief Websocket thread helper, it's used for sending message between UI thread and websocket thread.
  */
@@ -349,6 +485,13 @@ public:
     // Sends message to Cocos thread. It's needed to be invoked in Websocket thread.
     void sendMessageToCocosThread(const std::function<void()>& cb);
 
+    // Queues a received message for Cocos thread. It's needed to be invoked in Websocket thread.
+    // Messages are delivered in batches, at most one callback is scheduled until the queue is flushed.
+    void sendReceivedMessageToCocosThread(WsReceivedMessage&& msg);
+
+    // Queues an open/error/close notification behind the received messages. It's needed to be invoked in Websocket thread.
+    void sendNotificationToCocosThread(const std::function<void()>& cb);
+
     // Sends message to Websocket thread. It's needs to be invoked in Cocos thread.
     void sendMessageToWebSocketThread(WsMessage *msg);
 
@@ -363,6 +506,8 @@ public:
 
 protected:
     void wsThreadEntryFunc();
+    // Delivers all queued messages, it's invoked in Cocos thread.
+    static void flushReceivedMessages();
 public:
     std::list<WsMessage*>* _subThreadWsMessageQueue;
     std::mutex   _subThreadWsMessageQueueMutex;
@@ -504,6 +649,71 @@ void WsThreadHelper::sendMessageToCocosThread(const std::function<void()>& cb)
     cocos2d::Application::getInstance()->getScheduler()->performFunctionInCocosThread(cb);
 }
 
+// The queue isn't owned by __wsHelper, a scheduled flush may run after the last websocket instance is destroyed.
+static std::mutex __receivedMessagesMutex;
+static std::vector<WsReceivedMessage> __receivedMessages;
+
+void WsThreadHelper::sendReceivedMessageToCocosThread(WsReceivedMessage&& msg)
+{
+    bool needFlush = false;
+    {
+        std::lock_guard<std::mutex> lk(__receivedMessagesMutex);
+        // A non-empty queue always has a flush callback pending. Notifications go through the same queue,
+        // a message of one socket can't be flushed before its open or after its close.
+        needFlush = __receivedMessages.empty();
+        __receivedMessages.push_back(std::move(msg));
+    }
+
+    if (needFlush)
+    {
+        sendMessageToCocosThread(&WsThreadHelper::flushReceivedMessages);
+    }
+}
+
+void WsThreadHelper::sendNotificationToCocosThread(const std::function<void()>& cb)
+{
+    WsReceivedMessage msg;
+    msg.notify = cb;
+    sendReceivedMessageToCocosThread(std::move(msg));
+}
+
+void WsThreadHelper::flushReceivedMessages()
+{
+    // In UI thread
+    static std::vector<WsReceivedMessage> messages;
+    {
+        std::lock_guard<std::mutex> lk(__receivedMessagesMutex);
+        messages.swap(__receivedMessages);
+    }
+
+    LOGD("Notify %d messages to Cocos thread.\n", (int)messages.size());
+
+    for (auto& msg : messages)
+    {
+        if (msg.notify)
+        {
+            msg.notify();
+            continue;
+        }
+
+        if (*msg.isDestroyed)
+        {
+            LOGD("WebSocket instance was destroyed!\n");
+        }
+        else
+        {
+            cocos2d::network::WebSocket::Data data;
+            data.isBinary = msg.isBinary;
+            data.bytes = msg.buffer->getData() + msg.offset;
+            data.len = msg.len;
+            data.ext = msg.buffer;
+            msg.ws->_delegate->onMessage(msg.ws->_ws, data);
+        }
+        msg.buffer->release();
+    }
+    messages.clear();
+}
+
 void WsThreadHelper::sendMessageToWebSocketThread(WsMessage *msg)
 {
     std::lock_guard<std::mutex> lk(_subThreadWsMessageQueueMutex);
@@ -607,14 +817,14 @@ void WebSocketImpl::closeAllConnections()
 WebSocketImpl::WebSocketImpl(cocos2d::network::WebSocket* ws)
 : _ws(ws)
 , _readyState(cocos2d::network::WebSocket::State::CONNECTING)
+, _receiveBuffer(nullptr)
+, _receivedOffset(0)
 , _wsInstance(nullptr)
 , _lwsProtocols(nullptr)
 , _isDestroyed(std::make_shared<std::atomic<bool>>(false))
 , _delegate(nullptr)
 , _closeState(CloseState::NONE)
 {
-    // reserve data buffer to avoid allocate memory frequently
-    _receivedData.reserve(WS_RESERVE_RECEIVE_BUFFER_SIZE);
     if (__websocketInstances == nullptr)
     {
         __websocketInstances = new (std::nothrow) std::vector<WebSocketImpl*>();
@@ -667,6 +877,12 @@ WebSocketImpl::~WebSocketImpl()
 // NOTE: Refer to the comment in constructor!!!
 //    cocos2d::Director::getInstance()->getEventDispatcher()->removeEventListener(_resetDirectorListener);
 
+    if (_receiveBuffer != nullptr)
+    {
+        _receiveBuffer->release();
+        _receiveBuffer = nullptr;
+    }
+
     *_isDestroyed = true;
 }
 
@@ -1224,6 +1440,34 @@ int WebSocketImpl::onClientWritable()
     return 0;
 }
 
+bool WebSocketImpl::reserveReceiveBuffer(size_t len)
+{
+    // In websocket thread
+    if (_receiveBuffer != nullptr && _receiveBuffer->getRemain() >= len)
+        return true;
+
+    // Moves the partial message to a buffer which is large enough, it only happens once in a while
+    // since messages are usually much smaller than a pooled buffer.
+    size_t receivedSize = _receiveBuffer != nullptr ? _receiveBuffer->getUsed() - _receivedOffset : 0;
+    // Grows geometrically, a huge message split into many fragments shouldn't be copied again and again.
+    size_t capacity = std::max(receivedSize + len, receivedSize * 2);
+    WsReceiveBuffer* buffer = WsReceiveBuffer::create(std::max(capacity, (size_t)WS_RESERVE_RECEIVE_BUFFER_SIZE));
+    if (buffer == nullptr)
+    {
+        LOGE("Couldn't allocate %d bytes for received data!\n", (int)(receivedSize + len));
+        return false;
+    }
+
+    if (_receiveBuffer != nullptr)
+    {
+        buffer->append(_receiveBuffer->getData() + _receivedOffset, receivedSize);
+        _receiveBuffer->release();
+    }
+    _receiveBuffer = buffer;
+    _receivedOffset = 0;
+    return true;
+}
+
 int WebSocketImpl::onClientReceivedData(void* in, ssize_t len)
 {
     // In websocket thread
@@ -1233,8 +1477,10 @@ int WebSocketImpl::onClientReceivedData(void* in, ssize_t len)
     {
         LOGD("Receiving data:index:%d, len=%d\n", packageIndex, (int)len);
 
-        unsigned char* inData = (unsigned char*)in;
-        _receivedData.insert(_receivedData.end(), inData, inData + len);
+        // Reserves the rest of the frame and one more byte for the '\0' of text message
+        if (!reserveReceiveBuffer(len + lws_remaining_packet_payload(_wsInstance) + 1))
+            return -1;
+        _receiveBuffer->append(in, len);
     }
     else
     {
@@ -1248,41 +1494,35 @@ int WebSocketImpl::onClientReceivedData(void* in, ssize_t len)
 
     if (remainingSize == 0 && isFinalFragment)
     {
-        std::vector<char>* frameData = new (std::nothrow) std::vector<char>(std::move(_receivedData));
-
-        // reset capacity of received data buffer
-        _receivedData.reserve(WS_RESERVE_RECEIVE_BUFFER_SIZE);
-
-        ssize_t frameSize = frameData->size();
+        if (!reserveReceiveBuffer(1))
+            return -1;
 
-        bool isBinary = (lws_frame_is_binary(_wsInstance) != 0);
+        WsReceivedMessage msg;
+        msg.ws = this;
+        msg.isDestroyed = _isDestroyed;
+        msg.buffer = _receiveBuffer;
+        msg.offset = _receivedOffset;
+        msg.len = _receiveBuffer->getUsed() - _receivedOffset;
+        msg.isBinary = (lws_frame_is_binary(_wsInstance) != 0);
 
-        if (!isBinary)
+        if (!msg.isBinary)
         {
-            frameData->push_back('\0');
+            char end = '\0';
+            _receiveBuffer->append(&end, 1);
         }
 
-        std::shared_ptr<std::atomic<bool>> isDestroyed = _isDestroyed;
-        __wsHelper->sendMessageToCocosThread([this, frameData, frameSize, isBinary, isDestroyed](){
-            // In UI thread
-            LOGD("Notify data len %d to Cocos thread.\n", (int)frameSize);
-
-            cocos2d::network::WebSocket::Data data;
-            data.isBinary = isBinary;
-            data.bytes = (char*)frameData->data();
-            data.len = frameSize;
-
-            if (*isDestroyed)
-            {
-                LOGD("WebSocket instance was destroyed!\n");
-            }
-            else
-            {
-                _delegate->onMessage(_ws, data);
-            }
+        // The message keeps the buffer alive until it's consumed, next message is packed right after it.
+        _receiveBuffer->retain();
+        _receiveBuffer->align();
+        _receivedOffset = _receiveBuffer->getUsed();
+        if (_receiveBuffer->getRemain() < WS_RESERVE_RECEIVE_BUFFER_SIZE)
+        {
+            _receiveBuffer->release();
+            _receiveBuffer = nullptr;
+            _receivedOffset = 0;
+        }
 
-            delete frameData;
-        });
+        __wsHelper->sendReceivedMessageToCocosThread(std::move(msg));
     }
 
     return 0;
@@ -1309,7 +1549,7 @@ int WebSocketImpl::onConnectionOpened()
     }
 
     std::shared_ptr<std::atomic<bool>> isDestroyed = _isDestroyed;
-    __wsHelper->sendMessageToCocosThread([this, isDestroyed](){
+    __wsHelper->sendNotificationToCocosThread([this, isDestroyed](){
         if (*isDestroyed)
         {
             LOGD("WebSocket instance was destroyed!\n");
@@ -1335,7 +1575,7 @@ int WebSocketImpl::onConnectionError()
     }
 
     std::shared_ptr<std::atomic<bool>> isDestroyed = _isDestroyed;
-    __wsHelper->sendMessageToCocosThread([this, isDestroyed](){
+    __wsHelper->sendNotificationToCocosThread([this, isDestroyed](){
         if (*isDestroyed)
         {
             LOGD("WebSocket instance was destroyed!\n");
@@ -1397,7 +1637,7 @@ int WebSocketImpl::onConnectionClosed()
     }
 
     std::shared_ptr<std::atomic<bool>> isDestroyed = _isDestroyed;
-    __wsHelper->sendMessageToCocosThread([this, isDestroyed](){
+    __wsHelper->sendNotificationToCocosThread([this, isDestroyed](){
         if (*isDestroyed)
         {
             LOGD("WebSocket instance (%p) was destroyed!\n", this);
@@ -1470,6 +1710,31 @@ void WebSocket::closeAllConnections()
     WebSocketImpl::closeAllConnections();
 }
 
+/*static*/
+bool WebSocket::retainMessageData(const Data& data)
+{
+    if (data.ext == nullptr)
+        return false;
+
+    // A small message would pin a whole pooled buffer while script only accounts for its own length,
+    // only messages which take at least half of their buffer are shared.
+    WsReceiveBuffer* buffer = (WsReceiveBuffer*)data.ext;
+    if ((size_t)data.len * 2 < buffer->getCapacity())
+        return false;
+
+    buffer->retain();
+    return true;
+}
+
+/*static*/
+void WebSocket::releaseMessageData(void* ext)
+{
+    if (ext != nullptr)
+    {
+        ((WsReceiveBuffer*)ext)->release();
+    }
+}
+
 WebSocket::WebSocket()
 {
     _impl = new (std::nothrow) WebSocketImpl(this);
@@ -100,6 +100,23 @@ public:
         ssize_t getRemain() { return std::max((ssize_t)0, len - issued); }
     };
 
+    /**
+     * Keeps the storage of a received message alive after Delegate::onMessage returns,
+     * so that the bytes could be used without copying them.
+     * @param data The message data passed to Delegate::onMessage.
+     * @return true if the storage is retained, it has to be released by releaseMessageData with data.ext.
+     *         false if the message isn't backed by shared storage, or it takes less than half of the storage,
+     *         which is not worth pinning, the bytes have to be copied in onMessage then.
+     */
+    static bool retainMessageData(const Data& data);
+
+    /**
+     * Releases the storage retained by retainMessageData.
+     * @param ext The ext field of the retained message data.
+     * @note This method could be invoked on any thread.
+     */
+    static void releaseMessageData(void* ext);
+
     /**
      * ErrorCode enum used to represent the error in the websocket.
      */
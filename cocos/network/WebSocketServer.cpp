@@ -36,6 +36,10 @@
 
 #define MAX_MSG_PAYLOAD 2048
 #define SEND_BUFF 1024
+// frames a connection could queue before sends are rejected
+#define SEND_QUEUE_SIZE 4096
+// bytes written in one writable callback at most, small frames are drained together
+#define SEND_BUDGET (SEND_BUFF * 64)
 
 namespace {
 
@@ -182,6 +186,54 @@ std::string DataFrame::toString()
     return std::string((char*)getData(), size());
 }
 
+SendQueue::SendQueue(size_t capacity)
+: _capacity(capacity)
+{
+    _tail = new Node();
+    _head.store(_tail, std::memory_order_relaxed);
+}
+
+SendQueue::~SendQueue()
+{
+    std::shared_ptr<DataFrame> frame;
+    while (pop(frame));
+    delete _tail;
+}
+
+bool SendQueue::push(std::shared_ptr<DataFrame>& frame)
+{
+    // reserve a slot first, the count may run ahead of the linked nodes but never beyond capacity
+    if (_size.fetch_add(1, std::memory_order_relaxed) >= _capacity) {
+        _size.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Node* node = new Node();
+    node->frame = std::move(frame);
+    Node* prev = _head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+    return true;
+}
+
+bool SendQueue::pop(std::shared_ptr<DataFrame>& frame)
+{
+    Node* next = _tail->next.load(std::memory_order_acquire);
+    if (!next) {
+        // empty, or the producer which took the head hasn't linked its node yet
+        return false;
+    }
+    frame = std::move(next->frame);
+    delete _tail;
+    _tail = next;
+    _size.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+size_t SendQueue::size() const
+{
+    return _size.load(std::memory_order_relaxed);
+}
+
 WebSocketServer::WebSocketServer()
 {
     _aliveServer.fetch_add(1);
@@ -419,7 +471,7 @@ void WebSocketServer::destroyContext()
     }
 }
 
-WebSocketServerConnection::WebSocketServerConnection(struct lws* wsi) : _wsi(wsi)
+WebSocketServerConnection::WebSocketServerConnection(struct lws* wsi) : _wsi(wsi), _sendQueue(SEND_QUEUE_SIZE)
 {
     LOGE();
     uv_loop_t* loop = lws_uv_getloop(lws_get_context(wsi), 0);
@@ -438,8 +490,25 @@ WebSocketServerConnection::~WebSocketServerConnection()
 
 bool WebSocketServerConnection::send(std::shared_ptr<DataFrame> data)
 {
-    _sendQueue.emplace_back(data);
-    onDrainData();
+    // in any thread
+    size_t len = data->size();
+    if (!_sendQueue.push(data))
+    {
+        _rejectedFrames.fetch_add(1, std::memory_order_relaxed);
+        data->onFinish("Error: Send queue is full!");
+        return false;
+    }
+
+    _queuedFrames.fetch_add(1, std::memory_order_relaxed);
+    size_t queuedBytes = _queuedBytes.fetch_add(len, std::memory_order_relaxed) + len;
+    size_t maxQueuedBytes = _maxQueuedBytes.load(std::memory_order_relaxed);
+    while (queuedBytes > maxQueuedBytes && !_maxQueuedBytes.compare_exchange_weak(maxQueuedBytes, queuedBytes, std::memory_order_relaxed));
+
+    // only the first frame of a burst wakes up server thread, the rest are drained by the same writable callback
+    if (!_drainScheduled.exchange(true))
+    {
+        RUN_IN_SERVERTHREAD(this->scheduleSend());
+    }
     return true;
 }
 
@@ -451,7 +520,7 @@ void WebSocketServerConnection::sendTextAsync(const std::string& text, std::func
     if (callback) {
         DISPATCH_CALLBACK_IN_GAMETHREAD();
     }
-    RUN_IN_SERVERTHREAD(this->send(data));
+    send(data);
 }
 
 void WebSocketServerConnection::sendBinaryAsync(const void* in, size_t len, std::function<void(const std::string&)> callback)
@@ -461,7 +530,28 @@ void WebSocketServerConnection::sendBinaryAsync(const void* in, size_t len, std:
     if (callback) {
         DISPATCH_CALLBACK_IN_GAMETHREAD();
     }
-    RUN_IN_SERVERTHREAD(this->send(data));
+    send(data);
+}
+
+void WebSocketServerConnection::finishFrame(std::shared_ptr<DataFrame>& frame, const std::string& message)
+{
+    _queuedFrames.fetch_sub(1, std::memory_order_relaxed);
+    _queuedBytes.fetch_sub(frame->remain(), std::memory_order_relaxed);
+    frame->onFinish(message);
+    frame.reset();
+}
+
+WebSocketServerConnection::SendStats WebSocketServerConnection::getSendStats() const
+{
+    SendStats stats;
+    stats.queuedFrames = _queuedFrames.load(std::memory_order_relaxed);
+    stats.queuedBytes = _queuedBytes.load(std::memory_order_relaxed);
+    stats.maxQueuedBytes = _maxQueuedBytes.load(std::memory_order_relaxed);
+    stats.sentFrames = _sentFrames.load(std::memory_order_relaxed);
+    stats.sentBytes = _sentBytes.load(std::memory_order_relaxed);
+    stats.rejectedFrames = _rejectedFrames.load(std::memory_order_relaxed);
+    stats.writableCallbacks = _writableCallbacks.load(std::memory_order_relaxed);
+    return stats;
 }
 
 bool WebSocketServerConnection::close(int code, std::string message)
@@ -486,6 +576,11 @@ void WebSocketServerConnection::closeAsync(int code, std::string message)
 void WebSocketServerConnection::onConnected()
 {
     _readyState = ReadyState::OPEN;
+    // frames sent before the connection is open are drained now
+    if (!_sendQueue.empty())
+    {
+        scheduleSend();
+    }
     RUN_IN_GAMETHREAD(if(_onconnect)_onconnect());
 }
 
@@ -524,22 +619,33 @@ void WebSocketServerConnection::onDataReceive(void* in, int len)
 int WebSocketServerConnection::onDrainData()
 {
     LOGE();
+    // frames pushed from now on post a new wake up if this callback doesn't pick them up,
+    // it's cleared before any early return or sends would never wake up server thread again
+    _drainScheduled.store(false);
     if (!_wsi) return -1;
     if (_closed) return -1;
     if (_readyState == ReadyState::CLOSING) {
         return -1;
     }
     if (_readyState != ReadyState::OPEN) return 0;
+
+    _writableCallbacks.fetch_add(1, std::memory_order_relaxed);
+
     unsigned char* p = nullptr;
     int send_len = 0;
     int finish_len = 0;
-    int flags = 0;
+    int budget = SEND_BUDGET;
 
-    std::vector<char> buff(SEND_BUFF + LWS_PRE);
-
-    if (!_sendQueue.empty())
+    // keep writing queued frames until the budget is used up or the socket can't take more without blocking
+    while (budget > 0)
     {
-        std::shared_ptr<DataFrame> frag = _sendQueue.front();
+        if (!_sendingFrame && !_sendQueue.pop(_sendingFrame))
+        {
+            break;
+        }
+
+        std::shared_ptr<DataFrame>& frag = _sendingFrame;
+        int flags = 0;
 
         send_len = frag->slice(&p, SEND_BUFF);
 
@@ -568,25 +674,39 @@ int WebSocketServerConnection::onDrainData()
 
         finish_len = lws_write(_wsi, p, send_len, (lws_write_protocol)flags);
 
-        if (finish_len == 0)
+        if (finish_len == 0 && send_len > 0)
         {
-            frag->onFinish("Connection Closed");
+            finishFrame(frag, "Connection Closed");
             return -1;
         }
         else if (finish_len < 0)
         {
-            frag->onFinish("Send Error!");
+            finishFrame(frag, "Send Error!");
             return -1; 
         }
         else
         {
+            int remain = frag->remain();
             frag->consume(finish_len);
+            int consumed = remain - frag->remain();
+            _queuedBytes.fetch_sub(consumed, std::memory_order_relaxed);
+            _sentBytes.fetch_add(consumed, std::memory_order_relaxed);
+            budget -= finish_len;
         }
  
         if (frag->remain() == 0) {
-            frag->onFinish("");
-            _sendQueue.pop_front();
+            _sentFrames.fetch_add(1, std::memory_order_relaxed);
+            finishFrame(frag, "");
+        }
+
+        if (lws_send_pipe_choked(_wsi))
+        {
+            break;
         }
+    }
+
+    if (_sendingFrame || !_sendQueue.empty())
+    {
         lws_callback_on_writable(_wsi);
     }
 
@@ -647,6 +767,15 @@ void WebSocketServerConnection::onDestroyClient()
     //on wsi destroied
     if (_wsi)
     {
+        // notify the frames which will never be sent
+        if (_sendingFrame) {
+            finishFrame(_sendingFrame, "Connection Closed");
+        }
+        std::shared_ptr<DataFrame> frame;
+        while (_sendQueue.pop(frame)) {
+            finishFrame(frame, "Connection Closed");
+        }
+
         RUN_IN_GAMETHREAD(if(_onclose)_onclose(_closeCode, _closeReason));
         RUN_IN_GAMETHREAD(if(_onend) _onend());
         uv_close((uv_handle_t*)&_async, nullptr);
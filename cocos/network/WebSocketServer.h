@@ -103,9 +103,58 @@ namespace cocos2d {
 
         };
 
+        /**
+        * bounded multi-producer single-consumer queue of outgoing frames,
+        * producers on any thread never take a lock, only the server thread pops.
+        * A node is allocated per queued frame, so an idle connection only holds the stub node
+        */
+        class SendQueue {
+        public:
+
+            explicit SendQueue(size_t capacity);
+            ~SendQueue();
+
+            // moves frame into the queue, frame is left untouched if the queue is full
+            bool push(std::shared_ptr<DataFrame>& frame);
+
+            bool pop(std::shared_ptr<DataFrame>& frame);
+
+            size_t size() const;
+
+            inline bool empty() const { return size() == 0; }
+
+            inline size_t capacity() const { return _capacity; }
+
+        private:
+
+            struct Node {
+                std::atomic<Node*> next{nullptr};
+                std::shared_ptr<DataFrame> frame;
+            };
+
+            // producers append after _head, the consumer pops after _tail which is the last popped node
+            std::atomic<Node*> _head;
+            Node* _tail = nullptr;
+            std::atomic<size_t> _size{0};
+            size_t _capacity = 0;
+        };
+
         class CC_DLL WebSocketServerConnection {
         public:
 
+            /**
+            * statistics of the send queue, could be read on any thread
+            */
+            struct SendStats {
+                size_t queuedFrames = 0;    // frames waiting in the queue or being written
+                size_t queuedBytes = 0;     // payload bytes not written yet
+                size_t maxQueuedBytes = 0;  // high water mark of queuedBytes
+                uint64_t sentFrames = 0;
+                uint64_t sentBytes = 0;
+                uint64_t rejectedFrames = 0; // frames dropped since the queue was full
+                uint64_t writableCallbacks = 0;
+            };
+
             WebSocketServerConnection(struct lws* wsi);
             virtual ~WebSocketServerConnection();
 
@@ -140,6 +189,11 @@ namespace cocos2d {
 
             std::map<std::string, std::string> getHeaders();
 
+            /** bytes queued by sendTextAsync/sendBinaryAsync but not written to the socket yet */
+            inline size_t getBufferedAmount() const { return _queuedBytes.load(std::memory_order_relaxed); }
+
+            SendStats getSendStats() const;
+
             std::vector<std::string> getProtocols();
 
             inline void setOnClose(std::function<void(int, const std::string&)> cb)
@@ -186,6 +240,7 @@ namespace cocos2d {
 
             bool send(std::shared_ptr<DataFrame> data);
             bool close(int code, std::string reasson);
+            void finishFrame(std::shared_ptr<DataFrame>& frame, const std::string& message);
 
             inline void scheduleSend() {
                 if (_wsi)
@@ -202,7 +257,18 @@ namespace cocos2d {
 
             struct lws* _wsi = nullptr;
             std::map<std::string, std::string> _headers;
-            std::list<std::shared_ptr<DataFrame>> _sendQueue;
+            SendQueue _sendQueue;
+            // the frame being written, it's only accessed in server thread
+            std::shared_ptr<DataFrame> _sendingFrame;
+            // a wake up is posted to server thread, cleared once the queue is being drained
+            std::atomic<bool> _drainScheduled{false};
+            std::atomic<size_t> _queuedFrames{0};
+            std::atomic<size_t> _queuedBytes{0};
+            std::atomic<size_t> _maxQueuedBytes{0};
+            std::atomic<uint64_t> _sentFrames{0};
+            std::atomic<uint64_t> _sentBytes{0};
+            std::atomic<uint64_t> _rejectedFrames{0};
+            std::atomic<uint64_t> _writableCallbacks{0};
             std::shared_ptr<DataFrame> _prevPkg;
             bool _closed = false;
             std::string _closeReason = "close connection";
@@ -50,7 +50,7 @@ public:
     enum class Platform
     {
         WINDOWS,     /**< Windows */
-        LINUX,       /**< Linux */
+        LINUXOS,     /**< Linux, because LINUX is a macro, so use LINUXOS instead */
         MAC,         /**< Mac OS X*/
         ANDROIDOS,   /**< Android, because ANDROID is a macro, so use ANDROIDOS instead */
         IPHONE,      /**< iPhone */
@@ -0,0 +1,59 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_FILE_MAPPING_H__
+#define __CC_FILE_MAPPING_H__
+
+#include <cstddef>
+#include <string>
+
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/**
+ * Maps a file of the file system into memory. The mapping is private, so bytes written in memory never reach the file.
+ * @param fullPath Full path of the file, files packed in apk or obb can not be mapped.
+ * @param minSize The file is not mapped if it is smaller.
+ * @param size Byte size of the mapping on success.
+ * @return nullptr if the file can not be mapped, always on Windows.
+ */
+CC_DLL unsigned char* mapFile(const std::string& fullPath, std::size_t minSize, std::size_t& size);
+
+/**
+ * Unmaps a file mapped by mapFile.
+ */
+CC_DLL void unmapFile(unsigned char* data, std::size_t size);
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_FILE_MAPPING_H__
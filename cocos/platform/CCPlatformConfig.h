@@ -81,8 +81,8 @@ THE SOFTWARE.
     #define CC_TARGET_PLATFORM         CC_PLATFORM_WIN32
 #endif
 
-// linux
-#if defined(LINUX) && !defined(__APPLE__)
+// linux, keyed off the compiler macro too so a build does not need -DLINUX
+#if (defined(LINUX) || defined(__linux__)) && !defined(__APPLE__) && !defined(ANDROID) && !defined(__ANDROID__)
     #undef  CC_TARGET_PLATFORM
     #define CC_TARGET_PLATFORM         CC_PLATFORM_LINUX
 #endif
@@ -0,0 +1,336 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include "platform/CCApplication.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/utsname.h>
+#include "platform/CCFileUtils.h"
+#include "scripting/js-bindings/jswrapper/SeApi.h"
+#include "scripting/js-bindings/event/EventDispatcher.h"
+#include "base/CCScheduler.h"
+#include "base/CCAutoreleasePool.h"
+#include "base/CCGLUtils.h"
+#include "audio/include/AudioEngine.h"
+
+// The linux target is headless: there is no window and no GL context, the main loop only ticks
+// the scheduler and the script engine. With USE_GFX_NULL the renderer draws into the null backend,
+// see renderer/gfx/NullGraphics.h.
+
+namespace
+{
+    std::atomic<bool> s_shouldQuit(false);
+
+    // used when the preferred fps is not positive, frames then run back to back
+    const float FixedDeltaTime = 1.0f / 60;
+
+    bool setCanvasCallback(se::Object* global)
+    {
+        auto viewSize = cocos2d::Application::getInstance()->getViewSize();
+        se::ScriptEngine* se = se::ScriptEngine::getInstance();
+        char commandBuf[200] = {0};
+        sprintf(commandBuf, "window.innerWidth = %d; window.innerHeight = %d;",
+            (int)viewSize.x,
+            (int)viewSize.y);
+        se->evalString(commandBuf);
+        cocos2d::ccViewport(0, 0, viewSize.x, viewSize.y);
+        glDepthMask(GL_TRUE);
+        return true;
+    }
+
+    // language part of LC_ALL, LC_MESSAGES or LANG, such as "zh" of "zh_CN.UTF-8"
+    std::string getLocaleLanguage()
+    {
+        const char* envNames[] = { "LC_ALL", "LC_MESSAGES", "LANG" };
+        for (const char* name : envNames)
+        {
+            const char* value = getenv(name);
+            if (value != nullptr && value[0] != '\0' && strcmp(value, "C") != 0 && strcmp(value, "POSIX") != 0)
+            {
+                std::string locale(value);
+                return locale.substr(0, locale.find_first_of("_.@"));
+            }
+        }
+        return "en";
+    }
+}
+
+NS_CC_BEGIN
+
+Application* Application::_instance = nullptr;
+std::shared_ptr<Scheduler> Application::_scheduler = nullptr;
+
+Application::Application(const std::string& name, int width, int height)
+{
+    Application::_instance = this;
+    _scheduler = std::make_shared<Scheduler>();
+
+    createView(name, width, height);
+
+    _renderTexture = new RenderTexture(width, height);
+
+    EventDispatcher::init();
+    se::ScriptEngine::getInstance();
+}
+
+Application::~Application()
+{
+
+#if USE_AUDIO
+    AudioEngine::end();
+#endif
+
+    EventDispatcher::destroy();
+    se::ScriptEngine::destroyInstance();
+
+    delete _renderTexture;
+    _renderTexture = nullptr;
+
+    Application::_instance = nullptr;
+}
+
+const cocos2d::Vec2& Application::getViewSize() const
+{
+    return _viewSize;
+}
+
+void Application::updateViewSize(int width, int height)
+{
+    _viewSize.x = width;
+    _viewSize.y = height;
+}
+
+void Application::start()
+{
+    typedef std::chrono::steady_clock Clock;
+
+    s_shouldQuit = false;
+    Clock::time_point last = Clock::now();
+    se::ScriptEngine* se = se::ScriptEngine::getInstance();
+    while (!s_shouldQuit)
+    {
+        if (!_isStarted)
+        {
+            auto scheduler = Application::getInstance()->getScheduler();
+            scheduler->removeAllFunctionsToBePerformedInCocosThread();
+            scheduler->unscheduleAll();
+
+            se::ScriptEngine::getInstance()->cleanup();
+            cocos2d::PoolManager::getInstance()->getCurrentPool()->clear();
+            cocos2d::EventDispatcher::init();
+
+            ccInvalidateStateCache();
+            se->addRegisterCallback(setCanvasCallback);
+
+            if(!applicationDidFinishLaunching())
+                return;
+
+            _isStarted = true;
+            last = Clock::now();
+        }
+
+        float dt = FixedDeltaTime;
+        Clock::time_point now = Clock::now();
+        if (_fps > 0)
+        {
+            auto desiredInterval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / _fps));
+            auto actualInterval = now - last;
+            if (actualInterval < desiredInterval)
+            {
+                std::this_thread::sleep_for(desiredInterval - actualInterval);
+                continue;
+            }
+            dt = std::chrono::duration<float>(actualInterval).count();
+        }
+        last = now;
+
+        // should be invoked at the begin of rendering a frame
+        if (_isDownsampleEnabled)
+            _renderTexture->prepare();
+
+        _scheduler->update(dt);
+        EventDispatcher::dispatchTickEvent(dt);
+
+        if (_isDownsampleEnabled)
+            _renderTexture->draw();
+
+        PoolManager::getInstance()->getCurrentPool()->clear();
+    }
+}
+
+void Application::restart()
+{
+    _isStarted = false;
+}
+
+void Application::end()
+{
+    s_shouldQuit = true;
+}
+
+void Application::setPreferredFramesPerSecond(int fps)
+{
+    _fps = fps;
+}
+
+Application::LanguageType Application::getCurrentLanguage() const
+{
+    static const struct
+    {
+        const char* code;
+        LanguageType type;
+    } languages[] = {
+        { "zh", LanguageType::CHINESE },
+        { "en", LanguageType::ENGLISH },
+        { "fr", LanguageType::FRENCH },
+        { "it", LanguageType::ITALIAN },
+        { "de", LanguageType::GERMAN },
+        { "es", LanguageType::SPANISH },
+        { "ru", LanguageType::RUSSIAN },
+        { "nl", LanguageType::DUTCH },
+        { "ko", LanguageType::KOREAN },
+        { "ja", LanguageType::JAPANESE },
+        { "hu", LanguageType::HUNGARIAN },
+        { "pt", LanguageType::PORTUGUESE },
+        { "ar", LanguageType::ARABIC },
+        { "nb", LanguageType::NORWEGIAN },
+        { "pl", LanguageType::POLISH },
+        { "tr", LanguageType::TURKISH },
+        { "uk", LanguageType::UKRAINIAN },
+        { "ro", LanguageType::ROMANIAN },
+        { "bg", LanguageType::BULGARIAN },
+    };
+
+    std::string code = getLocaleLanguage();
+    for (const auto& language : languages)
+    {
+        if (code == language.code)
+            return language.type;
+    }
+    return LanguageType::ENGLISH;
+}
+
+std::string Application::getCurrentLanguageCode() const
+{
+    return getLocaleLanguage();
+}
+
+bool Application::isDisplayStats() {
+    se::AutoHandleScope hs;
+    se::Value ret;
+    char commandBuf[100] = "cc.debug.isDisplayStats();";
+    se::ScriptEngine::getInstance()->evalString(commandBuf, 100, &ret);
+    return ret.toBoolean();
+}
+
+void Application::setDisplayStats(bool isShow) {
+    se::AutoHandleScope hs;
+    char commandBuf[100] = {0};
+    sprintf(commandBuf, "cc.debug.setDisplayStats(%s);", isShow ? "true" : "false");
+    se::ScriptEngine::getInstance()->evalString(commandBuf);
+}
+
+float Application::getScreenScale() const
+{
+    return 1.f;
+}
+
+GLint Application::getMainFBO() const
+{
+    return _mainFBO;
+}
+
+Application::Platform Application::getPlatform() const
+{
+    return Platform::LINUXOS;
+}
+
+bool Application::openURL(const std::string &url)
+{
+    // no browser in headless mode
+    return false;
+}
+
+void Application::copyTextToClipboard(const std::string &text)
+{
+    // no clipboard in headless mode
+}
+
+bool Application::applicationDidFinishLaunching()
+{
+    return true;
+}
+
+void Application::onPause()
+{
+}
+
+void Application::onResume()
+{
+}
+
+void Application::setMultitouch(bool)
+{
+}
+
+void Application::onCreateView(PixelFormat& pixelformat, DepthFormat& depthFormat, int& multisamplingCount)
+{
+    pixelformat = PixelFormat::RGBA8;
+    depthFormat = DepthFormat::DEPTH24_STENCIL8;
+
+    multisamplingCount = 0;
+}
+
+void Application::createView(const std::string& name, int width, int height)
+{
+    int multisamplingCount = 0;
+    PixelFormat pixelformat;
+    DepthFormat depthFormat;
+
+    onCreateView(pixelformat,
+                 depthFormat,
+                 multisamplingCount);
+
+    // there is no window, the view size is the requested size and the default framebuffer is 0
+    updateViewSize(width, height);
+    _mainFBO = 0;
+}
+
+std::string Application::getSystemVersion()
+{
+    struct utsname info;
+    if (uname(&info) != 0)
+        return std::string("unknown Linux version");
+    return std::string(info.sysname) + " " + info.release;
+}
+
+NS_CC_END
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
@@ -0,0 +1,363 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCCanvasRenderingContext2D.h"
+#include "base/ccTypes.h"
+#include "base/csscolorparser.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <regex>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace cocos2d;
+
+// Headless canvas, there is no font rasterizer on the linux target.
+// Text is measured with an approximate advance and left blank, rectangles are filled so that
+// buffer sizes and upload traffic match a real device.
+
+class CanvasRenderingContext2DImpl
+{
+public:
+    void recreateBuffer(float w, float h)
+    {
+        _bufferWidth = w;
+        _bufferHeight = h;
+        if (_bufferWidth < 1.0f || _bufferHeight < 1.0f)
+        {
+            _imageData.clear();
+            return;
+        }
+
+        int textureSize = (int)_bufferWidth * (int)_bufferHeight * 4;
+        uint8_t* data = (uint8_t*)malloc(sizeof(uint8_t) * textureSize);
+        memset(data, 0x00, textureSize);
+        _imageData.fastSet(data, textureSize);
+    }
+
+    void clearRect(float x, float y, float w, float h)
+    {
+        fillRectWithColor(x, y, w, h, 0, 0, 0, 0);
+    }
+
+    void fillRect(float x, float y, float w, float h)
+    {
+        fillRectWithColor(x, y, w, h, _fillStyle.r, _fillStyle.g, _fillStyle.b, (uint8_t)(_fillStyle.a * 255.0f));
+    }
+
+    Size measureText(const std::string& text)
+    {
+        // count code points, every glyph advances about half of the font size
+        int count = 0;
+        for (unsigned char c : text)
+        {
+            if ((c & 0xc0) != 0x80)
+                ++count;
+        }
+        return Size(std::ceil(count * _fontSize * 0.5f), std::ceil(_fontSize));
+    }
+
+    void updateFont(float fontSize)
+    {
+        _fontSize = fontSize;
+    }
+
+    void setFillStyle(const CSSColorParser::Color& color)
+    {
+        _fillStyle = color;
+    }
+
+    const Data& getDataRef() const
+    {
+        return _imageData;
+    }
+
+private:
+    void fillRectWithColor(float x, float y, float w, float h, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+    {
+        uint8_t* buffer = _imageData.getBytes();
+        if (buffer == nullptr)
+            return;
+
+        uint32_t totalWidth = (uint32_t)_bufferWidth;
+        uint32_t totalHeight = (uint32_t)_bufferHeight;
+        uint32_t x0 = (uint32_t)std::max(0.0f, x);
+        uint32_t y0 = (uint32_t)std::max(0.0f, y);
+        uint32_t x1 = (uint32_t)std::min((float)totalWidth, std::max(0.0f, x + w));
+        uint32_t y1 = (uint32_t)std::min((float)totalHeight, std::max(0.0f, y + h));
+
+        for (uint32_t offsetY = y0; offsetY < y1; ++offsetY)
+        {
+            uint8_t* p = buffer + (totalWidth * offsetY + x0) * 4;
+            for (uint32_t offsetX = x0; offsetX < x1; ++offsetX)
+            {
+                *p++ = r;
+                *p++ = g;
+                *p++ = b;
+                *p++ = a;
+            }
+        }
+    }
+
+    Data _imageData;
+    float _bufferWidth = 0.0f;
+    float _bufferHeight = 0.0f;
+    float _fontSize = 10.0f;
+    CSSColorParser::Color _fillStyle;
+};
+
+NS_CC_BEGIN
+
+CanvasGradient::CanvasGradient()
+{
+}
+
+CanvasGradient::~CanvasGradient()
+{
+}
+
+void CanvasGradient::addColorStop(float offset, const std::string& color)
+{
+}
+
+// CanvasRenderingContext2D
+
+CanvasRenderingContext2D::CanvasRenderingContext2D(float width, float height)
+: __width(width)
+, __height(height)
+{
+    _impl = new CanvasRenderingContext2DImpl();
+    recreateBufferIfNeeded();
+}
+
+CanvasRenderingContext2D::~CanvasRenderingContext2D()
+{
+    delete _impl;
+}
+
+void CanvasRenderingContext2D::recreateBufferIfNeeded()
+{
+    if (_isBufferSizeDirty)
+    {
+        _isBufferSizeDirty = false;
+        _impl->recreateBuffer(__width, __height);
+        if (_canvasBufferUpdatedCB != nullptr)
+            _canvasBufferUpdatedCB(_impl->getDataRef());
+    }
+}
+
+void CanvasRenderingContext2D::clearRect(float x, float y, float width, float height)
+{
+    recreateBufferIfNeeded();
+    _impl->clearRect(x, y, width, height);
+}
+
+void CanvasRenderingContext2D::fillRect(float x, float y, float width, float height)
+{
+    recreateBufferIfNeeded();
+    _impl->fillRect(x, y, width, height);
+
+    if (_canvasBufferUpdatedCB != nullptr)
+        _canvasBufferUpdatedCB(_impl->getDataRef());
+}
+
+void CanvasRenderingContext2D::fillText(const std::string& text, float x, float y, float maxWidth)
+{
+    if (text.empty())
+        return;
+    recreateBufferIfNeeded();
+
+    if (_canvasBufferUpdatedCB != nullptr)
+        _canvasBufferUpdatedCB(_impl->getDataRef());
+}
+
+void CanvasRenderingContext2D::strokeText(const std::string& text, float x, float y, float maxWidth)
+{
+    if (text.empty())
+        return;
+    recreateBufferIfNeeded();
+
+    if (_canvasBufferUpdatedCB != nullptr)
+        _canvasBufferUpdatedCB(_impl->getDataRef());
+}
+
+cocos2d::Size CanvasRenderingContext2D::measureText(const std::string& text)
+{
+    return _impl->measureText(text);
+}
+
+CanvasGradient* CanvasRenderingContext2D::createLinearGradient(float x0, float y0, float x1, float y1)
+{
+    return nullptr;
+}
+
+void CanvasRenderingContext2D::save()
+{
+}
+
+void CanvasRenderingContext2D::beginPath()
+{
+}
+
+void CanvasRenderingContext2D::closePath()
+{
+}
+
+void CanvasRenderingContext2D::moveTo(float x, float y)
+{
+}
+
+void CanvasRenderingContext2D::lineTo(float x, float y)
+{
+}
+
+void CanvasRenderingContext2D::stroke()
+{
+    if (_canvasBufferUpdatedCB != nullptr)
+        _canvasBufferUpdatedCB(_impl->getDataRef());
+}
+
+void CanvasRenderingContext2D::restore()
+{
+}
+
+void CanvasRenderingContext2D::setCanvasBufferUpdatedCallback(const CanvasBufferUpdatedCallback& cb)
+{
+    _canvasBufferUpdatedCB = cb;
+}
+
+void CanvasRenderingContext2D::setPremultiply(bool multiply)
+{
+    _premultiply = multiply;
+}
+
+void CanvasRenderingContext2D::set__width(float width)
+{
+    __width = width;
+    _isBufferSizeDirty = true;
+    recreateBufferIfNeeded();
+}
+
+void CanvasRenderingContext2D::set__height(float height)
+{
+    __height = height;
+    _isBufferSizeDirty = true;
+    recreateBufferIfNeeded();
+}
+
+void CanvasRenderingContext2D::set_lineWidth(float lineWidth)
+{
+    _lineWidth = lineWidth;
+}
+
+void CanvasRenderingContext2D::set_lineCap(const std::string& lineCap)
+{
+    _lineCap = lineCap;
+}
+
+void CanvasRenderingContext2D::set_lineJoin(const std::string& lineJoin)
+{
+    _lineJoin = lineJoin;
+}
+
+void CanvasRenderingContext2D::fill()
+{
+}
+
+void CanvasRenderingContext2D::rect(float x, float y, float w, float h)
+{
+}
+
+void CanvasRenderingContext2D::set_font(const std::string& font)
+{
+    if (_font != font)
+    {
+        _font = font;
+
+        std::string fontSizeStr = "30";
+
+        // support get font size from `60px American` or `bold 60px "American abc-abc_abc"`
+        std::regex re("(bold)?\\s*((\\d+)([\\.]\\d+)?)px\\s+([\\w-]+|\"[\\w -]+\"$)");
+        std::match_results<std::string::const_iterator> results;
+        if (std::regex_search(_font.cbegin(), _font.cend(), results, re))
+        {
+            fontSizeStr = results[2].str();
+        }
+
+        _impl->updateFont(atof(fontSizeStr.c_str()));
+    }
+}
+
+void CanvasRenderingContext2D::set_textAlign(const std::string& textAlign)
+{
+    _textAlign = textAlign;
+}
+
+void CanvasRenderingContext2D::set_textBaseline(const std::string& textBaseline)
+{
+    _textBaseline = textBaseline;
+}
+
+void CanvasRenderingContext2D::set_fillStyle(const std::string& fillStyle)
+{
+    _fillStyle = fillStyle;
+    _impl->setFillStyle(CSSColorParser::parse(fillStyle));
+}
+
+void CanvasRenderingContext2D::set_strokeStyle(const std::string& strokeStyle)
+{
+    _strokeStyle = strokeStyle;
+}
+
+void CanvasRenderingContext2D::set_globalCompositeOperation(const std::string& globalCompositeOperation)
+{
+    _globalCompositeOperation = globalCompositeOperation;
+}
+
+void CanvasRenderingContext2D::_fillImageData(const Data& imageData, float imageWidth, float imageHeight, float offsetX, float offsetY)
+{
+}
+
+void CanvasRenderingContext2D::translate(float x, float y)
+{
+}
+
+void CanvasRenderingContext2D::scale(float x, float y)
+{
+}
+
+void CanvasRenderingContext2D::rotate(float angle)
+{
+}
+
+void CanvasRenderingContext2D::transform(float a, float b, float c, float d, float e, float f)
+{
+}
+
+void CanvasRenderingContext2D::setTransform(float a, float b, float c, float d, float e, float f)
+{
+}
+
+NS_CC_END
@@ -0,0 +1,119 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include "platform/linux/CCFileUtils-linux.h"
+#include "base/ccMacros.h"
+
+#include <unistd.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+NS_CC_BEGIN
+
+namespace
+{
+    std::string getExecutablePath()
+    {
+        char path[PATH_MAX] = {0};
+        ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+        if (length <= 0)
+            return "";
+        return std::string(path, length);
+    }
+}
+
+FileUtils* FileUtils::getInstance()
+{
+    if (s_sharedFileUtils == nullptr)
+    {
+        s_sharedFileUtils = new FileUtilsLinux();
+        if (!s_sharedFileUtils->init())
+        {
+          delete s_sharedFileUtils;
+          s_sharedFileUtils = nullptr;
+          CCLOG("ERROR: Could not init CCFileUtilsLinux");
+        }
+    }
+    return s_sharedFileUtils;
+}
+
+FileUtilsLinux::FileUtilsLinux()
+{
+}
+
+bool FileUtilsLinux::init()
+{
+    std::string exePath = getExecutablePath();
+    if (exePath.empty())
+        return false;
+
+    _defaultResRootPath = exePath.substr(0, exePath.find_last_of('/')) + "/Resources/";
+    return FileUtils::init();
+}
+
+std::string FileUtilsLinux::getWritablePath() const
+{
+    if (!_writablePath.empty())
+        return _writablePath;
+
+    std::string configPath;
+    const char* xdgConfigHome = getenv("XDG_CONFIG_HOME");
+    const char* home = getenv("HOME");
+    if (xdgConfigHome != nullptr && xdgConfigHome[0] == '/')
+        configPath = xdgConfigHome;
+    else if (home != nullptr)
+        configPath = std::string(home) + "/.config";
+    else
+        configPath = "/tmp";
+
+    std::string exePath = getExecutablePath();
+    std::string appName = exePath.substr(exePath.find_last_of('/') + 1);
+    if (appName.empty())
+        appName = "cocos2d";
+
+    std::string dir = configPath + "/" + appName + "/";
+    const_cast<FileUtilsLinux*>(this)->createDirectory(dir);
+    return dir;
+}
+
+bool FileUtilsLinux::isFileExistInternal(const std::string& strFilePath) const
+{
+    if (strFilePath.empty())
+        return false;
+
+    std::string strPath = strFilePath;
+    if (!isAbsolutePath(strPath))
+        strPath.insert(0, _defaultResRootPath);
+
+    struct stat sts;
+    return (stat(strPath.c_str(), &sts) == 0) && S_ISREG(sts.st_mode);
+}
+
+NS_CC_END
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
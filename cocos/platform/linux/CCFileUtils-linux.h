@@ -0,0 +1,71 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_FILEUTILS_LINUX_H__
+#define __CC_FILEUTILS_LINUX_H__
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include "platform/CCFileUtils.h"
+#include "base/ccMacros.h"
+#include "base/ccTypes.h"
+#include <string>
+#include <vector>
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+//! @brief  Helper class to handle file operations
+class CC_DLL FileUtilsLinux : public FileUtils
+{
+    friend class FileUtils;
+    FileUtilsLinux();
+public:
+    /* override functions */
+    bool init();
+    /**
+     *  Gets the writable path, it's $XDG_CONFIG_HOME/<executable name>/ or ~/.config/<executable name>/.
+     */
+    virtual std::string getWritablePath() const override;
+protected:
+    /**
+     *  Checks whether a file exists, relative paths are resolved against the default resource root path,
+     *  which is the Resources folder next to the executable.
+     */
+    virtual bool isFileExistInternal(const std::string& strFilePath) const override;
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#endif    // __CC_FILEUTILS_LINUX_H__
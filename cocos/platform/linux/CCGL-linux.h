@@ -1,18 +1,18 @@
 /****************************************************************************
- Copyright (c) 2018 Xiamen Yaji Software Co., Ltd.
- 
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
  http://www.cocos2d-x.org
- 
+
  Permission is hereby granted, free of charge, to any person obtaining a copy
  of this software and associated documentation files (the "Software"), to deal
  in the Software without restriction, including without limitation the rights
  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
  copies of the Software, and to permit persons to whom the Software is
  furnished to do so, subject to the following conditions:
- 
+
  The above copyright notice and this permission notice shall be included in
  all copies or substantial portions of the Software.
- 
+
  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
@@ -22,57 +22,25 @@
  THE SOFTWARE.
  ****************************************************************************/
 
-#pragma once
+#ifndef __PLATFORM_LINUX_CCGL_H__
+#define __PLATFORM_LINUX_CCGL_H__
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+// desktop GL prototypes, they are resolved by libGL or by the null backend when USE_GFX_NULL is enabled
+#ifndef GL_GLEXT_PROTOTYPES
+#define GL_GLEXT_PROTOTYPES 1
+#endif
+#include <GL/gl.h>
+#include <GL/glext.h>
 
-#include "../Macro.h"
-#include <vector>
-#include <stdint.h>
-#include <functional>
-#include <thread>
-#include <memory>
-#include <condition_variable>
-#include <mutex>
+#define CC_GL_DEPTH24_STENCIL8      GL_DEPTH24_STENCIL8
 
-RENDERER_BEGIN
+#define glClearDepthf                   glClearDepth
+#define glDepthRangef                   glDepthRange
+#define glReleaseShaderCompiler(xxx)
 
-class ParallelTask
-{
-public:
-    
-    enum RunFlag{
-        Begin = 0x00,
-        Stop = 0x01,
-    };
-    
-    typedef std::function<void(int)> Task;
-    
-    ParallelTask();
-    virtual ~ParallelTask();
-    
-    void pushTask(int tid, const Task& task);
-    void clearTasks();
-    
-    uint8_t* getRunFlag();
-    
-    void init(int threadNum);
-    void destroy();
-    
-    void waitAllThreads();
-    void stopAllThreads();
-    void beginAllThreads();
-private:
-    void joinThread(int tid);
-    void setThread(int tid);
-private:
-    std::vector<std::vector<Task>> _tasks;
-    std::vector<std::unique_ptr<std::thread>> _threads;
-    
-    uint8_t* _runFlags = nullptr;
-    bool _finished = false;
-    int _threadNum = 0;
-    
-    std::mutex _mutex;
-    std::condition_variable _cv;
-};
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
 
-RENDERER_END
+#endif // __PLATFORM_LINUX_CCGL_H__
@@ -117,6 +117,24 @@ void IndexBuffer::update(uint32_t offset, const void* data, size_t dataByteLengt
     _device->restoreIndexBuffer();
 }
 
+void IndexBuffer::orphan(uint32_t bytes)
+{
+    if (_glID == 0)
+    {
+        RENDERER_LOGE("The buffer is destroyed");
+        return;
+    }
+    
+    _bytes = bytes;
+    _numIndices = _bytes / _bytesPerIndex;
+    
+    ccBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _glID);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, _bytes, nullptr, (GLenum)_usage);
+    _needExpandDataStore = false;
+    
+    _device->restoreIndexBuffer();
+}
+
 void IndexBuffer::destroy()
 {
     if (_glID == 0)
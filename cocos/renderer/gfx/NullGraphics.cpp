@@ -0,0 +1,1332 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "NullGraphics.h"
+
+#if USE_GFX_NULL
+
+#include "platform/CCGL.h"
+
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace {
+
+    using cocos2d::renderer::NullGraphics;
+
+    const GLint MaxVertexAttribs = 16;
+    const GLint MaxTextureUnits = 16;
+    const GLint MaxTextureSize = 4096;
+
+    struct ActiveVariable
+    {
+        std::string name;
+        GLenum type;
+        GLint size;
+    };
+
+    struct ShaderObject
+    {
+        GLenum type = 0;
+        std::string source;
+    };
+
+    struct ProgramObject
+    {
+        std::vector<GLuint> shaders;
+        std::vector<ActiveVariable> attributes;
+        std::vector<ActiveVariable> uniforms;
+        std::unordered_map<std::string, GLint> boundAttribLocations;
+        bool linked = false;
+    };
+
+    struct BufferObject
+    {
+        GLsizeiptr size = 0;
+        GLenum usage = GL_STATIC_DRAW;
+    };
+
+    struct VertexAttrib
+    {
+        GLint size = 4;
+        GLenum type = GL_FLOAT;
+        GLboolean normalized = GL_FALSE;
+        GLsizei stride = 0;
+        const void* pointer = nullptr;
+        GLuint buffer = 0;
+        bool enabled = false;
+        GLfloat current[4] = { 0.f, 0.f, 0.f, 1.f };
+    };
+
+    struct RenderbufferObject
+    {
+        GLenum format = 0;
+        GLsizei width = 0;
+        GLsizei height = 0;
+    };
+
+    struct Context
+    {
+        NullGraphics::Stats stats;
+
+        GLuint nextName = 1;
+        std::unordered_map<GLuint, ShaderObject> shaders;
+        std::unordered_map<GLuint, ProgramObject> programs;
+        std::unordered_map<GLuint, BufferObject> buffers;
+        std::unordered_map<GLuint, RenderbufferObject> renderbuffers;
+        std::vector<GLuint> textures;
+        std::vector<GLuint> framebuffers;
+        std::vector<GLuint> vertexArrays;
+
+        GLuint arrayBuffer = 0;
+        GLuint elementArrayBuffer = 0;
+        GLuint vertexArray = 0;
+        GLuint program = 0;
+        GLuint framebuffer = 0;
+        GLuint renderbuffer = 0;
+        GLenum activeTexture = GL_TEXTURE0;
+        GLuint textures2D[MaxTextureUnits] = {};
+        GLuint texturesCube[MaxTextureUnits] = {};
+        VertexAttrib attribs[MaxVertexAttribs];
+
+        std::vector<GLenum> enabledCaps;
+        GLint viewport[4] = {};
+        GLint scissor[4] = {};
+        GLfloat clearColor[4] = {};
+        GLfloat blendColor[4] = {};
+        GLboolean colorMask[4] = { GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE };
+        GLboolean depthMask = GL_TRUE;
+        GLint unpackAlignment = 4;
+        GLint packAlignment = 4;
+    };
+
+    Context& ctx()
+    {
+        static Context context;
+        return context;
+    }
+
+    GLuint genName()
+    {
+        return ctx().nextName++;
+    }
+
+    template<typename T>
+    void eraseName(std::vector<T>& names, GLuint name)
+    {
+        auto iter = std::find(names.begin(), names.end(), name);
+        if (iter != names.end())
+            names.erase(iter);
+    }
+
+    inline void stateChanged()
+    {
+        ++ctx().stats.stateChanges;
+    }
+
+    inline void bound()
+    {
+        ++ctx().stats.bindings;
+    }
+
+    inline void uniformUpdated()
+    {
+        ++ctx().stats.uniformUpdates;
+    }
+
+    GLuint& boundTexture(GLenum target)
+    {
+        auto& c = ctx();
+        GLuint unit = std::min<GLuint>(c.activeTexture - GL_TEXTURE0, MaxTextureUnits - 1);
+        return target == GL_TEXTURE_CUBE_MAP ? c.texturesCube[unit] : c.textures2D[unit];
+    }
+
+    GLuint& boundBuffer(GLenum target)
+    {
+        auto& c = ctx();
+        return target == GL_ELEMENT_ARRAY_BUFFER ? c.elementArrayBuffer : c.arrayBuffer;
+    }
+
+    uint64_t pixelBytes(GLsizei width, GLsizei height, GLenum format, GLenum type)
+    {
+        GLint components = 4;
+        switch (format)
+        {
+            case GL_ALPHA:
+            case GL_LUMINANCE:
+            case GL_RED:
+            case GL_DEPTH_COMPONENT:
+                components = 1;
+                break;
+            case GL_LUMINANCE_ALPHA:
+            case GL_RG:
+                components = 2;
+                break;
+            case GL_RGB:
+                components = 3;
+                break;
+            default:
+                break;
+        }
+
+        GLint pixelSize = components;
+        switch (type)
+        {
+            case GL_UNSIGNED_SHORT_5_6_5:
+            case GL_UNSIGNED_SHORT_4_4_4_4:
+            case GL_UNSIGNED_SHORT_5_5_5_1:
+                pixelSize = 2;
+                break;
+            case GL_UNSIGNED_INT_24_8:
+                pixelSize = 4;
+                break;
+            case GL_HALF_FLOAT:
+            case 0x8D61: // GL_HALF_FLOAT_OES
+            case GL_UNSIGNED_SHORT:
+                pixelSize = components * 2;
+                break;
+            case GL_FLOAT:
+            case GL_UNSIGNED_INT:
+                pixelSize = components * 4;
+                break;
+            default:
+                break;
+        }
+
+        // rows are padded to the unpack alignment
+        GLint alignment = std::max(1, ctx().unpackAlignment);
+        uint64_t rowBytes = ((uint64_t)width * pixelSize + alignment - 1) / alignment * alignment;
+        return rowBytes * std::max(0, height);
+    }
+
+    // GLSL type names of the engine's shaders
+    GLenum glslType(const std::string& name)
+    {
+        static const std::unordered_map<std::string, GLenum> types = {
+            { "float", GL_FLOAT },
+            { "vec2", GL_FLOAT_VEC2 },
+            { "vec3", GL_FLOAT_VEC3 },
+            { "vec4", GL_FLOAT_VEC4 },
+            { "int", GL_INT },
+            { "ivec2", GL_INT_VEC2 },
+            { "ivec3", GL_INT_VEC3 },
+            { "ivec4", GL_INT_VEC4 },
+            { "bool", GL_BOOL },
+            { "bvec2", GL_BOOL_VEC2 },
+            { "bvec3", GL_BOOL_VEC3 },
+            { "bvec4", GL_BOOL_VEC4 },
+            { "mat2", GL_FLOAT_MAT2 },
+            { "mat3", GL_FLOAT_MAT3 },
+            { "mat4", GL_FLOAT_MAT4 },
+            { "sampler2D", GL_SAMPLER_2D },
+            { "samplerCube", GL_SAMPLER_CUBE },
+        };
+        auto iter = types.find(name);
+        return iter != types.end() ? iter->second : 0;
+    }
+
+    void tokenize(const std::string& source, std::vector<std::string>& tokens)
+    {
+        size_t i = 0, n = source.size();
+        while (i < n)
+        {
+            char c = source[i];
+            if (c == '/' && i + 1 < n && source[i + 1] == '/')
+            {
+                i = source.find('\n', i);
+                if (i == std::string::npos) break;
+            }
+            else if (c == '/' && i + 1 < n && source[i + 1] == '*')
+            {
+                i = source.find("*/", i + 2);
+                if (i == std::string::npos) break;
+                i += 2;
+            }
+            else if (c == '#')
+            {
+                // preprocessor lines are skipped, every branch is reported as active
+                i = source.find('\n', i);
+                if (i == std::string::npos) break;
+            }
+            else if (isalnum((unsigned char)c) || c == '_')
+            {
+                size_t begin = i;
+                while (i < n && (isalnum((unsigned char)source[i]) || source[i] == '_')) ++i;
+                tokens.push_back(source.substr(begin, i - begin));
+            }
+            else
+            {
+                if (!isspace((unsigned char)c))
+                    tokens.push_back(std::string(1, c));
+                ++i;
+            }
+        }
+    }
+
+    void addVariable(std::vector<ActiveVariable>& variables, const std::string& name, GLenum type, GLint size)
+    {
+        for (const auto& variable : variables)
+        {
+            if (variable.name == name)
+                return;
+        }
+        variables.push_back({ name, type, size });
+    }
+
+    // Collects `attribute` and `uniform` declarations, such as `uniform lowp vec4 a, b[4];`.
+    void parseDeclarations(const std::string& source, std::vector<ActiveVariable>& attributes, std::vector<ActiveVariable>& uniforms)
+    {
+        std::vector<std::string> tokens;
+        tokenize(source, tokens);
+
+        for (size_t i = 0, n = tokens.size(); i < n; ++i)
+        {
+            bool isAttribute = tokens[i] == "attribute";
+            if (!isAttribute && tokens[i] != "uniform")
+                continue;
+
+            size_t j = i + 1;
+            while (j < n && (tokens[j] == "lowp" || tokens[j] == "mediump" || tokens[j] == "highp"))
+                ++j;
+            if (j >= n)
+                break;
+
+            GLenum type = glslType(tokens[j]);
+            for (++j; j < n && tokens[j] != ";"; ++j)
+            {
+                if (tokens[j] == ",")
+                    continue;
+
+                std::string name = tokens[j];
+                GLint size = 1;
+                if (j + 3 < n && tokens[j + 1] == "[" && tokens[j + 3] == "]")
+                {
+                    size = std::max(1, atoi(tokens[j + 2].c_str()));
+                    j += 3;
+                }
+
+                // struct uniforms and unknown types are not reported
+                if (type == 0)
+                    continue;
+
+                if (isAttribute)
+                    addVariable(attributes, name, type, size);
+                else
+                    addVariable(uniforms, name, type, size);
+            }
+            i = j;
+        }
+    }
+
+    void copyName(const std::string& name, GLsizei bufSize, GLsizei* length, GLchar* dst)
+    {
+        GLsizei count = 0;
+        if (dst != nullptr && bufSize > 0)
+        {
+            count = std::min<GLsizei>((GLsizei)name.size(), bufSize - 1);
+            memcpy(dst, name.data(), count);
+            dst[count] = '\0';
+        }
+        if (length != nullptr)
+            *length = count;
+    }
+
+    void getActiveVariable(const std::vector<ActiveVariable>& variables, GLuint index, bool arrayName, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+    {
+        if (index >= variables.size())
+        {
+            copyName("", bufSize, length, name);
+            return;
+        }
+
+        const auto& variable = variables[index];
+        if (size != nullptr) *size = variable.size;
+        if (type != nullptr) *type = variable.type;
+        copyName(arrayName && variable.size > 1 ? variable.name + "[0]" : variable.name, bufSize, length, name);
+    }
+
+    GLint maxNameLength(const std::vector<ActiveVariable>& variables)
+    {
+        GLint length = 0;
+        for (const auto& variable : variables)
+        {
+            // room for "[0]" and the terminator
+            length = std::max(length, (GLint)variable.name.size() + 4);
+        }
+        return length;
+    }
+
+    GLint getIntegerState(GLenum pname, GLint* params)
+    {
+        auto& c = ctx();
+        switch (pname)
+        {
+            case GL_VIEWPORT:
+                memcpy(params, c.viewport, sizeof(c.viewport));
+                return 4;
+            case GL_SCISSOR_BOX:
+                memcpy(params, c.scissor, sizeof(c.scissor));
+                return 4;
+            case GL_COLOR_WRITEMASK:
+                for (int i = 0; i < 4; ++i) params[i] = c.colorMask[i];
+                return 4;
+            case GL_ARRAY_BUFFER_BINDING: *params = c.arrayBuffer; return 1;
+            case GL_ELEMENT_ARRAY_BUFFER_BINDING: *params = c.elementArrayBuffer; return 1;
+            case GL_VERTEX_ARRAY_BINDING: *params = c.vertexArray; return 1;
+            case GL_CURRENT_PROGRAM: *params = c.program; return 1;
+            case GL_FRAMEBUFFER_BINDING: *params = c.framebuffer; return 1;
+            case GL_RENDERBUFFER_BINDING: *params = c.renderbuffer; return 1;
+            case GL_ACTIVE_TEXTURE: *params = c.activeTexture; return 1;
+            case GL_TEXTURE_BINDING_2D: *params = boundTexture(GL_TEXTURE_2D); return 1;
+            case GL_TEXTURE_BINDING_CUBE_MAP: *params = boundTexture(GL_TEXTURE_CUBE_MAP); return 1;
+            case GL_DEPTH_WRITEMASK: *params = c.depthMask; return 1;
+            case GL_UNPACK_ALIGNMENT: *params = c.unpackAlignment; return 1;
+            case GL_PACK_ALIGNMENT: *params = c.packAlignment; return 1;
+
+            case GL_MAX_VERTEX_ATTRIBS: *params = MaxVertexAttribs; return 1;
+            case GL_MAX_TEXTURE_IMAGE_UNITS:
+            case GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS: *params = MaxTextureUnits; return 1;
+            case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS: *params = MaxTextureUnits * 2; return 1;
+            case GL_MAX_TEXTURE_SIZE:
+            case GL_MAX_CUBE_MAP_TEXTURE_SIZE:
+            case GL_MAX_RENDERBUFFER_SIZE: *params = MaxTextureSize; return 1;
+            case GL_MAX_VERTEX_UNIFORM_VECTORS:
+            case GL_MAX_FRAGMENT_UNIFORM_VECTORS: *params = 1024; return 1;
+            case GL_MAX_VERTEX_UNIFORM_COMPONENTS:
+            case GL_MAX_FRAGMENT_UNIFORM_COMPONENTS: *params = 4096; return 1;
+            case GL_MAX_VARYING_VECTORS: *params = 16; return 1;
+            case GL_MAX_VARYING_COMPONENTS: *params = 64; return 1;
+            case GL_MAX_COLOR_ATTACHMENTS:
+            case GL_MAX_DRAW_BUFFERS: *params = 4; return 1;
+            case GL_MAX_SAMPLES: *params = 4; return 1;
+            case GL_MAX_VIEWPORT_DIMS: params[0] = params[1] = MaxTextureSize; return 2;
+            case GL_RED_BITS:
+            case GL_GREEN_BITS:
+            case GL_BLUE_BITS:
+            case GL_ALPHA_BITS:
+            case GL_STENCIL_BITS: *params = 8; return 1;
+            case GL_DEPTH_BITS: *params = 24; return 1;
+            case GL_NUM_COMPRESSED_TEXTURE_FORMATS:
+            case GL_NUM_PROGRAM_BINARY_FORMATS: *params = 0; return 1;
+            default:
+                *params = 0;
+                return 1;
+        }
+    }
+}
+
+RENDERER_BEGIN
+
+const NullGraphics::Stats& NullGraphics::getStats()
+{
+    return ctx().stats;
+}
+
+void NullGraphics::resetStats()
+{
+    ctx().stats = Stats();
+}
+
+RENDERER_END
+
+extern "C" {
+
+// Errors and queries
+
+GLenum glGetError(void)
+{
+    return GL_NO_ERROR;
+}
+
+const GLubyte* glGetString(GLenum name)
+{
+    switch (name)
+    {
+        case GL_VENDOR: return (const GLubyte*)"cocos";
+        case GL_RENDERER: return (const GLubyte*)"Null";
+        case GL_VERSION: return (const GLubyte*)"OpenGL ES 2.0 Null";
+        case GL_SHADING_LANGUAGE_VERSION: return (const GLubyte*)"OpenGL ES GLSL ES 1.00";
+        case GL_EXTENSIONS: return (const GLubyte*)"GL_ARB_vertex_array_object GL_ARB_texture_float GL_OES_standard_derivatives GL_OES_element_index_uint GL_OES_depth24 GL_OES_packed_depth_stencil";
+        default: return (const GLubyte*)"";
+    }
+}
+
+void glGetIntegerv(GLenum pname, GLint* params)
+{
+    getIntegerState(pname, params);
+}
+
+void glGetFloatv(GLenum pname, GLfloat* params)
+{
+    auto& c = ctx();
+    switch (pname)
+    {
+        case GL_COLOR_CLEAR_VALUE:
+            memcpy(params, c.clearColor, sizeof(c.clearColor));
+            return;
+        case GL_BLEND_COLOR:
+            memcpy(params, c.blendColor, sizeof(c.blendColor));
+            return;
+        case GL_ALIASED_LINE_WIDTH_RANGE:
+        case GL_ALIASED_POINT_SIZE_RANGE:
+            params[0] = 1.f;
+            params[1] = 1.f;
+            return;
+        default:
+            break;
+    }
+
+    GLint values[4] = {};
+    GLint count = getIntegerState(pname, values);
+    for (GLint i = 0; i < count; ++i)
+        params[i] = (GLfloat)values[i];
+}
+
+void glGetBooleanv(GLenum pname, GLboolean* params)
+{
+    GLint values[4] = {};
+    GLint count = getIntegerState(pname, values);
+    for (GLint i = 0; i < count; ++i)
+        params[i] = values[i] != 0 ? GL_TRUE : GL_FALSE;
+}
+
+GLboolean glIsEnabled(GLenum cap)
+{
+    auto& caps = ctx().enabledCaps;
+    return std::find(caps.begin(), caps.end(), cap) != caps.end() ? GL_TRUE : GL_FALSE;
+}
+
+void glGetShaderPrecisionFormat(GLenum shadertype, GLenum precisiontype, GLint* range, GLint* precision)
+{
+    bool isInt = precisiontype == GL_LOW_INT || precisiontype == GL_MEDIUM_INT || precisiontype == GL_HIGH_INT;
+    range[0] = isInt ? 31 : 127;
+    range[1] = isInt ? 30 : 127;
+    *precision = isInt ? 0 : 23;
+}
+
+void glHint(GLenum target, GLenum mode) {}
+void glFlush(void) {}
+void glFinish(void) {}
+
+// Fixed function state
+
+void glEnable(GLenum cap)
+{
+    stateChanged();
+    if (!glIsEnabled(cap))
+        ctx().enabledCaps.push_back(cap);
+}
+
+void glDisable(GLenum cap)
+{
+    stateChanged();
+    eraseName(ctx().enabledCaps, cap);
+}
+
+void glBlendFunc(GLenum sfactor, GLenum dfactor) { stateChanged(); }
+void glBlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha) { stateChanged(); }
+void glBlendEquation(GLenum mode) { stateChanged(); }
+void glBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha) { stateChanged(); }
+
+void glBlendColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    stateChanged();
+    auto& c = ctx();
+    c.blendColor[0] = red;
+    c.blendColor[1] = green;
+    c.blendColor[2] = blue;
+    c.blendColor[3] = alpha;
+}
+
+void glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+    stateChanged();
+    auto& c = ctx();
+    c.colorMask[0] = red;
+    c.colorMask[1] = green;
+    c.colorMask[2] = blue;
+    c.colorMask[3] = alpha;
+}
+
+void glDepthMask(GLboolean flag)
+{
+    stateChanged();
+    ctx().depthMask = flag;
+}
+
+void glDepthFunc(GLenum func) { stateChanged(); }
+void glDepthRange(GLdouble nearVal, GLdouble farVal) { stateChanged(); }
+void glStencilFunc(GLenum func, GLint ref, GLuint mask) { stateChanged(); }
+void glStencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask) { stateChanged(); }
+void glStencilOp(GLenum fail, GLenum zfail, GLenum zpass) { stateChanged(); }
+void glStencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass) { stateChanged(); }
+void glStencilMask(GLuint mask) { stateChanged(); }
+void glStencilMaskSeparate(GLenum face, GLuint mask) { stateChanged(); }
+void glCullFace(GLenum mode) { stateChanged(); }
+void glFrontFace(GLenum mode) { stateChanged(); }
+void glLineWidth(GLfloat width) { stateChanged(); }
+void glPolygonOffset(GLfloat factor, GLfloat units) { stateChanged(); }
+void glSampleCoverage(GLfloat value, GLboolean invert) { stateChanged(); }
+void glDrawBuffer(GLenum buf) { stateChanged(); }
+void glReadBuffer(GLenum src) { stateChanged(); }
+
+void glPixelStorei(GLenum pname, GLint param)
+{
+    if (pname == GL_UNPACK_ALIGNMENT)
+        ctx().unpackAlignment = param;
+    else if (pname == GL_PACK_ALIGNMENT)
+        ctx().packAlignment = param;
+}
+
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    stateChanged();
+    GLint* viewport = ctx().viewport;
+    viewport[0] = x;
+    viewport[1] = y;
+    viewport[2] = width;
+    viewport[3] = height;
+}
+
+void glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    stateChanged();
+    GLint* scissor = ctx().scissor;
+    scissor[0] = x;
+    scissor[1] = y;
+    scissor[2] = width;
+    scissor[3] = height;
+}
+
+// Clears and draws
+
+void glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+    auto& c = ctx();
+    c.clearColor[0] = red;
+    c.clearColor[1] = green;
+    c.clearColor[2] = blue;
+    c.clearColor[3] = alpha;
+}
+
+void glClearDepth(GLdouble depth) {}
+void glClearStencil(GLint s) {}
+
+void glClear(GLbitfield mask)
+{
+    ++ctx().stats.clears;
+}
+
+void glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    auto& stats = ctx().stats;
+    ++stats.drawCalls;
+    stats.drawnElements += std::max(0, count);
+}
+
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+    auto& stats = ctx().stats;
+    ++stats.drawCalls;
+    stats.drawnElements += std::max(0, count);
+}
+
+void glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels)
+{
+    if (pixels != nullptr)
+        memset(pixels, 0, pixelBytes(width, height, format, type));
+}
+
+// Buffers and vertex arrays
+
+void glGenBuffers(GLsizei n, GLuint* buffers)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        buffers[i] = genName();
+        ctx().buffers[buffers[i]] = BufferObject();
+    }
+}
+
+void glDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    auto& c = ctx();
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        if (buffers[i] == 0)
+            continue;
+        if (c.arrayBuffer == buffers[i]) c.arrayBuffer = 0;
+        if (c.elementArrayBuffer == buffers[i]) c.elementArrayBuffer = 0;
+        c.buffers.erase(buffers[i]);
+    }
+}
+
+GLboolean glIsBuffer(GLuint buffer)
+{
+    return ctx().buffers.count(buffer) > 0 ? GL_TRUE : GL_FALSE;
+}
+
+void glBindBuffer(GLenum target, GLuint buffer)
+{
+    bound();
+    boundBuffer(target) = buffer;
+}
+
+void glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    auto& c = ctx();
+    auto iter = c.buffers.find(boundBuffer(target));
+    if (iter != c.buffers.end())
+    {
+        iter->second.size = size;
+        iter->second.usage = usage;
+    }
+
+    // allocating without data uploads nothing
+    if (data != nullptr)
+        c.stats.bufferUploadBytes += size;
+}
+
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    ctx().stats.bufferUploadBytes += size;
+}
+
+void glGetBufferParameteriv(GLenum target, GLenum pname, GLint* params)
+{
+    auto& c = ctx();
+    auto iter = c.buffers.find(boundBuffer(target));
+    if (iter == c.buffers.end())
+    {
+        *params = 0;
+        return;
+    }
+
+    if (pname == GL_BUFFER_SIZE)
+        *params = (GLint)iter->second.size;
+    else if (pname == GL_BUFFER_USAGE)
+        *params = iter->second.usage;
+    else
+        *params = 0;
+}
+
+void glGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        arrays[i] = genName();
+        ctx().vertexArrays.push_back(arrays[i]);
+    }
+}
+
+void glDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+    auto& c = ctx();
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        if (c.vertexArray == arrays[i]) c.vertexArray = 0;
+        eraseName(c.vertexArrays, arrays[i]);
+    }
+}
+
+void glBindVertexArray(GLuint array)
+{
+    bound();
+    ctx().vertexArray = array;
+}
+
+void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer)
+{
+    if (index >= (GLuint)MaxVertexAttribs)
+        return;
+
+    auto& c = ctx();
+    auto& attrib = c.attribs[index];
+    attrib.size = size;
+    attrib.type = type;
+    attrib.normalized = normalized;
+    attrib.stride = stride;
+    attrib.pointer = pointer;
+    attrib.buffer = c.arrayBuffer;
+    ++c.stats.stateChanges;
+}
+
+void glEnableVertexAttribArray(GLuint index)
+{
+    if (index < (GLuint)MaxVertexAttribs)
+        ctx().attribs[index].enabled = true;
+    stateChanged();
+}
+
+void glDisableVertexAttribArray(GLuint index)
+{
+    if (index < (GLuint)MaxVertexAttribs)
+        ctx().attribs[index].enabled = false;
+    stateChanged();
+}
+
+void glGetVertexAttribiv(GLuint index, GLenum pname, GLint* params)
+{
+    if (index >= (GLuint)MaxVertexAttribs)
+    {
+        *params = 0;
+        return;
+    }
+
+    const auto& attrib = ctx().attribs[index];
+    switch (pname)
+    {
+        case GL_VERTEX_ATTRIB_ARRAY_ENABLED: *params = attrib.enabled; break;
+        case GL_VERTEX_ATTRIB_ARRAY_SIZE: *params = attrib.size; break;
+        case GL_VERTEX_ATTRIB_ARRAY_STRIDE: *params = attrib.stride; break;
+        case GL_VERTEX_ATTRIB_ARRAY_TYPE: *params = attrib.type; break;
+        case GL_VERTEX_ATTRIB_ARRAY_NORMALIZED: *params = attrib.normalized; break;
+        case GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING: *params = attrib.buffer; break;
+        case GL_CURRENT_VERTEX_ATTRIB:
+            for (int i = 0; i < 4; ++i) params[i] = (GLint)attrib.current[i];
+            break;
+        default: *params = 0; break;
+    }
+}
+
+void glGetVertexAttribfv(GLuint index, GLenum pname, GLfloat* params)
+{
+    if (pname == GL_CURRENT_VERTEX_ATTRIB && index < (GLuint)MaxVertexAttribs)
+    {
+        memcpy(params, ctx().attribs[index].current, sizeof(GLfloat) * 4);
+        return;
+    }
+
+    GLint value = 0;
+    glGetVertexAttribiv(index, pname, &value);
+    *params = (GLfloat)value;
+}
+
+void glGetVertexAttribPointerv(GLuint index, GLenum pname, void** pointer)
+{
+    *pointer = index < (GLuint)MaxVertexAttribs ? const_cast<void*>(ctx().attribs[index].pointer) : nullptr;
+}
+
+static void setCurrentAttrib(GLuint index, GLfloat x, GLfloat y, GLfloat z, GLfloat w)
+{
+    if (index >= (GLuint)MaxVertexAttribs)
+        return;
+
+    GLfloat* current = ctx().attribs[index].current;
+    current[0] = x;
+    current[1] = y;
+    current[2] = z;
+    current[3] = w;
+    stateChanged();
+}
+
+void glVertexAttrib1f(GLuint index, GLfloat x) { setCurrentAttrib(index, x, 0.f, 0.f, 1.f); }
+void glVertexAttrib2f(GLuint index, GLfloat x, GLfloat y) { setCurrentAttrib(index, x, y, 0.f, 1.f); }
+void glVertexAttrib3f(GLuint index, GLfloat x, GLfloat y, GLfloat z) { setCurrentAttrib(index, x, y, z, 1.f); }
+void glVertexAttrib4f(GLuint index, GLfloat x, GLfloat y, GLfloat z, GLfloat w) { setCurrentAttrib(index, x, y, z, w); }
+void glVertexAttrib1fv(GLuint index, const GLfloat* v) { setCurrentAttrib(index, v[0], 0.f, 0.f, 1.f); }
+void glVertexAttrib2fv(GLuint index, const GLfloat* v) { setCurrentAttrib(index, v[0], v[1], 0.f, 1.f); }
+void glVertexAttrib3fv(GLuint index, const GLfloat* v) { setCurrentAttrib(index, v[0], v[1], v[2], 1.f); }
+void glVertexAttrib4fv(GLuint index, const GLfloat* v) { setCurrentAttrib(index, v[0], v[1], v[2], v[3]); }
+
+// Textures
+
+void glGenTextures(GLsizei n, GLuint* textures)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        textures[i] = genName();
+        ctx().textures.push_back(textures[i]);
+    }
+}
+
+void glDeleteTextures(GLsizei n, const GLuint* textures)
+{
+    auto& c = ctx();
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        for (GLint unit = 0; unit < MaxTextureUnits; ++unit)
+        {
+            if (c.textures2D[unit] == textures[i]) c.textures2D[unit] = 0;
+            if (c.texturesCube[unit] == textures[i]) c.texturesCube[unit] = 0;
+        }
+        eraseName(c.textures, textures[i]);
+    }
+}
+
+GLboolean glIsTexture(GLuint texture)
+{
+    auto& textures = ctx().textures;
+    return std::find(textures.begin(), textures.end(), texture) != textures.end() ? GL_TRUE : GL_FALSE;
+}
+
+void glActiveTexture(GLenum texture)
+{
+    ctx().activeTexture = texture;
+}
+
+void glBindTexture(GLenum target, GLuint texture)
+{
+    bound();
+    boundTexture(target) = texture;
+}
+
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
+{
+    // allocating without data uploads nothing
+    if (pixels != nullptr)
+        ctx().stats.textureUploadBytes += pixelBytes(width, height, format, type);
+}
+
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
+{
+    if (pixels != nullptr)
+        ctx().stats.textureUploadBytes += pixelBytes(width, height, format, type);
+}
+
+void glCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data)
+{
+    ctx().stats.textureUploadBytes += std::max(0, imageSize);
+}
+
+void glCompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void* data)
+{
+    ctx().stats.textureUploadBytes += std::max(0, imageSize);
+}
+
+void glCopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border) {}
+void glCopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height) {}
+void glGenerateMipmap(GLenum target) {}
+void glTexParameteri(GLenum target, GLenum pname, GLint param) { stateChanged(); }
+void glTexParameterf(GLenum target, GLenum pname, GLfloat param) { stateChanged(); }
+
+void glGetTexParameterfv(GLenum target, GLenum pname, GLfloat* params)
+{
+    *params = 0.f;
+}
+
+void glGetTexParameteriv(GLenum target, GLenum pname, GLint* params)
+{
+    *params = 0;
+}
+
+// Framebuffers and renderbuffers
+
+void glGenFramebuffers(GLsizei n, GLuint* framebuffers)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        framebuffers[i] = genName();
+        ctx().framebuffers.push_back(framebuffers[i]);
+    }
+}
+
+void glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+    auto& c = ctx();
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        if (c.framebuffer == framebuffers[i]) c.framebuffer = 0;
+        eraseName(c.framebuffers, framebuffers[i]);
+    }
+}
+
+GLboolean glIsFramebuffer(GLuint framebuffer)
+{
+    auto& framebuffers = ctx().framebuffers;
+    return std::find(framebuffers.begin(), framebuffers.end(), framebuffer) != framebuffers.end() ? GL_TRUE : GL_FALSE;
+}
+
+void glBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    bound();
+    ctx().framebuffer = framebuffer;
+}
+
+void glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) { stateChanged(); }
+void glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) { stateChanged(); }
+
+GLenum glCheckFramebufferStatus(GLenum target)
+{
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+void glGetFramebufferAttachmentParameteriv(GLenum target, GLenum attachment, GLenum pname, GLint* params)
+{
+    *params = 0;
+}
+
+void glGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        renderbuffers[i] = genName();
+        ctx().renderbuffers[renderbuffers[i]] = RenderbufferObject();
+    }
+}
+
+void glDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+{
+    auto& c = ctx();
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        if (c.renderbuffer == renderbuffers[i]) c.renderbuffer = 0;
+        c.renderbuffers.erase(renderbuffers[i]);
+    }
+}
+
+GLboolean glIsRenderbuffer(GLuint renderbuffer)
+{
+    return renderbuffer != 0 && ctx().renderbuffers.count(renderbuffer) > 0 ? GL_TRUE : GL_FALSE;
+}
+
+void glBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    bound();
+    ctx().renderbuffer = renderbuffer;
+}
+
+void glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    auto& c = ctx();
+    auto iter = c.renderbuffers.find(c.renderbuffer);
+    if (iter == c.renderbuffers.end())
+        return;
+
+    iter->second.format = internalformat;
+    iter->second.width = width;
+    iter->second.height = height;
+}
+
+void glGetRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params)
+{
+    auto& c = ctx();
+    auto iter = c.renderbuffers.find(c.renderbuffer);
+    *params = 0;
+    if (iter == c.renderbuffers.end())
+        return;
+
+    if (pname == GL_RENDERBUFFER_WIDTH)
+        *params = iter->second.width;
+    else if (pname == GL_RENDERBUFFER_HEIGHT)
+        *params = iter->second.height;
+    else if (pname == GL_RENDERBUFFER_INTERNAL_FORMAT)
+        *params = iter->second.format;
+}
+
+// Shaders and programs, compiling and linking always succeed
+
+GLuint glCreateShader(GLenum type)
+{
+    GLuint shader = genName();
+    ctx().shaders[shader].type = type;
+    return shader;
+}
+
+void glDeleteShader(GLuint shader)
+{
+    ctx().shaders.erase(shader);
+}
+
+GLboolean glIsShader(GLuint shader)
+{
+    return ctx().shaders.count(shader) > 0 ? GL_TRUE : GL_FALSE;
+}
+
+void glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+{
+    auto& c = ctx();
+    auto iter = c.shaders.find(shader);
+    if (iter == c.shaders.end())
+        return;
+
+    std::string& source = iter->second.source;
+    source.clear();
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        if (length != nullptr && length[i] >= 0)
+            source.append(string[i], length[i]);
+        else
+            source.append(string[i]);
+    }
+}
+
+void glCompileShader(GLuint shader) {}
+
+void glGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    auto& c = ctx();
+    auto iter = c.shaders.find(shader);
+    switch (pname)
+    {
+        case GL_SHADER_TYPE: *params = iter != c.shaders.end() ? iter->second.type : 0; break;
+        case GL_COMPILE_STATUS: *params = GL_TRUE; break;
+        case GL_SHADER_SOURCE_LENGTH: *params = iter != c.shaders.end() ? (GLint)iter->second.source.size() + 1 : 0; break;
+        default: *params = 0; break;
+    }
+}
+
+void glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    copyName("", bufSize, length, infoLog);
+}
+
+void glGetShaderSource(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* source)
+{
+    auto& c = ctx();
+    auto iter = c.shaders.find(shader);
+    copyName(iter != c.shaders.end() ? iter->second.source : "", bufSize, length, source);
+}
+
+GLuint glCreateProgram(void)
+{
+    GLuint program = genName();
+    ctx().programs[program] = ProgramObject();
+    return program;
+}
+
+void glDeleteProgram(GLuint program)
+{
+    auto& c = ctx();
+    if (c.program == program) c.program = 0;
+    c.programs.erase(program);
+}
+
+GLboolean glIsProgram(GLuint program)
+{
+    return ctx().programs.count(program) > 0 ? GL_TRUE : GL_FALSE;
+}
+
+void glAttachShader(GLuint program, GLuint shader)
+{
+    auto& c = ctx();
+    auto iter = c.programs.find(program);
+    if (iter != c.programs.end())
+        iter->second.shaders.push_back(shader);
+}
+
+void glDetachShader(GLuint program, GLuint shader)
+{
+    auto& c = ctx();
+    auto iter = c.programs.find(program);
+    if (iter != c.programs.end())
+        eraseName(iter->second.shaders, shader);
+}
+
+void glGetAttachedShaders(GLuint program, GLsizei maxCount, GLsizei* count, GLuint* shaders)
+{
+    auto& c = ctx();
+    auto iter = c.programs.find(program);
+    GLsizei n = 0;
+    if (iter != c.programs.end())
+    {
+        n = std::min<GLsizei>(maxCount, (GLsizei)iter->second.shaders.size());
+        std::copy(iter->second.shaders.begin(), iter->second.shaders.begin() + n, shaders);
+    }
+    if (count != nullptr)
+        *count = n;
+}
+
+void glBindAttribLocation(GLuint program, GLuint index, const GLchar* name)
+{
+    auto& c = ctx();
+    auto iter = c.programs.find(program);
+    if (iter != c.programs.end())
+        iter->second.boundAttribLocations[name] = index;
+}
+
+void glLinkProgram(GLuint program)
+{
+    auto& c = ctx();
+    auto iter = c.programs.find(program);
+    if (iter == c.programs.end())
+        return;
+
+    auto& programObject = iter->second;
+    programObject.attributes.clear();
+    programObject.uniforms.clear();
+    for (GLuint shader : programObject.shaders)
+    {
+        auto shaderIter = c.shaders.find(shader);
+        if (shaderIter == c.shaders.end())
+            continue;
+
+        std::vector<ActiveVariable> attributes;
+        parseDeclarations(shaderIter->second.source, attributes, programObject.uniforms);
+        // attributes are only inputs of the vertex stage
+        if (shaderIter->second.type == GL_VERTEX_SHADER)
+            programObject.attributes.insert(programObject.attributes.end(), attributes.begin(), attributes.end());
+    }
+    programObject.linked = true;
+}
+
+void glValidateProgram(GLuint program) {}
+
+void glUseProgram(GLuint program)
+{
+    bound();
+    ctx().program = program;
+}
+
+void glGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    auto& c = ctx();
+    auto iter = c.programs.find(program);
+    if (iter == c.programs.end())
+    {
+        *params = 0;
+        return;
+    }
+
+    const auto& programObject = iter->second;
+    switch (pname)
+    {
+        case GL_LINK_STATUS: *params = programObject.linked ? GL_TRUE : GL_FALSE; break;
+        case GL_VALIDATE_STATUS: *params = GL_TRUE; break;
+        case GL_ATTACHED_SHADERS: *params = (GLint)programObject.shaders.size(); break;
+        case GL_ACTIVE_ATTRIBUTES: *params = (GLint)programObject.attributes.size(); break;
+        case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH: *params = maxNameLength(programObject.attributes); break;
+        case GL_ACTIVE_UNIFORMS: *params = (GLint)programObject.uniforms.size(); break;
+        case GL_ACTIVE_UNIFORM_MAX_LENGTH: *params = maxNameLength(programObject.uniforms); break;
+        default: *params = 0; break;
+    }
+}
+
+void glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    copyName("", bufSize, length, infoLog);
+}
+
+void glGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    auto& c = ctx();
+    auto iter = c.programs.find(program);
+    if (iter != c.programs.end())
+        getActiveVariable(iter->second.attributes, index, false, bufSize, length, size, type, name);
+}
+
+void glGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    auto& c = ctx();
+    auto iter = c.programs.find(program);
+    if (iter != c.programs.end())
+        getActiveVariable(iter->second.uniforms, index, true, bufSize, length, size, type, name);
+}
+
+GLint glGetAttribLocation(GLuint program, const GLchar* name)
+{
+    auto& c = ctx();
+    auto iter = c.programs.find(program);
+    if (iter == c.programs.end())
+        return -1;
+
+    const auto& programObject = iter->second;
+    auto boundIter = programObject.boundAttribLocations.find(name);
+    if (boundIter != programObject.boundAttribLocations.end())
+        return boundIter->second;
+
+    for (size_t i = 0, n = programObject.attributes.size(); i < n; ++i)
+    {
+        if (programObject.attributes[i].name == name)
+            return (GLint)i;
+    }
+    return -1;
+}
+
+GLint glGetUniformLocation(GLuint program, const GLchar* name)
+{
+    auto& c = ctx();
+    auto iter = c.programs.find(program);
+    if (iter == c.programs.end())
+        return -1;
+
+    // "name" and "name[0]" address the same uniform
+    std::string uniformName(name);
+    size_t pos = uniformName.find("[0]");
+    if (pos != std::string::npos && pos + 3 == uniformName.size())
+        uniformName.resize(pos);
+
+    const auto& uniforms = iter->second.uniforms;
+    for (size_t i = 0, n = uniforms.size(); i < n; ++i)
+    {
+        if (uniforms[i].name == uniformName)
+            return (GLint)i;
+    }
+    return -1;
+}
+
+void glGetUniformfv(GLuint program, GLint location, GLfloat* params)
+{
+    *params = 0.f;
+}
+
+void glGetUniformiv(GLuint program, GLint location, GLint* params)
+{
+    *params = 0;
+}
+
+// Uniforms, only counted
+
+void glUniform1f(GLint location, GLfloat v0) { uniformUpdated(); }
+void glUniform2f(GLint location, GLfloat v0, GLfloat v1) { uniformUpdated(); }
+void glUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) { uniformUpdated(); }
+void glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) { uniformUpdated(); }
+void glUniform1i(GLint location, GLint v0) { uniformUpdated(); }
+void glUniform2i(GLint location, GLint v0, GLint v1) { uniformUpdated(); }
+void glUniform3i(GLint location, GLint v0, GLint v1, GLint v2) { uniformUpdated(); }
+void glUniform4i(GLint location, GLint v0, GLint v1, GLint v2, GLint v3) { uniformUpdated(); }
+void glUniform1fv(GLint location, GLsizei count, const GLfloat* value) { uniformUpdated(); }
+void glUniform2fv(GLint location, GLsizei count, const GLfloat* value) { uniformUpdated(); }
+void glUniform3fv(GLint location, GLsizei count, const GLfloat* value) { uniformUpdated(); }
+void glUniform4fv(GLint location, GLsizei count, const GLfloat* value) { uniformUpdated(); }
+void glUniform1iv(GLint location, GLsizei count, const GLint* value) { uniformUpdated(); }
+void glUniform2iv(GLint location, GLsizei count, const GLint* value) { uniformUpdated(); }
+void glUniform3iv(GLint location, GLsizei count, const GLint* value) { uniformUpdated(); }
+void glUniform4iv(GLint location, GLsizei count, const GLint* value) { uniformUpdated(); }
+void glUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) { uniformUpdated(); }
+void glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) { uniformUpdated(); }
+void glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) { uniformUpdated(); }
+
+} // extern "C"
+
+#else // USE_GFX_NULL
+
+RENDERER_BEGIN
+
+const NullGraphics::Stats& NullGraphics::getStats()
+{
+    static Stats stats;
+    return stats;
+}
+
+void NullGraphics::resetStats()
+{
+}
+
+RENDERER_END
+
+#endif // USE_GFX_NULL
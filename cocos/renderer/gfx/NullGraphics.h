@@ -0,0 +1,89 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../Macro.h"
+#include "base/ccConfig.h"
+#include <stdint.h>
+
+RENDERER_BEGIN
+
+/**
+ * @addtogroup gfx
+ * @{
+ */
+
+/**
+ * @brief Null graphics backend of headless builds.\n
+ * When USE_GFX_NULL is enabled, NullGraphics.cpp implements the GL entry points used by the engine,
+ * so DeviceGraphics, VertexBuffer, IndexBuffer, Texture2D and the rest of gfx run unchanged without a GPU.
+ * Nothing is rasterized, objects, bindings and state are tracked just enough to answer queries,
+ * and the work a driver would get is counted in Stats.
+ * @note The null backend is not thread safe, like a GL context it must be used by the rendering thread only.
+ */
+class NullGraphics
+{
+public:
+    /**
+     * @brief Work counters since the last resetStats.
+     */
+    struct Stats
+    {
+        /** glDrawArrays and glDrawElements calls */
+        uint32_t drawCalls = 0;
+        /** Vertices or indices submitted by draw calls */
+        uint64_t drawnElements = 0;
+        /** Calls changing fixed function state, such as blend, depth, stencil, cull and viewport */
+        uint32_t stateChanges = 0;
+        /** Buffer, texture, framebuffer, vertex array and program bindings */
+        uint32_t bindings = 0;
+        /** glUniform* calls */
+        uint32_t uniformUpdates = 0;
+        /** Bytes uploaded by glBufferData and glBufferSubData */
+        uint64_t bufferUploadBytes = 0;
+        /** Bytes uploaded by glTexImage2D, glTexSubImage2D and the compressed variants */
+        uint64_t textureUploadBytes = 0;
+        /** glClear calls */
+        uint32_t clears = 0;
+    };
+
+    /**
+     * @brief Whether the null backend is compiled in, it's the value of USE_GFX_NULL.
+     */
+    static bool isEnabled() { return USE_GFX_NULL > 0; }
+    /**
+     * @brief Gets the counters, they stay zero when the null backend isn't enabled.
+     */
+    static const Stats& getStats();
+    /**
+     * @brief Resets the counters, usually once per frame or per benchmark sample.
+     */
+    static void resetStats();
+};
+
+// end of gfx group
+/// @}
+
+RENDERER_END
@@ -29,10 +29,46 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+#include <EGL/egl.h>
+#endif
+
 namespace {
 
     uint32_t _genID = 0;
 
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+    // OES_get_program_binary, resolved at runtime since not every driver exports it
+    PFNGLGETPROGRAMBINARYOESPROC _glGetProgramBinary = nullptr;
+    PFNGLPROGRAMBINARYOESPROC _glProgramBinary = nullptr;
+    #define CC_GL_PROGRAM_BINARY_LENGTH GL_PROGRAM_BINARY_LENGTH_OES
+    #define CC_GL_NUM_PROGRAM_BINARY_FORMATS GL_NUM_PROGRAM_BINARY_FORMATS_OES
+
+    bool loadProgramBinaryFuncs()
+    {
+        static bool loaded = false;
+        static bool supported = false;
+        if (loaded)
+            return supported;
+        
+        loaded = true;
+        _glGetProgramBinary = (PFNGLGETPROGRAMBINARYOESPROC)eglGetProcAddress("glGetProgramBinaryOES");
+        _glProgramBinary = (PFNGLPROGRAMBINARYOESPROC)eglGetProcAddress("glProgramBinaryOES");
+        if (_glGetProgramBinary && _glProgramBinary)
+        {
+            GLint formatNum = 0;
+            glGetIntegerv(CC_GL_NUM_PROGRAM_BINARY_FORMATS, &formatNum);
+            supported = formatNum > 0;
+        }
+        return supported;
+    }
+#else
+    bool loadProgramBinaryFuncs()
+    {
+        return false;
+    }
+#endif
+
     std::string logForOpenGLShader(GLuint shader)
     {
         GLint logLength = 0;
@@ -267,17 +303,89 @@ void Program::link()
         return;
     }
 
+    _linkedFromBinary = linkBinary();
+    if (!_linkedFromBinary && !linkSources())
+        return;
+
+    // the binary is only needed by one link
+    _binary.clear();
+    _binary.shrink_to_fit();
+
+    parseActiveInfo();
+    _linked = true;
+}
+
+bool Program::isBinarySupported()
+{
+    return loadProgramBinaryFuncs();
+}
+
+void Program::setBinary(uint32_t format, const std::vector<uint8_t>& binary)
+{
+    _binaryFormat = format;
+    _binary = binary;
+}
+
+bool Program::getBinary(uint32_t& format, std::vector<uint8_t>& binary) const
+{
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+    if (!_linked || !loadProgramBinaryFuncs())
+        return false;
+
+    GLint length = 0;
+    GL_CHECK(glGetProgramiv(_glID, CC_GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0)
+        return false;
+
+    GLenum binaryFormat = 0;
+    binary.resize(length);
+    _glGetProgramBinary(_glID, length, nullptr, &binaryFormat, binary.data());
+    format = (uint32_t)binaryFormat;
+    return glGetError() == GL_NO_ERROR;
+#else
+    return false;
+#endif
+}
+
+bool Program::linkBinary()
+{
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+    if (_binary.empty() || !loadProgramBinaryFuncs())
+        return false;
+
+    GLuint program = glCreateProgram();
+    _glProgramBinary(program, (GLenum)_binaryFormat, _binary.data(), (GLint)_binary.size());
+
+    // binaries are rejected after a driver update, it's not an error
+    GLint status = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (glGetError() != GL_NO_ERROR || status == GL_FALSE)
+    {
+        RENDERER_LOGD("Program binary is rejected, compile it from sources.");
+        glDeleteProgram(program);
+        return false;
+    }
+
+    _glID = program;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Program::linkSources()
+{
     GLuint vertShader;
     bool ok = _createShader(GL_VERTEX_SHADER, _vertSource, &vertShader);
     if (!ok)
-        return;
+        return false;
 
     GLuint fragShader;
     ok = _createShader(GL_FRAGMENT_SHADER, _fragSource, &fragShader);
     if (!ok)
     {
         glDeleteShader(vertShader);
-        return;
+        return false;
     }
 
     GLuint program = glCreateProgram();
@@ -296,13 +404,19 @@ void Program::link()
         glDeleteShader(vertShader);
         glDeleteShader(fragShader);
         glDeleteProgram(program);
-        return;
+        return false;
     }
 
     glDeleteShader(vertShader);
     glDeleteShader(fragShader);
 
     _glID = program;
+    return true;
+}
+
+void Program::parseActiveInfo()
+{
+    GLuint program = _glID;
 
     // parse attribute
     GLint numAttributes;
@@ -391,8 +505,6 @@ void Program::link()
             free(uniformName);
         }
     }
-
-    _linked = true;
 }
 
 RENDERER_END
@@ -143,13 +143,45 @@ public:
      */
     inline bool isLinked() const { return _linked; }
     /**
-     * Link the program with its shader sources
+     * Link the program, it tries the program binary first if there is one, then falls back to shader sources
      */
     void link();
     
+    /**
+     * Indicates whether the driver can save and load program binaries
+     */
+    static bool isBinarySupported();
+    /**
+     * Sets a program binary saved by getBinary, it's used by the next link
+     * @param[in] format Driver specific binary format
+     * @param[in] binary Binary data
+     */
+    void setBinary(uint32_t format, const std::vector<uint8_t>& binary);
+    /**
+     * Gets the binary of a linked program
+     * @param[out] format Driver specific binary format
+     * @param[out] binary Binary data
+     * @return false if the program is not linked or the driver doesn't support program binaries
+     */
+    bool getBinary(uint32_t& format, std::vector<uint8_t>& binary) const;
+    /**
+     * Indicates whether the program is linked from binary instead of compiled from sources
+     */
+    inline bool isLinkedFromBinary() const { return _linkedFromBinary; }
+    
     inline size_t getHash() const { return _hash; }
     inline void setHash(size_t hash) { _hash = hash; }
+    
+    /**
+     * Gets the builtin uniforms of the renderer the program reads, a bit mask cached by the renderer, 0 until it's set
+     */
+    inline uint32_t getUniformUsage() const { return _uniformUsage; }
+    inline void setUniformUsage(uint32_t usage) { _uniformUsage = usage; }
 private:
+    bool linkBinary();
+    bool linkSources();
+    void parseActiveInfo();
+    
     DeviceGraphics* _device;
     std::vector<Attribute> _attributes;
     std::vector<Uniform> _uniforms;
@@ -158,6 +190,11 @@ private:
     uint32_t _id;
     bool _linked;
     size_t _hash = 0;
+    uint32_t _uniformUsage = 0;
+    
+    uint32_t _binaryFormat = 0;
+    std::vector<uint8_t> _binary;
+    bool _linkedFromBinary = false;
 };
 
 // end of gfx group
@@ -109,6 +109,23 @@ void VertexBuffer::update(uint32_t offset, const void* data, size_t dataByteLeng
     ccBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+void VertexBuffer::orphan(uint32_t bytes)
+{
+    if (_glID == 0)
+    {
+        RENDERER_LOGE("The buffer is destroyed");
+        return;
+    }
+    
+    _bytes = bytes;
+    _numVertices = _bytes / _format->_bytes;
+    
+    ccBindBuffer(GL_ARRAY_BUFFER, _glID);
+    glBufferData(GL_ARRAY_BUFFER, _bytes, nullptr, (GLenum)_usage);
+    _needExpandDataStore = false;
+    ccBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 void VertexBuffer::destroy()
 {
     if (_glID == 0)
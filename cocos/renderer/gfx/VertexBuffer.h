@@ -77,6 +77,11 @@ public:
      * @param[in] dataByteLength Data byte length to be updated.
      */
     void update(uint32_t offset, const void* data, size_t dataByteLength);
+    /**
+     * Re-specifies the GL buffer storage with undefined content, draws still reading the old storage are not waited for
+     * @param[in] bytes Byte size of the new storage.
+     */
+    void orphan(uint32_t bytes);
 
     /**
      * Gets the count of vertices
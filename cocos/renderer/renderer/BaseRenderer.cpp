@@ -37,9 +37,18 @@
 #include "Model.h"
 #include "math/MathUtil.h"
 #include "Program.h"
+#include "../scene/JobSystem.hpp"
+#include "../scene/Profiler.hpp"
 
 RENDERER_BEGIN
 
+namespace {
+    // models per extract job chunk, culling and extracting a model is only a few loads
+    const std::size_t ExtractJobGrain = 256;
+    // below it waking workers costs more than extracting on the calling thread
+    const std::size_t ExtractUseThreadModelCount = 1024;
+}
+
 const size_t BaseRenderer::cc_lightDirection = std::hash<std::string>{}("cc_lightDirection");
 const size_t BaseRenderer::cc_lightColor = std::hash<std::string>{}("cc_lightColor");
 const size_t BaseRenderer::cc_lightPositionAndRange = std::hash<std::string>{}("cc_lightPositionAndRange");
@@ -66,8 +75,6 @@ const size_t BaseRenderer::cc_shadow_map[4] = {
 
 BaseRenderer::BaseRenderer()
 {
-    _drawItems = new RecyclePool<DrawItem>([]()mutable->DrawItem*{return new DrawItem();},100);
-    _stageInfos = new RecyclePool<StageInfo>([]()mutable->StageInfo*{return new StageInfo();}, 10);
     _views = new RecyclePool<View>([]()mutable->View*{return new View();}, 8);
     
     _tmpMat4 = new cocos2d::Mat4();
@@ -84,12 +91,6 @@ BaseRenderer::~BaseRenderer()
     RENDERER_SAFE_RELEASE(_defaultTexture);
     _defaultTexture = nullptr;
     
-    delete _drawItems;
-    _drawItems = nullptr;
-    
-    delete _stageInfos;
-    _stageInfos = nullptr;
-    
     delete _views;
     _views = nullptr;
     
@@ -117,7 +118,32 @@ bool BaseRenderer::init(DeviceGraphics* device, std::vector<ProgramLib::Template
 
 void BaseRenderer::registerStage(const std::string& name, const StageCallback& callback)
 {
-    _stage2fn.emplace(std::make_pair(name, callback));
+    Config::addStage(name);
+    int stageID = Config::getStageID(name);
+    if (stageID == -1)
+    {
+        RENDERER_LOGW("Failed to register stage %s", name.c_str());
+        return;
+    }
+    _stage2fn.emplace(std::make_pair((uint32_t)stageID, callback));
+}
+
+void BaseRenderer::prepareEffect(EffectBase* effect)
+{
+    if (!effect || !_programLib)
+    {
+        return;
+    }
+    
+    std::vector<const OrderedValueMap*> defines;
+    for (const Pass* pass : effect->getPasses())
+    {
+        defines.clear();
+        size_t definesHash = _definesHash;
+        pass->extractDefines(definesHash, defines);
+        defines.push_back(&_defines);
+        _programLib->prepareProgram(pass->getHashName(), definesHash, defines);
+    }
 }
 
 // protected functions
@@ -139,66 +165,131 @@ void BaseRenderer::render(const View& view, const Scene* scene)
         clearColor = view.color;
     _device->clear(view.clearFlags, &clearColor, view.depth, view.stencil);
     
-    // get all draw items
-    _drawItems->reset();
-    for (const auto& model : scene->getModels())
+    // intern the stages of view, stages without callback are skipped
+    uint32_t viewStages = 0;
+    size_t stageCount = view.stages.size();
+    if (_stageBuckets.size() < stageCount)
     {
-        int modelMask = model->getCullingMask();
-        if ((modelMask & view.cullingMask) == 0)
-            continue;
-        
-        DrawItem* drawItem = _drawItems->add();
-        model->extractDrawItem(*drawItem);
+        _stageBuckets.resize(stageCount);
+    }
+    for (size_t i = 0; i < stageCount; i++)
+    {
+        StageBucket& bucket = _stageBuckets[i];
+        int stageID = Config::getStageID(view.stages[i]);
+        auto foundIter = _stage2fn.find((uint32_t)stageID);
+        bucket.items.clear();
+        bucket.stageID = 0;
+        bucket.callback = nullptr;
+        if (stageID != -1 && _stage2fn.end() != foundIter)
+        {
+            bucket.stageID = (uint32_t)stageID;
+            bucket.callback = &foundIter->second;
+            viewStages |= bucket.stageID;
+        }
     }
     
-    // dispatch draw items to different stage
-    _stageInfos->reset();
+    // get all draw items
+    extractDrawItems(view, scene, viewStages);
+    
+    // dispatch draw items to stage buckets in model order
     StageItem stageItem;
-    for (const auto& stage : view.stages)
+    for (size_t i = 0, len = _drawItems.size(); i < len; i++)
     {
-        StageInfo* stageInfo = _stageInfos->add();
-        stageInfo->stage = stage;
-        stageInfo->items.clear();
-        for (size_t i = 0, len = _drawItems->getLength(); i < len; i++)
+        uint32_t itemStages = _drawItemStages[i];
+        if (itemStages == 0)
+        {
+            continue;
+        }
+        
+        const DrawItem& item = _drawItems[i];
+        const auto& passes = item.effect->getPasses();
+        size_t passCount = (size_t)passes.size();
+        if (passCount > StageItem::MAX_PASS_COUNT)
+        {
+            passCount = StageItem::MAX_PASS_COUNT;
+        }
+        for (size_t j = 0; j < stageCount; j++)
         {
-            const DrawItem* item = _drawItems->getData(i);
+            StageBucket& bucket = _stageBuckets[j];
+            if ((itemStages & bucket.stageID) == 0)
+            {
+                continue;
+            }
             
-            stageItem.passes.clear();
-            for (const Pass* p : item->effect->getPasses())
+            stageItem.passMask = 0;
+            stageItem.passCount = 0;
+            for (size_t k = 0; k < passCount; k++)
             {
-                if (p->getStage() == stage)
+                if (passes.at(k)->getStageID() == bucket.stageID)
                 {
-                    stageItem.passes.push_back(p);
+                    stageItem.passMask |= 1u << k;
+                    stageItem.passCount++;
                 }
             }
-            if (stageItem.passes.size() == 0)
-            {
-                continue;
-            }
             
-            stageItem.model = item->model;
-            stageItem.ia = item->ia;
-            stageItem.effect = item->effect;
+            stageItem.model = item.model;
+            stageItem.ia = item.ia;
+            stageItem.effect = item.effect;
             stageItem.sortKey = -1;
             
-            stageInfo->items.push_back(stageItem);
+            bucket.items.push_back(stageItem);
         }
     }
     
     // render stages
-    std::unordered_map<std::string, const StageCallback>::iterator foundIter;
-    for (size_t i = 0, len = _stageInfos->getLength(); i < len; i++)
+    for (size_t i = 0; i < stageCount; i++)
     {
-        StageInfo* stageInfo = _stageInfos->getData(i);
-        foundIter = _stage2fn.find(stageInfo->stage);
-        if (_stage2fn.end() != foundIter)
+        StageBucket& bucket = _stageBuckets[i];
+        if (bucket.callback)
         {
-            auto& fn = foundIter->second;
-            fn(view, stageInfo->items);
+            RENDER_PROFILE_COUNT(STAGE_ITEMS, bucket.items.size());
+            (*bucket.callback)(view, bucket.items);
         }
     }
 }
 
+void BaseRenderer::extractDrawItems(const View& view, const Scene* scene, uint32_t viewStages)
+{
+    RENDER_PROFILE_SCOPE(EXTRACT_ITEMS);
+    const auto& models = scene->getModels();
+    size_t modelCount = models.size();
+    _drawItems.resize(modelCount);
+    _drawItemStages.resize(modelCount);
+    
+    // every model writes its own slot, so culling and extracting can be spread over workers
+    auto extract = [&](std::size_t begin, std::size_t end, int tid)
+    {
+        for (std::size_t i = begin; i < end; i++)
+        {
+            const Model* model = models[i];
+            uint32_t itemStages = 0;
+            if ((model->getCullingMask() & view.cullingMask) != 0)
+            {
+                DrawItem& drawItem = _drawItems[i];
+                model->extractDrawItem(drawItem);
+                if (drawItem.effect)
+                {
+                    for (const Pass* pass : drawItem.effect->getPasses())
+                    {
+                        itemStages |= pass->getStageID();
+                    }
+                }
+            }
+            _drawItemStages[i] = itemStages & viewStages;
+        }
+    };
+    
+    JobSystem* jobSystem = JobSystem::getInstance();
+    if (jobSystem && modelCount >= ExtractUseThreadModelCount)
+    {
+        jobSystem->parallelFor(modelCount, ExtractJobGrain, extract);
+    }
+    else
+    {
+        extract(0, modelCount, 0);
+    }
+}
+
 void BaseRenderer::setProperty (const Effect::Property* prop)
 {
     Technique::Parameter::Type propType = prop->getType();
@@ -270,17 +361,72 @@ std::vector<const OrderedValueMap*> BaseRenderer::__tmp_defines__;
 void BaseRenderer::draw(const StageItem& item)
 {
     const Mat4& worldMatrix = item.model->getWorldMatrix();
-    _device->setUniformMat4(cc_matWorld, worldMatrix);
-    
-    _tmpMat4->set(worldMatrix);
-    _tmpMat4->inverse();
-    _tmpMat4->transpose();
-    _device->setUniformMat4(cc_matWorldIT, *_tmpMat4);
+    bool worldSubmitted = false;
+    bool worldITSubmitted = false;
     
     auto ia = item.ia;
-    // for each pass
-    for (const auto& pass : item.passes)
+    const auto& passes = item.effect->getPasses();
+    // for each pass of the stage
+    for (size_t i = 0, len = passes.size(); i < len && i < StageItem::MAX_PASS_COUNT; i++)
     {
+        if ((item.passMask & (1u << i)) == 0)
+        {
+            continue;
+        }
+        const Pass* pass = passes.at(i);
+        
+        // get program, the define list is only needed when the variant is not linked yet
+        size_t definesHash = _definesHash;
+        pass->extractDefinesHash(definesHash);
+        Program* program = _programLib->getProgram(pass->getHashName(), definesHash);
+        if (!program)
+        {
+            __tmp_defines__.clear();
+            size_t hash = _definesHash;
+            pass->extractDefines(hash, __tmp_defines__);
+            __tmp_defines__.push_back(&_defines);
+            program = _programLib->switchProgram(pass->getHashName(), definesHash, __tmp_defines__);
+        }
+        if (!program)
+        {
+            continue;
+        }
+        
+        if (_program != program)
+        {
+            _program = program;
+            _programSwitchCount++;
+        }
+        else
+        {
+            _sameProgramCount++;
+        }
+        _device->setProgram(_program);
+        
+        // world matrices, 2D programs usually read neither of them
+        uint32_t usage = getUniformUsage(_program);
+        if ((usage & USE_MAT_WORLD) && !worldSubmitted)
+        {
+            _device->setUniformMat4(cc_matWorld, worldMatrix);
+            worldSubmitted = true;
+        }
+        if ((usage & USE_MAT_WORLD_IT) && !worldITSubmitted)
+        {
+            _tmpMat4->set(worldMatrix);
+            _tmpMat4->inverse();
+            _tmpMat4->transpose();
+            _device->setUniformMat4(cc_matWorldIT, *_tmpMat4);
+            worldITSubmitted = true;
+        }
+        if (!(usage & USE_MAT_WORLD))
+        {
+            _skippedMatrixCount++;
+        }
+        if (!(usage & USE_MAT_WORLD_IT))
+        {
+            _skippedMatrixCount++;
+        }
+        
         // set vertex buffer
         _device->setVertexBuffer(0, ia->getVertexBuffer());
         
@@ -291,14 +437,6 @@ void BaseRenderer::draw(const StageItem& item)
         // set primitive type
         _device->setPrimitiveType(ia->_primitiveType);
         
-        // get program
-        __tmp_defines__.clear();
-        size_t definesHash = _definesHash;
-        pass->extractDefines(definesHash, __tmp_defines__);
-        __tmp_defines__.push_back(&_defines);
-        _program = _programLib->switchProgram(pass->getHashName(), definesHash, __tmp_defines__);
-        _device->setProgram(_program);
-        
         for (auto& uniform : _program->getUniforms())
         {
             auto prop = pass->getProperty(uniform.hashName);
@@ -357,11 +495,38 @@ void BaseRenderer::draw(const StageItem& item)
         
         // draw pass
         _device->draw(ia->_start, ia->getPrimitiveCount());
+        _drawCount++;
+        RENDER_PROFILE_COUNT(DRAW_CALLS, 1);
+        RENDER_PROFILE_COUNT(PRIMITIVES, ia->getPrimitiveCount());
         
         resetTextureUint();
     }
 }
 
+uint32_t BaseRenderer::getUniformUsage(Program* program)
+{
+    uint32_t usage = program->getUniformUsage();
+    if (usage & USAGE_RESOLVED)
+    {
+        return usage;
+    }
+    
+    // uniforms are parsed once by link, so it's resolved once per program
+    usage = USAGE_RESOLVED;
+    for (const auto& uniform : program->getUniforms())
+    {
+        if (uniform.hashName == cc_matWorld)
+            usage |= USE_MAT_WORLD;
+        else if (uniform.hashName == cc_matWorldIT)
+            usage |= USE_MAT_WORLD_IT;
+    }
+    if (program->isLinked())
+    {
+        program->setUniformUsage(usage);
+    }
+    return usage;
+}
+
 // private functions
 
 void BaseRenderer::resetTextureUint()
@@ -381,7 +546,11 @@ int BaseRenderer::allocTextureUnit()
 void BaseRenderer::reset()
 {
     _views->reset();
-    _stageInfos->reset();
+    
+    _drawCount = 0;
+    _programSwitchCount = 0;
+    _sameProgramCount = 0;
+    _skippedMatrixCount = 0;
 }
 
 View* BaseRenderer::requestView()
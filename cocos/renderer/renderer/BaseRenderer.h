@@ -32,6 +32,7 @@
 #include "ProgramLib.h"
 #include "Model.h"
 #include "Effect.h"
+#include "Config.h"
 #include "../memop/RecyclePool.hpp"
 
 RENDERER_BEGIN
@@ -57,13 +58,23 @@ class Texture2D;
 class BaseRenderer : public Ref
 {
 public:
+    /**
+     *  @brief An item of a stage, it refers to the passes of effect which belong to the stage by bits,
+     *  so it's trivially copyable and stage item arrays can be reused without any allocation.
+     *  Only the first MAX_PASS_COUNT passes of an effect are considered.
+     */
     struct StageItem
     {
+        static const size_t MAX_PASS_COUNT = 32;
+        
         Model* model = nullptr;
         InputAssembler *ia = nullptr;
         EffectVariant* effect = nullptr;
-        std::vector<const Pass*> passes;
+        uint32_t passMask = 0;
+        int passCount = 0;
         int sortKey = -1;
+        // packed render states, see ForwardRenderer::opaqueStage
+        uint64_t stateKey = 0;
     };
     typedef std::function<void(const View&, std::vector<StageItem>&)> StageCallback;
     /**
@@ -99,18 +110,52 @@ public:
      *  @return Program library pointer.
      */
     ProgramLib* getProgramLib() const { return _programLib; };
+    /**
+     *  @brief Preprocesses program variants of all passes of the effect on worker threads, with the current renderer defines.
+     *  It's meant to be called while loading, so the first draw only needs to compile them.
+     *  @param[in] effect Effect or effect variant.
+     */
+    void prepareEffect(EffectBase* effect);
+    /**
+     *  @brief Gets the pass count drawn during the last render.
+     */
+    uint32_t getDrawCount() const { return _drawCount; };
+    /**
+     *  @brief Gets how many times the program changed between two draws during the last render.
+     */
+    uint32_t getProgramSwitchCount() const { return _programSwitchCount; };
+    /**
+     *  @brief Gets how many draws kept the program of the draw before during the last render.
+     */
+    uint32_t getSameProgramCount() const { return _sameProgramCount; };
+    /**
+     *  @brief Gets the world matrix uploads skipped during the last render because the program doesn't read them.
+     */
+    uint32_t getSkippedMatrixCount() const { return _skippedMatrixCount; };
     
 protected:
     void render(const View&, const Scene* scene);
     void draw(const StageItem& item);
     void setProperty (const Effect::Property* prop);
     
-    struct StageInfo
+    struct StageBucket
     {
     public:
         std::vector<StageItem> items;
-        std::string stage = "";
+        uint32_t stageID = 0;
+        const StageCallback* callback = nullptr;
+    };
+    
+    void extractDrawItems(const View& view, const Scene* scene, uint32_t viewStages);
+    
+    // builtin per draw uniforms a program uses, cached on the program so it goes with it
+    enum UniformUsage
+    {
+        USE_MAT_WORLD = 1 << 0,
+        USE_MAT_WORLD_IT = 1 << 1,
+        USAGE_RESOLVED = 1u << 31
     };
+    uint32_t getUniformUsage(Program* program);
     
     void resetTextureUint();
     int allocTextureUnit();
@@ -121,10 +166,19 @@ protected:
     DeviceGraphics* _device = nullptr;
     ProgramLib* _programLib = nullptr;
     Program* _program = nullptr;
+    
+    uint32_t _drawCount = 0;
+    uint32_t _programSwitchCount = 0;
+    uint32_t _sameProgramCount = 0;
+    uint32_t _skippedMatrixCount = 0;
     Texture2D* _defaultTexture = nullptr;
-    std::unordered_map<std::string, const StageCallback> _stage2fn;
-    RecyclePool<DrawItem>* _drawItems = nullptr;
-    RecyclePool<StageInfo>* _stageInfos = nullptr;
+    // keyed by the stage id interned by Config
+    std::unordered_map<uint32_t, const StageCallback> _stage2fn;
+    // indexed by model, draw item stages is 0 if the model is culled
+    std::vector<DrawItem> _drawItems;
+    std::vector<uint32_t> _drawItemStages;
+    // one bucket per stage of the view, kept between views and frames to reuse item arrays
+    std::vector<StageBucket> _stageBuckets;
     RecyclePool<View>* _views = nullptr;
     
     cocos2d::Mat4* _tmpMat4 = nullptr;
@@ -23,6 +23,7 @@
  ****************************************************************************/
 
 #include "Config.h"
+#include <assert.h>
 
 RENDERER_BEGIN
 
@@ -34,7 +35,15 @@ void Config::addStage(const std::string& name)
     if (Config::_name2stageID.end() != Config::_name2stageID.find(name))
         return;
     
-    unsigned int stageID = 1 << Config::_stageOffset;
+    // stage ids are bits of a uint32, see MAX_STAGE_COUNT
+    assert(Config::_stageOffset < MAX_STAGE_COUNT);
+    if (Config::_stageOffset >= MAX_STAGE_COUNT)
+    {
+        RENDERER_LOGW("Failed to add stage %s, at most %d stages are supported", name.c_str(), MAX_STAGE_COUNT);
+        return;
+    }
+    
+    unsigned int stageID = 1u << Config::_stageOffset;
     Config::_name2stageID[name] = stageID;
     
     ++Config::_stageOffset;
@@ -42,8 +42,15 @@ RENDERER_BEGIN
 class Config
 {
 public:
+    /**
+     *  @brief Stage id is a bit of uint32, so there are at most 32 stages.
+     */
+    static const unsigned int MAX_STAGE_COUNT = 32;
+    
     /**
      *  @brief Adds stage id by name.
+     *  @note Adding more than MAX_STAGE_COUNT stages asserts in debug builds, release builds warn and
+     *  ignore the stage, so passes of it are never rendered.
      *  @param[in] name Stage name.
      */
     static void addStage(const std::string& name);
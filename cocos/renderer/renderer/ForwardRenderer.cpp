@@ -42,6 +42,7 @@
 #include "CCApplication.h"
 
 #include "math/MathUtil.h"
+#include "../scene/Profiler.hpp"
 
 RENDERER_BEGIN
 
@@ -271,8 +272,8 @@ void ForwardRenderer::submitOtherStagesUniforms()
 
 bool ForwardRenderer::compareItems(const StageItem &a, const StageItem &b)
 {
-    size_t pa = a.passes.size();
-    size_t pb = b.passes.size();
+    int pa = a.passCount;
+    int pb = b.passCount;
     
     if (pa != pb) {
         return pa > pb;
@@ -286,6 +287,94 @@ void ForwardRenderer::sortItems(std::vector<StageItem>& items)
     std::sort(items.begin(), items.end(), compareItems);
 }
 
+namespace {
+    inline uint64_t foldBits(size_t value, int bits)
+    {
+        uint64_t v = (uint64_t)value;
+        v ^= v >> 32;
+        v ^= v >> 16;
+        return v & ((1ull << bits) - 1);
+    }
+}
+
+bool ForwardRenderer::computeStateKey(StageItem& item)
+{
+    const auto& passes = item.effect->getPasses();
+    const Pass* first = nullptr;
+    bool sortable = item.passCount > 0;
+    for (size_t i = 0, len = passes.size(); i < len && i < StageItem::MAX_PASS_COUNT; i++)
+    {
+        if ((item.passMask & (1u << i)) == 0)
+        {
+            continue;
+        }
+        
+        // only opaque depth tested passes give the same image in any order
+        const Pass* pass = passes.at(i);
+        if (pass->isBlend() || pass->isStencilTest() || !pass->isDepthTest() || !pass->isDepthWrite())
+        {
+            sortable = false;
+            break;
+        }
+        if (!first)
+        {
+            first = pass;
+        }
+    }
+    
+    if (!sortable)
+    {
+        item.stateKey = 0;
+        return false;
+    }
+    
+    // | program 20 | texture 16 | blend & depth 12 | vertex buffer 16 |
+    size_t programHash = first->getHashName();
+    first->extractDefinesHash(programHash);
+    
+    size_t stateHash = 0;
+    MathUtil::combineHash(stateHash, (size_t)first->isBlend());
+    MathUtil::combineHash(stateHash, (size_t)first->getBlendEq());
+    MathUtil::combineHash(stateHash, (size_t)first->getBlendSrc());
+    MathUtil::combineHash(stateHash, (size_t)first->getBlendDst());
+    MathUtil::combineHash(stateHash, (size_t)first->getDepthFunc());
+    MathUtil::combineHash(stateHash, (size_t)first->getCullMode());
+    
+    auto ia = item.ia;
+    item.stateKey = (foldBits(programHash, 20) << 44)
+                  | (foldBits((size_t)first->getMainTexture() >> 4, 16) << 28)
+                  | (foldBits(stateHash, 12) << 16)
+                  | foldBits(ia ? (size_t)ia->getVertexBuffer() >> 4 : 0, 16);
+    return true;
+}
+
+void ForwardRenderer::sortOpaqueItems(std::vector<StageItem>& items)
+{
+    // sort each run of sortable items by state key, other items keep their submission order
+    // so 2D content which relies on painter's order is untouched
+    size_t runStart = 0;
+    bool inRun = false;
+    for (size_t i = 0, len = items.size(); i <= len; i++)
+    {
+        bool sortable = i < len && computeStateKey(items[i]);
+        if (sortable && !inRun)
+        {
+            runStart = i;
+            inRun = true;
+        }
+        else if (!sortable && inRun)
+        {
+            if (i - runStart > 1)
+            {
+                std::stable_sort(items.begin() + runStart, items.begin() + i, [](const StageItem& a, const StageItem& b) {
+                    return a.stateKey < b.stateKey;
+                });
+            }
+            inRun = false;
+        }
+    }
+}
+
 void ForwardRenderer::drawItems(const std::vector<StageItem>& items)
 {
     size_t count = _shadowLights.size();
@@ -312,6 +401,7 @@ void ForwardRenderer::drawItems(const std::vector<StageItem>& items)
 
 void ForwardRenderer::opaqueStage(const View& view, std::vector<StageItem>& items)
 {
+    RENDER_PROFILE_SCOPE(OPAQUE_STAGE);
     // update uniforms
     _device->setUniformMat4(cc_matView, view.matView);
     _device->setUniformMat4(cc_matViewInv,view.matViewInv);
@@ -324,11 +414,16 @@ void ForwardRenderer::opaqueStage(const View& view, std::vector<StageItem>& item
     _device->setUniformVec4(cc_cameraPos, cameraPos4);
     submitLightsUniforms();
     submitOtherStagesUniforms();
+    {
+        RENDER_PROFILE_SCOPE(STAGE_SORT);
+        sortOpaqueItems(items);
+    }
     drawItems(items);
 }
 
 void ForwardRenderer::shadowStage(const View& view, std::vector<StageItem>& items)
 {
+    RENDER_PROFILE_SCOPE(SHADOW_STAGE);
     // update rendering
     submitShadowStageUniforms(view);
     
@@ -343,6 +438,7 @@ void ForwardRenderer::shadowStage(const View& view, std::vector<StageItem>& item
 
 void ForwardRenderer::transparentStage(const View& view, const std::vector<StageItem>& items)
 {
+    RENDER_PROFILE_SCOPE(TRANSPARENT_STAGE);
     // update uniforms
     _device->setUniformMat4(cc_matView, view.matView);
     _device->setUniformMat4(cc_matViewInv,view.matViewInv);
@@ -380,7 +476,10 @@ void ForwardRenderer::transparentStage(const View& view, const std::vector<Stage
         item.sortKey = -Vec3::dot(tmpVec3, camFwd);
     }
     
-    sortItems(const_cast<std::vector<StageItem>&>(items));
+    {
+        RENDER_PROFILE_SCOPE(STAGE_SORT);
+        sortItems(const_cast<std::vector<StageItem>&>(items));
+    }
     drawItems(items);
 }
 
@@ -70,6 +70,8 @@ private:
     void submitShadowStageUniforms(const View& view);
     void submitOtherStagesUniforms();
     void sortItems(std::vector<StageItem>& items);
+    void sortOpaqueItems(std::vector<StageItem>& items);
+    bool computeStateKey(StageItem& item);
     void drawItems(const std::vector<StageItem>& items);
     void opaqueStage(const View& view, std::vector<StageItem>& items);
     void shadowStage(const View& view, std::vector<StageItem>& items);
@@ -104,6 +104,7 @@ public:
      *  @brief Adds an effect.
      */
     void setEffect(EffectVariant* effect);
+    inline EffectVariant* getEffect() const { return _effect; }
     /**
      *  @brief Set user key.
      */
@@ -23,6 +23,7 @@
  ****************************************************************************/
 
 #include "Pass.h"
+#include "Config.h"
 #include "math/MathUtil.h"
 #include "Texture2D.h"
 
@@ -86,6 +87,7 @@ Pass::Pass(
 {
     _hashName = std::hash<std::string>{}(programName);
     _properties = properties;
+    updateMainTexture();
     _defines.insert(defines.begin(), defines.end());
     generateDefinesKey();
     reset();
@@ -116,6 +118,39 @@ void Pass::extractDefines(size_t& hash, std::vector<const OrderedValueMap*>& def
     defines.push_back(&_defines);
 }
 
+void Pass::extractDefinesHash(size_t& hash) const
+{
+    if (_parent) {
+        _parent->extractDefinesHash(hash);
+    }
+    
+    MathUtil::combineHash(hash, _definesHash);
+}
+
+Texture* Pass::getMainTexture() const
+{
+    if (_mainTexture) {
+        return _mainTexture;
+    }
+    
+    return _parent ? _parent->getMainTexture() : nullptr;
+}
+
+void Pass::updateMainTexture()
+{
+    _mainTexture = nullptr;
+    size_t mainHashName = 0;
+    for (const auto& iter : _properties) {
+        const auto& prop = iter.second;
+        if (prop.getType() == Technique::Parameter::Type::TEXTURE_2D && prop.getTexture()) {
+            if (!_mainTexture || iter.first < mainHashName) {
+                _mainTexture = prop.getTexture();
+                mainHashName = iter.first;
+            }
+        }
+    }
+}
+
 void Pass::setCullMode(CullMode cullMode)
 {
     _states[0] = (uint32_t)cullMode;
@@ -195,6 +230,31 @@ uint32_t Pass::getState(uint32_t index) const {
     return DEFAULT_STATES[index];
 }
 
+void Pass::setStage(const std::string& stage)
+{
+    _stage = stage;
+    _stageID = 0;
+    if (_stage != "")
+    {
+        // intern the stage here, so the renderer can bucket passes without comparing strings
+        Config::addStage(_stage);
+        int stageID = Config::getStageID(_stage);
+        _stageID = stageID == -1 ? 0 : (uint32_t)stageID;
+    }
+}
+
+uint32_t Pass::getStageID() const {
+    const Pass* parent = this;
+    while (parent) {
+        if (parent->_stage != "") {
+            return parent->_stageID;
+        }
+        parent = parent->_parent;
+    }
+    
+    return _stageID;
+}
+
 const std::string& Pass::getStage() const {
     const Pass* parent = this;
     while (parent) {
@@ -214,9 +274,11 @@ void Pass::copy(const Pass& pass)
     _parent = pass._parent;
     
     _stage = pass._stage;
+    _stageID = pass._stageID;
     
     _defines = pass._defines;
     _properties = pass._properties;
+    _mainTexture = pass._mainTexture;
     _definesHash = pass._definesHash;
     
     memcpy(_states, pass._states, PASS_VALUE_LENGTH * sizeof(uint32_t));
@@ -256,6 +318,7 @@ const Value* Pass::getDefine(const std::string& name) const
 void Pass::setProperty(size_t hashName, const Technique::Parameter& property)
 {
     _properties[hashName] = property;
+    updateMainTexture();
 }
 
 void Pass::setProperty(size_t hashName, void* value)
@@ -278,6 +341,7 @@ void Pass::setProperty(size_t hashName, void* value)
     prop->setValue(value);
     
     if (prop->getType() == Technique::Parameter::Type::TEXTURE_2D) {
+        updateMainTexture();
         if (prop->getTexture()) {
             bool isAlphaAtlas = prop->getTexture()->isAlphaAtlas();
             auto key = "CC_USE_ALPHA_ATLAS_" + prop->getName();
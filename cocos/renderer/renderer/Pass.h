@@ -25,6 +25,7 @@
 #pragma once
 
 #include <string>
+#include <string.h>
 #include <base/CCRef.h>
 #include "../Macro.h"
 #include "../Types.h"
@@ -146,8 +147,10 @@ public:
     uint32_t getState(uint32_t index) const;
     
     // stage
-    void setStage (const std::string& stage) { _stage = stage; }
+    void setStage (const std::string& stage);
     const std::string& getStage() const;
+    // stage id interned by Config, 0 means no stage
+    uint32_t getStageID() const;
     
     inline void reset () { memset(_states, -1, PASS_VALUE_LENGTH * sizeof(uint32_t)); }
     
@@ -155,6 +158,10 @@ public:
     inline const Pass* getParent() { return _parent; }
     
     void extractDefines (size_t& hash, std::vector<const OrderedValueMap*>& defines) const;
+    // same hash as extractDefines without collecting the define maps
+    void extractDefinesHash (size_t& hash) const;
+    // texture used to group draws, resolved when the properties change, falls back to the parents
+    Texture* getMainTexture () const;
     
     void generateDefinesKey ();
     inline size_t getDefinesHash() const {return _definesHash;}
@@ -170,12 +177,16 @@ public:
     const Value* getDefine(const std::string& name) const;
     void define(const std::string& name, const Value& value);
 private:
+    void updateMainTexture();
+    
     std::string _programName = "";
     size_t _hashName = 0;
     
     Pass* _parent = nullptr;
     
     std::unordered_map<size_t, Technique::Parameter> _properties;
+    // texture property with the lowest hash name, so it doesn't depend on the map order
+    Texture* _mainTexture = nullptr;
     OrderedValueMap _defines;
     size_t _definesHash = 0;
     
@@ -185,6 +196,7 @@ private:
     static uint32_t* DEFAULT_STATES;
     
     std::string _stage = "";
+    uint32_t _stageID = 0;
 };
 
 // end of renderer group
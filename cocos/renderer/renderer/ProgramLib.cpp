@@ -26,132 +26,412 @@
 #include "gfx/DeviceGraphics.h"
 
 #include "math/MathUtil.h"
+#include "base/CCThreadPool.h"
+#include "base/CCData.h"
+#include "base/uthash.h"
+#include "platform/CCFileUtils.h"
 
 #include <regex>
 #include <string>
-#include <sstream>
-#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <unordered_set>
 
 namespace {
     uint32_t _shdID = 0;
 
-    std::string generateDefines(const std::vector<const cocos2d::OrderedValueMap*>& definesList)
+    // The shader preprocessor runs in linear passes without regex. Its output is the same as the
+    // former regex implementation: macro numbers are replaced by plain substring matching, one name
+    // after another in name order, then "#pragma for" blocks are unrolled. tools/shader-preprocess
+    // compares both.
+
+    struct MacroNum
+    {
+        std::string name;
+        std::string value;
+    };
+
+    void collectMacroNums(const std::vector<const cocos2d::OrderedValueMap*>& definesList, std::vector<MacroNum>& out)
+    {
+        // later define maps take precedence, names are kept in order
+        cocos2d::OrderedValueMap cache;
+        for (int i = (int)definesList.size() - 1; i >= 0; i--)
+        {
+            const cocos2d::OrderedValueMap* defMap = definesList[i];
+            for (const auto& def : *defMap)
+            {
+                if (def.second.getType() == cocos2d::Value::Type::INTEGER || def.second.getType() == cocos2d::Value::Type::UNSIGNED)
+                {
+                    cache.emplace(def.first, def.second);
+                }
+            }
+        }
+
+        out.clear();
+        out.reserve(cache.size());
+        for (const auto& def : cache)
+        {
+            if (!def.first.empty())
+            {
+                out.push_back({ def.first, def.second.asString() });
+            }
+        }
+    }
+
+    void generateDefines(const std::vector<const cocos2d::OrderedValueMap*>& definesList, std::string& out)
     {
-        std::string ret;
-        std::string v;
-        cocos2d::ValueMap cache;
+        std::unordered_set<std::string> cache;
         for (int i = (int)definesList.size() - 1; i >= 0; i--)
         {
             const cocos2d::OrderedValueMap* defMap = definesList[i];
             for (const auto& def : *defMap)
             {
-                if (cache.find(def.first) != cache.end())
+                if (!cache.insert(def.first).second)
                 {
                     continue;
                 }
-                
+
+                out += "#define ";
+                out += def.first;
+                out += ' ';
                 if (def.second.getType() == cocos2d::Value::Type::BOOLEAN)
                 {
-                    v = def.second.asBool() ? "1" : "0";
+                    out += def.second.asBool() ? '1' : '0';
                 }
                 else
                 {
-                    v = std::to_string(def.second.asUnsignedInt());
+                    out += std::to_string(def.second.asUnsignedInt());
                 }
-                
-                ret += "#define "  + def.first + " " + v + "\n";
-                
-                cache.emplace(def.first, def.second);
+                out += '\n';
             }
         }
-       
-        return ret;
     }
 
-    std::string replaceMacroNums(const std::string str, const std::vector<const cocos2d::OrderedValueMap*>& definesList)
+    // replaces the names one after another, a later name also matches text former values were written into
+    void replaceMacroNumsInTurn(const std::string& text, const std::vector<MacroNum>& macros, std::string& out)
     {
-        cocos2d::OrderedValueMap cache;
-        std::string tmp = str;
-        for (int i = (int)definesList.size() - 1; i >= 0; i--)
+        out = text;
+        std::string replaced;
+        for (const auto& macro : macros)
         {
-            const cocos2d::OrderedValueMap* defMap = definesList[i];
+            size_t pos = out.find(macro.name);
+            if (pos == std::string::npos)
+            {
+                continue;
+            }
 
-            for (const auto& def : *defMap)
+            replaced.clear();
+            replaced.reserve(out.size());
+            size_t cur = 0;
+            while (pos != std::string::npos)
+            {
+                replaced.append(out, cur, pos - cur);
+                replaced += macro.value;
+                cur = pos + macro.name.size();
+                pos = out.find(macro.name, cur);
+            }
+            replaced.append(out, cur, std::string::npos);
+            out.swap(replaced);
+        }
+    }
+
+    void replaceMacroNums(const std::string& text, const std::vector<MacroNum>& macros, std::string& out)
+    {
+        // values are integers, only a name holding a digit or '-' can match across a value written before it
+        for (const auto& macro : macros)
+        {
+            if (macro.name.find_first_of("0123456789-") != std::string::npos)
+            {
+                replaceMacroNumsInTurn(text, macros, out);
+                return;
+            }
+        }
+
+        struct Match
+        {
+            size_t pos;
+            size_t macro;
+        };
+
+        // a name only matches text no former name has taken, just like replacing the names one by one
+        std::vector<Match> matches;
+        std::vector<bool> taken;
+        for (size_t i = 0; i < macros.size(); i++)
+        {
+            const std::string& name = macros[i].name;
+            size_t pos = text.find(name);
+            while (pos != std::string::npos)
             {
-                if (cache.find(def.first) != cache.end())
+                bool free = true;
+                if (!taken.empty())
+                {
+                    for (size_t j = pos, end = pos + name.size(); j < end && free; j++)
+                    {
+                        free = !taken[j];
+                    }
+                }
+
+                if (!free)
                 {
+                    pos = text.find(name, pos + 1);
                     continue;
                 }
-                
-                if (def.second.getType() == cocos2d::Value::Type::INTEGER || def.second.getType() == cocos2d::Value::Type::UNSIGNED)
+
+                if (taken.empty())
                 {
-                    cache.emplace(def.first, def.second);
+                    taken.resize(text.size(), false);
                 }
+                std::fill(taken.begin() + pos, taken.begin() + pos + name.size(), true);
+                matches.push_back({ pos, i });
+                pos = text.find(name, pos + name.size());
             }
         }
-        
-        for (const auto& def : cache)
+
+        std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+            return a.pos < b.pos;
+        });
+
+        out.clear();
+        out.reserve(text.size());
+        size_t cur = 0;
+        for (const auto& match : matches)
         {
-            std::regex pattern(def.first);
-            tmp = std::regex_replace(tmp, pattern, def.second.asString());
+            out.append(text, cur, match.pos - cur);
+            out += macros[match.macro].value;
+            cur = match.pos + macros[match.macro].name.size();
         }
-        
-        return tmp;
+        out.append(text, cur, std::string::npos);
     }
 
-    using RegexReplaceCallback = std::function<std::string(const std::match_results<std::string::const_iterator>&)>;
+    inline bool isWordChar(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    }
 
-    static std::string regexReplaceString(const std::string& text, const std::string& pattern, const RegexReplaceCallback& replaceCallback)
+    inline bool isDigitChar(char c)
     {
-        std::string ret = text;
-        std::regex re(pattern);
+        return c >= '0' && c <= '9';
+    }
 
-        std::string::const_iterator text_iter = text.cbegin();
-        std::match_results<std::string::const_iterator> results;
+    inline bool isSpaceChar(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+    }
 
-        size_t start = 0;
-        size_t offset = 0;
-        while (std::regex_search(text_iter, text.end(), results, re))
+    // parses "#pragma for name in range(begin, end)" at pos, returns the position after it or npos
+    size_t parseForPragma(const std::string& text, size_t pos, std::string& name, int32_t& begin, int32_t& end)
+    {
+        static const char prefix[] = "#pragma for ";
+        static const char range[] = " in range(";
+        const size_t len = text.size();
+
+        pos += sizeof(prefix) - 1;
+        size_t nameStart = pos;
+        while (pos < len && isWordChar(text[pos])) pos++;
+        if (pos == nameStart || text.compare(pos, sizeof(range) - 1, range) != 0)
+            return std::string::npos;
+        name.assign(text, nameStart, pos - nameStart);
+        pos += sizeof(range) - 1;
+
+        int32_t* bounds[2] = { &begin, &end };
+        for (int i = 0; i < 2; i++)
         {
-            offset = start + results.position();
-            std::string replacement = replaceCallback(results);
-            ret = ret.replace(offset, results.length(), replacement);
-            start = offset + replacement.length();
-
-            text_iter = results[0].second;
+            while (pos < len && isSpaceChar(text[pos])) pos++;
+            size_t numStart = pos;
+            while (pos < len && isDigitChar(text[pos])) pos++;
+            if (pos == numStart)
+                return std::string::npos;
+            *bounds[i] = atoi(text.substr(numStart, pos - numStart).c_str());
+            while (pos < len && isSpaceChar(text[pos])) pos++;
+            if (pos >= len || text[pos] != (i == 0 ? ',' : ')'))
+                return std::string::npos;
+            pos++;
         }
-
-        return ret;
+        return pos;
     }
 
-    std::string unrollLoops(const std::string& text)
+    void unrollLoops(const std::string& text, std::string& out)
     {
-        auto func = [](const std::match_results<std::string::const_iterator>& results) -> std::string {
-            assert(results.size() == 5);
-            std::string snippet = results[4].str();
-            std::string replacePatternStr = "\\{" + results[1].str() + "\\}";
-            std::regex replacePattern(replacePatternStr);
+        static const char forPragma[] = "#pragma for ";
+        static const char endPragma[] = "#pragma endFor";
+        static const size_t endLength = sizeof(endPragma) - 1;
+
+        std::string name;
+        std::string placeholder;
+        char number[16] = {0};
+        size_t cur = 0;
+        size_t search = 0;
+        while (true)
+        {
+            size_t start = text.find(forPragma, search);
+            if (start == std::string::npos)
+                break;
+
+            int32_t parsedBegin = 0;
+            int32_t parsedEnd = 0;
+            size_t bodyStart = parseForPragma(text, start, name, parsedBegin, parsedEnd);
+            // the loop body has one character at least
+            size_t bodyEnd = bodyStart == std::string::npos ? std::string::npos : text.find(endPragma, bodyStart + 1);
+            if (bodyEnd == std::string::npos)
+            {
+                search = start + 1;
+                continue;
+            }
 
-            int32_t parsedBegin = atoi(results[2].str().c_str());
-            int32_t parsedEnd = atoi(results[3].str().c_str());
             if (parsedBegin < 0 || parsedEnd < 0)
             {
                 RENDERER_LOGE("Unroll For Loops Error: begin and end of range must be an int num.");
             }
 
-            std::string unroll;
-            char tmp[256] = {0};
+            out.append(text, cur, start - cur);
+
+            placeholder = "{" + name + "}";
             for (int32_t i = parsedBegin; i < parsedEnd; ++i)
             {
-                snprintf(tmp, 256, "%d", i);
-                std::string replaceFormat(tmp);
-                unroll += std::regex_replace(snippet, replacePattern, replaceFormat);
+                snprintf(number, sizeof(number), "%d", i);
+                size_t bodyCur = bodyStart;
+                size_t found = text.find(placeholder, bodyCur);
+                while (found != std::string::npos && found + placeholder.size() <= bodyEnd)
+                {
+                    out.append(text, bodyCur, found - bodyCur);
+                    out += number;
+                    bodyCur = found + placeholder.size();
+                    found = text.find(placeholder, bodyCur);
+                }
+                out.append(text, bodyCur, bodyEnd - bodyCur);
             }
-            return unroll;
-        };
 
-        return regexReplaceString(text, "#pragma for (\\w+) in range\\(\\s*(\\d+)\\s*,\\s*(\\d+)\\s*\\)([\\s\\S]+?)#pragma endFor", func);
+            cur = bodyEnd + endLength;
+            search = cur;
+        }
+        out.append(text, cur, std::string::npos);
+    }
+
+    std::string unrollLoops(const std::string& text)
+    {
+        std::string out;
+        out.reserve(text.size());
+        unrollLoops(text, out);
+        return out;
+    }
+
+    // customDef is the output of generateDefines
+    void preprocess(const std::string& vertTemplate, const std::string& fragTemplate,
+                    const std::vector<const cocos2d::OrderedValueMap*>& definesList, std::string customDef,
+                    std::string& vert, std::string& frag)
+    {
+        std::vector<MacroNum> macros;
+        collectMacroNums(definesList, macros);
+
+        customDef += '\n';
+
+        std::string replaced;
+        replaceMacroNums(vertTemplate, macros, replaced);
+        vert = customDef;
+        unrollLoops(replaced, vert);
+
+        replaceMacroNums(fragTemplate, macros, replaced);
+        frag = customDef;
+        unrollLoops(replaced, frag);
+    }
+
+    // variant cache file: magic, version, count, then per variant
+    // variant key, source hash, vert, frag, binary format, binary, all lengths are uint32
+    const uint32_t CacheMagic = 0x56504343; // "CCPV"
+    const uint32_t CacheVersion = 2;
+
+    // std::hash may change with the standard library, hashes written to the cache file use the Jenkins hash of uthash
+    uint32_t fixedHash(const std::string& str)
+    {
+        unsigned hashv = 0, bkt = 0;
+        HASH_JEN(str.data(), (unsigned)str.size(), 1, hashv, bkt);
+        return hashv;
     }
+
+    // program name hash in the high bits, so the variants of a program are found by key
+    uint64_t variantKey(const std::string& name, const std::string& defines)
+    {
+        return ((uint64_t)fixedHash(name) << 32) | fixedHash(defines);
+    }
+
+    uint32_t programOfKey(uint64_t key)
+    {
+        return (uint32_t)(key >> 32);
+    }
+
+    void writeU32(std::vector<uint8_t>& out, uint32_t v)
+    {
+        const uint8_t* p = (const uint8_t*)&v;
+        out.insert(out.end(), p, p + sizeof(v));
+    }
+
+    void writeU64(std::vector<uint8_t>& out, uint64_t v)
+    {
+        const uint8_t* p = (const uint8_t*)&v;
+        out.insert(out.end(), p, p + sizeof(v));
+    }
+
+    void writeBytes(std::vector<uint8_t>& out, const void* bytes, size_t size)
+    {
+        writeU32(out, (uint32_t)size);
+        const uint8_t* p = (const uint8_t*)bytes;
+        out.insert(out.end(), p, p + size);
+    }
+
+    class CacheReader
+    {
+    public:
+        CacheReader(const uint8_t* data, size_t size) : _cur(data), _end(data + size) {}
+
+        bool ok() const { return _ok; }
+
+        uint32_t readU32()
+        {
+            uint32_t v = 0;
+            read(&v, sizeof(v));
+            return v;
+        }
+
+        uint64_t readU64()
+        {
+            uint64_t v = 0;
+            read(&v, sizeof(v));
+            return v;
+        }
+
+        void readString(std::string& out)
+        {
+            uint32_t size = readU32();
+            if (!check(size)) return;
+            out.assign((const char*)_cur, size);
+            _cur += size;
+        }
+
+        void readBytes(std::vector<uint8_t>& out)
+        {
+            uint32_t size = readU32();
+            if (!check(size)) return;
+            out.assign(_cur, _cur + size);
+            _cur += size;
+        }
+    private:
+        bool check(size_t size)
+        {
+            _ok = _ok && (size_t)(_end - _cur) >= size;
+            return _ok;
+        }
+
+        void read(void* out, size_t size)
+        {
+            if (!check(size)) return;
+            memcpy(out, _cur, size);
+            _cur += size;
+        }
+
+        const uint8_t* _cur = nullptr;
+        const uint8_t* _end = nullptr;
+        bool _ok = true;
+    };
 }
 
 std::string test_unrollLoops(const std::string& text)
@@ -159,10 +439,29 @@ std::string test_unrollLoops(const std::string& text)
     return unrollLoops(text);
 }
 
+std::string test_replaceMacroNums(const std::string& text, const std::vector<const cocos2d::OrderedValueMap*>& definesList)
+{
+    std::vector<MacroNum> macros;
+    collectMacroNums(definesList, macros);
+    std::string out;
+    replaceMacroNums(text, macros, out);
+    return out;
+}
+
+void test_preprocess(const std::string& vertTemplate, const std::string& fragTemplate,
+                     const std::vector<const cocos2d::OrderedValueMap*>& definesList,
+                     std::string& vert, std::string& frag)
+{
+    std::string customDef;
+    generateDefines(definesList, customDef);
+    preprocess(vertTemplate, fragTemplate, definesList, customDef, vert, frag);
+}
+
 RENDERER_BEGIN
 
 ProgramLib::ProgramLib(DeviceGraphics* device, std::vector<Template>& templates)
 : _device(device)
+, _store(std::make_shared<VariantStore>())
 {
     RENDERER_SAFE_RETAIN(_device);
     
@@ -181,6 +480,9 @@ ProgramLib::~ProgramLib()
     }
     _cache.clear();
 
+    // pending tasks keep the store alive, they only touch memory and files
+    _store.reset();
+
     RENDERER_SAFE_RELEASE(_device);
     _device = nullptr;
 }
@@ -239,6 +541,216 @@ void ProgramLib::define(const std::string& name, const std::string& vert, const
     templ.vert = newVert;
     templ.frag = newFrag;
     templ.defines = defines;
+    templ.sourceHash = ((uint64_t)fixedHash(newVert) << 32) | fixedHash(newFrag);
+    
+    std::lock_guard<std::mutex> lock(_store->mutex);
+    _store->sourceHashes[fixedHash(name)] = templ.sourceHash;
+}
+
+void ProgramLib::setCacheFile(const std::string& path)
+{
+    {
+        std::lock_guard<std::mutex> lock(_store->mutex);
+        _store->file = path;
+    }
+    
+    if (path.empty())
+    {
+        return;
+    }
+    
+    auto store = _store;
+    ThreadPool::getDefaultThreadPool()->pushTask([store, path](int tid) {
+        store->load(path);
+    });
+}
+
+void ProgramLib::prepareProgram(const size_t programNameHash, const size_t definesKeyHash, const std::vector<const OrderedValueMap*>& definesList)
+{
+    size_t programHash = 0;
+    MathUtil::combineHash(programHash, programNameHash);
+    MathUtil::combineHash(programHash, definesKeyHash);
+    
+    auto templIter = _templates.find(programNameHash);
+    if (templIter == _templates.end() || _cache.find(programHash) != _cache.end())
+    {
+        return;
+    }
+    
+    const auto& tmpl = templIter->second;
+    std::string customDef;
+    generateDefines(definesList, customDef);
+    uint64_t key = variantKey(tmpl.name, customDef);
+    {
+        std::lock_guard<std::mutex> lock(_store->mutex);
+        auto iter = _store->variants.find(key);
+        if (iter != _store->variants.end() && iter->second.sourceHash == tmpl.sourceHash)
+        {
+            return;
+        }
+    }
+    
+    // the define maps belong to passes, which may change before the task runs
+    auto defines = std::make_shared<std::vector<OrderedValueMap>>();
+    defines->reserve(definesList.size());
+    for (const auto* defMap : definesList)
+    {
+        defines->push_back(*defMap);
+    }
+    
+    auto store = _store;
+    std::string vertTemplate = tmpl.vert;
+    std::string fragTemplate = tmpl.frag;
+    uint64_t sourceHash = tmpl.sourceHash;
+    ThreadPool::getDefaultThreadPool()->pushTask([store, defines, vertTemplate, fragTemplate, customDef, sourceHash, key](int tid) {
+        std::vector<const OrderedValueMap*> list;
+        list.reserve(defines->size());
+        for (const auto& defMap : *defines)
+        {
+            list.push_back(&defMap);
+        }
+        
+        Variant variant;
+        variant.sourceHash = sourceHash;
+        preprocess(vertTemplate, fragTemplate, list, customDef, variant.vert, variant.frag);
+        
+        std::lock_guard<std::mutex> lock(store->mutex);
+        store->variants[key] = std::move(variant);
+    });
+}
+
+void ProgramLib::scheduleSave()
+{
+    // one pending save takes all variants added before it runs
+    if (_store->savePending.exchange(true))
+    {
+        return;
+    }
+    
+    auto store = _store;
+    ThreadPool::getDefaultThreadPool()->pushTask([store](int tid) {
+        store->save();
+    });
+}
+
+bool ProgramLib::VariantStore::find(uint64_t key, uint64_t sourceHash, Variant& out)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto iter = variants.find(key);
+    if (iter == variants.end())
+    {
+        return false;
+    }
+    if (iter->second.sourceHash != sourceHash)
+    {
+        variants.erase(iter);
+        return false;
+    }
+    out = iter->second;
+    return true;
+}
+
+bool ProgramLib::VariantStore::isStale(uint64_t key, const Variant& variant) const
+{
+    // variants of programs not defined yet are kept, they may be defined later
+    auto iter = sourceHashes.find(programOfKey(key));
+    return iter != sourceHashes.end() && iter->second != variant.sourceHash;
+}
+
+void ProgramLib::VariantStore::load(const std::string& path)
+{
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(path))
+    {
+        return;
+    }
+    
+    Data data = fileUtils->getDataFromFile(path);
+    CacheReader reader(data.getBytes(), (size_t)data.getSize());
+    if (reader.readU32() != CacheMagic || reader.readU32() != CacheVersion)
+    {
+        return;
+    }
+    
+    uint32_t count = reader.readU32();
+    for (uint32_t i = 0; i < count && reader.ok(); i++)
+    {
+        uint64_t key = reader.readU64();
+        Variant variant;
+        variant.sourceHash = reader.readU64();
+        reader.readString(variant.vert);
+        reader.readString(variant.frag);
+        variant.binaryFormat = reader.readU32();
+        reader.readBytes(variant.binary);
+        if (!reader.ok())
+        {
+            RENDERER_LOGW("Program variant cache %s is truncated.", path.c_str());
+            break;
+        }
+        
+        // variants added since start up are newer
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!isStale(key, variant))
+        {
+            variants.emplace(key, std::move(variant));
+        }
+    }
+}
+
+void ProgramLib::VariantStore::save()
+{
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    savePending = false;
+    
+    std::vector<uint8_t> buffer;
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        path = file;
+        if (path.empty())
+        {
+            return;
+        }
+        
+        // variants whose program sources changed since they were loaded are not written back
+        for (auto iter = variants.begin(); iter != variants.end();)
+        {
+            if (isStale(iter->first, iter->second))
+            {
+                iter = variants.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+        
+        writeU32(buffer, CacheMagic);
+        writeU32(buffer, CacheVersion);
+        writeU32(buffer, (uint32_t)variants.size());
+        for (const auto& iter : variants)
+        {
+            const Variant& variant = iter.second;
+            writeU64(buffer, iter.first);
+            writeU64(buffer, variant.sourceHash);
+            writeBytes(buffer, variant.vert.data(), variant.vert.size());
+            writeBytes(buffer, variant.frag.data(), variant.frag.size());
+            writeU32(buffer, variant.binaryFormat);
+            writeBytes(buffer, variant.binary.data(), variant.binary.size());
+        }
+    }
+    
+    // write aside and rename over the cache in one step, a killed process must not leave a half written cache
+    Data data;
+    data.copy(buffer.data(), (ssize_t)buffer.size());
+    auto fileUtils = FileUtils::getInstance();
+    std::string tmpPath = path + ".tmp";
+    if (!fileUtils->writeDataToFile(data, tmpPath) || !fileUtils->renameFile(tmpPath, path))
+    {
+        fileUtils->removeFile(tmpPath);
+    }
 }
 
 Program* ProgramLib::switchProgram(const size_t programNameHash, const size_t definesKeyHash, const std::vector<const OrderedValueMap*>& definesList)
@@ -253,7 +765,8 @@ Program* ProgramLib::switchProgram(const size_t programNameHash, const size_t de
     
     auto iter = _cache.find(programHash);
     if (iter != _cache.end()) {
-        return iter->second;
+        _current = iter->second;
+        return _current;
     }
 
     Program* program = nullptr;
@@ -262,18 +775,46 @@ Program* ProgramLib::switchProgram(const size_t programNameHash, const size_t de
     if (templIter != _templates.end())
     {
         const auto& tmpl = templIter->second;
-        std::string customDef = generateDefines(definesList) + "\n";
-        std::string vert = replaceMacroNums(tmpl.vert, definesList);
-        vert = customDef + unrollLoops(vert);
-        std::string frag = replaceMacroNums(tmpl.frag, definesList);
-        frag = customDef + unrollLoops(frag);
+        
+        // prepared on a worker thread or loaded from the cache file
+        std::string customDef;
+        generateDefines(definesList, customDef);
+        uint64_t key = variantKey(tmpl.name, customDef);
+        Variant variant;
+        bool cached = _store->find(key, tmpl.sourceHash, variant);
+        if (!cached)
+        {
+            variant.sourceHash = tmpl.sourceHash;
+            preprocess(tmpl.vert, tmpl.frag, definesList, customDef, variant.vert, variant.frag);
+        }
         
         program = new Program();
-        program->init(_device, vert.c_str(), frag.c_str());
+        program->init(_device, variant.vert.c_str(), variant.frag.c_str());
+        if (!variant.binary.empty())
+        {
+            program->setBinary(variant.binaryFormat, variant.binary);
+        }
         program->link();
         _cache.emplace(programHash, program);
         
         program->setHash(programHash);
+        
+        // persist new variants, and binaries which are missing or rejected by the driver
+        bool binaryDirty = program->isLinked() && !program->isLinkedFromBinary() && Program::isBinarySupported();
+        if (!cached || binaryDirty)
+        {
+            if (binaryDirty && !program->getBinary(variant.binaryFormat, variant.binary))
+            {
+                variant.binaryFormat = 0;
+                variant.binary.clear();
+            }
+            
+            {
+                std::lock_guard<std::mutex> lock(_store->mutex);
+                _store->variants[key] = std::move(variant);
+            }
+            scheduleSave();
+        }
     }
     
     _current = program;
@@ -281,6 +822,25 @@ Program* ProgramLib::switchProgram(const size_t programNameHash, const size_t de
     return program;
 }
 
+Program* ProgramLib::getProgram(const size_t programNameHash, const size_t definesKeyHash)
+{
+    size_t programHash = 0;
+    MathUtil::combineHash(programHash, programNameHash);
+    MathUtil::combineHash(programHash, definesKeyHash);
+    
+    if (_current && _current->getHash() == programHash) {
+        return _current;
+    }
+    
+    auto iter = _cache.find(programHash);
+    if (iter != _cache.end()) {
+        _current = iter->second;
+        return _current;
+    }
+    
+    return nullptr;
+}
+
 const Value* ProgramLib::getValueFromDefineList(const std::string& name, const std::vector<const ValueMap*>& definesList)
 {
     for (int i = (int)definesList.size() - 1; i >= 0; i--)
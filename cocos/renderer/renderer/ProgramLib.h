@@ -30,6 +30,9 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <atomic>
 
 RENDERER_BEGIN
 
@@ -57,6 +60,8 @@ public:
         std::string vert;
         std::string frag;
         ValueVector defines;
+        // hash of the sources, variants cached on disk are dropped once it changes
+        uint64_t sourceHash = 0;
     };
 
     /**
@@ -78,14 +83,62 @@ public:
      *  @note The return value needs to be released by its 'release' method.
      */
     Program* switchProgram(const size_t programNameHash, const size_t definesKeyHash, const std::vector<const OrderedValueMap*>& definesList);
+    /**
+     *  @brief Gets a linked program by template name and defines key, it never compiles.
+     *  @return The program or nullptr if it's not linked yet, then switchProgram should be used with the define settings.
+     */
+    Program* getProgram(const size_t programNameHash, const size_t definesKeyHash);
+    /**
+     *  @brief Preprocesses a program variant on a worker thread, so switchProgram only needs to compile it.
+     *  The define settings are copied, the program is created and linked when it's used first time.
+     */
+    void prepareProgram(const size_t programNameHash, const size_t definesKeyHash, const std::vector<const OrderedValueMap*>& definesList);
+    /**
+     *  @brief Sets the file of the persistent variant cache and loads it on a worker thread.
+     *  The cache holds preprocessed sources and program binaries if the driver supports them,
+     *  it's rewritten on a worker thread whenever a new variant is linked.
+     *  It's disabled until a file is set, e.g. getWritablePath() + "program-variants.bin", an empty path disables it again.
+     */
+    void setCacheFile(const std::string& path);
     
     const Value* getValueFromDefineList(const std::string& name, const std::vector<const ValueMap*>& definesList);
 
 private:
     uint32_t getValueKey(const Value* v);
     
+    struct Variant
+    {
+        uint64_t sourceHash = 0;
+        std::string vert;
+        std::string frag;
+        uint32_t binaryFormat = 0;
+        std::vector<uint8_t> binary;
+    };
+    
+    // shared with worker threads, which may finish after ProgramLib is destroyed,
+    // variants are keyed by a fixed hash of program name and defines, so the keys stay valid across builds
+    struct VariantStore
+    {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, Variant> variants;
+        // source hash of the defined programs by program name hash, variants of older sources are dropped
+        std::unordered_map<uint32_t, uint64_t> sourceHashes;
+        std::string file;
+        std::mutex fileMutex;
+        std::atomic<bool> savePending;
+        
+        VariantStore() : savePending(false) {}
+        bool find(uint64_t key, uint64_t sourceHash, Variant& out);
+        bool isStale(uint64_t key, const Variant& variant) const;
+        void load(const std::string& file);
+        void save();
+    };
+    
+    void scheduleSave();
+    
 private:
     DeviceGraphics* _device = nullptr;
+    std::shared_ptr<VariantStore> _store;
     std::unordered_map<size_t, Template> _templates;
     std::unordered_map<uint64_t, Program*> _cache;
     
@@ -0,0 +1,337 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "JobSystem.hpp"
+#include <algorithm>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
+// `thread_local` can not compile on iOS 9.0 below device
+#   define JOB_USE_THREAD_LOCAL (__IPHONE_OS_VERSION_MIN_REQUIRED >= 90000)
+#else
+#   define JOB_USE_THREAD_LOCAL 1
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_IOS
+
+#if !JOB_USE_THREAD_LOCAL
+#include <pthread.h>
+#endif
+
+RENDERER_BEGIN
+
+namespace {
+    // at most 7 workers, more lanes only add stealing traffic for per frame jobs
+    const int MaxWorkerCount = 7;
+    const int SpinCount = 2000;
+    const int SpinYieldCount = 64;
+
+    inline uint64_t packRange(uint32_t lo, uint32_t hi)
+    {
+        return ((uint64_t)hi << 32) | lo;
+    }
+
+    inline uint32_t rangeLo(uint64_t range)
+    {
+        return (uint32_t)(range & 0xffffffff);
+    }
+
+    inline uint32_t rangeHi(uint64_t range)
+    {
+        return (uint32_t)(range >> 32);
+    }
+
+    inline void spinPause(int spin)
+    {
+        if (spin >= SpinCount - SpinYieldCount)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+#if JOB_USE_THREAD_LOCAL
+    thread_local bool tl_inJob = false;
+
+    inline bool isInJob() { return tl_inJob; }
+    inline void setInJob(bool inJob) { tl_inJob = inJob; }
+#else
+    pthread_key_t s_inJobKey;
+    pthread_once_t s_inJobOnce = PTHREAD_ONCE_INIT;
+
+    void createInJobKey() { pthread_key_create(&s_inJobKey, nullptr); }
+
+    inline bool isInJob()
+    {
+        pthread_once(&s_inJobOnce, createInJobKey);
+        return pthread_getspecific(s_inJobKey) != nullptr;
+    }
+
+    inline void setInJob(bool inJob)
+    {
+        pthread_once(&s_inJobOnce, createInJobKey);
+        pthread_setspecific(s_inJobKey, inJob ? (void*)1 : nullptr);
+    }
+#endif
+}
+
+JobSystem* JobSystem::_instance = nullptr;
+
+int JobSystem::getDefaultWorkerCount()
+{
+    int coreNum = (int)std::thread::hardware_concurrency();
+    return std::max(0, std::min(coreNum - 1, MaxWorkerCount));
+}
+
+JobSystem::JobSystem(int workerNum)
+: _generation(0)
+, _activeWorkers(0)
+, _remainChunks(0)
+, _parkedWorkers(0)
+, _callerParked(false)
+, _finished(false)
+{
+    _instance = this;
+
+    _workerNum = workerNum < 0 ? getDefaultWorkerCount() : workerNum;
+    _lanes.reset(new Lane[_workerNum + 1]);
+    for (int i = 0; i <= _workerNum; i++)
+    {
+        _lanes[i].range.store(0);
+    }
+
+    _threads.resize(_workerNum);
+    for (int i = 0; i < _workerNum; i++)
+    {
+        setThread(i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _finished = true;
+        _workCV.notify_all();
+    }
+
+    for (int i = 0, n = (int)_threads.size(); i < n; ++i)
+    {
+        joinThread(i);
+    }
+    _threads.clear();
+
+    if (_instance == this)
+    {
+        _instance = nullptr;
+    }
+}
+
+void JobSystem::parallelFor(std::size_t count, std::size_t grain, const RangeJob& job)
+{
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+
+    std::size_t chunkNum = (count + grain - 1) / grain;
+    if (_workerNum == 0 || chunkNum <= 1 || isInJob() || chunkNum > UINT32_MAX)
+    {
+        job(0, count, getCallerLane());
+        return;
+    }
+
+    _job = &job;
+    _count = count;
+    _grain = grain;
+    _remainChunks.store((uint32_t)chunkNum);
+
+    // give every lane an even contiguous span of chunks
+    int laneNum = getLaneCount();
+    uint32_t lo = 0;
+    for (int i = 0; i < laneNum; i++)
+    {
+        uint32_t hi = (uint32_t)(chunkNum * (i + 1) / laneNum);
+        _lanes[i].range.store(packRange(lo, hi));
+        lo = hi;
+    }
+
+    // publish the job
+    _generation.fetch_add(1);
+    if (_parkedWorkers.load() > 0)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _workCV.notify_all();
+    }
+
+    setInJob(true);
+    runLane(getCallerLane());
+    setInJob(false);
+
+    waitFinish();
+}
+
+void JobSystem::waitFinish()
+{
+    for (int spin = 0; spin < SpinCount && _remainChunks.load() != 0; spin++)
+    {
+        spinPause(spin);
+    }
+
+    if (_remainChunks.load() != 0)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _callerParked = true;
+        _doneCV.wait(lock, [this]() {
+            return _remainChunks.load() == 0;
+        });
+        _callerParked = false;
+    }
+
+    // close the job, late workers will see an even generation and back off
+    _generation.fetch_add(1);
+    while (_activeWorkers.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+    _job = nullptr;
+}
+
+bool JobSystem::popChunk(int lane, uint32_t& chunk)
+{
+    auto& range = _lanes[lane].range;
+    uint64_t cur = range.load();
+    while (rangeLo(cur) < rangeHi(cur))
+    {
+        if (range.compare_exchange_weak(cur, packRange(rangeLo(cur) + 1, rangeHi(cur))))
+        {
+            chunk = rangeLo(cur);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobSystem::stealChunks(int lane)
+{
+    int laneNum = getLaneCount();
+    for (int i = 1; i < laneNum; i++)
+    {
+        auto& victim = _lanes[(lane + i) % laneNum].range;
+        uint64_t cur = victim.load();
+        while (rangeLo(cur) < rangeHi(cur))
+        {
+            uint32_t lo = rangeLo(cur), hi = rangeHi(cur);
+            uint32_t mid = hi - (hi - lo + 1) / 2;
+            if (victim.compare_exchange_weak(cur, packRange(lo, mid)))
+            {
+                // own lane is empty here, so nobody else can modify it concurrently
+                _lanes[lane].range.store(packRange(mid, hi));
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void JobSystem::runChunk(uint32_t chunk, int lane)
+{
+    std::size_t begin = chunk * _grain;
+    std::size_t end = std::min(begin + _grain, _count);
+    (*_job)(begin, end, lane);
+
+    if (_remainChunks.fetch_sub(1) == 1 && _callerParked.load())
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _doneCV.notify_all();
+    }
+}
+
+void JobSystem::runLane(int lane)
+{
+    uint32_t chunk = 0;
+    do
+    {
+        while (popChunk(lane, chunk))
+        {
+            runChunk(chunk, lane);
+        }
+    } while (stealChunks(lane));
+}
+
+void JobSystem::joinThread(int tid)
+{
+    if (tid < 0 || tid >= (int)_threads.size())
+    {
+        return;
+    }
+
+    if (_threads[tid] && _threads[tid]->joinable())
+    {
+        _threads[tid]->join();
+    }
+}
+
+void JobSystem::setThread(int tid)
+{
+    auto f = [this, tid]() {
+        setInJob(true);
+        uint32_t seen = _generation.load();
+
+        while (!_finished)
+        {
+            uint32_t gen = _generation.load();
+            if ((gen & 1) && gen != seen)
+            {
+                _activeWorkers.fetch_add(1);
+                if (_generation.load() == gen)
+                {
+                    runLane(tid);
+                }
+                _activeWorkers.fetch_sub(1);
+                seen = gen;
+                continue;
+            }
+
+            // spin a while before parking, jobs of one frame come in bursts
+            bool hasWork = false;
+            for (int spin = 0; spin < SpinCount; spin++)
+            {
+                gen = _generation.load();
+                if (((gen & 1) && gen != seen) || _finished)
+                {
+                    hasWork = true;
+                    break;
+                }
+                spinPause(spin);
+            }
+            if (hasWork) continue;
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            _parkedWorkers.fetch_add(1);
+            _workCV.wait(lock, [this, seen]() {
+                uint32_t cur = _generation.load();
+                return ((cur & 1) && cur != seen) || _finished;
+            });
+            _parkedWorkers.fetch_sub(1);
+        }
+    };
+    _threads[tid].reset(new(std::nothrow) std::thread(f));
+}
+
+RENDERER_END
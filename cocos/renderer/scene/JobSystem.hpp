@@ -0,0 +1,149 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../Macro.h"
+#include <vector>
+#include <stdint.h>
+#include <functional>
+#include <thread>
+#include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+RENDERER_BEGIN
+
+/**
+ * @addtogroup scene
+ * @{
+ */
+
+/**
+ *  @brief A work-stealing job scheduler used by the render flow.\n
+ *  A range job is split into chunks, every lane (one per worker plus one for the calling thread) owns
+ *  a contiguous span of chunks and steals half of another lane's span once its own span is exhausted.\n
+ *  Workers spin for a short while after a job before parking, so back to back jobs of one frame
+ *  do not pay a wake up each.
+ *  @note parallelFor must be called from a single thread, usually the cocos thread.
+ */
+class JobSystem
+{
+public:
+    /*
+     *  @brief Range job callback.
+     *  @param[in] begin First element of the range.
+     *  @param[in] end One past the last element of the range.
+     *  @param[in] tid Lane id in [0, getLaneCount()), can be used to index per thread scratch data.
+     */
+    typedef std::function<void(std::size_t begin, std::size_t end, int tid)> RangeJob;
+
+    static JobSystem* getInstance()
+    {
+        return _instance;
+    }
+
+    /*
+     *  @brief Default worker count, core count minus the calling thread.
+     */
+    static int getDefaultWorkerCount();
+
+    /*
+     *  @brief The constructor.
+     *  @param[in] workerNum Worker thread count, negative means getDefaultWorkerCount.
+     */
+    JobSystem(int workerNum = -1);
+    /*
+     *  @brief The destructor, it stops and joins all worker threads.
+     */
+    ~JobSystem();
+
+    /*
+     *  @brief Gets the worker thread count.
+     */
+    int getWorkerCount() const { return _workerNum; }
+    /*
+     *  @brief Gets the lane count, it equals worker count plus the calling thread.
+     */
+    int getLaneCount() const { return _workerNum + 1; }
+    /*
+     *  @brief Gets the lane id of the calling thread, it's always the last lane.
+     */
+    int getCallerLane() const { return _workerNum; }
+
+    /**
+     *  @brief Runs job over [0, count) in chunks of grain elements and returns once all chunks are done.
+     *  The calling thread takes part in the job. Small jobs and nested calls run inline.
+     *  @param[in] count Element count.
+     *  @param[in] grain Element count of a chunk, it must be greater than 0.
+     *  @param[in] job The range job.
+     */
+    void parallelFor(std::size_t count, std::size_t grain, const RangeJob& job);
+private:
+    CC_DISALLOW_COPY_ASSIGN_AND_MOVE(JobSystem);
+
+    void setThread(int tid);
+    void joinThread(int tid);
+    void runLane(int lane);
+    bool popChunk(int lane, uint32_t& chunk);
+    bool stealChunks(int lane);
+    void runChunk(uint32_t chunk, int lane);
+    void waitFinish();
+private:
+    static JobSystem* _instance;
+
+    // packed as (hi << 32 | lo). Lanes are padded to a cache line, so no two ranges share one
+    // even though new[] doesn't honor over-alignment before C++17
+    struct Lane
+    {
+        std::atomic<uint64_t> range;
+        char padding[64 - sizeof(std::atomic<uint64_t>)];
+    };
+
+    int _workerNum = 0;
+    std::vector<std::unique_ptr<std::thread>> _threads;
+    std::unique_ptr<Lane[]> _lanes;
+
+    // odd generation means a job is running
+    std::atomic<uint32_t> _generation;
+    std::atomic<int> _activeWorkers;
+    std::atomic<uint32_t> _remainChunks;
+    std::atomic<int> _parkedWorkers;
+    std::atomic<bool> _callerParked;
+    std::atomic<bool> _finished;
+
+    const RangeJob* _job = nullptr;
+    std::size_t _count = 0;
+    std::size_t _grain = 0;
+
+    std::mutex _mutex;
+    std::condition_variable _workCV;
+    std::condition_variable _doneCV;
+};
+
+// end of scene group
+/// @}
+
+RENDERER_END
@@ -27,26 +27,47 @@
 #include "ModelBatcher.hpp"
 #include "RenderFlow.hpp"
 #include "../gfx/DeviceGraphics.h"
+#include "Profiler.hpp"
+#include <algorithm>
 
 #define MAX_VERTEX_COUNT 65535
 
 RENDERER_BEGIN
 
-MeshBuffer::MeshBuffer(ModelBatcher* batcher, VertexFormat* fmt)
+namespace {
+    /*
+     * Uploads [start, end) of data. The GPU storage is orphaned first when asked or when it is smaller than
+     * the memory data, then everything before end is uploaded since the new storage holds nothing yet.
+     */
+    template<typename Buffer>
+    uint32_t uploadRange(Buffer* buffer, const uint8_t* data, uint32_t capacity, uint32_t start, uint32_t end, bool orphan)
+    {
+        if (orphan || buffer->getBytes() < capacity)
+        {
+            buffer->orphan(capacity);
+            start = 0;
+        }
+        
+        if (start >= end)
+        {
+            return 0;
+        }
+        
+        buffer->update(start, data + start, end - start);
+        return end - start;
+    }
+}
+
+MeshBuffer::MeshBuffer(ModelBatcher* batcher, VertexFormat* fmt, uint32_t initCount)
 : _vertexFmt(fmt)
 , _batcher(batcher)
 {
     _bytesPerVertex = _vertexFmt->getBytes();
     
-    DeviceGraphics* device = _batcher->getFlow()->getDevice();
-    _vb = VertexBuffer::create(device, _vertexFmt, Usage::DYNAMIC, nullptr, 0, 0);
-    _vbArr.pushBack(_vb);
+    useGPUBuffer(0);
     
-    _ib = IndexBuffer::create(device, IndexFormat::UINT16, Usage::STATIC, nullptr, 0, 0);
-    _ibArr.pushBack(_ib);
-    
-    _vDataCount = MeshBuffer::INIT_VERTEX_COUNT * 4 * _bytesPerVertex / sizeof(float);
-    _iDataCount = MeshBuffer::INIT_VERTEX_COUNT * 6;
+    _vDataCount = initCount * 4 * _bytesPerVertex / sizeof(float);
+    _iDataCount = initCount * 6;
     
     reallocVBuffer();
     reallocIBuffer();
@@ -54,17 +75,15 @@ MeshBuffer::MeshBuffer(ModelBatcher* batcher, VertexFormat* fmt)
 
 MeshBuffer::~MeshBuffer()
 {
-    for (std::size_t i = 0, n = _vbArr.size(); i < n; i++)
+    for (auto gpuBuffer : _gpuBuffers)
     {
-         _vbArr.at(i)->destroy();
+        gpuBuffer->vb->destroy();
+        gpuBuffer->ib->destroy();
+        CC_SAFE_RELEASE(gpuBuffer->vb);
+        CC_SAFE_RELEASE(gpuBuffer->ib);
+        delete gpuBuffer;
     }
-    _vbArr.clear();
-    
-    for (std::size_t i = 0, n = _ibArr.size(); i < n; i++)
-    {
-         _ibArr.at(i)->destroy();
-    }
-    _ibArr.clear();
+    _gpuBuffers.clear();
 
     if (iData)
     {
@@ -156,36 +175,49 @@ const MeshBuffer::OffsetInfo& MeshBuffer::requestStatic(uint32_t vertexCount, ui
 
 void MeshBuffer::uploadData()
 {
-    _vb->update(0, vData, _byteOffset);
-    _ib->update(0, iData, _indexOffset * IDATA_BYTE);
+    if (!_dirty)
+    {
+        return;
+    }
+    
+    RENDER_PROFILE_SCOPE(BUFFER_UPLOAD);
+    bool orphan = _gpuBuffer->orphan;
+    uint32_t uploaded = uploadRange(_vb, (const uint8_t*)vData, _vDataCount * VDATA_BYTE, _dirtyVStart, _dirtyVEnd, orphan);
+    uploaded += uploadRange(_ib, (const uint8_t*)iData, _iDataCount * IDATA_BYTE, _dirtyIStart, _dirtyIEnd, orphan);
+    _gpuBuffer->orphan = false;
+    _uploadedBytes += uploaded;
+    RENDER_PROFILE_COUNT(UPLOAD_BYTES, uploaded);
     _dirty = false;
 }
 
-void MeshBuffer::switchBuffer(uint32_t vertexCount)
+void MeshBuffer::useGPUBuffer(std::size_t pos)
 {
-    std::size_t offset = ++_vbPos;
+    if (pos >= _gpuBuffers.size())
+    {
+        // GPU storage is allocated by the first upload, sized to the memory data
+        DeviceGraphics* device = _batcher->getFlow()->getDevice();
+        GPUBuffer* gpuBuffer = new GPUBuffer();
+        gpuBuffer->vb = VertexBuffer::create(device, _vertexFmt, Usage::DYNAMIC, nullptr, 0, 0);
+        gpuBuffer->ib = IndexBuffer::create(device, IndexFormat::UINT16, Usage::STATIC, nullptr, 0, 0);
+        CC_SAFE_RETAIN(gpuBuffer->vb);
+        CC_SAFE_RETAIN(gpuBuffer->ib);
+        _gpuBuffers.push_back(gpuBuffer);
+    }
+    
+    _vbPos = pos;
+    _gpuBuffer = _gpuBuffers[pos];
+    _vb = _gpuBuffer->vb;
+    _ib = _gpuBuffer->ib;
+}
 
+void MeshBuffer::switchBuffer(uint32_t vertexCount)
+{
     _byteOffset = 0;
     _vertexOffset = 0;
     _indexOffset = 0;
     _indexStart = 0;
 
-    if (offset < _vbArr.size())
-    {
-        _vb = _vbArr.at(offset);
-        _ib = _ibArr.at(offset);
-    }
-    else
-    {
-        DeviceGraphics* device = _batcher->getFlow()->getDevice();
-        _vb = VertexBuffer::create(device, _vertexFmt, Usage::DYNAMIC, nullptr, 0, 0);
-        _vb->setBytes(_vDataCount * VDATA_BYTE);
-        _vbArr.pushBack(_vb);
-        
-        _ib = IndexBuffer::create(device, IndexFormat::UINT16, Usage::STATIC, nullptr, 0, 0);
-        _ib->setBytes(_iDataCount * IDATA_BYTE);
-        _ibArr.pushBack(_ib);
-    }
+    useGPUBuffer(_vbPos + 1);
 }
 
 void MeshBuffer::checkAndSwitchBuffer(uint32_t vertexCount)
@@ -209,14 +241,32 @@ void MeshBuffer::updateOffset (uint32_t vertexCount, uint32_t indiceCount, uint3
     _offsetInfo.vByte = _byteOffset;
     _byteOffset = byteOffset;
 
-    _dirty = true;
+    uint32_t iStart = _offsetInfo.index * IDATA_BYTE;
+    uint32_t iEnd = _indexOffset * IDATA_BYTE;
+    if (_dirty)
+    {
+        _dirtyVStart = std::min(_dirtyVStart, _offsetInfo.vByte);
+        _dirtyVEnd = std::max(_dirtyVEnd, _byteOffset);
+        _dirtyIStart = std::min(_dirtyIStart, iStart);
+        _dirtyIEnd = std::max(_dirtyIEnd, iEnd);
+    }
+    else
+    {
+        _dirtyVStart = _offsetInfo.vByte;
+        _dirtyVEnd = _byteOffset;
+        _dirtyIStart = iStart;
+        _dirtyIEnd = iEnd;
+        _dirty = true;
+    }
 }
 
 void MeshBuffer::reset()
 {
-    _vbPos = 0;
-    _vb = _vbArr.at(0);
-    _ib = _ibArr.at(0);
+    for (auto gpuBuffer : _gpuBuffers)
+    {
+        gpuBuffer->orphan = true;
+    }
+    useGPUBuffer(0);
     _byteStart = 0;
     _byteOffset = 0;
     _vertexStart = 0;
@@ -224,6 +274,7 @@ void MeshBuffer::reset()
     _indexStart = 0;
     _indexOffset = 0;
     _dirty = false;
+    _uploadedBytes = 0;
 }
 
 RENDERER_END
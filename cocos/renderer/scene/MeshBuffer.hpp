@@ -25,6 +25,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <vector>
 
 #include "../Macro.h"
 #include "../gfx/VertexFormat.h"
@@ -43,7 +44,9 @@ class ModelBatcher;
 
 /**
  *  @brief The buffer which stores mesh render datas, including the vertices data and the indices data.
- *  It can be used as a global buffer shared by multiple render handles and eventually shared by Models
+ *  It can be used as a global buffer shared by multiple render handles and eventually shared by Models.\n
+ *  The first upload after reset orphans the GPU storage, so draws of the last frame which may still read it
+ *  are never waited for, and every upload only sends the ranges requested since the previous one.
  */
 class MeshBuffer
 {
@@ -65,8 +68,9 @@ public:
      *  @brief Constructor
      *  @param[in] batcher The ModelBatcher which creates the current buffer
      *  @param[in] fmt The vertex format of vertex data
+     *  @param[in] initCount Initial capacity in quads, 4 vertices and 6 indices each
      */
-    MeshBuffer(ModelBatcher* batcher, VertexFormat* fmt);
+    MeshBuffer(ModelBatcher* batcher, VertexFormat* fmt, uint32_t initCount = INIT_VERTEX_COUNT);
     /**
      *  @brief Destructor
      */
@@ -82,14 +86,19 @@ public:
     const OffsetInfo& requestStatic(uint32_t vertexCount, uint32_t indexCount);
     
     /**
-     *  @brief Upload data to GPU memory
+     *  @brief Upload the ranges requested since last upload to GPU memory.
      */
     void uploadData();
     /**
-     *  @brief Reset all states.
+     *  @brief Reset all states, the next upload of every GPU buffer orphans its storage.
      */
     void reset();
     
+    /**
+     *  @brief Gets the bytes of vertices and indices uploaded since last reset.
+     */
+    uint32_t getUploadedBytes() const { return _uploadedBytes; };
+    
     /**
      *  @brief Gets the current byte offset which indicates the start of empty range
      *  @return Byte offset.
@@ -157,7 +166,20 @@ protected:
     void checkAndSwitchBuffer(uint32_t vertexCount);
     void switchBuffer(uint32_t vertexCount);
     void updateOffset(uint32_t vertexCount, uint32_t indiceCount, uint32_t byteOffset);
+    void useGPUBuffer(std::size_t pos);
 private:
+    /*
+     *  @brief GPU buffers of one buffer position.
+     */
+    struct GPUBuffer
+    {
+        VertexBuffer* vb = nullptr;
+        IndexBuffer* ib = nullptr;
+        // the GPU may still read it, the next upload re-specifies the storage
+        bool orphan = false;
+    };
+    
+
     uint32_t _byteStart = 0;
     uint32_t _byteOffset = 0;
     uint32_t _indexStart = 0;
@@ -173,11 +195,17 @@ private:
     uint32_t _oldIDataCount = 0;
     
     bool _dirty = false;
+    // byte ranges requested since last upload
+    uint32_t _dirtyVStart = 0;
+    uint32_t _dirtyVEnd = 0;
+    uint32_t _dirtyIStart = 0;
+    uint32_t _dirtyIEnd = 0;
+    uint32_t _uploadedBytes = 0;
     
     ModelBatcher* _batcher = nullptr;
     std::size_t _vbPos = 0;
-    cocos2d::Vector<VertexBuffer*> _vbArr;
-    cocos2d::Vector<IndexBuffer*> _ibArr;
+    std::vector<GPUBuffer*> _gpuBuffers;
+    GPUBuffer* _gpuBuffer = nullptr;
     VertexBuffer* _vb = nullptr;
     IndexBuffer* _ib = nullptr;
     OffsetInfo _offsetInfo;
@@ -27,6 +27,8 @@
 #include "StencilManager.hpp"
 #include "assembler/RenderDataList.hpp"
 #include "NodeProxy.hpp"
+#include "StaticBatch.hpp"
+#include "Profiler.hpp"
 
 RENDERER_BEGIN
 
@@ -159,11 +161,21 @@ void ModelBatcher::commit(NodeProxy* node, Assembler* assembler, int cullingMask
         
         assembler->fillBuffers(node, this, i);
     }
+    
+    // the baked vertices hold the current opacity, assemblers ignoring opacity or skipping
+    // an IA never clear the flag themselves and would rebake the static batch every frame
+    if (_staticBatch)
+    {
+        assembler->disableDirty(AssemblerBase::VERTICES_OPACITY_CHANGED);
+    }
 }
 
 void ModelBatcher::commitIA(NodeProxy* node, CustomAssembler* assembler, int cullingMask)
 {
     changeCommitState(CommitState::Custom);
+    
+    // custom input assemblers are owned and updated by their assemblers
+    if (_staticBatch) _staticBatch->setUnbakeable();
 
     EffectVariant* effect = assembler->getEffect(0);
     if (!effect) return;
@@ -235,6 +247,9 @@ void ModelBatcher::flushIA()
         return;
     }
     
+    RENDER_PROFILE_SCOPE(BATCH_FLUSH);
+    RENDER_PROFILE_COUNT(BATCHES, 1);
+    
     // Stencil manager process
     _stencilMgr->handleEffect(_currEffect);
     
@@ -281,6 +296,9 @@ void ModelBatcher::flush()
         return;
     }
     
+    RENDER_PROFILE_SCOPE(BATCH_FLUSH);
+    RENDER_PROFILE_COUNT(BATCHES, 1);
+    
     _ia.setVertexBuffer(_buffer->getVertexBuffer());
     _ia.setIndexBuffer(_buffer->getIndexBuffer());
     _ia.setStart(indexStart);
@@ -291,16 +309,23 @@ void ModelBatcher::flush()
     
     // Generate model
     Model* model = nullptr;
-    if (_modelOffset >= _modelPool.size())
+    if (_staticBatch)
     {
-        model = new Model();
-        _modelPool.push_back(model);
+        model = _staticBatch->requestModel();
     }
     else
     {
-        model = _modelPool[_modelOffset];
+        if (_modelOffset >= _modelPool.size())
+        {
+            model = new Model();
+            _modelPool.push_back(model);
+        }
+        else
+        {
+            model = _modelPool[_modelOffset];
+        }
+        _modelOffset++;
     }
-    _modelOffset++;
     model->setWorldMatix(_modelMat);
     model->setCullingMask(_cullingMask);
     model->setEffect(_currEffect);
@@ -333,6 +358,38 @@ void ModelBatcher::terminateBatch()
     _walking = false;
 }
 
+void ModelBatcher::startStaticBatch(StaticBatch* staticBatch)
+{
+    // the static batch never merges with the batch before it
+    changeCommitState(CommitState::None);
+    _buffer = nullptr;
+    
+    _staticBatch = staticBatch;
+    _staticBatch->reset();
+}
+
+void ModelBatcher::terminateStaticBatch()
+{
+    changeCommitState(CommitState::None);
+    _buffer = nullptr;
+    
+    _staticBatch->uploadData();
+    _staticBatch = nullptr;
+}
+
+void ModelBatcher::commitStaticBatch(StaticBatch* staticBatch)
+{
+    changeCommitState(CommitState::None);
+    
+    Scene* scene = _flow->getRenderScene();
+    for (std::size_t i = 0, n = staticBatch->getModelCount(); i < n; i++)
+    {
+        Model* model = staticBatch->getModel(i);
+        _stencilMgr->handleEffect(model->getEffect());
+        scene->addModel(model);
+    }
+}
+
 void ModelBatcher::setNode(NodeProxy* node)
 {
     if (_node == node)
@@ -355,6 +412,16 @@ void ModelBatcher::setCurrentEffect(EffectVariant* effect)
     CC_SAFE_RETAIN(_currEffect);
 };
 
+uint32_t ModelBatcher::getUploadedBytes() const
+{
+    uint32_t bytes = 0;
+    for (auto iter : _buffers)
+    {
+        bytes += iter.second->getUploadedBytes();
+    }
+    return bytes;
+}
+
 MeshBuffer* ModelBatcher::getBuffer(VertexFormat* fmt)
 {
     if (_buffer != nullptr && fmt == _buffer->_vertexFmt)
@@ -362,6 +429,11 @@ MeshBuffer* ModelBatcher::getBuffer(VertexFormat* fmt)
         return _buffer;
     }
     
+    if (_staticBatch)
+    {
+        return _staticBatch->getBuffer(this, fmt);
+    }
+    
     MeshBuffer* buffer = nullptr;
     auto iter = _buffers.find(fmt);
     if (iter == _buffers.end())
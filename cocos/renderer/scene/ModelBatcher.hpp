@@ -37,6 +37,7 @@ RENDERER_BEGIN
 
 class RenderFlow;
 class StencilManager;
+class StaticBatch;
 
 /**
  * @addtogroup scene
@@ -105,12 +106,35 @@ public:
      */
     void terminateBatch();
     
+    /**
+     *  @brief Starts baking a static subtree, following commits go into the static batch's own buffers and models.
+     *  @param[in] staticBatch The static batch to bake into.
+     */
+    void startStaticBatch(StaticBatch* staticBatch);
+    /**
+     *  @brief Finishes baking the static subtree and uploads its buffers.
+     */
+    void terminateStaticBatch();
+    /**
+     *  @brief Commits the baked models of a static batch to the render Scene.
+     *  @param[in] staticBatch The baked static batch.
+     */
+    void commitStaticBatch(StaticBatch* staticBatch);
+    /**
+     *  @brief Gets the static batch being baked, nullptr if not baking.
+     */
+    StaticBatch* getStaticBatch() const { return _staticBatch; };
+    
     /**
      *  @brief Gets a suitable MeshBuffer for the given VertexFormat.
      *  Render datas arranged in different VertexFormat can't share the same buffer.
      *  @param[in] fmt The VertexFormat
      */
     MeshBuffer* getBuffer(VertexFormat* fmt);
+    /**
+     *  @brief Gets the bytes uploaded by all MeshBuffers in the last frame.
+     */
+    uint32_t getUploadedBytes() const;
     /**
      *  @brief Gets the current MeshBuffer.
      */
@@ -141,6 +165,7 @@ private:
     NodeProxy* _node = nullptr;
     
     MeshBuffer* _buffer = nullptr;
+    StaticBatch* _staticBatch = nullptr;
     EffectVariant* _currEffect = nullptr;
     RenderFlow* _flow = nullptr;
 
@@ -36,6 +36,8 @@
 #include <math.h>
 #include "RenderFlow.hpp"
 #include "assembler/AssemblerSprite.hpp"
+#include "assembler/MaskAssembler.hpp"
+#include "StaticBatch.hpp"
 
 RENDERER_BEGIN
 
@@ -83,6 +85,7 @@ NodeProxy::~NodeProxy()
     {
         child->_parent = nullptr;
     }
+    CC_SAFE_DELETE(_staticBatch);
 }
 
 void NodeProxy::destroyImmediately()
@@ -91,9 +94,12 @@ void NodeProxy::destroyImmediately()
     {
         _parent->removeChild(this);
     }
-    RenderFlow::getInstance()->removeNodeLevel(_level, _worldMat);
+    RenderFlow::getInstance()->removeNodeLevel(_level, _levelIndex);
     CC_SAFE_RELEASE_NULL(_assembler);
+    // baked models may retain this node
+    CC_SAFE_DELETE(_staticBatch);
     _level = NODE_LEVEL_INVALID;
+    _levelIndex = NODE_LEVEL_INVALID;
     _dirty = nullptr;
     _trs = nullptr;
     _localMat = nullptr;
@@ -148,6 +154,7 @@ void NodeProxy::addChild(NodeProxy* child)
     }
     _children.pushBack(child);
     child->setParent(this);
+    markStaticBatchDirty();
 }
 
 void NodeProxy::detachChild(NodeProxy *child, ssize_t childIndex)
@@ -155,6 +162,7 @@ void NodeProxy::detachChild(NodeProxy *child, ssize_t childIndex)
     // set parent nil at the end
     child->setParent(nullptr);
     _children.erase(childIndex);
+    markStaticBatchDirty();
 }
 
 void NodeProxy::removeChild(NodeProxy* child)
@@ -180,6 +188,7 @@ void NodeProxy::removeAllChildren()
     }
     
     _children.clear();
+    markStaticBatchDirty();
 }
 
 NodeProxy* NodeProxy::getChildByName(std::string childName)
@@ -241,8 +250,9 @@ void NodeProxy::updateLevel()
     static RenderFlow::LevelInfo levelInfo;
     auto renderFlow = RenderFlow::getInstance();
 
-    renderFlow->removeNodeLevel(_level, _worldMat);
+    renderFlow->removeNodeLevel(_level, _levelIndex);
     
+    levelInfo.node = this;
     levelInfo.dirty = _dirty;
     levelInfo.localMat = _localMat;
     levelInfo.worldMat = _worldMat;
@@ -263,7 +273,7 @@ void NodeProxy::updateLevel()
         levelInfo.parentDirty = nullptr;
         levelInfo.parentRealOpacity = nullptr;
     }
-    renderFlow->insertNodeLevel(_level, levelInfo);
+    _levelIndex = renderFlow->insertNodeLevel(_level, levelInfo);
     
     for (auto it = _children.begin(); it != _children.end(); it++)
     {
@@ -316,12 +326,14 @@ void NodeProxy::setAssembler(AssemblerBase* assembler)
     {
         *_dirty &= ~RenderFlow::PRE_CALCULATE_VERTICES;
     }
+    markStaticBatchDirty();
 }
 
 void NodeProxy::clearAssembler()
 {
     CC_SAFE_RELEASE_NULL(_assembler);
     *_dirty &= ~RenderFlow::PRE_CALCULATE_VERTICES;
+    markStaticBatchDirty();
 }
 
 AssemblerBase* NodeProxy::getAssembler() const
@@ -329,6 +341,32 @@ AssemblerBase* NodeProxy::getAssembler() const
     return _assembler;
 }
 
+void NodeProxy::enableStaticBatch(bool value)
+{
+    if (value == (_staticBatch != nullptr)) return;
+    
+    if (value)
+    {
+        _staticBatch = new StaticBatch();
+    }
+    else
+    {
+        CC_SAFE_DELETE(_staticBatch);
+        // an outer static batch baked this subtree through the inner one
+        markStaticBatchDirty();
+    }
+}
+
+void NodeProxy::markStaticBatchDirty()
+{
+    if (StaticBatch::getCount() == 0) return;
+    
+    for (NodeProxy* node = this; node != nullptr; node = node->_parent)
+    {
+        if (node->_staticBatch) node->_staticBatch->setDirty();
+    }
+}
+
 void NodeProxy::getPosition(cocos2d::Vec3* out) const
 {
     out->x = _trs->x;
@@ -517,8 +555,40 @@ void NodeProxy::updateLocalMatrix()
     }
 }
 
+void NodeProxy::renderStaticBatch(NodeProxy* node, ModelBatcher* batcher, Scene* scene)
+{
+    StaticBatch* staticBatch = node->_staticBatch;
+    if (!staticBatch->isDirty() && !staticBatch->checkNodes())
+    {
+        // keep render order as if the subtree was traversed
+        for (auto child : staticBatch->getNodes())
+        {
+            child->_renderOrder = _globalRenderOrder++;
+        }
+        batcher->commitStaticBatch(staticBatch);
+        return;
+    }
+    
+    batcher->startStaticBatch(staticBatch);
+    render(node, batcher, scene);
+    batcher->terminateStaticBatch();
+}
+
 void NodeProxy::render(NodeProxy* node, ModelBatcher* batcher, Scene* scene)
 {
+    StaticBatch* staticBatch = batcher->getStaticBatch();
+    if (staticBatch)
+    {
+        staticBatch->addNode(node);
+        // masks change stencil states during traversal, they can't be replayed from baked models
+        if (node->_assembler && dynamic_cast<MaskAssembler*>(node->_assembler)) staticBatch->setUnbakeable();
+    }
+    else if (node->_staticBatch && node->_staticBatch->isBakeable())
+    {
+        renderStaticBatch(node, batcher, scene);
+        return;
+    }
+    
     node->_renderOrder = _globalRenderOrder++;
     
     if (!node->_needVisit || node->_realOpacity == 0) return;
@@ -547,6 +617,10 @@ void NodeProxy::render(NodeProxy* node, ModelBatcher* batcher, Scene* scene)
 
 void NodeProxy::visit(NodeProxy* node, ModelBatcher* batcher, Scene* scene)
 {
+    // visited nodes update their own matrices, a baked subtree would skip that
+    StaticBatch* staticBatch = batcher->getStaticBatch();
+    if (staticBatch) staticBatch->setUnbakeable();
+    
     node->_renderOrder = _globalRenderOrder++;
     
     if (!node->_needVisit) return;
@@ -43,8 +43,11 @@ namespace se {
 
 RENDERER_BEGIN
 
+#define NODE_LEVEL_INVALID 0xffffffff
+
 class ModelBatcher;
 class Scene;
+class StaticBatch;
 struct TRS;
 struct ParentInfo;
 struct Skew;
@@ -267,12 +270,29 @@ public:
     /*
      *  @brief Enables visit.
      */
-    void enableVisit(bool value) { _needVisit = value; }
+    void enableVisit(bool value)
+    {
+        if (_needVisit == value) return;
+        _needVisit = value;
+        markStaticBatchDirty();
+    }
     
     /*
      *  @brief Disables visit.
      */
-    void disableVisit() { _needVisit = false; }
+    void disableVisit() { enableVisit(false); }
+    
+    /**
+     *  @brief Enables or disables static batch of the subtree.
+     *  A static subtree keeps its baked vertices, indices and models, and is baked again only when something in it changes.
+     *  @param[in] value
+     */
+    void enableStaticBatch(bool value);
+    /**
+     *  @brief Notifies the static batches containing this node to bake again.
+     *  It must be called when render data is changed without setting any dirty flag.
+     */
+    void markStaticBatchDirty();
     
     /*
      *  @brief Updates local matrix.
@@ -306,6 +326,21 @@ public:
      */
     bool isDirty(uint32_t flag) const { return *_dirty & flag; }
     
+    /*
+     *  @brief Gets node level in the hierarchy.
+     */
+    std::size_t getLevel() const { return _level; }
+    
+    /*
+     *  @brief Gets node index in its level, RenderFlow uses it to remove node level in constant time.
+     */
+    std::size_t getLevelIndex() const { return _levelIndex; }
+    
+    /*
+     *  @brief Sets node index in its level, it's only called by RenderFlow.
+     */
+    void setLevelIndex(std::size_t index) { _levelIndex = index; }
+    
     /*
      *  @brief Gets render order
      */
@@ -314,17 +349,26 @@ public:
     /*
      *  @brief switch traverse interface to visit
      */
-    void switchTraverseToVisit() { traverseHandle = visit; }
+    void switchTraverseToVisit()
+    {
+        traverseHandle = visit;
+        markStaticBatchDirty();
+    }
     /*
      *  @brief switch traverse interface to render
      */
-    void switchTraverseToRender() { traverseHandle = render; }
+    void switchTraverseToRender()
+    {
+        traverseHandle = render;
+        markStaticBatchDirty();
+    }
 
     /*
      *  @brief traverse handle
      */
     TraverseFunc traverseHandle = nullptr;
 protected:
+    static void renderStaticBatch(NodeProxy* node, ModelBatcher* batcher, Scene* scene);
     void updateLevel();
     void childrenAlloc();
     void detachChild(NodeProxy* child, ssize_t childIndex);
@@ -338,6 +382,7 @@ private:
     std::string _id = "";
     std::string _name = "";
     std::size_t _level = 0;
+    std::size_t _levelIndex = NODE_LEVEL_INVALID;
     
     uint32_t* _dirty = nullptr;
     TRS* _trs = nullptr;
@@ -358,6 +403,7 @@ private:
     cocos2d::Vector<NodeProxy*> _children;        ///< array of children nodes
 
     AssemblerBase* _assembler = nullptr;
+    StaticBatch* _staticBatch = nullptr;
     
     uint32_t _renderOrder = 0;
     static uint32_t _globalRenderOrder;
@@ -0,0 +1,391 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Profiler.hpp"
+#include "platform/CCFileUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#include <stdarg.h>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
+// `thread_local` can not compile on iOS 9.0 below device
+#   define PROFILER_USE_THREAD_LOCAL (__IPHONE_OS_VERSION_MIN_REQUIRED >= 90000)
+#else
+#   define PROFILER_USE_THREAD_LOCAL 1
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_IOS
+
+#if !PROFILER_USE_THREAD_LOCAL
+#include <pthread.h>
+#endif
+
+RENDERER_BEGIN
+
+namespace {
+    // per thread events of one frame, the render thread records a few dozens
+    const uint32_t RingCapacity = 1 << 13;
+    const uint32_t TraceCapacity = 1 << 16;
+    const uint32_t FrameHistoryCapacity = 600;
+
+    struct Event
+    {
+        uint64_t begin;
+        uint32_t duration;
+        uint32_t scope;
+    };
+
+    // single writer ring, the owner thread publishes with head, endFrame reads up to head
+    struct Ring
+    {
+        Event events[RingCapacity];
+        std::atomic<uint64_t> head;
+        uint64_t readPos = 0;
+        int tid = 0;
+        std::string name;
+    };
+
+    struct TraceEvent
+    {
+        uint64_t begin;
+        uint32_t duration;
+        uint16_t scope;
+        uint16_t tid;
+    };
+
+    struct FrameRecord
+    {
+        uint64_t index;
+        uint64_t begin;
+        uint64_t counters[Profiler::COUNTER_COUNT];
+    };
+
+    const char* ScopeNames[Profiler::SCOPE_COUNT] = {
+        "Frame",
+        "MiddlewareUpdate",
+        "MiddlewareTransform",
+        "LocalMatrix",
+        "WorldMatrix",
+        "Traverse",
+        "MiddlewareRender",
+        "BatchFlush",
+        "BufferUpload",
+        "ForwardRender",
+        "ExtractItems",
+        "StageSort",
+        "ShadowStage",
+        "OpaqueStage",
+        "TransparentStage"
+    };
+
+    const char* CounterNames[Profiler::COUNTER_COUNT] = {
+        "drawCalls",
+        "primitives",
+        "batches",
+        "uploadBytes",
+        "localMatrices",
+        "worldMatrices",
+        "stageItems"
+    };
+
+    const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+
+    std::atomic<bool> s_requested(false);
+    std::atomic<bool> s_recording(false);
+    std::atomic<uint64_t> s_counters[Profiler::COUNTER_COUNT];
+
+    // only touched by the render thread
+    bool s_frameActive = false;
+    uint64_t s_frameBegin = 0;
+    uint64_t s_frameIndex = 0;
+    std::thread::id s_renderThread;
+    double s_frameData[Profiler::FRAME_DATA_LENGTH] = {0};
+    std::vector<TraceEvent> s_trace;
+    uint64_t s_traceHead = 0;
+    std::vector<FrameRecord> s_frames;
+    uint64_t s_frameHead = 0;
+
+    // guards ring registration, a thread takes it once. Rings are kept for the lifetime of the process,
+    // recording threads are the render thread and the long lived job system workers
+    std::mutex s_ringMutex;
+    std::vector<std::unique_ptr<Ring>> s_rings;
+#if PROFILER_USE_THREAD_LOCAL
+    thread_local Ring* tl_ring = nullptr;
+
+    inline Ring* getThreadRing() { return tl_ring; }
+    inline void setThreadRing(Ring* ring) { tl_ring = ring; }
+#else
+    pthread_key_t s_ringKey;
+    pthread_once_t s_ringKeyOnce = PTHREAD_ONCE_INIT;
+
+    void createRingKey() { pthread_key_create(&s_ringKey, nullptr); }
+
+    inline Ring* getThreadRing()
+    {
+        pthread_once(&s_ringKeyOnce, createRingKey);
+        return (Ring*)pthread_getspecific(s_ringKey);
+    }
+
+    inline void setThreadRing(Ring* ring)
+    {
+        pthread_once(&s_ringKeyOnce, createRingKey);
+        pthread_setspecific(s_ringKey, ring);
+    }
+#endif
+
+    Ring* getRing()
+    {
+        Ring* threadRing = getThreadRing();
+        if (threadRing == nullptr)
+        {
+            std::unique_ptr<Ring> ring(new Ring());
+            ring->head.store(0);
+
+            std::lock_guard<std::mutex> lock(s_ringMutex);
+            ring->tid = (int)s_rings.size();
+            if (std::this_thread::get_id() == s_renderThread)
+            {
+                ring->name = "Render thread";
+            }
+            else
+            {
+                ring->name = "Worker " + std::to_string(ring->tid);
+            }
+            threadRing = ring.get();
+            setThreadRing(threadRing);
+            s_rings.push_back(std::move(ring));
+        }
+        return threadRing;
+    }
+
+    template <typename T>
+    void pushHistory(std::vector<T>& history, uint64_t& head, uint32_t capacity, const T& value)
+    {
+        if (history.size() < capacity)
+        {
+            history.push_back(value);
+        }
+        else
+        {
+            history[head % capacity] = value;
+        }
+        head++;
+    }
+
+    // visits the history from the oldest entry
+    template <typename T, typename F>
+    void forEachHistory(const std::vector<T>& history, uint64_t head, F func)
+    {
+        std::size_t size = history.size();
+        std::size_t start = head > size ? (std::size_t)(head % size) : 0;
+        for (std::size_t i = 0; i < size; i++)
+        {
+            func(history[(start + i) % size]);
+        }
+    }
+
+    void appendFormat(std::string& out, const char* format, ...)
+    {
+        char buf[256];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        if (len > 0)
+        {
+            out.append(buf, std::min((std::size_t)len, sizeof(buf) - 1));
+        }
+    }
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+    s_requested.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::isEnabled()
+{
+    return s_requested.load(std::memory_order_relaxed);
+}
+
+bool Profiler::isRecording()
+{
+    return s_recording.load(std::memory_order_relaxed);
+}
+
+uint64_t Profiler::now()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_epoch).count();
+}
+
+void Profiler::beginFrame()
+{
+    bool recording = s_requested.load(std::memory_order_relaxed);
+    s_recording.store(recording, std::memory_order_relaxed);
+    s_frameActive = recording;
+    if (!recording) return;
+
+    s_renderThread = std::this_thread::get_id();
+    s_frameBegin = now();
+}
+
+void Profiler::endFrame()
+{
+    if (!s_frameActive) return;
+    s_frameActive = false;
+
+    record(FRAME, s_frameBegin, now());
+
+    for (int i = 0; i < FRAME_DATA_LENGTH; i++)
+    {
+        s_frameData[i] = 0;
+    }
+    s_frameData[0] = (double)s_frameIndex;
+
+    {
+        std::lock_guard<std::mutex> lock(s_ringMutex);
+        for (auto& ring : s_rings)
+        {
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            // a thread recorded more than a ring in one frame, the oldest events are lost
+            if (head - ring->readPos > RingCapacity)
+            {
+                ring->readPos = head - RingCapacity;
+            }
+
+            for (; ring->readPos < head; ring->readPos++)
+            {
+                const Event& event = ring->events[ring->readPos & (RingCapacity - 1)];
+                s_frameData[1 + event.scope] += event.duration / 1000000.0;
+
+                TraceEvent trace = { event.begin, event.duration, (uint16_t)event.scope, (uint16_t)ring->tid };
+                pushHistory(s_trace, s_traceHead, TraceCapacity, trace);
+            }
+        }
+    }
+
+    FrameRecord frame;
+    frame.index = s_frameIndex;
+    frame.begin = s_frameBegin;
+    for (int i = 0; i < COUNTER_COUNT; i++)
+    {
+        frame.counters[i] = s_counters[i].exchange(0, std::memory_order_relaxed);
+        s_frameData[1 + SCOPE_COUNT + i] = (double)frame.counters[i];
+    }
+    pushHistory(s_frames, s_frameHead, FrameHistoryCapacity, frame);
+
+    s_frameIndex++;
+}
+
+void Profiler::record(Scope scope, uint64_t begin, uint64_t end)
+{
+    if (!s_recording.load(std::memory_order_relaxed) || scope < 0 || scope >= SCOPE_COUNT) return;
+
+    Ring* ring = getRing();
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    Event& event = ring->events[head & (RingCapacity - 1)];
+    event.begin = begin;
+    event.duration = (uint32_t)std::min(end - begin, (uint64_t)UINT32_MAX);
+    event.scope = (uint32_t)scope;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::count(Counter counter, uint64_t n)
+{
+    if (!s_recording.load(std::memory_order_relaxed) || counter < 0 || counter >= COUNTER_COUNT) return;
+
+    s_counters[counter].fetch_add(n, std::memory_order_relaxed);
+}
+
+const double* Profiler::getFrameData()
+{
+    return s_frameData;
+}
+
+const char* Profiler::getScopeName(Scope scope)
+{
+    return scope >= 0 && scope < SCOPE_COUNT ? ScopeNames[scope] : "";
+}
+
+const char* Profiler::getCounterName(Counter counter)
+{
+    return counter >= 0 && counter < COUNTER_COUNT ? CounterNames[counter] : "";
+}
+
+bool Profiler::dumpTrace(const std::string& path)
+{
+    auto fileUtils = FileUtils::getInstance();
+    if (fileUtils == nullptr || path.empty()) return false;
+
+    std::string fullPath = path;
+    if (!fileUtils->isAbsolutePath(path))
+    {
+        fullPath = fileUtils->getWritablePath() + path;
+    }
+
+    std::string out;
+    out.reserve(s_trace.size() * 96 + s_frames.size() * 192 + 256);
+    out.append("{\"traceEvents\":[\n");
+
+    bool first = true;
+    auto separate = [&out, &first]() {
+        if (!first) out.append(",\n");
+        first = false;
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(s_ringMutex);
+        for (auto& ring : s_rings)
+        {
+            separate();
+            appendFormat(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                         ring->tid, ring->name.c_str());
+        }
+    }
+
+    forEachHistory(s_trace, s_traceHead, [&](const TraceEvent& event) {
+        separate();
+        appendFormat(out, "{\"name\":\"%s\",\"cat\":\"renderer\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                     ScopeNames[event.scope], (int)event.tid, event.begin / 1000.0, event.duration / 1000.0);
+    });
+
+    forEachHistory(s_frames, s_frameHead, [&](const FrameRecord& frame) {
+        separate();
+        appendFormat(out, "{\"name\":\"Counters\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{", frame.begin / 1000.0);
+        for (int i = 0; i < COUNTER_COUNT; i++)
+        {
+            appendFormat(out, "%s\"%s\":%llu", i > 0 ? "," : "", CounterNames[i], (unsigned long long)frame.counters[i]);
+        }
+        out.append("}}");
+    });
+
+    out.append("\n],\"displayTimeUnit\":\"ms\"}\n");
+    return fileUtils->writeStringToFile(out, fullPath);
+}
+
+RENDERER_END
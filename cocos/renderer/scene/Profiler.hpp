@@ -0,0 +1,183 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "../Macro.h"
+#include "base/ccConfig.h"
+#include <stdint.h>
+#include <string>
+
+RENDERER_BEGIN
+
+/**
+ * @addtogroup scene
+ * @{
+ */
+
+/**
+ *  @brief Frame profiler of the native render pipeline.\n
+ *  Scoped timers are written into a fixed size ring owned by the recording thread, so worker lanes of
+ *  the job system record without locks. Counters are relaxed atomics.\n
+ *  Rings and counters are collected by endFrame on the render thread, after all jobs of the frame
+ *  are done. The last frame is exposed as a flat array, see getFrameData, and the recent history can be
+ *  dumped as Chrome trace event JSON, see dumpTrace.
+ *  @note Recording is off by default, while it's off a scope only checks a flag.
+ */
+class Profiler
+{
+public:
+    enum Scope
+    {
+        FRAME = 0,
+        MIDDLEWARE_UPDATE,
+        MIDDLEWARE_TRANSFORM,
+        LOCAL_MATRIX,
+        WORLD_MATRIX,
+        TRAVERSE,
+        MIDDLEWARE_RENDER,
+        BATCH_FLUSH,
+        BUFFER_UPLOAD,
+        FORWARD_RENDER,
+        EXTRACT_ITEMS,
+        STAGE_SORT,
+        SHADOW_STAGE,
+        OPAQUE_STAGE,
+        TRANSPARENT_STAGE,
+        SCOPE_COUNT
+    };
+
+    enum Counter
+    {
+        DRAW_CALLS = 0,
+        PRIMITIVES,
+        BATCHES,
+        UPLOAD_BYTES,
+        LOCAL_MATRICES,
+        WORLD_MATRICES,
+        STAGE_ITEMS,
+        COUNTER_COUNT
+    };
+
+    /**
+     *  @brief Length of the frame data, frame index, milliseconds of every scope and value of every counter.
+     */
+    static const int FRAME_DATA_LENGTH = 1 + SCOPE_COUNT + COUNTER_COUNT;
+
+    /**
+     *  @brief Turns recording on or off, it takes effect from the next frame.
+     */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+    /**
+     *  @brief Whether the current frame is recorded, scopes and counters check it.
+     */
+    static bool isRecording();
+
+    /**
+     *  @brief Starts a frame, it should be called on the render thread.
+     */
+    static void beginFrame();
+    /**
+     *  @brief Ends a frame and collects all events recorded since beginFrame.
+     *  It must be called on the render thread when no job of the frame is running.
+     */
+    static void endFrame();
+
+    /**
+     *  @brief Monotonic time in nanoseconds.
+     */
+    static uint64_t now();
+    /**
+     *  @brief Records a scope of the calling thread, it does nothing while the profiler is disabled.
+     */
+    static void record(Scope scope, uint64_t begin, uint64_t end);
+    /**
+     *  @brief Adds n to a counter of the current frame, it does nothing while the profiler is disabled.
+     */
+    static void count(Counter counter, uint64_t n);
+
+    /**
+     *  @brief Data of the last collected frame, FRAME_DATA_LENGTH doubles laid out as
+     *  [frame index, milliseconds of every Scope, value of every Counter].\n
+     *  Time of a scope is summed over all threads, so a parallel scope reports cpu time.
+     */
+    static const double* getFrameData();
+    static const char* getScopeName(Scope scope);
+    static const char* getCounterName(Counter counter);
+
+    /**
+     *  @brief Writes the recorded history as Chrome trace event JSON, it can be loaded by chrome://tracing.
+     *  @param[in] path File path, a relative path is resolved against the writable path.
+     *  @return True if the file is written.
+     */
+    static bool dumpTrace(const std::string& path);
+};
+
+/**
+ *  @brief Records the enclosing block as a scope of the calling thread.
+ */
+class ProfileGuard
+{
+public:
+    ProfileGuard(Profiler::Scope scope)
+    : _scope(scope)
+    , _active(Profiler::isRecording())
+    , _begin(_active ? Profiler::now() : 0)
+    {
+    }
+
+    ~ProfileGuard()
+    {
+        if (_active)
+        {
+            Profiler::record(_scope, _begin, Profiler::now());
+        }
+    }
+private:
+    CC_DISALLOW_COPY_ASSIGN_AND_MOVE(ProfileGuard);
+
+    Profiler::Scope _scope;
+    bool _active;
+    uint64_t _begin;
+};
+
+// end of scene group
+/// @}
+
+RENDERER_END
+
+#if USE_RENDER_PROFILER
+#define RENDER_PROFILE_CONCAT_(a, b) a##b
+#define RENDER_PROFILE_CONCAT(a, b) RENDER_PROFILE_CONCAT_(a, b)
+#define RENDER_PROFILE_SCOPE(scope) cocos2d::renderer::ProfileGuard RENDER_PROFILE_CONCAT(__profileGuard, __LINE__)(cocos2d::renderer::Profiler::scope)
+#define RENDER_PROFILE_COUNT(counter, n) cocos2d::renderer::Profiler::count(cocos2d::renderer::Profiler::counter, (n))
+#define RENDER_PROFILE_BEGIN_FRAME() cocos2d::renderer::Profiler::beginFrame()
+#define RENDER_PROFILE_END_FRAME() cocos2d::renderer::Profiler::endFrame()
+#else
+#define RENDER_PROFILE_SCOPE(scope) do {} while(false)
+#define RENDER_PROFILE_COUNT(counter, n) do {} while(false)
+#define RENDER_PROFILE_BEGIN_FRAME() do {} while(false)
+#define RENDER_PROFILE_END_FRAME() do {} while(false)
+#endif // USE_RENDER_PROFILER
@@ -24,22 +24,23 @@
 
 #include "RenderFlow.hpp"
 #include "NodeMemPool.hpp"
+#include "math/MathUtil.h"
 #include "assembler/AssemblerSprite.hpp"
+#include "Profiler.hpp"
 
 #if USE_MIDDLEWARE
 #include "MiddlewareManager.h"
 #endif
 
-#define SUB_RENDER_THREAD_COUNT 1
-#define RENDER_THREAD_COUNT (SUB_RENDER_THREAD_COUNT + 1)
-
 RENDERER_BEGIN
 
 const uint32_t InitLevelCount = 3;
 const uint32_t InitLevelNodeCount = 100;
 
 const uint32_t LocalMat_Use_Thread_Unit_Count = 5;
-const uint32_t WorldMat_Use_Thread_Node_count = 500;
+const uint32_t LocalMat_Job_Unit_Count = 1;
+const uint32_t WorldMat_Use_Thread_Root_Count = 16;
+const uint32_t WorldMat_Job_Root_Count = 4;
 
 RenderFlow* RenderFlow::_instance = nullptr;
 
@@ -52,27 +53,7 @@ RenderFlow::RenderFlow(DeviceGraphics* device, Scene* scene, ForwardRenderer* fo
     
     _batcher = new ModelBatcher(this);
 
-#if SUB_RENDER_THREAD_COUNT > 0
-    _paralleTask = new ParallelTask();
-    _paralleTask->init(SUB_RENDER_THREAD_COUNT);
-    
-    for (uint32_t i = 0; i < SUB_RENDER_THREAD_COUNT; i++)
-    {
-        _paralleTask->pushTask(i, [this](int tid){
-            switch(_parallelStage)
-            {
-                case ParallelStage::LOCAL_MAT:
-                    calculateLocalMatrix(tid);
-                break;
-                case ParallelStage::WORLD_MAT:
-                    calculateLevelWorldMatrix(tid, _parallelStage);
-                break;
-                default:
-                break;
-            }
-        });
-    }
-#endif
+    _jobSystem = new JobSystem();
     
     _levelInfoArr.resize(InitLevelCount);
     for (auto i = 0; i < InitLevelCount; i++)
@@ -83,25 +64,25 @@ RenderFlow::RenderFlow(DeviceGraphics* device, Scene* scene, ForwardRenderer* fo
 
 RenderFlow::~RenderFlow()
 {
-    CC_SAFE_DELETE(_paralleTask);
+    CC_SAFE_DELETE(_jobSystem);
     CC_SAFE_DELETE(_batcher);
 }
 
-void RenderFlow::removeNodeLevel(std::size_t level, cocos2d::Mat4* worldMat)
+void RenderFlow::removeNodeLevel(std::size_t level, std::size_t index)
 {
     if (level >= _levelInfoArr.size()) return;
     auto& levelInfos = _levelInfoArr[level];
-    for(auto it = levelInfos.begin(); it != levelInfos.end(); it++)
+    if (index >= levelInfos.size()) return;
+    
+    if (index != levelInfos.size() - 1)
     {
-        if (it->worldMat == worldMat)
-        {
-            levelInfos.erase(it);
-            return;
-        }
+        levelInfos[index] = levelInfos.back();
+        levelInfos[index].node->setLevelIndex(index);
     }
+    levelInfos.pop_back();
 }
 
-void RenderFlow::insertNodeLevel(std::size_t level, const LevelInfo& levelInfo)
+std::size_t RenderFlow::insertNodeLevel(std::size_t level, const LevelInfo& levelInfo)
 {
     if (level >= _levelInfoArr.size())
     {
@@ -109,17 +90,52 @@ void RenderFlow::insertNodeLevel(std::size_t level, const LevelInfo& levelInfo)
     }
     auto& levelInfos = _levelInfoArr[level];
     levelInfos.push_back(levelInfo);
+    return levelInfos.size() - 1;
 }
 
-void RenderFlow::calculateLocalMatrix(int tid)
+void RenderFlow::calculateLocalMatrix()
 {
+    NodeMemPool* instance = NodeMemPool::getInstance();
+    CCASSERT(instance, "RenderFlow calculateLocalMatrix NodeMemPool is null");
+    std::size_t unitCount = instance->getCommonList().size();
+    
+    std::size_t laneCount = _jobSystem->getLaneCount();
+    _worldDirtyNodes.resize(laneCount);
+    _localDirtyIndices.resize(laneCount);
+    _localMatCounts.assign(laneCount, 0);
+    
+    if (unitCount < LocalMat_Use_Thread_Unit_Count)
+    {
+        calculateLocalMatrix(0, unitCount, _jobSystem->getCallerLane());
+    }
+    else
+    {
+        _jobSystem->parallelFor(unitCount, LocalMat_Job_Unit_Count, [this](std::size_t begin, std::size_t end, int tid) {
+            calculateLocalMatrix(begin, end, tid);
+        });
+    }
+    
+    _localMatUpdateCount = 0;
+    for (auto count : _localMatCounts)
+    {
+        _localMatUpdateCount += count;
+    }
+    RENDER_PROFILE_COUNT(LOCAL_MATRICES, _localMatUpdateCount);
+}
+
+void RenderFlow::calculateLocalMatrix(std::size_t begin, std::size_t end, int tid)
+{
+    RENDER_PROFILE_SCOPE(LOCAL_MATRIX);
     const uint16_t SPACE_FREE_FLAG = 0x0;
-    cocos2d::Mat4 matTemp;
+    const uint32_t WORLD_DIRTY_MASK = WORLD_TRANSFORM | OPACITY;
     
     NodeMemPool* instance = NodeMemPool::getInstance();
     CCASSERT(instance, "RenderFlow calculateLocalMatrix NodeMemPool is null");
     auto& commonList = instance->getCommonList();
     auto& nodePool = instance->getNodePool();
+    auto& worldDirtyNodes = _worldDirtyNodes[tid];
+    auto& localDirtyIndices = _localDirtyIndices[tid];
+    uint32_t localMatCount = 0;
 
     UnitCommon* commonUnit = nullptr;
     uint16_t usingNum = 0;
@@ -127,23 +143,8 @@ void RenderFlow::calculateLocalMatrix(int tid)
     Sign* signData = nullptr;
     UnitNode* nodeUnit = nullptr;
     uint32_t* dirty = nullptr;
-    cocos2d::Mat4* localMat = nullptr;
-    TRS* trs = nullptr;
-    uint8_t* is3D = nullptr;
-    cocos2d::Quaternion* quat = nullptr;
-    float trsZ = 0.0f, trsSZ = 0.0f;
     
-    std::size_t begin = 0, end = commonList.size();
-    std::size_t fieldSize = end / RENDER_THREAD_COUNT;
-    if (tid >= 0)
-    {
-        begin = tid * fieldSize;
-        if (tid < RENDER_THREAD_COUNT - 1)
-        {
-            end = (tid + 1) * fieldSize;
-        }
-    }
-
+    end = std::min(end, commonList.size());
     for(auto i = begin; i < end; i++)
     {
         commonUnit = commonList[i];
@@ -157,198 +158,178 @@ void RenderFlow::calculateLocalMatrix(int tid)
         nodeUnit = nodePool[commonUnit->unitID];
         
         dirty = nodeUnit->getDirty(0);
-        localMat = nodeUnit->getLocalMat(0);
-        trs = nodeUnit->getTRS(0);
-        is3D = nodeUnit->getIs3D(0);
+        localDirtyIndices.clear();
         
         NodeProxy** nodeProxy = (NodeProxy**)nodeUnit->getNode(0);
         
-        for (auto j = 0; j < contentNum; j++, localMat ++, trs ++, is3D ++, signData++, dirty++, nodeProxy++)
+        for (uint32_t j = 0; j < contentNum; j++, signData++, dirty++, nodeProxy++)
         {
             if (signData->freeFlag == SPACE_FREE_FLAG) continue;
             
             // reset world transform changed flag
             *dirty &= ~(WORLD_TRANSFORM_CHANGED | NODE_OPACITY_CHANGED);
-            if (!(*dirty & LOCAL_TRANSFORM)) continue;
-            
-            localMat->setIdentity();
-            trsZ = *is3D ? trs->z : 0;
-            localMat->translate(trs->x, trs->y, trsZ);
-            
-            quat = (cocos2d::Quaternion*)&(trs->qx);
-            cocos2d::Mat4::createRotation(*quat, &matTemp);
-            cocos2d::Mat4::multiply(*localMat, matTemp, localMat);
             
-            trsSZ = *is3D ? trs->sz : 1;
-            cocos2d::Mat4::createScale(trs->sx, trs->sy, trsSZ, &matTemp);
-            cocos2d::Mat4::multiply(*localMat, matTemp, localMat);
+            if (*dirty & LOCAL_TRANSFORM)
+            {
+                localDirtyIndices.push_back(j);
+                *dirty &= ~LOCAL_TRANSFORM;
+                *dirty |= WORLD_TRANSFORM;
+            }
             
-            *dirty &= ~LOCAL_TRANSFORM;
-            *dirty |= WORLD_TRANSFORM;
+            // only self dirty nodes start a world matrix propagation
+            if ((*dirty & WORLD_DIRTY_MASK) && *nodeProxy)
+            {
+                worldDirtyNodes.push_back(*nodeProxy);
+            }
+        }
+        
+        if (!localDirtyIndices.empty())
+        {
+            cocos2d::MathUtil::composeTRSBatch((const float*)nodeUnit->getTRS(0), nodeUnit->getIs3D(0), localDirtyIndices.data(), localDirtyIndices.size(), nodeUnit->getLocalMat(0)->m);
+            localMatCount += (uint32_t)localDirtyIndices.size();
         }
     }
+    
+    _localMatCounts[tid] += localMatCount;
 }
 
-void RenderFlow::calculateLevelWorldMatrix(int tid, int stage)
+static inline void updateLevelInfo(RenderFlow::LevelInfo& info)
 {
-    if (_curLevel >= _levelInfoArr.size())
+    auto dirty = info.dirty;
+    auto parentDirty = info.parentDirty;
+    auto selfWorldDirty = *dirty & RenderFlow::WORLD_TRANSFORM;
+    auto selfOpacityDirty = *dirty & RenderFlow::OPACITY;
+    
+    if (parentDirty)
     {
-        return;
+        if ((*parentDirty & RenderFlow::WORLD_TRANSFORM_CHANGED) || selfWorldDirty)
+        {
+            cocos2d::Mat4::multiply(*info.parentWorldMat, *info.localMat, info.worldMat);
+            *dirty |= RenderFlow::WORLD_TRANSFORM_CHANGED;
+            *dirty &= ~RenderFlow::WORLD_TRANSFORM;
+        }
+        
+        if ((*parentDirty & RenderFlow::NODE_OPACITY_CHANGED) || selfOpacityDirty)
+        {
+            *info.realOpacity = *info.opacity * *info.parentRealOpacity / 255.0f;
+            *dirty |= RenderFlow::NODE_OPACITY_CHANGED;
+            *dirty &= ~RenderFlow::OPACITY;
+        }
     }
-    
-    auto& levelInfos = _levelInfoArr[_curLevel];
-
-    std::size_t begin = 0, end = levelInfos.size();
-    std::size_t fieldSize = end / RENDER_THREAD_COUNT;
-    if (tid >= 0)
+    else
     {
-        begin = tid * fieldSize;
-        if (tid < RENDER_THREAD_COUNT - 1)
+        if (selfWorldDirty)
+        {
+            *info.worldMat = *info.localMat;
+            *dirty |= RenderFlow::WORLD_TRANSFORM_CHANGED;
+            *dirty &= ~RenderFlow::WORLD_TRANSFORM;
+        }
+        
+        if (selfOpacityDirty)
         {
-            end = (tid + 1) * fieldSize;
+            *info.realOpacity = *info.opacity;
+            *dirty |= RenderFlow::NODE_OPACITY_CHANGED;
+            *dirty &= ~RenderFlow::OPACITY;
         }
     }
+}
+
+bool RenderFlow::hasWorldDirtyAncestor(NodeProxy* node) const
+{
+    for (NodeProxy* parent = node->getParent(); parent && parent->isValid(); parent = parent->getParent())
+    {
+        if (parent->isDirty(WORLD_TRANSFORM | OPACITY)) return true;
+    }
+    return false;
+}
 
+void RenderFlow::calculateSubtreeWorldMatrix(std::size_t begin, std::size_t end, int tid)
+{
+    RENDER_PROFILE_SCOPE(WORLD_MATRIX);
+    const uint32_t CHANGED_MASK = WORLD_TRANSFORM_CHANGED | NODE_OPACITY_CHANGED;
+    auto& stack = _subtreeStacks[tid];
+    uint32_t worldMatCount = 0;
+    
+    end = std::min(end, _worldDirtyRoots.size());
     for(std::size_t index = begin; index < end; index++)
     {
-        auto& info = levelInfos[index];
-        auto dirty = info.dirty;
-        auto parentDirty = info.parentDirty;
-        auto selfWorldDirty = *dirty & WORLD_TRANSFORM;
-        auto selfOpacityDirty = *dirty & OPACITY;
-        
-        if (parentDirty)
+        stack.push_back(_worldDirtyRoots[index]);
+        while (!stack.empty())
         {
-            if ((*parentDirty & WORLD_TRANSFORM_CHANGED) || selfWorldDirty)
-            {
-                cocos2d::Mat4::multiply(*info.parentWorldMat, *info.localMat, info.worldMat);
-                *dirty |= WORLD_TRANSFORM_CHANGED;
-                *dirty &= ~WORLD_TRANSFORM;
-            }
+            NodeProxy* node = stack.back();
+            stack.pop_back();
             
-            if ((*parentDirty & NODE_OPACITY_CHANGED) || selfOpacityDirty)
-            {
-                *info.realOpacity = *info.opacity * *info.parentRealOpacity / 255.0f;
-                *dirty |= NODE_OPACITY_CHANGED;
-                *dirty &= ~OPACITY;
-            }
-        }
-        else
-        {
-            if (selfWorldDirty)
-            {
-                *info.worldMat = *info.localMat;
-                *dirty |= WORLD_TRANSFORM_CHANGED;
-                *dirty &= ~WORLD_TRANSFORM;
-            }
+            // parent is always updated before its children, no level barrier is needed
+            updateLevelInfo(_levelInfoArr[node->getLevel()][node->getLevelIndex()]);
+            worldMatCount++;
+            if (!node->isDirty(CHANGED_MASK)) continue;
             
-            if (selfOpacityDirty)
+            for (const auto& child : node->getChildren())
             {
-                *info.realOpacity = *info.opacity;
-                *dirty |= NODE_OPACITY_CHANGED;
-                *dirty &= ~OPACITY;
+                if (child->getLevelIndex() != NODE_LEVEL_INVALID)
+                {
+                    stack.push_back(child);
+                }
             }
         }
     }
+    
+    _worldMatCounts[tid] += worldMatCount;
 }
 
 void RenderFlow::calculateWorldMatrix()
 {
-    for(std::size_t level = 0, n = _levelInfoArr.size(); level < n; level++)
+    // a dirty node under another dirty node is updated by its ancestor's subtree,
+    // so the remaining roots are independent of each other
+    _worldDirtyRoots.clear();
+    for (auto& dirtyNodes : _worldDirtyNodes)
     {
-        auto& levelInfos = _levelInfoArr[level];
-        for(std::size_t index = 0, count = levelInfos.size(); index < count; index++)
+        for (auto node : dirtyNodes)
         {
-            auto& info = levelInfos[index];
-            auto selfWorldDirty = *info.dirty & WORLD_TRANSFORM;
-            auto selfOpacityDirty = *info.dirty & OPACITY;
-            
-            if (info.parentDirty)
-            {
-                if ((*info.parentDirty & WORLD_TRANSFORM_CHANGED) || selfWorldDirty)
-                {
-                    cocos2d::Mat4::multiply(*info.parentWorldMat, *info.localMat, info.worldMat);
-                    *info.dirty |= WORLD_TRANSFORM_CHANGED;
-                    *info.dirty &= ~WORLD_TRANSFORM;
-                }
-                
-                if ((*info.parentDirty & NODE_OPACITY_CHANGED) || selfOpacityDirty)
-                {
-                    *info.realOpacity = *info.opacity * *info.parentRealOpacity / 255.0f;
-                    *info.dirty |= NODE_OPACITY_CHANGED;
-                    *info.dirty &= ~OPACITY;
-                }
-            }
-            else
-            {
-                if (selfWorldDirty)
-                {
-                    *info.worldMat = *info.localMat;
-                    *info.dirty |= WORLD_TRANSFORM_CHANGED;
-                    *info.dirty &= ~WORLD_TRANSFORM;
-                }
-                
-                if (selfOpacityDirty)
-                {
-                    *info.realOpacity = *info.opacity;
-                    *info.dirty |= NODE_OPACITY_CHANGED;
-                    *info.dirty &= ~OPACITY;
-                }
-            }
+            if (node->getLevelIndex() == NODE_LEVEL_INVALID) continue;
+            if (hasWorldDirtyAncestor(node)) continue;
+            _worldDirtyRoots.push_back(node);
         }
+        dirtyNodes.clear();
+    }
+    
+    std::size_t laneCount = _jobSystem->getLaneCount();
+    _subtreeStacks.resize(laneCount);
+    _worldMatCounts.assign(laneCount, 0);
+    
+    std::size_t rootCount = _worldDirtyRoots.size();
+    if (rootCount < WorldMat_Use_Thread_Root_Count)
+    {
+        calculateSubtreeWorldMatrix(0, rootCount, _jobSystem->getCallerLane());
+    }
+    else
+    {
+        _jobSystem->parallelFor(rootCount, WorldMat_Job_Root_Count, [this](std::size_t begin, std::size_t end, int tid) {
+            calculateSubtreeWorldMatrix(begin, end, tid);
+        });
+    }
+    
+    _worldMatUpdateCount = 0;
+    for (auto count : _worldMatCounts)
+    {
+        _worldMatUpdateCount += count;
     }
+    RENDER_PROFILE_COUNT(WORLD_MATRICES, _worldMatUpdateCount);
 }
 
 void RenderFlow::render(NodeProxy* scene, float deltaTime, Camera *camera)
 {
     if (scene != nullptr)
     {
+        RENDER_PROFILE_BEGIN_FRAME();
         
 #if USE_MIDDLEWARE
         // udpate middleware before render
         middleware::MiddlewareManager::getInstance()->update(deltaTime);
 #endif
         
-#if SUB_RENDER_THREAD_COUNT > 0
-
-        int mainThreadTid = RENDER_THREAD_COUNT - 1;
-
-        NodeMemPool* instance = NodeMemPool::getInstance();
-        auto& commonList = instance->getCommonList();
-        if (commonList.size() < LocalMat_Use_Thread_Unit_Count)
-        {
-            _parallelStage = ParallelStage::NONE;
-            calculateLocalMatrix();
-        }
-        else
-        {
-            _parallelStage = ParallelStage::LOCAL_MAT;
-            _paralleTask->beginAllThreads();
-            calculateLocalMatrix(mainThreadTid);
-            _paralleTask->waitAllThreads();
-        }
-
-        _curLevel = 0;
-        for(auto count = _levelInfoArr.size(); _curLevel < count; _curLevel++)
-        {
-            auto& levelInfos = _levelInfoArr[_curLevel];
-            if (levelInfos.size() < WorldMat_Use_Thread_Node_count)
-            {
-                _parallelStage = ParallelStage::NONE;
-                calculateLevelWorldMatrix();
-            }
-            else
-            {
-                _parallelStage = ParallelStage::WORLD_MAT;
-                _paralleTask->beginAllThreads();
-                calculateLevelWorldMatrix(mainThreadTid);
-                _paralleTask->waitAllThreads();
-            }
-        }
-#else
         calculateLocalMatrix();
         calculateWorldMatrix();
-#endif
         
         _batcher->startBatch();
 
@@ -358,16 +339,24 @@ void RenderFlow::render(NodeProxy* scene, float deltaTime, Camera *camera)
 #endif
         scene->resetGlobalRenderOrder();
         
-        auto traverseHandle = scene->traverseHandle;
-        traverseHandle(scene, _batcher, _scene);
+        {
+            RENDER_PROFILE_SCOPE(TRAVERSE);
+            auto traverseHandle = scene->traverseHandle;
+            traverseHandle(scene, _batcher, _scene);
+        }
         _batcher->terminateBatch();
 
-        if (camera) {
-            _forward->renderCamera(camera, _scene);
-        }
-        else {
-            _forward->render(_scene, deltaTime);
+        {
+            RENDER_PROFILE_SCOPE(FORWARD_RENDER);
+            if (camera) {
+                _forward->renderCamera(camera, _scene);
+            }
+            else {
+                _forward->render(_scene, deltaTime);
+            }
         }
+
+        RENDER_PROFILE_END_FRAME();
     }
 }
 
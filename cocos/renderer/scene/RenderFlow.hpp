@@ -30,7 +30,7 @@
 #include "../renderer/Scene.h"
 #include "../renderer/ForwardRenderer.h"
 #include "../gfx/DeviceGraphics.h"
-#include "ParallelTask.hpp"
+#include "JobSystem.hpp"
 
 RENDERER_BEGIN
 
@@ -49,8 +49,6 @@ RENDERER_BEGIN
  @endcode
  */
 
-#define NODE_LEVEL_INVALID 0xffffffff
-
 class RenderFlow
 {
 public:
@@ -80,14 +78,8 @@ public:
         NODE_OPACITY_CHANGED = 1 << 31,
     };
 
-    enum ParallelStage {
-        NONE = 1 << 0,
-        LOCAL_MAT = 1 << 1,
-        WORLD_MAT = 1 << 2,
-        CALC_VERTICES = 1 << 3,
-    };
-    
     struct LevelInfo{
+        NodeProxy* node = nullptr;
         uint32_t* dirty = nullptr;
         uint32_t* parentDirty = nullptr;
         cocos2d::Mat4* parentWorldMat = nullptr;
@@ -137,28 +129,49 @@ public:
      */
     void visit(NodeProxy* rootNode);
     /**
-     *  @brief Calculate local matrix.
-     *  @param[in] tid It must rather than -1 if enable multiple thread.
+     *  @brief Calculate local matrix of all dirty nodes and collect the nodes whose world matrix or opacity is dirty,
+     *  large pools are split into jobs.
      */
-    void calculateLocalMatrix(int tid = -1);
+    void calculateLocalMatrix();
     /**
-     *  @brief Calculate world matrix.
+     *  @brief Calculate local matrix of the nodes in a range of common units.
+     *  @param[in] begin First unit index in common list.
+     *  @param[in] end One past the last unit index in common list.
+     *  @param[in] tid Job lane id.
+     */
+    void calculateLocalMatrix(std::size_t begin, std::size_t end, int tid);
+    /**
+     *  @brief Calculate world matrix and opacity of the dirty nodes collected by calculateLocalMatrix and their subtrees.
      */
     void calculateWorldMatrix();
     /**
-     *  @brief Calculate world matrix by level.
-     *  @param[in] tid Thread id.
-     *  @param[level] level Node level.
+     *  @brief Calculate world matrix of the subtrees rooted at a range of dirty roots.
+     *  @param[in] begin First dirty root index.
+     *  @param[in] end One past the last dirty root index.
+     *  @param[in] tid Job lane id.
+     */
+    void calculateSubtreeWorldMatrix(std::size_t begin, std::size_t end, int tid);
+    /**
+     *  @brief Gets the count of local matrices recalculated in the last frame.
+     */
+    uint32_t getLocalMatUpdateCount() const { return _localMatUpdateCount; }
+    /**
+     *  @brief Gets the count of nodes whose world matrix or opacity was recalculated in the last frame.
      */
-    void calculateLevelWorldMatrix(int tid = -1, int stage = -1);
+    uint32_t getWorldMatUpdateCount() const { return _worldMatUpdateCount; }
     /**
      *  @brief remove node level
+     *  @param[in] level Node level.
+     *  @param[in] index Node index in level, the last node of the level is moved into the hole.
      */
-    void removeNodeLevel(std::size_t level, cocos2d::Mat4* worldMat);
+    void removeNodeLevel(std::size_t level, std::size_t index);
     /**
      *  @brief insert node level
+     *  @return Node index in level.
      */
-    void insertNodeLevel(std::size_t level, const LevelInfo& levelInfo);
+    std::size_t insertNodeLevel(std::size_t level, const LevelInfo& levelInfo);
+private:
+    bool hasWorldDirtyAncestor(NodeProxy* node) const;
 private:
     
     static RenderFlow *_instance;
@@ -167,11 +180,22 @@ private:
     Scene* _scene = nullptr;
     DeviceGraphics* _device = nullptr;
     ForwardRenderer* _forward = nullptr;
-    std::size_t _curLevel = 0;
     std::vector<std::vector<LevelInfo>> _levelInfoArr;
+    
+    // self dirty nodes collected by every job lane
+    std::vector<std::vector<NodeProxy*>> _worldDirtyNodes;
+    std::vector<NodeProxy*> _worldDirtyRoots;
+    // local matrix dirty slots of the unit being scanned by every job lane
+    std::vector<std::vector<uint32_t>> _localDirtyIndices;
+    // traverse stack of every job lane
+    std::vector<std::vector<NodeProxy*>> _subtreeStacks;
+    
+    std::vector<uint32_t> _localMatCounts;
+    std::vector<uint32_t> _worldMatCounts;
+    uint32_t _localMatUpdateCount = 0;
+    uint32_t _worldMatUpdateCount = 0;
 
-    ParallelStage _parallelStage = ParallelStage::NONE;
-    ParallelTask* _paralleTask = nullptr;
+    JobSystem* _jobSystem = nullptr;
 };
 
 // end of scene group
@@ -0,0 +1,151 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "StaticBatch.hpp"
+#include "NodeProxy.hpp"
+#include "MeshBuffer.hpp"
+#include "RenderFlow.hpp"
+#include "../renderer/Model.h"
+
+// baked subtrees are usually small panels, the buffers grow as needed
+#define STATIC_INIT_QUAD_COUNT 64
+
+RENDERER_BEGIN
+
+const uint32_t StaticBatch::NODE_DIRTY_MASK = RenderFlow::WORLD_TRANSFORM_CHANGED | RenderFlow::NODE_OPACITY_CHANGED |
+    RenderFlow::REORDER_CHILDREN | RenderFlow::UPDATE_RENDER_DATA | RenderFlow::COLOR;
+const uint32_t StaticBatch::NODE_RENDER_MASK = RenderFlow::RENDER | RenderFlow::POST_RENDER;
+
+uint32_t StaticBatch::_count = 0;
+
+StaticBatch::StaticBatch()
+{
+    _count++;
+}
+
+StaticBatch::~StaticBatch()
+{
+    for (auto model : _models)
+    {
+        delete model;
+    }
+    _models.clear();
+    
+    for (auto iter : _buffers)
+    {
+        delete iter.second;
+    }
+    _buffers.clear();
+    
+    _count--;
+}
+
+void StaticBatch::setDirty()
+{
+    _dirty = true;
+    _bakeable = true;
+}
+
+void StaticBatch::reset()
+{
+    for (std::size_t i = 0; i < _modelCount; i++)
+    {
+        _models[i]->reset();
+    }
+    _modelCount = 0;
+    
+    for (auto iter : _buffers)
+    {
+        iter.second->reset();
+    }
+    
+    _nodes.clear();
+    _nodeStates.clear();
+    _dirty = false;
+}
+
+void StaticBatch::addNode(NodeProxy* node)
+{
+    NodeState state;
+    state.renderFlag = *node->getDirty() & NODE_RENDER_MASK;
+    state.cullingMask = node->getCullingMask();
+    _nodes.push_back(node);
+    _nodeStates.push_back(state);
+}
+
+bool StaticBatch::checkNodes() const
+{
+    for (std::size_t i = 0, n = _nodes.size(); i < n; i++)
+    {
+        NodeProxy* node = _nodes[i];
+        // removed nodes mark the batch dirty, a destroyed node here means a missed notification
+        if (!node->isValid()) return true;
+        
+        uint32_t dirty = *node->getDirty();
+        if (dirty & NODE_DIRTY_MASK) return true;
+        
+        const NodeState& state = _nodeStates[i];
+        if ((dirty & NODE_RENDER_MASK) != state.renderFlag) return true;
+        if (node->getCullingMask() != state.cullingMask) return true;
+        
+        // assemblers of nodes which are not rendered are not baked, their flags are never cleared
+        if (!(state.renderFlag & RenderFlow::RENDER)) continue;
+        AssemblerBase* assembler = node->getAssembler();
+        if (assembler && assembler->isDirty(AssemblerBase::VERTICES_DIRTY | AssemblerBase::VERTICES_OPACITY_CHANGED)) return true;
+    }
+    return false;
+}
+
+MeshBuffer* StaticBatch::getBuffer(ModelBatcher* batcher, VertexFormat* fmt)
+{
+    auto iter = _buffers.find(fmt);
+    if (iter != _buffers.end())
+    {
+        return iter->second;
+    }
+    
+    MeshBuffer* buffer = new MeshBuffer(batcher, fmt, STATIC_INIT_QUAD_COUNT);
+    _buffers.emplace(fmt, buffer);
+    return buffer;
+}
+
+Model* StaticBatch::requestModel()
+{
+    if (_modelCount >= _models.size())
+    {
+        _models.push_back(new Model());
+    }
+    return _models[_modelCount++];
+}
+
+void StaticBatch::uploadData()
+{
+    for (auto iter : _buffers)
+    {
+        iter.second->uploadData();
+    }
+}
+
+RENDERER_END
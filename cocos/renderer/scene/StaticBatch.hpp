@@ -0,0 +1,153 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+#include "../Macro.h"
+
+RENDERER_BEGIN
+
+class NodeProxy;
+class ModelBatcher;
+class MeshBuffer;
+class Model;
+class VertexFormat;
+
+/**
+ * @addtogroup scene
+ * @{
+ */
+
+/**
+ *  @brief Baked render result of a static node subtree.\n
+ *  The subtree is traversed into its own mesh buffers and models once, later frames only commit the baked models
+ *  until a node of the subtree reports a change through its dirty flags, its assembler's dirty flags,
+ *  its culling mask or a hierarchy change.\n
+ *  Render data rewritten by script without touching any flag must be reported with NodeProxy::markStaticBatchDirty.
+ *  Subtrees containing masks, custom assemblers or nodes visited with NodeProxy::visit can't be baked,
+ *  they are traversed every frame as usual.
+ */
+class StaticBatch
+{
+public:
+    /*
+     *  @brief Node flags which invalidate the baked result.
+     */
+    static const uint32_t NODE_DIRTY_MASK;
+    /*
+     *  @brief Node flags which decide whether the node is rendered, they are recorded while baking.
+     */
+    static const uint32_t NODE_RENDER_MASK;
+    
+    /*
+     *  @brief Gets the count of alive static batches, hierarchy changes don't look for static batches if it's 0.
+     */
+    static uint32_t getCount() { return _count; }
+    
+    StaticBatch();
+    ~StaticBatch();
+    
+    /*
+     *  @brief Whether the subtree needs to be baked again.
+     */
+    bool isDirty() const { return _dirty; }
+    /*
+     *  @brief Marks the subtree to be baked again, it also gives an unbakeable subtree another try.
+     */
+    void setDirty();
+    /*
+     *  @brief Whether the last baking succeeded.
+     */
+    bool isBakeable() const { return _bakeable; }
+    /*
+     *  @brief Marks the subtree unbakeable until next setDirty.
+     */
+    void setUnbakeable() { _bakeable = false; }
+    
+    /*
+     *  @brief Clears the baked result before baking again.
+     */
+    void reset();
+    /*
+     *  @brief Records a node traversed while baking.
+     */
+    void addNode(NodeProxy* node);
+    /*
+     *  @brief Checks the recorded nodes for changes since baking.
+     *  @return True if any node changed.
+     */
+    bool checkNodes() const;
+    /*
+     *  @brief Gets the nodes traversed while baking, in traversal order.
+     */
+    const std::vector<NodeProxy*>& getNodes() const { return _nodes; }
+    
+    /*
+     *  @brief Gets the mesh buffer for a vertex format, it's owned by the static batch.
+     */
+    MeshBuffer* getBuffer(ModelBatcher* batcher, VertexFormat* fmt);
+    /*
+     *  @brief Gets a model to store a baked batch.
+     */
+    Model* requestModel();
+    /*
+     *  @brief Gets the baked model count.
+     */
+    std::size_t getModelCount() const { return _modelCount; }
+    /*
+     *  @brief Gets a baked model.
+     */
+    Model* getModel(std::size_t index) const { return _models[index]; }
+    /*
+     *  @brief Uploads the baked mesh buffers.
+     */
+    void uploadData();
+private:
+    CC_DISALLOW_COPY_ASSIGN_AND_MOVE(StaticBatch);
+    
+    struct NodeState
+    {
+        uint32_t renderFlag = 0;
+        int32_t cullingMask = 0;
+    };
+    
+    static uint32_t _count;
+    
+    bool _dirty = true;
+    bool _bakeable = true;
+    std::vector<NodeProxy*> _nodes;
+    std::vector<NodeState> _nodeStates;
+    std::vector<Model*> _models;
+    std::size_t _modelCount = 0;
+    std::unordered_map<VertexFormat*, MeshBuffer*> _buffers;
+};
+
+// end of scene group
+/// @}
+
+RENDERER_END
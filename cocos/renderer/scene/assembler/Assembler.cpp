@@ -29,6 +29,7 @@
 #include "../MeshBuffer.hpp"
 #include "../../renderer/Scene.h"
 #include "math/CCMath.h"
+#include "math/MathUtil.h"
 #include "cocos/scripting/js-bindings/jswrapper/SeApi.h"
 #include "cocos/scripting/js-bindings/manual/jsb_conversions.hpp"
 #include "cocos/scripting/js-bindings/auto/jsb_renderer_auto.hpp"
@@ -87,7 +88,11 @@ void Assembler::updateMeshIndex(std::size_t iaIndex, int meshIndex)
         _iaDatas.resize(iaIndex + 1);
     }
     IARenderData& ia = _iaDatas[iaIndex];
+    if (ia.meshIndex == meshIndex) return;
     ia.meshIndex = meshIndex;
+    
+    // lets static batches containing this assembler bake again
+    enableDirty(AssemblerBase::VERTICES_OPACITY_CHANGED);
 }
 
 void Assembler::updateIndicesRange(std::size_t iaIndex, int start, int count)
@@ -97,8 +102,11 @@ void Assembler::updateIndicesRange(std::size_t iaIndex, int start, int count)
         _iaDatas.resize(iaIndex + 1);
     }
     IARenderData& ia = _iaDatas[iaIndex];
+    if (ia.indicesStart == start && ia.indicesCount == count) return;
     ia.indicesStart = start;
     ia.indicesCount = count;
+    
+    enableDirty(AssemblerBase::VERTICES_OPACITY_CHANGED);
 }
 
 void Assembler::updateVerticesRange(std::size_t iaIndex, int start, int count)
@@ -121,7 +129,10 @@ void Assembler::updateEffect(std::size_t iaIndex, EffectVariant* effect)
         _iaDatas.resize(iaIndex + 1);
     }
     IARenderData& ia = _iaDatas[iaIndex];
+    if (ia.getEffect() == effect) return;
     ia.setEffect(effect);
+    
+    enableDirty(AssemblerBase::VERTICES_OPACITY_CHANGED);
 }
 
 void Assembler::reset()
@@ -178,22 +189,11 @@ void Assembler::fillBuffers(NodeProxy* node, ModelBatcher* batcher, std::size_t
         switch (num) {
            // Vertex is X Y Z Format
             case 3:
-                for (uint32_t i = 0; i < vertexCount; ++i)
-                {
-                    ((cocos2d::Vec3*)ptrPos)->transformMat4(*((cocos2d::Vec3*)ptrPos), worldMat);
-                    ptrPos += dataPerVertex;
-                }
+                MathUtil::transformVertices3D(worldMat.m, ptrPos, dataPerVertex, vertexCount);
                 break;
-            // Vertex is X Y Format
+            // Vertex is X Y Format, the float after position is left untouched
             case 2:
-                for (uint32_t i = 0; i < vertexCount; ++i)
-                {
-                    float z = ptrPos[2];
-                    ptrPos[2] = 0;
-                    worldMat.transformPoint((cocos2d::Vec3*)ptrPos);
-                    ptrPos[2] = z;
-                    ptrPos += dataPerVertex;
-                }
+                MathUtil::transformVertices2D(worldMat.m, ptrPos, dataPerVertex, vertexCount);
                 break;
         }
     }
@@ -201,10 +201,7 @@ void Assembler::fillBuffers(NodeProxy* node, ModelBatcher* batcher, std::size_t
     // Copy index buffer with vertex offset
     uint16_t* indices = (uint16_t*)data->getIndices();
     uint16_t* dst = buffer->iData;
-    for (auto i = 0, j = ia.indicesStart; i < indexCount; ++i, ++j)
-    {
-        dst[indexId++] = vertexOffset + indices[j];
-    }
+    MathUtil::offsetIndices(indices + ia.indicesStart, indexCount, (uint16_t)vertexOffset, dst + indexId);
 }
 
 void Assembler::setVertexFormat(VertexFormat* vfmt)
@@ -24,6 +24,7 @@
 
 #include "AssemblerSprite.hpp"
 #include "../RenderFlow.hpp"
+#include "math/MathUtil.h"
 
 RENDERER_BEGIN
 
@@ -107,10 +108,7 @@ void AssemblerSprite::fillBuffers(NodeProxy* node, ModelBatcher* batcher, std::s
     // Copy index buffer with vertex offset
     uint16_t* srcIndices = (uint16_t*)data->getIndices();
     uint16_t* dstIndices = buffer->iData;
-    for (auto i = 0, j = ia.indicesStart; i < indexCount; ++i, ++j)
-    {
-        dstIndices[indexId++] = vertexOffset + srcIndices[j];
-    }
+    MathUtil::offsetIndices(srcIndices + ia.indicesStart, indexCount, (uint16_t)vertexOffset, dstIndices + indexId);
 }
 
 void AssemblerSprite::calculateWorldVertices(const Mat4& worldMat)
@@ -136,21 +134,10 @@ void AssemblerSprite::calculateWorldVertices(const Mat4& worldMat)
         
         switch (num) {
             case 3:
-                for (uint32_t i = 0; i < vertexCount; ++i)
-                {
-                    ((cocos2d::Vec3*)srcWorldVerts)->transformMat4(*((cocos2d::Vec3*)srcWorldVerts), worldMat);
-                    srcWorldVerts += dataPerVertex;
-                }
+                MathUtil::transformVertices3D(worldMat.m, srcWorldVerts, dataPerVertex, vertexCount);
                 break;
             case 2:
-                for (uint32_t i = 0; i < vertexCount; ++i)
-                {
-                    float z = srcWorldVerts[2];
-                    srcWorldVerts[2] = 0;
-                    worldMat.transformPoint((cocos2d::Vec3*)srcWorldVerts);
-                    srcWorldVerts[2] = z;
-                    srcWorldVerts += dataPerVertex;
-                }
+                MathUtil::transformVertices2D(worldMat.m, srcWorldVerts, dataPerVertex, vertexCount);
                 break;
         }
     }
@@ -24,6 +24,7 @@ THE SOFTWARE.
 
 #include "Particle3DAssembler.hpp"
 #include "../NodeProxy.hpp"
+#include "math/MathUtil.h"
 
 RENDERER_BEGIN
 
@@ -71,10 +72,7 @@ void Particle3DAssembler::fillBuffer(NodeProxy *node, MeshBuffer *buffer, const
     // Copy index buffer with vertex offset
     uint16_t* indices = (uint16_t*)data->getIndices();
     uint16_t* dst = buffer->iData;
-    for (auto i = 0, j = ia.indicesStart; i < indexCount; ++i, ++j)
-    {
-        dst[indexId++] = vertexOffset + indices[j];
-    }
+    MathUtil::offsetIndices(indices + ia.indicesStart, indexCount, (uint16_t)vertexOffset, dst + indexId);
 }
 
 void Particle3DAssembler::fillTrailBuffer(NodeProxy *node, MeshBuffer *buffer, const IARenderData& ia, RenderData* data)
@@ -97,10 +95,7 @@ void Particle3DAssembler::fillTrailBuffer(NodeProxy *node, MeshBuffer *buffer, c
     // Copy index buffer with vertex offset
     uint16_t* indices = (uint16_t*)data->getIndices();
     uint16_t* dst = buffer->iData;
-    for (auto i = 0, j = ia.indicesStart; i < indexCount; ++i, ++j)
-    {
-        dst[indexId++] = vertexOffset + indices[j];
-    }
+    MathUtil::offsetIndices(indices + ia.indicesStart, indexCount, (uint16_t)vertexOffset, dst + indexId);
 }
 
 void Particle3DAssembler::fillBuffers(NodeProxy *node, ModelBatcher *batcher, std::size_t index)
@@ -24,6 +24,7 @@
 
 #include "SimpleSprite2D.hpp"
 #include "../RenderFlow.hpp"
+#include "math/MathUtil.h"
 
 RENDERER_BEGIN
 
@@ -65,27 +66,20 @@ void SimpleSprite2D::fillBuffers(NodeProxy* node, ModelBatcher* batcher, std::si
         float* srcWorldVerts = (float*)data->getVertices();
         
         // left bottom
-        float u = srcWorldVerts[2];
-        worldMat.transformVector(vl, vb, 0.0f, 1.0f, (cocos2d::Vec3*)srcWorldVerts);
-        srcWorldVerts[2] = u;
-
+        srcWorldVerts[0] = vl;
+        srcWorldVerts[1] = vb;
         // right bottom
-        srcWorldVerts += dataPerVertex;
-        u = srcWorldVerts[2];
-        worldMat.transformVector(vr, vb, 0.0f, 1.0f, (cocos2d::Vec3*)srcWorldVerts);
-        srcWorldVerts[2] = u;
-
+        srcWorldVerts[dataPerVertex] = vr;
+        srcWorldVerts[dataPerVertex + 1] = vb;
         // left top
-        srcWorldVerts += dataPerVertex;
-        u = srcWorldVerts[2];
-        worldMat.transformVector(vl, vt, 0.0f, 1.0f, (cocos2d::Vec3*)srcWorldVerts);
-        srcWorldVerts[2] = u;
-
+        srcWorldVerts[dataPerVertex * 2] = vl;
+        srcWorldVerts[dataPerVertex * 2 + 1] = vt;
         // right top
-        srcWorldVerts += dataPerVertex;
-        u = srcWorldVerts[2];
-        worldMat.transformVector(vr, vt, 0.0f, 1.0f, (cocos2d::Vec3*)srcWorldVerts);
-        srcWorldVerts[2] = u;
+        srcWorldVerts[dataPerVertex * 3] = vr;
+        srcWorldVerts[dataPerVertex * 3 + 1] = vt;
+        
+        // u following the position is kept by the kernel
+        MathUtil::transformVertices2D(worldMat.m, srcWorldVerts, dataPerVertex, 4);
         
         *_dirty &= ~VERTICES_DIRTY;
     }
@@ -96,10 +90,7 @@ void SimpleSprite2D::fillBuffers(NodeProxy* node, ModelBatcher* batcher, std::si
     // Copy index buffer with vertex offset
     uint16_t* srcIndices = (uint16_t*)data->getIndices();
     uint16_t* dstIndices = buffer->iData;
-    for (auto i = 0, j = 0; i < 6; ++i, ++j)
-    {
-        dstIndices[indexId++] = vertexId + srcIndices[j];
-    }
+    MathUtil::offsetIndices(srcIndices, 6, (uint16_t)vertexId, dstIndices + indexId);
 }
 
 RENDERER_END
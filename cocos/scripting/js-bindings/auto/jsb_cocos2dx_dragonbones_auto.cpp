@@ -7334,6 +7334,80 @@ static bool js_cocos2dx_dragonbones_ArmatureCacheMgr_buildArmatureCache(se::Stat
 }
 SE_BIND_FUNC(js_cocos2dx_dragonbones_ArmatureCacheMgr_buildArmatureCache)
 
+static bool js_cocos2dx_dragonbones_ArmatureCacheMgr_setDiskCachePath(se::State& s)
+{
+    dragonBones::ArmatureCacheMgr* cobj = (dragonBones::ArmatureCacheMgr*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_dragonbones_ArmatureCacheMgr_setDiskCachePath : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        std::string arg0;
+        ok &= seval_to_std_string(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_dragonbones_ArmatureCacheMgr_setDiskCachePath : Error processing arguments");
+        cobj->setDiskCachePath(arg0);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_dragonbones_ArmatureCacheMgr_setDiskCachePath)
+
+static bool js_cocos2dx_dragonbones_ArmatureCacheMgr_setDiskCacheSaveEnabled(se::State& s)
+{
+    dragonBones::ArmatureCacheMgr* cobj = (dragonBones::ArmatureCacheMgr*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_dragonbones_ArmatureCacheMgr_setDiskCacheSaveEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        bool arg0;
+        ok &= seval_to_boolean(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_dragonbones_ArmatureCacheMgr_setDiskCacheSaveEnabled : Error processing arguments");
+        cobj->setDiskCacheSaveEnabled(arg0);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_dragonbones_ArmatureCacheMgr_setDiskCacheSaveEnabled)
+
+static bool js_cocos2dx_dragonbones_ArmatureCacheMgr_getDiskCachePath(se::State& s)
+{
+    dragonBones::ArmatureCacheMgr* cobj = (dragonBones::ArmatureCacheMgr*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_dragonbones_ArmatureCacheMgr_getDiskCachePath : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        const std::string& result = cobj->getDiskCachePath();
+        ok &= std_string_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_dragonbones_ArmatureCacheMgr_getDiskCachePath : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_dragonbones_ArmatureCacheMgr_getDiskCachePath)
+
+static bool js_cocos2dx_dragonbones_ArmatureCacheMgr_isDiskCacheSaveEnabled(se::State& s)
+{
+    dragonBones::ArmatureCacheMgr* cobj = (dragonBones::ArmatureCacheMgr*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_dragonbones_ArmatureCacheMgr_isDiskCacheSaveEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isDiskCacheSaveEnabled();
+        ok &= boolean_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_dragonbones_ArmatureCacheMgr_isDiskCacheSaveEnabled : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_dragonbones_ArmatureCacheMgr_isDiskCacheSaveEnabled)
+
 static bool js_cocos2dx_dragonbones_ArmatureCacheMgr_destroyInstance(se::State& s)
 {
     const auto& args = s.args();
@@ -7385,6 +7459,10 @@ bool js_register_cocos2dx_dragonbones_ArmatureCacheMgr(se::Object* obj)
 
     cls->defineFunction("removeArmatureCache", _SE(js_cocos2dx_dragonbones_ArmatureCacheMgr_removeArmatureCache));
     cls->defineFunction("buildArmatureCache", _SE(js_cocos2dx_dragonbones_ArmatureCacheMgr_buildArmatureCache));
+    cls->defineFunction("setDiskCachePath", _SE(js_cocos2dx_dragonbones_ArmatureCacheMgr_setDiskCachePath));
+    cls->defineFunction("setDiskCacheSaveEnabled", _SE(js_cocos2dx_dragonbones_ArmatureCacheMgr_setDiskCacheSaveEnabled));
+    cls->defineFunction("getDiskCachePath", _SE(js_cocos2dx_dragonbones_ArmatureCacheMgr_getDiskCachePath));
+    cls->defineFunction("isDiskCacheSaveEnabled", _SE(js_cocos2dx_dragonbones_ArmatureCacheMgr_isDiskCacheSaveEnabled));
     cls->defineStaticFunction("destroyInstance", _SE(js_cocos2dx_dragonbones_ArmatureCacheMgr_destroyInstance));
     cls->defineStaticFunction("getInstance", _SE(js_cocos2dx_dragonbones_ArmatureCacheMgr_getInstance));
     cls->defineFinalizeFunction(_SE(js_dragonBones_ArmatureCacheMgr_finalize));
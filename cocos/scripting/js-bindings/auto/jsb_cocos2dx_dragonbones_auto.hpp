@@ -405,6 +405,10 @@ bool js_register_dragonBones_ArmatureCacheMgr(se::Object* obj);
 bool register_all_cocos2dx_dragonbones(se::Object* obj);
 SE_DECLARE_FUNC(js_cocos2dx_dragonbones_ArmatureCacheMgr_removeArmatureCache);
 SE_DECLARE_FUNC(js_cocos2dx_dragonbones_ArmatureCacheMgr_buildArmatureCache);
+SE_DECLARE_FUNC(js_cocos2dx_dragonbones_ArmatureCacheMgr_setDiskCachePath);
+SE_DECLARE_FUNC(js_cocos2dx_dragonbones_ArmatureCacheMgr_setDiskCacheSaveEnabled);
+SE_DECLARE_FUNC(js_cocos2dx_dragonbones_ArmatureCacheMgr_getDiskCachePath);
+SE_DECLARE_FUNC(js_cocos2dx_dragonbones_ArmatureCacheMgr_isDiskCacheSaveEnabled);
 SE_DECLARE_FUNC(js_cocos2dx_dragonbones_ArmatureCacheMgr_destroyInstance);
 SE_DECLARE_FUNC(js_cocos2dx_dragonbones_ArmatureCacheMgr_getInstance);
 
@@ -240,6 +240,78 @@ static bool js_extension_EventAssetsManagerEx_isResuming(se::State& s)
 }
 SE_BIND_FUNC(js_extension_EventAssetsManagerEx_isResuming)
 
+static bool js_extension_EventAssetsManagerEx_getProcessedBytes(se::State& s)
+{
+    cocos2d::extension::EventAssetsManagerEx* cobj = (cocos2d::extension::EventAssetsManagerEx*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_extension_EventAssetsManagerEx_getProcessedBytes : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        double result = cobj->getProcessedBytes();
+        ok &= double_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_extension_EventAssetsManagerEx_getProcessedBytes : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_extension_EventAssetsManagerEx_getProcessedBytes)
+
+static bool js_extension_EventAssetsManagerEx_getProcessedFiles(se::State& s)
+{
+    cocos2d::extension::EventAssetsManagerEx* cobj = (cocos2d::extension::EventAssetsManagerEx*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_extension_EventAssetsManagerEx_getProcessedFiles : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        int result = cobj->getProcessedFiles();
+        ok &= int32_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_extension_EventAssetsManagerEx_getProcessedFiles : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_extension_EventAssetsManagerEx_getProcessedFiles)
+
+static bool js_extension_EventAssetsManagerEx_getDownloadSpeed(se::State& s)
+{
+    cocos2d::extension::EventAssetsManagerEx* cobj = (cocos2d::extension::EventAssetsManagerEx*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_extension_EventAssetsManagerEx_getDownloadSpeed : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        double result = cobj->getDownloadSpeed();
+        ok &= double_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_extension_EventAssetsManagerEx_getDownloadSpeed : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_extension_EventAssetsManagerEx_getDownloadSpeed)
+
+static bool js_extension_EventAssetsManagerEx_getProcessSpeed(se::State& s)
+{
+    cocos2d::extension::EventAssetsManagerEx* cobj = (cocos2d::extension::EventAssetsManagerEx*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_extension_EventAssetsManagerEx_getProcessSpeed : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        double result = cobj->getProcessSpeed();
+        ok &= double_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_extension_EventAssetsManagerEx_getProcessSpeed : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_extension_EventAssetsManagerEx_getProcessSpeed)
+
 SE_DECLARE_FINALIZE_FUNC(js_cocos2d_extension_EventAssetsManagerEx_finalize)
 
 static bool js_extension_EventAssetsManagerEx_constructor(se::State& s)
@@ -288,6 +360,10 @@ bool js_register_extension_EventAssetsManagerEx(se::Object* obj)
     cls->defineFunction("getEventCode", _SE(js_extension_EventAssetsManagerEx_getEventCode));
     cls->defineFunction("getPercent", _SE(js_extension_EventAssetsManagerEx_getPercent));
     cls->defineFunction("isResuming", _SE(js_extension_EventAssetsManagerEx_isResuming));
+    cls->defineFunction("getProcessedBytes", _SE(js_extension_EventAssetsManagerEx_getProcessedBytes));
+    cls->defineFunction("getProcessedFiles", _SE(js_extension_EventAssetsManagerEx_getProcessedFiles));
+    cls->defineFunction("getDownloadSpeed", _SE(js_extension_EventAssetsManagerEx_getDownloadSpeed));
+    cls->defineFunction("getProcessSpeed", _SE(js_extension_EventAssetsManagerEx_getProcessSpeed));
     cls->defineFinalizeFunction(_SE(js_cocos2d_extension_EventAssetsManagerEx_finalize));
     cls->install();
     JSBClassType::registerClass<cocos2d::extension::EventAssetsManagerEx>(cls);
@@ -412,6 +488,66 @@ static bool js_extension_Manifest_isLoaded(se::State& s)
 }
 SE_BIND_FUNC(js_extension_Manifest_isLoaded)
 
+static bool js_extension_Manifest_isBinary(se::State& s)
+{
+    cocos2d::extension::Manifest* cobj = (cocos2d::extension::Manifest*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_extension_Manifest_isBinary : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isBinary();
+        ok &= boolean_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_extension_Manifest_isBinary : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_extension_Manifest_isBinary)
+
+static bool js_extension_Manifest_saveToBinaryFile(se::State& s)
+{
+    cocos2d::extension::Manifest* cobj = (cocos2d::extension::Manifest*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_extension_Manifest_saveToBinaryFile : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        std::string arg0;
+        ok &= seval_to_std_string(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_extension_Manifest_saveToBinaryFile : Error processing arguments");
+        bool result = cobj->saveToBinaryFile(arg0);
+        ok &= boolean_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_extension_Manifest_saveToBinaryFile : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_extension_Manifest_saveToBinaryFile)
+
+static bool js_extension_Manifest_saveToJSONFile(se::State& s)
+{
+    cocos2d::extension::Manifest* cobj = (cocos2d::extension::Manifest*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_extension_Manifest_saveToJSONFile : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        std::string arg0;
+        ok &= seval_to_std_string(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_extension_Manifest_saveToJSONFile : Error processing arguments");
+        bool result = cobj->saveToJSONFile(arg0);
+        ok &= boolean_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_extension_Manifest_saveToJSONFile : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_extension_Manifest_saveToJSONFile)
+
 static bool js_extension_Manifest_getPackageUrl(se::State& s)
 {
     cocos2d::extension::Manifest* cobj = (cocos2d::extension::Manifest*)s.nativeThisObject();
@@ -587,6 +723,9 @@ bool js_register_extension_Manifest(se::Object* obj)
     cls->defineFunction("isVersionLoaded", _SE(js_extension_Manifest_isVersionLoaded));
     cls->defineFunction("parseFile", _SE(js_extension_Manifest_parseFile));
     cls->defineFunction("isLoaded", _SE(js_extension_Manifest_isLoaded));
+    cls->defineFunction("isBinary", _SE(js_extension_Manifest_isBinary));
+    cls->defineFunction("saveToBinaryFile", _SE(js_extension_Manifest_saveToBinaryFile));
+    cls->defineFunction("saveToJSONFile", _SE(js_extension_Manifest_saveToJSONFile));
     cls->defineFunction("getPackageUrl", _SE(js_extension_Manifest_getPackageUrl));
     cls->defineFunction("isUpdating", _SE(js_extension_Manifest_isUpdating));
     cls->defineFunction("getVersion", _SE(js_extension_Manifest_getVersion));
@@ -1080,6 +1219,115 @@ static bool js_extension_AssetsManagerEx_isResuming(se::State& s)
 }
 SE_BIND_FUNC(js_extension_AssetsManagerEx_isResuming)
 
+static bool js_extension_AssetsManagerEx_getProcessedBytes(se::State& s)
+{
+    cocos2d::extension::AssetsManagerEx* cobj = (cocos2d::extension::AssetsManagerEx*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_extension_AssetsManagerEx_getProcessedBytes : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        double result = cobj->getProcessedBytes();
+        ok &= double_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_extension_AssetsManagerEx_getProcessedBytes : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_extension_AssetsManagerEx_getProcessedBytes)
+
+static bool js_extension_AssetsManagerEx_getProcessedFiles(se::State& s)
+{
+    cocos2d::extension::AssetsManagerEx* cobj = (cocos2d::extension::AssetsManagerEx*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_extension_AssetsManagerEx_getProcessedFiles : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        int result = cobj->getProcessedFiles();
+        ok &= int32_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_extension_AssetsManagerEx_getProcessedFiles : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_extension_AssetsManagerEx_getProcessedFiles)
+
+static bool js_extension_AssetsManagerEx_getDownloadSpeed(se::State& s)
+{
+    cocos2d::extension::AssetsManagerEx* cobj = (cocos2d::extension::AssetsManagerEx*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_extension_AssetsManagerEx_getDownloadSpeed : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        double result = cobj->getDownloadSpeed();
+        ok &= double_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_extension_AssetsManagerEx_getDownloadSpeed : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_extension_AssetsManagerEx_getDownloadSpeed)
+
+static bool js_extension_AssetsManagerEx_getProcessSpeed(se::State& s)
+{
+    cocos2d::extension::AssetsManagerEx* cobj = (cocos2d::extension::AssetsManagerEx*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_extension_AssetsManagerEx_getProcessSpeed : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        double result = cobj->getProcessSpeed();
+        ok &= double_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_extension_AssetsManagerEx_getProcessSpeed : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_extension_AssetsManagerEx_getProcessSpeed)
+
+static bool js_extension_AssetsManagerEx_isNativeVerifyEnabled(se::State& s)
+{
+    cocos2d::extension::AssetsManagerEx* cobj = (cocos2d::extension::AssetsManagerEx*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_extension_AssetsManagerEx_isNativeVerifyEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isNativeVerifyEnabled();
+        ok &= boolean_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_extension_AssetsManagerEx_isNativeVerifyEnabled : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_extension_AssetsManagerEx_isNativeVerifyEnabled)
+
+static bool js_extension_AssetsManagerEx_setNativeVerifyEnabled(se::State& s)
+{
+    cocos2d::extension::AssetsManagerEx* cobj = (cocos2d::extension::AssetsManagerEx*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_extension_AssetsManagerEx_setNativeVerifyEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        bool arg0;
+        ok &= seval_to_boolean(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_extension_AssetsManagerEx_setNativeVerifyEnabled : Error processing arguments");
+        cobj->setNativeVerifyEnabled(arg0);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_extension_AssetsManagerEx_setNativeVerifyEnabled)
+
 static bool js_extension_AssetsManagerEx_create(se::State& s)
 {
     const auto& args = s.args();
@@ -1214,6 +1462,12 @@ bool js_register_extension_AssetsManagerEx(se::Object* obj)
     cls->defineFunction("prepareUpdate", _SE(js_extension_AssetsManagerEx_prepareUpdate));
     cls->defineFunction("downloadFailedAssets", _SE(js_extension_AssetsManagerEx_downloadFailedAssets));
     cls->defineFunction("isResuming", _SE(js_extension_AssetsManagerEx_isResuming));
+    cls->defineFunction("getProcessedBytes", _SE(js_extension_AssetsManagerEx_getProcessedBytes));
+    cls->defineFunction("getProcessedFiles", _SE(js_extension_AssetsManagerEx_getProcessedFiles));
+    cls->defineFunction("getDownloadSpeed", _SE(js_extension_AssetsManagerEx_getDownloadSpeed));
+    cls->defineFunction("getProcessSpeed", _SE(js_extension_AssetsManagerEx_getProcessSpeed));
+    cls->defineFunction("isNativeVerifyEnabled", _SE(js_extension_AssetsManagerEx_isNativeVerifyEnabled));
+    cls->defineFunction("setNativeVerifyEnabled", _SE(js_extension_AssetsManagerEx_setNativeVerifyEnabled));
     cls->defineStaticFunction("create", _SE(js_extension_AssetsManagerEx_create));
     cls->defineFinalizeFunction(_SE(js_cocos2d_extension_AssetsManagerEx_finalize));
     cls->install();
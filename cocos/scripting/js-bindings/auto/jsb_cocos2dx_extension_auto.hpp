@@ -21,6 +21,10 @@ SE_DECLARE_FUNC(js_extension_EventAssetsManagerEx_getPercentByFile);
 SE_DECLARE_FUNC(js_extension_EventAssetsManagerEx_getEventCode);
 SE_DECLARE_FUNC(js_extension_EventAssetsManagerEx_getPercent);
 SE_DECLARE_FUNC(js_extension_EventAssetsManagerEx_isResuming);
+SE_DECLARE_FUNC(js_extension_EventAssetsManagerEx_getProcessedBytes);
+SE_DECLARE_FUNC(js_extension_EventAssetsManagerEx_getProcessedFiles);
+SE_DECLARE_FUNC(js_extension_EventAssetsManagerEx_getDownloadSpeed);
+SE_DECLARE_FUNC(js_extension_EventAssetsManagerEx_getProcessSpeed);
 SE_DECLARE_FUNC(js_extension_EventAssetsManagerEx_EventAssetsManagerEx);
 
 extern se::Object* __jsb_cocos2d_extension_Manifest_proto;
@@ -34,6 +38,9 @@ SE_DECLARE_FUNC(js_extension_Manifest_getManifestFileUrl);
 SE_DECLARE_FUNC(js_extension_Manifest_isVersionLoaded);
 SE_DECLARE_FUNC(js_extension_Manifest_parseFile);
 SE_DECLARE_FUNC(js_extension_Manifest_isLoaded);
+SE_DECLARE_FUNC(js_extension_Manifest_isBinary);
+SE_DECLARE_FUNC(js_extension_Manifest_saveToBinaryFile);
+SE_DECLARE_FUNC(js_extension_Manifest_saveToJSONFile);
 SE_DECLARE_FUNC(js_extension_Manifest_getPackageUrl);
 SE_DECLARE_FUNC(js_extension_Manifest_isUpdating);
 SE_DECLARE_FUNC(js_extension_Manifest_getVersion);
@@ -67,6 +74,12 @@ SE_DECLARE_FUNC(js_extension_AssetsManagerEx_getRemoteManifest);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_prepareUpdate);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_downloadFailedAssets);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_isResuming);
+SE_DECLARE_FUNC(js_extension_AssetsManagerEx_getProcessedBytes);
+SE_DECLARE_FUNC(js_extension_AssetsManagerEx_getProcessedFiles);
+SE_DECLARE_FUNC(js_extension_AssetsManagerEx_getDownloadSpeed);
+SE_DECLARE_FUNC(js_extension_AssetsManagerEx_getProcessSpeed);
+SE_DECLARE_FUNC(js_extension_AssetsManagerEx_isNativeVerifyEnabled);
+SE_DECLARE_FUNC(js_extension_AssetsManagerEx_setNativeVerifyEnabled);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_create);
 SE_DECLARE_FUNC(js_extension_AssetsManagerEx_AssetsManagerEx);
 
@@ -15255,6 +15255,80 @@ static bool js_cocos2dx_spine_SkeletonCacheMgr_buildSkeletonCache(se::State& s)
 }
 SE_BIND_FUNC(js_cocos2dx_spine_SkeletonCacheMgr_buildSkeletonCache)
 
+static bool js_cocos2dx_spine_SkeletonCacheMgr_setDiskCachePath(se::State& s)
+{
+    spine::SkeletonCacheMgr* cobj = (spine::SkeletonCacheMgr*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_spine_SkeletonCacheMgr_setDiskCachePath : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        std::string arg0;
+        ok &= seval_to_std_string(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_spine_SkeletonCacheMgr_setDiskCachePath : Error processing arguments");
+        cobj->setDiskCachePath(arg0);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_spine_SkeletonCacheMgr_setDiskCachePath)
+
+static bool js_cocos2dx_spine_SkeletonCacheMgr_setDiskCacheSaveEnabled(se::State& s)
+{
+    spine::SkeletonCacheMgr* cobj = (spine::SkeletonCacheMgr*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_spine_SkeletonCacheMgr_setDiskCacheSaveEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        bool arg0;
+        ok &= seval_to_boolean(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_spine_SkeletonCacheMgr_setDiskCacheSaveEnabled : Error processing arguments");
+        cobj->setDiskCacheSaveEnabled(arg0);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_spine_SkeletonCacheMgr_setDiskCacheSaveEnabled)
+
+static bool js_cocos2dx_spine_SkeletonCacheMgr_getDiskCachePath(se::State& s)
+{
+    spine::SkeletonCacheMgr* cobj = (spine::SkeletonCacheMgr*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_spine_SkeletonCacheMgr_getDiskCachePath : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        const std::string& result = cobj->getDiskCachePath();
+        ok &= std_string_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_spine_SkeletonCacheMgr_getDiskCachePath : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_spine_SkeletonCacheMgr_getDiskCachePath)
+
+static bool js_cocos2dx_spine_SkeletonCacheMgr_isDiskCacheSaveEnabled(se::State& s)
+{
+    spine::SkeletonCacheMgr* cobj = (spine::SkeletonCacheMgr*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_cocos2dx_spine_SkeletonCacheMgr_isDiskCacheSaveEnabled : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isDiskCacheSaveEnabled();
+        ok &= boolean_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_cocos2dx_spine_SkeletonCacheMgr_isDiskCacheSaveEnabled : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_cocos2dx_spine_SkeletonCacheMgr_isDiskCacheSaveEnabled)
+
 static bool js_cocos2dx_spine_SkeletonCacheMgr_destroyInstance(se::State& s)
 {
     const auto& args = s.args();
@@ -15306,6 +15380,10 @@ bool js_register_cocos2dx_spine_SkeletonCacheMgr(se::Object* obj)
 
     cls->defineFunction("removeSkeletonCache", _SE(js_cocos2dx_spine_SkeletonCacheMgr_removeSkeletonCache));
     cls->defineFunction("buildSkeletonCache", _SE(js_cocos2dx_spine_SkeletonCacheMgr_buildSkeletonCache));
+    cls->defineFunction("setDiskCachePath", _SE(js_cocos2dx_spine_SkeletonCacheMgr_setDiskCachePath));
+    cls->defineFunction("setDiskCacheSaveEnabled", _SE(js_cocos2dx_spine_SkeletonCacheMgr_setDiskCacheSaveEnabled));
+    cls->defineFunction("getDiskCachePath", _SE(js_cocos2dx_spine_SkeletonCacheMgr_getDiskCachePath));
+    cls->defineFunction("isDiskCacheSaveEnabled", _SE(js_cocos2dx_spine_SkeletonCacheMgr_isDiskCacheSaveEnabled));
     cls->defineStaticFunction("destroyInstance", _SE(js_cocos2dx_spine_SkeletonCacheMgr_destroyInstance));
     cls->defineStaticFunction("getInstance", _SE(js_cocos2dx_spine_SkeletonCacheMgr_getInstance));
     cls->defineFinalizeFunction(_SE(js_spine_SkeletonCacheMgr_finalize));
@@ -997,6 +997,10 @@ bool js_register_spine_SkeletonCacheMgr(se::Object* obj);
 bool register_all_cocos2dx_spine(se::Object* obj);
 SE_DECLARE_FUNC(js_cocos2dx_spine_SkeletonCacheMgr_removeSkeletonCache);
 SE_DECLARE_FUNC(js_cocos2dx_spine_SkeletonCacheMgr_buildSkeletonCache);
+SE_DECLARE_FUNC(js_cocos2dx_spine_SkeletonCacheMgr_setDiskCachePath);
+SE_DECLARE_FUNC(js_cocos2dx_spine_SkeletonCacheMgr_setDiskCacheSaveEnabled);
+SE_DECLARE_FUNC(js_cocos2dx_spine_SkeletonCacheMgr_getDiskCachePath);
+SE_DECLARE_FUNC(js_cocos2dx_spine_SkeletonCacheMgr_isDiskCacheSaveEnabled);
 SE_DECLARE_FUNC(js_cocos2dx_spine_SkeletonCacheMgr_destroyInstance);
 SE_DECLARE_FUNC(js_cocos2dx_spine_SkeletonCacheMgr_getInstance);
 
@@ -1,5 +1,5 @@
 #include "scripting/js-bindings/auto/jsb_renderer_auto.hpp"
-#if (USE_GFX_RENDERER > 0) && (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#if (USE_GFX_RENDERER > 0) && (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
 #include "scripting/js-bindings/manual/jsb_conversions.hpp"
 #include "scripting/js-bindings/manual/jsb_global.h"
 #include "renderer/renderer/Renderer.h"
@@ -33,6 +33,25 @@ static bool js_renderer_ProgramLib_define(se::State& s)
 }
 SE_BIND_FUNC(js_renderer_ProgramLib_define)
 
+static bool js_renderer_ProgramLib_setCacheFile(se::State& s)
+{
+    cocos2d::renderer::ProgramLib* cobj = (cocos2d::renderer::ProgramLib*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_renderer_ProgramLib_setCacheFile : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        std::string arg0;
+        ok &= seval_to_std_string(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_renderer_ProgramLib_setCacheFile : Error processing arguments");
+        cobj->setCacheFile(arg0);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_renderer_ProgramLib_setCacheFile)
+
 SE_DECLARE_FINALIZE_FUNC(js_cocos2d_renderer_ProgramLib_finalize)
 
 static bool js_renderer_ProgramLib_constructor(se::State& s)
@@ -73,6 +92,7 @@ bool js_register_renderer_ProgramLib(se::Object* obj)
     auto cls = se::Class::create("ProgramLib", obj, nullptr, _SE(js_renderer_ProgramLib_constructor));
 
     cls->defineFunction("define", _SE(js_renderer_ProgramLib_define));
+    cls->defineFunction("setCacheFile", _SE(js_renderer_ProgramLib_setCacheFile));
     cls->defineFinalizeFunction(_SE(js_cocos2d_renderer_ProgramLib_finalize));
     cls->install();
     JSBClassType::registerClass<cocos2d::renderer::ProgramLib>(cls);
@@ -1205,6 +1225,40 @@ static bool js_renderer_NodeProxy_enableVisit(se::State& s)
 }
 SE_BIND_FUNC(js_renderer_NodeProxy_enableVisit)
 
+static bool js_renderer_NodeProxy_enableStaticBatch(se::State& s)
+{
+    cocos2d::renderer::NodeProxy* cobj = (cocos2d::renderer::NodeProxy*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_renderer_NodeProxy_enableStaticBatch : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        bool arg0;
+        ok &= seval_to_boolean(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_renderer_NodeProxy_enableStaticBatch : Error processing arguments");
+        cobj->enableStaticBatch(arg0);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_renderer_NodeProxy_enableStaticBatch)
+
+static bool js_renderer_NodeProxy_markStaticBatchDirty(se::State& s)
+{
+    cocos2d::renderer::NodeProxy* cobj = (cocos2d::renderer::NodeProxy*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_renderer_NodeProxy_markStaticBatchDirty : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cobj->markStaticBatchDirty();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_renderer_NodeProxy_markStaticBatchDirty)
+
 static bool js_renderer_NodeProxy_getLocalMatrix(se::State& s)
 {
     cocos2d::renderer::NodeProxy* cobj = (cocos2d::renderer::NodeProxy*)s.nativeThisObject();
@@ -1334,6 +1388,8 @@ bool js_register_renderer_NodeProxy(se::Object* obj)
     cls->defineFunction("destroyImmediately", _SE(js_renderer_NodeProxy_destroyImmediately));
     cls->defineFunction("isValid", _SE(js_renderer_NodeProxy_isValid));
     cls->defineFunction("enableVisit", _SE(js_renderer_NodeProxy_enableVisit));
+    cls->defineFunction("enableStaticBatch", _SE(js_renderer_NodeProxy_enableStaticBatch));
+    cls->defineFunction("markStaticBatchDirty", _SE(js_renderer_NodeProxy_markStaticBatchDirty));
     cls->defineFunction("getLocalMatrix", _SE(js_renderer_NodeProxy_getLocalMatrix));
     cls->defineFunction("setName", _SE(js_renderer_NodeProxy_setName));
     cls->defineFunction("clearAssembler", _SE(js_renderer_NodeProxy_clearAssembler));
@@ -1353,6 +1409,24 @@ bool js_register_renderer_NodeProxy(se::Object* obj)
 se::Object* __jsb_cocos2d_renderer_BaseRenderer_proto = nullptr;
 se::Class* __jsb_cocos2d_renderer_BaseRenderer_class = nullptr;
 
+static bool js_renderer_BaseRenderer_getDrawCount(se::State& s)
+{
+    cocos2d::renderer::BaseRenderer* cobj = (cocos2d::renderer::BaseRenderer*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_renderer_BaseRenderer_getDrawCount : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getDrawCount();
+        ok &= uint32_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_renderer_BaseRenderer_getDrawCount : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_renderer_BaseRenderer_getDrawCount)
+
 static bool js_renderer_BaseRenderer_getProgramLib(se::State& s)
 {
     cocos2d::renderer::BaseRenderer* cobj = (cocos2d::renderer::BaseRenderer*)s.nativeThisObject();
@@ -1371,6 +1445,60 @@ static bool js_renderer_BaseRenderer_getProgramLib(se::State& s)
 }
 SE_BIND_FUNC(js_renderer_BaseRenderer_getProgramLib)
 
+static bool js_renderer_BaseRenderer_getProgramSwitchCount(se::State& s)
+{
+    cocos2d::renderer::BaseRenderer* cobj = (cocos2d::renderer::BaseRenderer*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_renderer_BaseRenderer_getProgramSwitchCount : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getProgramSwitchCount();
+        ok &= uint32_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_renderer_BaseRenderer_getProgramSwitchCount : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_renderer_BaseRenderer_getProgramSwitchCount)
+
+static bool js_renderer_BaseRenderer_getSameProgramCount(se::State& s)
+{
+    cocos2d::renderer::BaseRenderer* cobj = (cocos2d::renderer::BaseRenderer*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_renderer_BaseRenderer_getSameProgramCount : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getSameProgramCount();
+        ok &= uint32_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_renderer_BaseRenderer_getSameProgramCount : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_renderer_BaseRenderer_getSameProgramCount)
+
+static bool js_renderer_BaseRenderer_getSkippedMatrixCount(se::State& s)
+{
+    cocos2d::renderer::BaseRenderer* cobj = (cocos2d::renderer::BaseRenderer*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_renderer_BaseRenderer_getSkippedMatrixCount : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        unsigned int result = cobj->getSkippedMatrixCount();
+        ok &= uint32_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_renderer_BaseRenderer_getSkippedMatrixCount : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_renderer_BaseRenderer_getSkippedMatrixCount)
+
 static bool js_renderer_BaseRenderer_init(se::State& s)
 {
     CC_UNUSED bool ok = true;
@@ -1416,6 +1544,25 @@ static bool js_renderer_BaseRenderer_init(se::State& s)
 }
 SE_BIND_FUNC(js_renderer_BaseRenderer_init)
 
+static bool js_renderer_BaseRenderer_prepareEffect(se::State& s)
+{
+    cocos2d::renderer::BaseRenderer* cobj = (cocos2d::renderer::BaseRenderer*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_renderer_BaseRenderer_prepareEffect : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        cocos2d::renderer::EffectBase* arg0 = nullptr;
+        ok &= seval_to_native_ptr(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_renderer_BaseRenderer_prepareEffect : Error processing arguments");
+        cobj->prepareEffect(arg0);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_renderer_BaseRenderer_prepareEffect)
+
 SE_DECLARE_FINALIZE_FUNC(js_cocos2d_renderer_BaseRenderer_finalize)
 
 static bool js_renderer_BaseRenderer_constructor(se::State& s)
@@ -1442,8 +1589,13 @@ bool js_register_renderer_BaseRenderer(se::Object* obj)
 {
     auto cls = se::Class::create("Base", obj, nullptr, _SE(js_renderer_BaseRenderer_constructor));
 
+    cls->defineFunction("getDrawCount", _SE(js_renderer_BaseRenderer_getDrawCount));
     cls->defineFunction("getProgramLib", _SE(js_renderer_BaseRenderer_getProgramLib));
+    cls->defineFunction("getProgramSwitchCount", _SE(js_renderer_BaseRenderer_getProgramSwitchCount));
+    cls->defineFunction("getSameProgramCount", _SE(js_renderer_BaseRenderer_getSameProgramCount));
+    cls->defineFunction("getSkippedMatrixCount", _SE(js_renderer_BaseRenderer_getSkippedMatrixCount));
     cls->defineFunction("init", _SE(js_renderer_BaseRenderer_init));
+    cls->defineFunction("prepareEffect", _SE(js_renderer_BaseRenderer_prepareEffect));
     cls->defineFinalizeFunction(_SE(js_cocos2d_renderer_BaseRenderer_finalize));
     cls->install();
     JSBClassType::registerClass<cocos2d::renderer::BaseRenderer>(cls);
@@ -4760,4 +4912,4 @@ bool register_all_renderer(se::Object* obj)
     return true;
 }
 
-#endif //#if (USE_GFX_RENDERER > 0) && (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#endif //#if (USE_GFX_RENDERER > 0) && (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
@@ -1,6 +1,6 @@
 #pragma once
 #include "base/ccConfig.h"
-#if (USE_GFX_RENDERER > 0) && (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#if (USE_GFX_RENDERER > 0) && (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
 
 #include "cocos/scripting/js-bindings/jswrapper/SeApi.h"
 
@@ -10,6 +10,7 @@ extern se::Class* __jsb_cocos2d_renderer_ProgramLib_class;
 bool js_register_cocos2d_renderer_ProgramLib(se::Object* obj);
 bool register_all_renderer(se::Object* obj);
 SE_DECLARE_FUNC(js_renderer_ProgramLib_define);
+SE_DECLARE_FUNC(js_renderer_ProgramLib_setCacheFile);
 SE_DECLARE_FUNC(js_renderer_ProgramLib_ProgramLib);
 
 extern se::Object* __jsb_cocos2d_renderer_EffectBase_proto;
@@ -80,6 +81,8 @@ SE_DECLARE_FUNC(js_renderer_NodeProxy_notifyUpdateParent);
 SE_DECLARE_FUNC(js_renderer_NodeProxy_destroyImmediately);
 SE_DECLARE_FUNC(js_renderer_NodeProxy_isValid);
 SE_DECLARE_FUNC(js_renderer_NodeProxy_enableVisit);
+SE_DECLARE_FUNC(js_renderer_NodeProxy_enableStaticBatch);
+SE_DECLARE_FUNC(js_renderer_NodeProxy_markStaticBatchDirty);
 SE_DECLARE_FUNC(js_renderer_NodeProxy_getLocalMatrix);
 SE_DECLARE_FUNC(js_renderer_NodeProxy_setName);
 SE_DECLARE_FUNC(js_renderer_NodeProxy_clearAssembler);
@@ -92,8 +95,13 @@ extern se::Class* __jsb_cocos2d_renderer_BaseRenderer_class;
 
 bool js_register_cocos2d_renderer_BaseRenderer(se::Object* obj);
 bool register_all_renderer(se::Object* obj);
+SE_DECLARE_FUNC(js_renderer_BaseRenderer_getDrawCount);
 SE_DECLARE_FUNC(js_renderer_BaseRenderer_getProgramLib);
+SE_DECLARE_FUNC(js_renderer_BaseRenderer_getProgramSwitchCount);
+SE_DECLARE_FUNC(js_renderer_BaseRenderer_getSameProgramCount);
+SE_DECLARE_FUNC(js_renderer_BaseRenderer_getSkippedMatrixCount);
 SE_DECLARE_FUNC(js_renderer_BaseRenderer_init);
+SE_DECLARE_FUNC(js_renderer_BaseRenderer_prepareEffect);
 SE_DECLARE_FUNC(js_renderer_BaseRenderer_BaseRenderer);
 
 extern se::Object* __jsb_cocos2d_renderer_View_proto;
@@ -344,4 +352,4 @@ SE_DECLARE_FUNC(js_renderer_Particle3DAssembler_setParticleSpace);
 SE_DECLARE_FUNC(js_renderer_Particle3DAssembler_setTrailModuleEnable);
 SE_DECLARE_FUNC(js_renderer_Particle3DAssembler_Particle3DAssembler);
 
-#endif //#if (USE_GFX_RENDERER > 0) && (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#endif //#if (USE_GFX_RENDERER > 0) && (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
@@ -24,6 +24,7 @@
  ****************************************************************************/
 #pragma once
 
+#include <cstddef>
 #include <unordered_map>
 
 namespace se {
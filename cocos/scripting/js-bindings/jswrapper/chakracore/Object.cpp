@@ -32,6 +32,23 @@
 #include "../MappingUtils.hpp"
 
 namespace se {
+
+    namespace {
+        struct ExternalArrayBufferHolder
+        {
+            void* contents;
+            size_t byteLength;
+            Object::BufferContentsFreeFunc freeFunc;
+            void* freeUserData;
+        };
+
+        void onExternalArrayBufferFinalized(void* data)
+        {
+            ExternalArrayBufferHolder* holder = (ExternalArrayBufferHolder*)data;
+            holder->freeFunc(holder->contents, holder->byteLength, holder->freeUserData);
+            delete holder;
+        }
+    }
  
     Object::Object()
     : _cls(nullptr)
@@ -88,6 +105,23 @@ namespace se {
         return obj;
     }
 
+    Object* Object::createExternalArrayBufferObject(void* contents, size_t byteLength, BufferContentsFreeFunc freeFunc, void* freeUserData)
+    {
+        ExternalArrayBufferHolder* holder = new ExternalArrayBufferHolder();
+        holder->contents = contents;
+        holder->byteLength = byteLength;
+        holder->freeFunc = freeFunc;
+        holder->freeUserData = freeUserData;
+
+        JsValueRef jsobj;
+        if (JsNoError != JsCreateExternalArrayBuffer(contents, (unsigned int)byteLength, onExternalArrayBufferFinalized, holder, &jsobj))
+        {
+            onExternalArrayBufferFinalized(holder);
+            return nullptr;
+        }
+        return Object::_createJSObject(nullptr, jsobj);
+    }
+
     Object* Object::createTypedArray(TypedArrayType type, void* data, size_t byteLength)
     {
         if (type == TypedArrayType::NONE)
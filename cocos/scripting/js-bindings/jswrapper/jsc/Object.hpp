@@ -101,6 +101,27 @@ namespace se {
          */
         static Object* createArrayBufferObject(void* bytes, size_t byteLength);
 
+        /**
+         *  @brief The callback to release the memory of an external Array Buffer.
+         *  @param[in] contents The memory passed to createExternalArrayBufferObject.
+         *  @param[in] byteLength The number of bytes pointed to by contents.
+         *  @param[in] userData The user data passed to createExternalArrayBufferObject.
+         */
+        typedef void (*BufferContentsFreeFunc)(void* contents, size_t byteLength, void* userData);
+
+        /**
+         *  @brief Creates a JavaScript Array Buffer object which uses an existing memory as its backing store without copying it.
+         *  @param[in] contents The memory to be used as the backing store, it has to be valid until freeFunc is invoked.
+         *  @param[in] byteLength The number of bytes pointed to by contents.
+         *  @param[in] freeFunc The callback to be invoked once the Array Buffer is garbage collected, it's always invoked exactly once,
+         *                      even if the object couldn't be created. Engines without external Array Buffer support copy the contents
+         *                      and invoke freeFunc immediately.
+         *  @param[in] freeUserData The user data passed to freeFunc.
+         *  @return A Array Buffer Object, or nullptr if there is an error.
+         *  @note The return value (non-null) has to be released manually.
+         */
+        static Object* createExternalArrayBufferObject(void* contents, size_t byteLength, BufferContentsFreeFunc freeFunc, void* freeUserData = nullptr);
+
         /**
          *  @brief Creates a JavaScript Object from a JSON formatted string.
          *  @param[in] jsonStr The utf-8 string containing the JSON string to be parsed.
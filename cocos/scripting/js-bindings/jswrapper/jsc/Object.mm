@@ -105,6 +105,20 @@ namespace se {
     {
         free(bytes);
     }
+
+    struct ExternalArrayBufferHolder
+    {
+        size_t byteLength;
+        Object::BufferContentsFreeFunc freeFunc;
+        void* freeUserData;
+    };
+
+    static void externalArrayBufferBytesDeallocator(void* bytes, void* deallocatorContext)
+    {
+        ExternalArrayBufferHolder* holder = (ExternalArrayBufferHolder*)deallocatorContext;
+        holder->freeFunc(bytes, holder->byteLength, holder->freeUserData);
+        delete holder;
+    }
 #endif
 
     Object* Object::createArrayBufferObject(void* data, size_t byteLength)
@@ -149,6 +163,36 @@ namespace se {
         return obj;
     }
 
+    Object* Object::createExternalArrayBufferObject(void* contents, size_t byteLength, BufferContentsFreeFunc freeFunc, void* freeUserData)
+    {
+#if (__MAC_OS_X_VERSION_MAX_ALLOWED >= 101200 || __IPHONE_OS_VERSION_MAX_ALLOWED >= 100000)
+        if (isSupportTypedArrayAPI())
+        {
+            ExternalArrayBufferHolder* holder = new ExternalArrayBufferHolder();
+            holder->byteLength = byteLength;
+            holder->freeFunc = freeFunc;
+            holder->freeUserData = freeUserData;
+
+            // The deallocator is also invoked by JavaScriptCore if the object couldn't be created.
+            JSValueRef exception = nullptr;
+            JSObjectRef jsobj = JSObjectMakeArrayBufferWithBytesNoCopy(__cx, contents, byteLength, externalArrayBufferBytesDeallocator, holder, &exception);
+            if (exception != nullptr)
+            {
+                ScriptEngine::getInstance()->_clearException(exception);
+                return nullptr;
+            }
+
+            Object* obj = Object::_createJSObject(nullptr, jsobj);
+            if (obj != nullptr)
+                obj->_type = Type::ARRAY_BUFFER;
+            return obj;
+        }
+#endif
+        Object* obj = createArrayBufferObject(contents, byteLength);
+        freeFunc(contents, byteLength, freeUserData);
+        return obj;
+    }
+
     Object* Object::createTypedArray(TypedArrayType type, void* data, size_t byteLength)
     {
         if (type == TypedArrayType::NONE)
@@ -149,6 +149,14 @@ namespace se {
         return obj;
     }
 
+    Object* Object::createExternalArrayBufferObject(void* contents, size_t byteLength, BufferContentsFreeFunc freeFunc, void* freeUserData)
+    {
+        // This version of SpiderMonkey can't free external contents with a custom callback, copy them instead.
+        Object* obj = createArrayBufferObject(contents, byteLength);
+        freeFunc(contents, byteLength, freeUserData);
+        return obj;
+    }
+
     Object* Object::createTypedArray(TypedArrayType type, void* data, size_t byteLength)
     {
         if (type == TypedArrayType::NONE)
@@ -40,6 +40,30 @@ namespace se {
 
     namespace {
         v8::Isolate* __isolate = nullptr;
+
+        struct ExternalArrayBufferHolder
+        {
+            v8::Global<v8::ArrayBuffer> handle;
+            void* contents;
+            size_t byteLength;
+            Object::BufferContentsFreeFunc freeFunc;
+            void* freeUserData;
+        };
+
+        void onExternalArrayBufferFreed(const v8::WeakCallbackInfo<ExternalArrayBufferHolder>& info)
+        {
+            ExternalArrayBufferHolder* holder = info.GetParameter();
+            info.GetIsolate()->AdjustAmountOfExternalAllocatedMemory(-(int64_t)holder->byteLength);
+            holder->freeFunc(holder->contents, holder->byteLength, holder->freeUserData);
+            delete holder;
+        }
+
+        void onExternalArrayBufferCollected(const v8::WeakCallbackInfo<ExternalArrayBufferHolder>& info)
+        {
+            // Only handles could be reset in the first pass, the memory is released in the second pass.
+            info.GetParameter()->handle.Reset();
+            info.SetSecondPassCallback(onExternalArrayBufferFreed);
+        }
     }
 
     Object::Object()
@@ -225,6 +249,28 @@ namespace se {
         Object* obj = Object::_createJSObject(nullptr, jsobj);
         return obj;
     }
+
+    Object* Object::createExternalArrayBufferObject(void* contents, size_t byteLength, BufferContentsFreeFunc freeFunc, void* freeUserData)
+    {
+        // The externalized backing store isn't freed by v8, a weak handle tells when it's safe to free it.
+        v8::Local<v8::ArrayBuffer> jsobj = v8::ArrayBuffer::New(__isolate, contents, byteLength, v8::ArrayBufferCreationMode::kExternalized);
+        Object* obj = Object::_createJSObject(nullptr, jsobj);
+        if (obj == nullptr)
+        {
+            freeFunc(contents, byteLength, freeUserData);
+            return nullptr;
+        }
+
+        ExternalArrayBufferHolder* holder = new ExternalArrayBufferHolder();
+        holder->handle.Reset(__isolate, jsobj);
+        holder->handle.SetWeak(holder, onExternalArrayBufferCollected, v8::WeakCallbackType::kParameter);
+        holder->contents = contents;
+        holder->byteLength = byteLength;
+        holder->freeFunc = freeFunc;
+        holder->freeUserData = freeUserData;
+        __isolate->AdjustAmountOfExternalAllocatedMemory((int64_t)byteLength);
+        return obj;
+    }
     
     Object* Object::createTypedArray(TypedArrayType type, void* data, size_t byteLength)
     {
@@ -31,6 +31,7 @@
 #include "cocos/scripting/js-bindings/auto/jsb_cocos2dx_auto.hpp"
 
 #include "storage/local-storage/LocalStorage.h"
+#include "2d/CCTTFLabelAtlasCache.h"
 #include "cocos2d.h"
 #include <sstream>
 
@@ -763,10 +764,61 @@ static void js_engine_LabelRenderer_export_structs_info(se::Object *obj)
     
 }
 
+// jsb.LabelRenderer.prewarm(fontPath, fontSize, text, hasOutline)
+static bool js_engine_LabelRenderer_prewarm(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc >= 3) {
+        std::string fontPath;
+        float fontSize = 0;
+        std::string text;
+        bool hasOutline = false;
+        ok &= seval_to_std_string(args[0], &fontPath);
+        ok &= seval_to_float(args[1], &fontSize);
+        ok &= seval_to_std_string(args[2], &text);
+        if (argc > 3) {
+            ok &= seval_to_boolean(args[3], &hasOutline);
+        }
+        SE_PRECONDITION2(ok, false, "js_engine_LabelRenderer_prewarm : Error processing arguments");
+        bool result = cocos2d::TTFLabelAtlasCache::getInstance()->prewarm(fontPath, fontSize, hasOutline, text);
+        s.rval().setBoolean(result);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 3);
+    return false;
+}
+SE_BIND_FUNC(js_engine_LabelRenderer_prewarm)
+
+// jsb.LabelRenderer.getAtlasStats()
+static bool js_engine_LabelRenderer_getAtlasStats(se::State& s)
+{
+    cocos2d::FontAtlas::Stats stats = cocos2d::TTFLabelAtlasCache::getInstance()->getStats();
+    se::HandleObject obj(se::Object::createPlainObject());
+    obj->setProperty("pageCount", se::Value(stats.pageCount));
+    obj->setProperty("letterCount", se::Value(stats.letterCount));
+    obj->setProperty("unusedLetterCount", se::Value(stats.unusedLetterCount));
+    obj->setProperty("occupancy", se::Value(stats.occupancy));
+    obj->setProperty("evictedLetters", se::Value(stats.evictedLetters));
+    obj->setProperty("defragmentCount", se::Value(stats.defragmentCount));
+    s.rval().setObject(obj);
+    return true;
+}
+SE_BIND_FUNC(js_engine_LabelRenderer_getAtlasStats)
+
 static bool register_labelrenderer_ext(se::Object *obj)
 {
     __jsb_cocos2d_LabelRenderer_proto->defineFunction("init", _SE(js_engine_LabelRenderer_init));
     js_engine_LabelRenderer_export_structs_info(obj);
+
+    se::Value jsbVal;
+    se::Value labelRenderVal;
+    if (obj->getProperty("jsb", &jsbVal) && jsbVal.isObject() && jsbVal.toObject()->getProperty("LabelRenderer", &labelRenderVal) && labelRenderVal.isObject())
+    {
+        labelRenderVal.toObject()->defineFunction("prewarm", _SE(js_engine_LabelRenderer_prewarm));
+        labelRenderVal.toObject()->defineFunction("getAtlasStats", _SE(js_engine_LabelRenderer_getAtlasStats));
+    }
     return true;
 }
 
@@ -24,11 +24,12 @@
  ****************************************************************************/
 #include "base/ccConfig.h"
 #include "jsb_renderer_manual.hpp"
-#if (USE_GFX_RENDERER > 0) && (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#if (USE_GFX_RENDERER > 0) && (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
 #include "cocos/scripting/js-bindings/auto/jsb_renderer_auto.hpp"
 #include "cocos/scripting/js-bindings/manual/jsb_conversions.hpp"
 #include "scene/NodeProxy.hpp"
 #include "scene/assembler/Assembler.hpp"
+#include "scene/Profiler.hpp"
 #include "jsb_conversions.hpp"
 
 using namespace cocos2d;
@@ -420,6 +421,110 @@ static bool js_renderer_EffectBase_setProperty(se::State& s)
 }
 SE_BIND_FUNC(js_renderer_EffectBase_setProperty);
 
+static bool js_renderer_Profiler_setEnabled(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        bool enabled = false;
+        CC_UNUSED bool ok = seval_to_boolean(args[0], &enabled);
+        SE_PRECONDITION2(ok, false, "js_renderer_Profiler_setEnabled : Error processing arguments");
+        cocos2d::renderer::Profiler::setEnabled(enabled);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_renderer_Profiler_setEnabled)
+
+static bool js_renderer_Profiler_isEnabled(se::State& s)
+{
+    s.rval().setBoolean(cocos2d::renderer::Profiler::isEnabled());
+    return true;
+}
+SE_BIND_FUNC(js_renderer_Profiler_isEnabled)
+
+// fills the Float64Array passed in if it's large enough, so polling every frame doesn't allocate
+static bool js_renderer_Profiler_getFrameData(se::State& s)
+{
+    using cocos2d::renderer::Profiler;
+    const auto& args = s.args();
+    const size_t byteLength = Profiler::FRAME_DATA_LENGTH * sizeof(double);
+    const double* data = Profiler::getFrameData();
+    
+    if (args.size() > 0 && args[0].isObject())
+    {
+        se::Object* arr = args[0].toObject();
+        uint8_t* ptr = nullptr;
+        size_t length = 0;
+        if (arr->isTypedArray() && arr->getTypedArrayType() == se::Object::TypedArrayType::FLOAT64
+            && arr->getTypedArrayData(&ptr, &length) && length >= byteLength)
+        {
+            memcpy(ptr, data, byteLength);
+            s.rval().setObject(arr);
+            return true;
+        }
+    }
+    
+    se::HandleObject arr(se::Object::createTypedArray(se::Object::TypedArrayType::FLOAT64, (void*)data, byteLength));
+    s.rval().setObject(arr);
+    return true;
+}
+SE_BIND_FUNC(js_renderer_Profiler_getFrameData)
+
+static bool js_renderer_Profiler_getScopeNames(se::State& s)
+{
+    using cocos2d::renderer::Profiler;
+    std::vector<std::string> names;
+    for (int i = 0; i < Profiler::SCOPE_COUNT; i++)
+    {
+        names.push_back(Profiler::getScopeName((Profiler::Scope)i));
+    }
+    return std_vector_string_to_seval(names, &s.rval());
+}
+SE_BIND_FUNC(js_renderer_Profiler_getScopeNames)
+
+static bool js_renderer_Profiler_getCounterNames(se::State& s)
+{
+    using cocos2d::renderer::Profiler;
+    std::vector<std::string> names;
+    for (int i = 0; i < Profiler::COUNTER_COUNT; i++)
+    {
+        names.push_back(Profiler::getCounterName((Profiler::Counter)i));
+    }
+    return std_vector_string_to_seval(names, &s.rval());
+}
+SE_BIND_FUNC(js_renderer_Profiler_getCounterNames)
+
+static bool js_renderer_Profiler_dumpTrace(se::State& s)
+{
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 1) {
+        std::string path;
+        CC_UNUSED bool ok = seval_to_std_string(args[0], &path);
+        SE_PRECONDITION2(ok, false, "js_renderer_Profiler_dumpTrace : Error processing arguments");
+        s.rval().setBoolean(cocos2d::renderer::Profiler::dumpTrace(path));
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_renderer_Profiler_dumpTrace)
+
+static bool js_register_renderer_Profiler(se::Object* obj)
+{
+    se::HandleObject profiler(se::Object::createPlainObject());
+    profiler->defineFunction("setEnabled", _SE(js_renderer_Profiler_setEnabled));
+    profiler->defineFunction("isEnabled", _SE(js_renderer_Profiler_isEnabled));
+    profiler->defineFunction("getFrameData", _SE(js_renderer_Profiler_getFrameData));
+    profiler->defineFunction("getScopeNames", _SE(js_renderer_Profiler_getScopeNames));
+    profiler->defineFunction("getCounterNames", _SE(js_renderer_Profiler_getCounterNames));
+    profiler->defineFunction("dumpTrace", _SE(js_renderer_Profiler_dumpTrace));
+    obj->setProperty("Profiler", se::Value(profiler));
+    return true;
+}
+
 bool jsb_register_renderer_manual(se::Object* global)
 {
     // Get the ns
@@ -433,6 +538,7 @@ bool jsb_register_renderer_manual(se::Object* global)
     se::Object* ns = nsVal.toObject();
 
     js_register_renderer_Config(ns);
+    js_register_renderer_Profiler(ns);
 
     // Effect
     __jsb_cocos2d_renderer_Effect_proto->defineFunction("self", _SE(js_renderer_Effect_self));
@@ -467,4 +573,4 @@ bool jsb_register_renderer_manual(se::Object* global)
     return true;
 }
 
-#endif //#if (USE_GFX_RENDERER > 0) && (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#endif //#if (USE_GFX_RENDERER > 0) && (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
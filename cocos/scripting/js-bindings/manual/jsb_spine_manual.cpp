@@ -43,6 +43,7 @@
 #include "cocos/scripting/js-bindings/auto/jsb_cocos2dx_spine_auto.hpp"
 
 #include "middleware-adapter.h"
+#include "BakedCacheFile.h"
 #include "spine-creator-support/SkeletonDataMgr.h"
 #include "spine-creator-support/SkeletonRenderer.h"
 #include "spine-creator-support/spine-cocos2dx.h"
@@ -112,6 +113,9 @@ static bool js_register_spine_initSkeletonData (se::State& s)
     
     spine::AttachmentLoader* attachmentLoader = new (__FILE__, __LINE__) spine::Cocos2dAtlasAttachmentLoader(atlas);
     spine::SkeletonData* skeletonData = nullptr;
+    // baked animation caches on disk are only valid for this exact data
+    uint64_t contentHash = middleware::hashString(atlasText);
+    contentHash = middleware::hashBytes(&scale, sizeof(scale), contentHash);
 
     std::size_t length = skeletonDataFile.length();
     auto binPos = skeletonDataFile.find(".skel", length - 5);
@@ -127,12 +131,14 @@ static bool js_register_spine_initSkeletonData (se::State& s)
             
             spine::SkeletonBinary binary(attachmentLoader);
             binary.setScale(scale);
+            contentHash = middleware::hashBytes(cocos2dData.getBytes(), (std::size_t)cocos2dData.getSize(), contentHash);
             skeletonData = binary.readSkeletonData(cocos2dData.getBytes(), (int)cocos2dData.getSize());
             CCASSERT(skeletonData, !binary.getError().isEmpty() ? binary.getError().buffer() : "Error reading binary skeleton data.");
         }
     } else {
         spine::SkeletonJson json(attachmentLoader);
         json.setScale(scale);
+        contentHash = middleware::hashString(skeletonDataFile, contentHash);
         skeletonData = json.readSkeletonData(skeletonDataFile.c_str());
         CCASSERT(skeletonData, !json.getError().isEmpty() ? json.getError().buffer() : "Error reading json skeleton data.");
     }
@@ -143,7 +149,7 @@ static bool js_register_spine_initSkeletonData (se::State& s)
         {
             texturesIndex.push_back(it->second->getRealTextureIndex());
         }
-        mgr->setSkeletonData(uuid, skeletonData, atlas, attachmentLoader, texturesIndex);
+        mgr->setSkeletonData(uuid, skeletonData, atlas, attachmentLoader, texturesIndex, contentHash);
         native_ptr_to_rooted_seval<spine::SkeletonData>(skeletonData, &s.rval());
     } else {
         if (atlas) {
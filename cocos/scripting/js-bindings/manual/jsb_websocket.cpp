@@ -135,7 +135,19 @@ void JSB_WebSocketDelegate::onMessage(WebSocket* ws, const WebSocket::Data& data
 
         if (data.isBinary)
         {
-            se::HandleObject dataObj(se::Object::createArrayBufferObject(data.bytes, data.len));
+            se::Object* arrayBuffer = nullptr;
+            if (WebSocket::retainMessageData(data))
+            {
+                // The ArrayBuffer uses the received buffer directly, it's released once the ArrayBuffer is garbage collected.
+                arrayBuffer = se::Object::createExternalArrayBufferObject(data.bytes, data.len, [](void*, size_t, void* userData){
+                    WebSocket::releaseMessageData(userData);
+                }, data.ext);
+            }
+            else
+            {
+                arrayBuffer = se::Object::createArrayBufferObject(data.bytes, data.len);
+            }
+            se::HandleObject dataObj(arrayBuffer);
             jsObj->setProperty("data", se::Value(dataObj));
         }
         else
@@ -25,10 +25,16 @@
  ****************************************************************************/
 #include "AssetsManagerEx.h"
 #include "base/ccUTF8.h"
-#include "CCAsyncTaskPool.h"
+#include "base/CCScheduler.h"
+#include "platform/CCApplication.h"
 
 #include <stdio.h>
 #include <errno.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 #ifdef MINIZIP_FROM_SYSTEM
 #include <minizip/unzip.h>
@@ -46,10 +52,198 @@ NS_CC_EXT_BEGIN
 #define BUFFER_SIZE    8192
 #define MAX_FILENAME   512
 
+#define PROCESS_BUFFER_SIZE         65536
+#define MAX_PROCESS_THREAD          4
+// entries extracted by each process pool task at least, small archives are not worth more tasks
+#define MIN_ZIP_ENTRIES_PER_TASK    8
+#define SPEED_SAMPLE_INTERVAL       0.5f
+
 #define DEFAULT_CONNECTION_TIMEOUT 45
 
 #define SAVE_POINT_INTERVAL 0.1
 
+namespace {
+    // MD5 (RFC 1321) of downloaded assets, compared with the md5 in the manifest
+    class MD5
+    {
+    public:
+        MD5()
+        : _length(0)
+        {
+            _state[0] = 0x67452301;
+            _state[1] = 0xefcdab89;
+            _state[2] = 0x98badcfe;
+            _state[3] = 0x10325476;
+        }
+
+        void update(const unsigned char* data, size_t size)
+        {
+            size_t used = (size_t)(_length & 63);
+            _length += size;
+
+            if (used > 0)
+            {
+                size_t fill = std::min(size, (size_t)64 - used);
+                memcpy(_buffer + used, data, fill);
+                data += fill;
+                size -= fill;
+                if (used + fill < 64)
+                {
+                    return;
+                }
+                transform(_buffer);
+            }
+            for (; size >= 64; data += 64, size -= 64)
+            {
+                transform(data);
+            }
+            if (size > 0)
+            {
+                memcpy(_buffer, data, size);
+            }
+        }
+
+        std::string finish()
+        {
+            uint64_t bits = _length * 8;
+            unsigned char padding[72] = { 0x80 };
+            size_t used = (size_t)(_length & 63);
+            size_t padSize = used < 56 ? 56 - used : 120 - used;
+            for (int i = 0; i < 8; ++i)
+            {
+                padding[padSize + i] = (unsigned char)(bits >> (i * 8));
+            }
+            update(padding, padSize + 8);
+
+            static const char* hexDigits = "0123456789abcdef";
+            std::string hex(32, '0');
+            for (int i = 0; i < 16; ++i)
+            {
+                unsigned char byte = (unsigned char)(_state[i / 4] >> ((i % 4) * 8));
+                hex[i * 2] = hexDigits[byte >> 4];
+                hex[i * 2 + 1] = hexDigits[byte & 15];
+            }
+            return hex;
+        }
+
+    private:
+        void transform(const unsigned char* block)
+        {
+            static const uint32_t K[64] = {
+                0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+                0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+                0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+                0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+                0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+                0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+                0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+                0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+            };
+            static const int R[16] = { 7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21 };
+
+            uint32_t M[16];
+            for (int i = 0; i < 16; ++i)
+            {
+                M[i] = (uint32_t)block[i * 4] | ((uint32_t)block[i * 4 + 1] << 8) |
+                       ((uint32_t)block[i * 4 + 2] << 16) | ((uint32_t)block[i * 4 + 3] << 24);
+            }
+
+            uint32_t a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+            for (int i = 0; i < 64; ++i)
+            {
+                uint32_t f;
+                int g;
+                if (i < 16)
+                {
+                    f = (b & c) | (~b & d);
+                    g = i;
+                }
+                else if (i < 32)
+                {
+                    f = (d & b) | (~d & c);
+                    g = (5 * i + 1) & 15;
+                }
+                else if (i < 48)
+                {
+                    f = b ^ c ^ d;
+                    g = (3 * i + 5) & 15;
+                }
+                else
+                {
+                    f = c ^ (b | ~d);
+                    g = (7 * i) & 15;
+                }
+                f += a + K[i] + M[g];
+                int r = R[(i / 16) * 4 + (i & 3)];
+                a = d;
+                d = c;
+                c = b;
+                b += (f << r) | (f >> (32 - r));
+            }
+            _state[0] += a;
+            _state[1] += b;
+            _state[2] += c;
+            _state[3] += d;
+        }
+
+        uint32_t _state[4];
+        uint64_t _length;
+        unsigned char _buffer[64];
+    };
+
+    bool fileMD5(const std::string& path, std::string& hex, double& size)
+    {
+        FILE* fp = fopen(FileUtils::getInstance()->getSuitableFOpen(path).c_str(), "rb");
+        if (!fp)
+        {
+            return false;
+        }
+
+        MD5 md5;
+        std::vector<unsigned char> buffer(PROCESS_BUFFER_SIZE);
+        size = 0;
+        size_t read = 0;
+        while ((read = fread(buffer.data(), 1, buffer.size(), fp)) > 0)
+        {
+            md5.update(buffer.data(), read);
+            size += read;
+        }
+        bool ok = ferror(fp) == 0;
+        fclose(fp);
+
+        hex = md5.finish();
+        return ok;
+    }
+
+    bool isSameMD5(const std::string& hex, const std::string& expected)
+    {
+        if (hex.size() != expected.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < hex.size(); ++i)
+        {
+            if (hex[i] != ::tolower((unsigned char)expected[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int getProcessThreadNum()
+    {
+        int coreNum = (int)std::thread::hardware_concurrency();
+        return std::max(1, std::min(coreNum - 1, MAX_PROCESS_THREAD));
+    }
+}
+
+struct AssetsManagerEx::ZipEntry
+{
+    std::string fullPath;
+    unz_file_pos pos;
+};
+
 const std::string AssetsManagerEx::VERSION_ID = "@version";
 const std::string AssetsManagerEx::MANIFEST_ID = "@manifest";
 
@@ -57,7 +251,6 @@ const std::string AssetsManagerEx::MANIFEST_ID = "@manifest";
 
 AssetsManagerEx::AssetsManagerEx(const std::string& manifestUrl, const std::string& storagePath)
 : _updateState(State::UNINITED)
-, _assets(nullptr)
 , _storagePath("")
 , _tempVersionPath("")
 , _cacheManifestPath("")
@@ -79,13 +272,21 @@ AssetsManagerEx::AssetsManagerEx(const std::string& manifestUrl, const std::stri
 , _currConcurrentTask(0)
 , _verifyCallback(nullptr)
 , _inited(false)
+, _nativeVerifyEnabled(false)
+, _processPool(nullptr)
+, _aliveToken(std::make_shared<bool>(true))
+, _totalProcessed(0)
+, _processedFiles(0)
+, _downloadSpeed(0)
+, _processSpeed(0)
+, _speedSampleDownloaded(0)
+, _speedSampleProcessed(0)
 {
     init(manifestUrl, storagePath);
 }
 
 AssetsManagerEx::AssetsManagerEx(const std::string& manifestUrl, const std::string& storagePath, const VersionCompareHandle& handle)
 : _updateState(State::UNINITED)
-, _assets(nullptr)
 , _storagePath("")
 , _tempVersionPath("")
 , _cacheManifestPath("")
@@ -109,6 +310,15 @@ AssetsManagerEx::AssetsManagerEx(const std::string& manifestUrl, const std::stri
 , _verifyCallback(nullptr)
 , _eventCallback(nullptr)
 , _inited(false)
+, _nativeVerifyEnabled(false)
+, _processPool(nullptr)
+, _aliveToken(std::make_shared<bool>(true))
+, _totalProcessed(0)
+, _processedFiles(0)
+, _downloadSpeed(0)
+, _processSpeed(0)
+, _speedSampleDownloaded(0)
+, _speedSampleProcessed(0)
 {
     init(manifestUrl, storagePath);
 }
@@ -155,6 +365,13 @@ AssetsManagerEx::~AssetsManagerEx()
     _downloader->onTaskError = (nullptr);
     _downloader->onFileTaskSuccess = (nullptr);
     _downloader->onTaskProgress = (nullptr);
+    // Pending processing results are dropped, unprocessed assets will be downloaded again on resuming
+    _aliveToken.reset();
+    if (_processPool)
+    {
+        _processPool->stopAllTasks();
+        CC_SAFE_DELETE(_processPool);
+    }
     CC_SAFE_RELEASE(_localManifest);
     // _tempManifest could share a ptr with _remoteManifest or _localManifest
     if (_tempManifest != _localManifest && _tempManifest != _remoteManifest)
@@ -221,9 +438,6 @@ void AssetsManagerEx::initManifests()
 
 void AssetsManagerEx::prepareLocalManifest()
 {
-    // An alias to assets
-    _assets = &(_localManifest->getAssets());
-
     // Add search paths
     _localManifest->prependSearchPaths();
 }
@@ -442,9 +656,9 @@ std::string AssetsManagerEx::basename(const std::string& path) const
 
 std::string AssetsManagerEx::get(const std::string& key) const
 {
-    auto it = _assets->find(key);
-    if (it != _assets->cend()) {
-        return _storagePath + it->second.path;
+    Manifest::Asset asset;
+    if (_localManifest->findAsset(key, &asset)) {
+        return _storagePath + asset.path;
     }
     else return "";
 }
@@ -484,6 +698,20 @@ void AssetsManagerEx::adjustPath(std::string &path)
 }
 
 bool AssetsManagerEx::decompress(const std::string &zip)
+{
+    std::string zipPath;
+    std::vector<ZipEntry> entries;
+    if (!listZipEntries(zip, zipPath, entries))
+    {
+        return false;
+    }
+    std::atomic<size_t> nextEntry(0);
+    std::atomic<bool> failed(false);
+    extractZipEntries(zipPath, entries, nextEntry, failed);
+    return !failed;
+}
+
+bool AssetsManagerEx::listZipEntries(const std::string &zip, std::string &zipPath, std::vector<ZipEntry> &entries)
 {
     // Find root path for zip file
     size_t pos = zip.find_last_of("/\\");
@@ -493,9 +721,10 @@ bool AssetsManagerEx::decompress(const std::string &zip)
         return false;
     }
     const std::string rootPath = zip.substr(0, pos+1);
+    zipPath = FileUtils::getInstance()->getSuitableFOpen(zip);
 
     // Open the zip file
-    unzFile zipfile = unzOpen(FileUtils::getInstance()->getSuitableFOpen(zip).c_str());
+    unzFile zipfile = unzOpen(zipPath.c_str());
     if (! zipfile)
     {
         CCLOG("AssetsManagerEx : can not open downloaded zip file %s\n", zip.c_str());
@@ -511,9 +740,9 @@ bool AssetsManagerEx::decompress(const std::string &zip)
         return false;
     }
 
-    // Buffer to hold data read from the zip file
-    char readBuffer[BUFFER_SIZE];
-    // Loop to extract all files.
+    // Create all directories and record file entries, so that they can be extracted in any order
+    entries.reserve(global_info.number_entry);
+    std::unordered_set<std::string> createdDirs;
     uLong i;
     for (i = 0; i < global_info.number_entry; ++i)
     {
@@ -535,13 +764,14 @@ bool AssetsManagerEx::decompress(const std::string &zip)
         }
         const std::string fullPath = rootPath + fileName;
 
-        // Check if this entry is a directory or a file.
+        // There are not directory entry in some case.
+        // So we need to create directory of file entry too
         const size_t filenameLength = strlen(fileName);
-        if (fileName[filenameLength-1] == '/')
+        bool isDirectory = filenameLength > 0 && fileName[filenameLength-1] == '/';
+        std::string dir = basename(fullPath);
+        if (createdDirs.insert(dir).second)
         {
-            //There are not directory entry in some case.
-            //So we need to create directory when decompressing file entry
-            if ( !_fileUtils->createDirectory(basename(fullPath)) )
+            if ((isDirectory || !_fileUtils->isDirectoryExist(dir)) && !_fileUtils->createDirectory(dir))
             {
                 // Failed to create directory
                 CCLOG("AssetsManagerEx : can not create directory %s\n", fullPath.c_str());
@@ -549,62 +779,20 @@ bool AssetsManagerEx::decompress(const std::string &zip)
                 return false;
             }
         }
-        else
-        {
-            // Create all directories in advance to avoid issue
-            std::string dir = basename(fullPath);
-            if (!_fileUtils->isDirectoryExist(dir)) {
-                if (!_fileUtils->createDirectory(dir)) {
-                    // Failed to create directory
-                    CCLOG("AssetsManagerEx : can not create directory %s\n", fullPath.c_str());
-                    unzClose(zipfile);
-                    return false;
-                }
-            }
-            // Entry is a file, so extract it.
-            // Open current file.
-            if (unzOpenCurrentFile(zipfile) != UNZ_OK)
-            {
-                CCLOG("AssetsManagerEx : can not extract file %s\n", fileName);
-                unzClose(zipfile);
-                return false;
-            }
 
-            // Create a file to store current file.
-            FILE *out = fopen(FileUtils::getInstance()->getSuitableFOpen(fullPath).c_str(), "wb");
-            if (!out)
+        if (!isDirectory)
+        {
+            ZipEntry entry;
+            entry.fullPath = fullPath;
+            if (unzGetFilePos(zipfile, &entry.pos) != UNZ_OK)
             {
-                CCLOG("AssetsManagerEx : can not create decompress destination file %s (errno: %d)\n", fullPath.c_str(), errno);
-                unzCloseCurrentFile(zipfile);
+                CCLOG("AssetsManagerEx : can not locate file %s\n", fileName);
                 unzClose(zipfile);
                 return false;
             }
-
-            // Write current file content to destinate file.
-            int error = UNZ_OK;
-            do
-            {
-                error = unzReadCurrentFile(zipfile, readBuffer, BUFFER_SIZE);
-                if (error < 0)
-                {
-                    CCLOG("AssetsManagerEx : can not read zip file %s, error code is %d\n", fileName, error);
-                    fclose(out);
-                    unzCloseCurrentFile(zipfile);
-                    unzClose(zipfile);
-                    return false;
-                }
-
-                if (error > 0)
-                {
-                    fwrite(readBuffer, error, 1, out);
-                }
-            } while(error > 0);
-
-            fclose(out);
+            entries.push_back(entry);
         }
 
-        unzCloseCurrentFile(zipfile);
-
         // Goto next entry listed in the zip file.
         if ((i+1) < global_info.number_entry)
         {
@@ -616,49 +804,207 @@ bool AssetsManagerEx::decompress(const std::string &zip)
             }
         }
     }
-
     unzClose(zipfile);
     return true;
 }
 
+void AssetsManagerEx::extractZipEntries(const std::string &zipPath, const std::vector<ZipEntry> &entries, std::atomic<size_t> &nextEntry, std::atomic<bool> &failed)
+{
+    // Every extracting task reads the zip with its own handle
+    unzFile zipfile = unzOpen(zipPath.c_str());
+    if (!zipfile)
+    {
+        CCLOG("AssetsManagerEx : can not open downloaded zip file %s\n", zipPath.c_str());
+        failed = true;
+        return;
+    }
+
+    // Buffer to hold data read from the zip file
+    std::vector<char> readBuffer(PROCESS_BUFFER_SIZE);
+    size_t index = 0;
+    while (!failed && (index = nextEntry.fetch_add(1)) < entries.size())
+    {
+        const ZipEntry& entry = entries[index];
+        if (unzGoToFilePos(zipfile, const_cast<unz_file_pos*>(&entry.pos)) != UNZ_OK || unzOpenCurrentFile(zipfile) != UNZ_OK)
+        {
+            CCLOG("AssetsManagerEx : can not extract file %s\n", entry.fullPath.c_str());
+            failed = true;
+            break;
+        }
+
+        // Create a file to store current file.
+        FILE *out = fopen(FileUtils::getInstance()->getSuitableFOpen(entry.fullPath).c_str(), "wb");
+        if (!out)
+        {
+            CCLOG("AssetsManagerEx : can not create decompress destination file %s (errno: %d)\n", entry.fullPath.c_str(), errno);
+            unzCloseCurrentFile(zipfile);
+            failed = true;
+            break;
+        }
+        // Data is written in large chunks, skip the stdio buffer copy
+        setvbuf(out, nullptr, _IONBF, 0);
+
+        // Write current file content to destinate file.
+        int error = UNZ_OK;
+        do
+        {
+            error = unzReadCurrentFile(zipfile, readBuffer.data(), (unsigned)readBuffer.size());
+            if (error < 0)
+            {
+                CCLOG("AssetsManagerEx : can not read zip file %s, error code is %d\n", entry.fullPath.c_str(), error);
+                failed = true;
+            }
+            else if (error > 0 && fwrite(readBuffer.data(), error, 1, out) != 1)
+            {
+                CCLOG("AssetsManagerEx : can not write decompress destination file %s (errno: %d)\n", entry.fullPath.c_str(), errno);
+                failed = true;
+            }
+        } while (error > 0 && !failed);
+
+        fclose(out);
+        unzCloseCurrentFile(zipfile);
+    }
+    unzClose(zipfile);
+}
+
+void AssetsManagerEx::decompressAsync(const std::string &zip, const std::function<void(bool)> &onFinished)
+{
+    struct Extraction
+    {
+        std::string zipPath;
+        std::vector<ZipEntry> entries;
+        std::atomic<size_t> nextEntry;
+        std::atomic<bool> failed;
+        std::atomic<int> pendingTasks;
+        std::function<void(bool)> onFinished;
+    };
+
+    auto extraction = std::make_shared<Extraction>();
+    if (!listZipEntries(zip, extraction->zipPath, extraction->entries))
+    {
+        onFinished(false);
+        return;
+    }
+    extraction->nextEntry = 0;
+    extraction->failed = false;
+    extraction->onFinished = onFinished;
+
+    // Entries are taken one by one by all tasks, so a large entry doesn't hold the others back.
+    // Tasks never wait for each other, the last one to finish reports the result
+    int taskNum = (int)std::min<size_t>(getProcessThreadNum(), std::max<size_t>(1, extraction->entries.size() / MIN_ZIP_ENTRIES_PER_TASK));
+    extraction->pendingTasks = taskNum;
+    auto extract = [extraction](int /*tid*/) {
+        extractZipEntries(extraction->zipPath, extraction->entries, extraction->nextEntry, extraction->failed);
+        if (--extraction->pendingTasks == 0)
+        {
+            extraction->onFinished(!extraction->failed);
+        }
+    };
+    for (int i = 1; i < taskNum; ++i)
+    {
+        _processPool->pushTask(extract);
+    }
+    extract(0);
+}
+
 void AssetsManagerEx::decompressDownloadedZip(const std::string &customId, const std::string &storagePath)
 {
-    struct AsyncData
+    processDownloadedAsset(customId, storagePath, "", true);
+}
+
+void AssetsManagerEx::processDownloadedAsset(const std::string &customId, const std::string &storagePath, const std::string &md5, bool compressed)
+{
+    struct ProcessResult
     {
-        std::string customId;
-        std::string zipFile;
-        bool succeed;
+        double size;
+        bool verified;
+        bool decompressed;
     };
 
-    AsyncData* asyncData = new AsyncData;
-    asyncData->customId = customId;
-    asyncData->zipFile = storagePath;
-    asyncData->succeed = false;
+    if (_processPool == nullptr)
+    {
+        _processPool = ThreadPool::newFixedThreadPool(getProcessThreadNum());
+    }
+
+    // The asset is no longer downloading, let the next download start while it's processed
+    _processingUnits.insert(customId);
+    _currConcurrentTask = std::max(0, _currConcurrentTask-1);
+
+    std::weak_ptr<bool> alive = _aliveToken;
+    _processPool->pushTask([this, alive, customId, storagePath, md5, compressed](int /*tid*/) {
+        auto result = std::make_shared<ProcessResult>();
+        result->size = 0;
+        result->verified = true;
+        result->decompressed = true;
 
-    std::function<void(void*)> decompressFinished = [this](void* param) {
-        auto dataInner = reinterpret_cast<AsyncData*>(param);
-        if (dataInner->succeed)
+        if (!md5.empty())
         {
-            fileSuccess(dataInner->customId, dataInner->zipFile);
+            std::string hex;
+            result->verified = fileMD5(storagePath, hex, result->size) && isSameMD5(hex, md5);
         }
         else
         {
-            std::string errorMsg = "Unable to decompress file " + dataInner->zipFile;
-            // Ensure zip file deletion (if decompress failure cause task thread exit anormally)
-            _fileUtils->removeFile(dataInner->zipFile);
-            dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DECOMPRESS, "", errorMsg);
-            fileError(dataInner->customId, errorMsg);
+            result->size = (double)_fileUtils->getFileSize(storagePath);
         }
-        delete dataInner;
-    };
-    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, decompressFinished, (void*)asyncData, [this, asyncData]() {
-        // Decompress all compressed files
-        if (decompress(asyncData->zipFile))
+
+        auto finish = [this, alive, result, customId, storagePath]() {
+            Application::getInstance()->getScheduler()->performFunctionInCocosThread([this, alive, result, customId, storagePath]() {
+                if (alive.expired())
+                {
+                    return;
+                }
+
+                _totalProcessed += std::max(0.0, result->size);
+                _processedFiles++;
+                updateSpeed();
+
+                if (!result->verified)
+                {
+                    fileError(customId, "Asset file verification failed after downloaded");
+                }
+                else if (!result->decompressed)
+                {
+                    std::string errorMsg = "Unable to decompress file " + storagePath;
+                    dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DECOMPRESS, "", errorMsg);
+                    fileError(customId, errorMsg);
+                }
+                else
+                {
+                    fileSuccess(customId, storagePath);
+                }
+            });
+        };
+
+        if (result->verified && compressed)
         {
-            asyncData->succeed = true;
+            // Decompress all compressed files, the entries of one archive are spread over the process pool
+            decompressAsync(storagePath, [this, result, storagePath, finish](bool decompressed) {
+                result->decompressed = decompressed;
+                _fileUtils->removeFile(storagePath);
+                finish();
+            });
+            return;
         }
-        _fileUtils->removeFile(asyncData->zipFile);
+        finish();
     });
+
+    queueDowload();
+}
+
+void AssetsManagerEx::updateSpeed()
+{
+    auto now = std::chrono::steady_clock::now();
+    float elapsed = std::chrono::duration<float>(now - _speedSampleTime).count();
+    if (elapsed < SPEED_SAMPLE_INTERVAL)
+    {
+        return;
+    }
+
+    _downloadSpeed = std::max(0.0, (_totalDownloaded - _speedSampleDownloaded) / elapsed);
+    _processSpeed = std::max(0.0, (_totalProcessed - _speedSampleProcessed) / elapsed);
+    _speedSampleTime = now;
+    _speedSampleDownloaded = _totalDownloaded;
+    _speedSampleProcessed = _totalProcessed;
 }
 
 void AssetsManagerEx::dispatchUpdateEvent(EventAssetsManagerEx::EventCode code, const std::string &assetId/* = ""*/, const std::string &message/* = ""*/, int curle_code/* = CURLE_OK*/, int curlm_code/* = CURLM_OK*/)
@@ -1137,6 +1483,10 @@ void AssetsManagerEx::updateAssets(const DownloadUnits& assets)
         _downloadUnits.clear();
         _downloadedSize.clear();
         _percent = _percentByFile = _sizeCollected = _totalDownloaded = _totalSize = 0;
+        _totalProcessed = _downloadSpeed = _processSpeed = 0;
+        _processedFiles = 0;
+        _speedSampleDownloaded = _speedSampleProcessed = 0;
+        _speedSampleTime = std::chrono::steady_clock::now();
         _totalWaitToDownload = _totalToDownload = (int)assets.size();
         _nextSavePoint = 0;
         _totalEnabled = false;
@@ -1177,7 +1527,11 @@ void AssetsManagerEx::fileError(const std::string& identifier, const std::string
     dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_UPDATING, identifier, errorStr, errorCode, errorCodeInternal);
     _tempManifest->setAssetDownloadState(identifier, Manifest::DownloadState::UNSTARTED);
 
-    _currConcurrentTask = std::max(0, _currConcurrentTask-1);
+    // Download slot of a processed asset was already released
+    if (_processingUnits.erase(identifier) == 0)
+    {
+        _currConcurrentTask = std::max(0, _currConcurrentTask-1);
+    }
     queueDowload();
 }
 
@@ -1201,13 +1555,18 @@ void AssetsManagerEx::fileSuccess(const std::string &customId, const std::string
         _totalWaitToDownload--;
 
         _percentByFile = 100 * (float)(_totalToDownload - _totalWaitToDownload) / _totalToDownload;
+        updateSpeed();
         // Notify progression event
         dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_PROGRESSION, "");
     }
     // Notify asset updated event
     dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ASSET_UPDATED, customId);
 
-    _currConcurrentTask = std::max(0, _currConcurrentTask-1);
+    // Download slot of a processed asset was already released
+    if (_processingUnits.erase(customId) == 0)
+    {
+        _currConcurrentTask = std::max(0, _currConcurrentTask-1);
+    }
     queueDowload();
 }
 
@@ -1277,6 +1636,8 @@ void AssetsManagerEx::onProgress(double total, double downloaded, const std::str
             }
         }
 
+        updateSpeed();
+
         if (_totalEnabled && _updateState == State::UPDATING)
         {
             float currentPercent = 100 * _totalDownloaded / _totalSize;
@@ -1305,11 +1666,10 @@ void AssetsManagerEx::onSuccess(const std::string &/*srcUrl*/, const std::string
     else
     {
         bool ok = true;
-        auto &assets = _remoteManifest->getAssets();
-        auto assetIt = assets.find(customId);
-        if (assetIt != assets.end())
+        Manifest::Asset asset;
+        bool found = _remoteManifest->findAsset(customId, &asset);
+        if (found)
         {
-            Manifest::Asset asset = assetIt->second;
             if (_verifyCallback != nullptr)
             {
                 ok = _verifyCallback(storagePath, asset);
@@ -1318,10 +1678,11 @@ void AssetsManagerEx::onSuccess(const std::string &/*srcUrl*/, const std::string
 
         if (ok)
         {
-            bool compressed = assetIt != assets.end() ? assetIt->second.compressed : false;
-            if (compressed)
+            bool compressed = found ? asset.compressed : false;
+            std::string md5 = _nativeVerifyEnabled && found ? asset.md5 : "";
+            if (compressed || !md5.empty())
             {
-                decompressDownloadedZip(customId, storagePath);
+                processDownloadedAsset(customId, storagePath, md5, compressed);
             }
             else
             {
@@ -29,8 +29,14 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
+#include <memory>
+#include <chrono>
+#include <atomic>
+#include <functional>
 
+#include "base/CCThreadPool.h"
 #include "platform/CCFileUtils.h"
 #include "network/CCDownloader.h"
 
@@ -170,6 +176,32 @@ public:
      */
     int getDownloadedFiles() const {return _totalToDownload - _totalWaitToDownload;};
     
+    /** @brief Gets the byte size of downloaded files which have been verified and decompressed on worker threads, this will only be available after READY_TO_UPDATE state, under unknown states it will return 0 by default.
+     */
+    double getProcessedBytes() const {return _totalProcessed;};
+    
+    /** @brief Gets the count of downloaded files which have been verified and decompressed on worker threads, this will only be available after READY_TO_UPDATE state, under unknown states it will return 0 by default.
+     */
+    int getProcessedFiles() const {return _processedFiles;};
+    
+    /** @brief Gets the recent download throughput of the update in bytes per second.
+     */
+    double getDownloadSpeed() const {return _downloadSpeed;};
+    
+    /** @brief Gets the recent verification and decompression throughput of the update in bytes per second.
+     */
+    double getProcessSpeed() const {return _processSpeed;};
+    
+    /** @brief Enable or disable the native md5 verification, when enabled, every downloaded asset with a md5 in the remote manifest
+     * is hashed on worker threads while the remaining assets are still downloading. It runs after the verify callback if both are set.
+     * @param enabled   Whether to verify the md5 of downloaded assets natively, it's disabled by default
+     */
+    void setNativeVerifyEnabled(bool enabled) {_nativeVerifyEnabled = enabled;};
+    
+    /** @brief Gets whether the native md5 verification is enabled.
+     */
+    bool isNativeVerifyEnabled() const {return _nativeVerifyEnabled;};
+    
     /** @brief Function for retrieving the max concurrent task count
      */
     const int getMaxConcurrentTask() const {return _maxConcurrentTask;};
@@ -226,8 +258,32 @@ protected:
     void startUpdate();
     void updateSucceed();
     bool decompress(const std::string &filename);
+    
+    struct ZipEntry;
+    /** @brief Create the directories of a zip file and list its file entries
+     */
+    bool listZipEntries(const std::string &zip, std::string &zipPath, std::vector<ZipEntry> &entries);
+    /** @brief Extract entries until all of them are taken or one fails, it can run on several threads with the same counters
+     */
+    static void extractZipEntries(const std::string &zipPath, const std::vector<ZipEntry> &entries, std::atomic<size_t> &nextEntry, std::atomic<bool> &failed);
+    /** @brief Decompress a zip file with as many process pool tasks as its entries are worth, each with its own zip handle.
+     * onFinished is called once on a process pool thread, when all entries are extracted or one of them failed
+     */
+    void decompressAsync(const std::string &zip, const std::function<void(bool)> &onFinished);
     void decompressDownloadedZip(const std::string &customId, const std::string &storagePath);
     
+    /** @brief Verify and decompress a downloaded asset on worker threads, its download slot is released at once so the next downloads can start
+     * @param customId      The key of this asset
+     * @param storagePath   The downloaded file path
+     * @param md5           The expected md5 of the file, empty to skip the verification
+     * @param compressed    Whether the file should be decompressed
+     */
+    void processDownloadedAsset(const std::string &customId, const std::string &storagePath, const std::string &md5, bool compressed);
+    
+    /** @brief Sample download and processing throughput
+     */
+    void updateSpeed();
+    
     /** @brief Update a list of assets under the current AssetsManagerEx context
      */
     void updateAssets(const DownloadUnits& assets);
@@ -302,9 +358,6 @@ private:
     //! Downloader
     std::shared_ptr<network::Downloader> _downloader;
     
-    //! The reference to the local assets
-    const std::unordered_map<std::string, Manifest::Asset> *_assets;
-    
     //! The path to store successfully downloaded version.
     std::string _storagePath;
     
@@ -398,6 +451,35 @@ private:
     
     //! Marker for whether the assets manager is inited
     bool _inited;
+    
+    //! Whether the md5 of downloaded assets is verified natively
+    bool _nativeVerifyEnabled;
+    
+    //! Worker threads for verifying and decompressing downloaded assets, created on demand
+    ThreadPool *_processPool;
+    
+    //! Assets being verified or decompressed, their download slots are already released
+    std::unordered_set<std::string> _processingUnits;
+    
+    //! Shared with processing tasks, a task result is dropped once the manager is destroyed
+    std::shared_ptr<bool> _aliveToken;
+    
+    //! Total processed file size (sum of all verified and decompressed files)
+    double _totalProcessed;
+    
+    //! Total number of processed files
+    int _processedFiles;
+    
+    //! Download throughput in bytes per second
+    double _downloadSpeed;
+    
+    //! Processing throughput in bytes per second
+    double _processSpeed;
+    
+    //! Last throughput sample
+    std::chrono::steady_clock::time_point _speedSampleTime;
+    double _speedSampleDownloaded;
+    double _speedSampleProcessed;
 };
 
 NS_CC_EXT_END
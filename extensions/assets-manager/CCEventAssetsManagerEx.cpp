@@ -75,5 +75,25 @@ int EventAssetsManagerEx::getTotalFiles() const
     return _manager->getTotalFiles();
 }
 
+double EventAssetsManagerEx::getProcessedBytes() const
+{
+    return _manager->getProcessedBytes();
+}
+
+int EventAssetsManagerEx::getProcessedFiles() const
+{
+    return _manager->getProcessedFiles();
+}
+
+double EventAssetsManagerEx::getDownloadSpeed() const
+{
+    return _manager->getDownloadSpeed();
+}
+
+double EventAssetsManagerEx::getProcessSpeed() const
+{
+    return _manager->getProcessSpeed();
+}
+
 
 NS_CC_EXT_END
@@ -80,6 +80,14 @@ public:
     
     int getTotalFiles() const;
     
+    double getProcessedBytes() const;
+    
+    int getProcessedFiles() const;
+    
+    double getDownloadSpeed() const;
+    
+    double getProcessSpeed() const;
+    
 public:
     /** Constructor */
     EventAssetsManagerEx(const std::string& eventName, cocos2d::extension::AssetsManagerEx *manager, const EventCode &code, const std::string& assetId = "", const std::string& message = "", int curle_code = 0, int curlm_code = 0);
@@ -25,11 +25,15 @@
  ****************************************************************************/
 
 #include "Manifest.h"
+#include "platform/CCFileMapping.h"
 #include "json/prettywriter.h"
 #include "json/stringbuffer.h"
 
+#include <algorithm>
 #include <fstream>
+#include <map>
 #include <stdio.h>
+#include <stdint.h>
 
 #define KEY_VERSION             "version"
 #define KEY_PACKAGE_URL         "packageUrl"
@@ -50,8 +54,280 @@
 #define KEY_COMPRESSED_FILE     "compressedFile"
 #define KEY_DOWNLOAD_STATE      "downloadState"
 
+#define BINARY_MANIFEST_MAGIC       0x464d4343 // "CCMF"
+#define BINARY_MANIFEST_VERSION     1
+#define BINARY_MANIFEST_UPDATING    0x1
+
 NS_CC_EXT_BEGIN
 
+namespace {
+    /*
+     * Binary manifest layout, all integers are little endian and all sections are 4 bytes aligned:
+     * BinaryHeader | string offsets (stringCount + 1) | string data | asset records | hash buckets | groups | search paths
+     * Strings are unique, sorted and null terminated, they are referenced by their index in the sorted table,
+     * so asset records sorted by key index are also sorted by key. Hash buckets store record index + 1 with linear probing.
+     */
+    struct BinaryHeader
+    {
+        uint32_t magic;
+        uint16_t formatVersion;
+        uint16_t flags;
+        uint32_t size;
+        uint32_t stringCount;
+        uint32_t stringOffsets;
+        uint32_t stringData;
+        uint32_t stringDataSize;
+        uint32_t assetCount;
+        uint32_t assets;
+        uint32_t bucketCount;
+        uint32_t buckets;
+        uint32_t groupCount;
+        uint32_t groups;
+        uint32_t searchPathCount;
+        uint32_t searchPaths;
+        uint32_t version;
+        uint32_t packageUrl;
+        uint32_t manifestUrl;
+        uint32_t versionUrl;
+        uint32_t engineVersion;
+    };
+
+    struct BinaryAsset
+    {
+        uint32_t key;
+        uint32_t path;
+        uint32_t md5;
+        uint32_t size;
+        uint8_t compressed;
+        int8_t downloadState;
+        uint16_t reserved;
+    };
+
+    inline uint32_t hashKey(const char *key, size_t length)
+    {
+        // FNV-1a
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash = (hash ^ (uint8_t)key[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+    inline uint32_t align4(uint32_t size)
+    {
+        return (size + 3) & ~3u;
+    }
+
+    class BinaryView
+    {
+    public:
+        BinaryView(const unsigned char *data)
+        : _data(data)
+        , _header((const BinaryHeader*)data)
+        {
+        }
+
+        const BinaryHeader& header() const { return *_header; }
+
+        uint32_t assetCount() const { return _header->assetCount; }
+
+        const BinaryAsset& asset(uint32_t index) const
+        {
+            return ((const BinaryAsset*)(_data + _header->assets))[index];
+        }
+
+        const char* string(uint32_t id) const
+        {
+            return (const char*)(_data + _header->stringData + offsets()[id]);
+        }
+
+        uint32_t length(uint32_t id) const
+        {
+            return offsets()[id + 1] - offsets()[id] - 1;
+        }
+
+        bool equals(uint32_t id, const char *str, size_t len) const
+        {
+            return length(id) == len && memcmp(string(id), str, len) == 0;
+        }
+
+        std::string toString(uint32_t id) const
+        {
+            return std::string(string(id), length(id));
+        }
+
+        const uint32_t* pairs(uint32_t offset) const
+        {
+            return (const uint32_t*)(_data + offset);
+        }
+
+        int find(const std::string &key) const
+        {
+            const uint32_t *buckets = (const uint32_t*)(_data + _header->buckets);
+            uint32_t mask = _header->bucketCount - 1;
+            uint32_t slot = hashKey(key.c_str(), key.size()) & mask;
+            for (uint32_t probe = 0; probe <= mask && buckets[slot] != 0; ++probe)
+            {
+                uint32_t index = buckets[slot] - 1;
+                if (equals(asset(index).key, key.c_str(), key.size()))
+                {
+                    return (int)index;
+                }
+                slot = (slot + 1) & mask;
+            }
+            return -1;
+        }
+
+        ManifestAsset toAsset(const BinaryAsset &record) const
+        {
+            ManifestAsset asset;
+            asset.md5 = toString(record.md5);
+            asset.path = toString(record.path);
+            asset.compressed = record.compressed != 0;
+            asset.size = (float)record.size;
+            asset.downloadState = record.downloadState;
+            return asset;
+        }
+
+        bool validate(size_t size) const
+        {
+            const BinaryHeader &h = *_header;
+            if (size < sizeof(BinaryHeader) || h.magic != BINARY_MANIFEST_MAGIC || h.formatVersion != BINARY_MANIFEST_VERSION || h.size != size)
+                return false;
+
+            // Every section should be aligned and inside the data
+            auto inside = [size](uint32_t offset, uint64_t count, uint64_t elementSize) {
+                return (offset & 3) == 0 && offset + count * elementSize <= size;
+            };
+            if (h.stringCount == 0 || !inside(h.stringOffsets, (uint64_t)h.stringCount + 1, 4) || !inside(h.stringData, h.stringDataSize, 1) ||
+                !inside(h.assets, h.assetCount, sizeof(BinaryAsset)) || !inside(h.buckets, h.bucketCount, 4) ||
+                !inside(h.groups, (uint64_t)h.groupCount * 2, 4) || !inside(h.searchPaths, h.searchPathCount, 4))
+                return false;
+            if (h.bucketCount == 0 || (h.bucketCount & (h.bucketCount - 1)) != 0 || h.bucketCount < h.assetCount)
+                return false;
+
+            const uint32_t *offs = offsets();
+            const char *chars = (const char*)(_data + h.stringData);
+            if (offs[0] != 0 || offs[h.stringCount] > h.stringDataSize)
+                return false;
+            for (uint32_t i = 0; i < h.stringCount; ++i)
+            {
+                if (offs[i + 1] <= offs[i] || offs[i + 1] > h.stringDataSize || chars[offs[i + 1] - 1] != '\0')
+                    return false;
+            }
+
+            auto validId = [&h](uint32_t id) { return id < h.stringCount; };
+            if (!validId(h.version) || !validId(h.packageUrl) || !validId(h.manifestUrl) || !validId(h.versionUrl) || !validId(h.engineVersion))
+                return false;
+            for (uint32_t i = 0; i < h.assetCount; ++i)
+            {
+                const BinaryAsset &record = asset(i);
+                // Keys should be strictly sorted for in place diff
+                if (!validId(record.key) || !validId(record.path) || !validId(record.md5) || (i > 0 && record.key <= asset(i - 1).key))
+                    return false;
+            }
+            const uint32_t *buckets = (const uint32_t*)(_data + h.buckets);
+            for (uint32_t i = 0; i < h.bucketCount; ++i)
+            {
+                if (buckets[i] > h.assetCount)
+                    return false;
+            }
+            const uint32_t *groups = pairs(h.groups);
+            for (uint32_t i = 0; i < h.groupCount * 2; ++i)
+            {
+                if (!validId(groups[i]))
+                    return false;
+            }
+            const uint32_t *paths = pairs(h.searchPaths);
+            for (uint32_t i = 0; i < h.searchPathCount; ++i)
+            {
+                if (!validId(paths[i]))
+                    return false;
+            }
+            return true;
+        }
+
+    private:
+        const uint32_t* offsets() const
+        {
+            return (const uint32_t*)(_data + _header->stringOffsets);
+        }
+
+        const unsigned char *_data;
+        const BinaryHeader *_header;
+    };
+
+    // Collects strings of a manifest, then lays them out sorted
+    class StringTable
+    {
+    public:
+        void add(const std::string &str)
+        {
+            _ids.emplace(str, 0);
+        }
+
+        void build()
+        {
+            uint32_t id = 0;
+            uint32_t offset = 0;
+            _offsets.reserve(_ids.size() + 1);
+            for (auto &it : _ids)
+            {
+                it.second = id++;
+                _offsets.push_back(offset);
+                offset += (uint32_t)it.first.size() + 1;
+            }
+            _offsets.push_back(offset);
+        }
+
+        uint32_t id(const std::string &str) const { return _ids.at(str); }
+
+        uint32_t count() const { return (uint32_t)_ids.size(); }
+
+        uint32_t dataSize() const { return _offsets.back(); }
+
+        const std::vector<uint32_t>& offsets() const { return _offsets; }
+
+        void writeData(unsigned char *out) const
+        {
+            for (auto &it : _ids)
+            {
+                memcpy(out, it.first.c_str(), it.first.size() + 1);
+                out += it.first.size() + 1;
+            }
+        }
+
+    private:
+        std::map<std::string, uint32_t> _ids;
+        std::vector<uint32_t> _offsets;
+    };
+
+    // Writes through a temporary file, the destination could be the file mapped by the manifest itself
+    bool writeFile(const std::string &filepath, const void *data, size_t size)
+    {
+        FileUtils *fileUtils = FileUtils::getInstance();
+        std::string tempPath = filepath + ".tmp";
+        FILE *fp = fopen(fileUtils->getSuitableFOpen(tempPath).c_str(), "wb");
+        if (!fp)
+        {
+            CCLOG("Fail to open file for writing: %s\n", tempPath.c_str());
+            return false;
+        }
+        bool ok = fwrite(data, 1, size, fp) == size;
+        ok = fclose(fp) == 0 && ok;
+        if (ok)
+        {
+            ok = fileUtils->renameFile(tempPath, filepath);
+        }
+        if (!ok)
+        {
+            fileUtils->removeFile(tempPath);
+        }
+        return ok;
+    }
+}
+
 static int cmpVersion(const std::string& v1, const std::string& v2)
 {
     int i;
@@ -82,6 +358,9 @@ Manifest::Manifest(const std::string& manifestUrl/* = ""*/)
 , _remoteVersionUrl("")
 , _version("")
 , _engineVer("")
+, _binData(nullptr)
+, _binSize(0)
+, _binMapped(false)
 {
     // Init variables
     _fileUtils = FileUtils::getInstance();
@@ -98,6 +377,9 @@ Manifest::Manifest(const std::string& content, const std::string& manifestRoot)
 , _remoteVersionUrl("")
 , _version("")
 , _engineVer("")
+, _binData(nullptr)
+, _binSize(0)
+, _binMapped(false)
 {
     // Init variables
     _fileUtils = FileUtils::getInstance();
@@ -105,19 +387,46 @@ Manifest::Manifest(const std::string& content, const std::string& manifestRoot)
         parseJSONString(content, manifestRoot);
 }
 
+Manifest::~Manifest()
+{
+    releaseBinary();
+}
+
 void Manifest::loadJson(const std::string& url)
 {
     clear();
+    // Binary manifest is mapped instead of being read
+    if (loadBinary(url))
+    {
+        return;
+    }
+
     std::string content;
     if (_fileUtils->isFileExist(url))
     {
         // Load file content
         content = _fileUtils->getStringFromFile(url);
         
+        uint32_t magic = 0;
+        if (content.size() >= sizeof(BinaryHeader))
+        {
+            memcpy(&magic, content.data(), sizeof(magic));
+        }
+
         if (content.size() == 0)
         {
             CCLOG("Fail to retrieve local file content: %s\n", url.c_str());
         }
+        else if (magic == BINARY_MANIFEST_MAGIC)
+        {
+            // The file can't be mapped, e.g. it's packed in apk
+            unsigned char *data = (unsigned char*)malloc(content.size());
+            if (data)
+            {
+                memcpy(data, content.data(), content.size());
+                loadBinaryFromBuffer(data, content.size());
+            }
+        }
         else
         {
             loadJsonFromString(content);
@@ -146,11 +455,86 @@ void Manifest::loadJsonFromString(const std::string& content)
     }
 }
 
+bool Manifest::loadBinary(const std::string& url)
+{
+    std::string fullPath = _fileUtils->fullPathForFilename(url);
+    // Sniff the magic first, json manifests are not worth a mapping
+    FILE *fp = fopen(_fileUtils->getSuitableFOpen(fullPath).c_str(), "rb");
+    if (!fp)
+    {
+        return false;
+    }
+    uint32_t magic = 0;
+    bool isBinary = fread(&magic, sizeof(magic), 1, fp) == 1 && magic == BINARY_MANIFEST_MAGIC;
+    fclose(fp);
+    if (!isBinary)
+    {
+        return false;
+    }
+
+    // Private mapping, download states written in memory never reach the file
+    size_t size = 0;
+    unsigned char *data = mapFile(fullPath, sizeof(BinaryHeader), size);
+    if (!data)
+    {
+        return false;
+    }
+
+    _json.SetNull();
+    _binData = data;
+    _binSize = size;
+    _binMapped = true;
+    if (!BinaryView(_binData).validate(_binSize))
+    {
+        CCLOG("Invalid binary manifest: %s\n", url.c_str());
+        releaseBinary();
+        return false;
+    }
+    return true;
+}
+
+bool Manifest::loadBinaryFromBuffer(unsigned char *data, size_t size)
+{
+    _json.SetNull();
+    _binData = data;
+    _binSize = size;
+    _binMapped = false;
+    if (!BinaryView(_binData).validate(_binSize))
+    {
+        CCLOG("Invalid binary manifest data\n");
+        releaseBinary();
+        return false;
+    }
+    return true;
+}
+
+void Manifest::releaseBinary()
+{
+    if (_binData)
+    {
+        if (_binMapped)
+        {
+            unmapFile(_binData, _binSize);
+        }
+        else
+        {
+            free(_binData);
+        }
+        _binData = nullptr;
+        _binSize = 0;
+        _binMapped = false;
+    }
+}
+
 void Manifest::parseVersion(const std::string& versionUrl)
 {
     loadJson(versionUrl);
     
-    if (_json.IsObject())
+    if (_binData)
+    {
+        loadBinaryVersion();
+    }
+    else if (_json.IsObject())
     {
         loadVersion(_json);
     }
@@ -160,7 +544,7 @@ void Manifest::parseFile(const std::string& manifestUrl)
 {
     loadJson(manifestUrl);
 	
-    if (!_json.HasParseError() && _json.IsObject())
+    if (_binData || (!_json.HasParseError() && _json.IsObject()))
     {
         // Register the local manifest root
         size_t found = manifestUrl.find_last_of("/\\");
@@ -168,7 +552,14 @@ void Manifest::parseFile(const std::string& manifestUrl)
         {
             _manifestRoot = manifestUrl.substr(0, found+1);
         }
-        loadManifest(_json);
+        if (_binData)
+        {
+            loadBinaryManifest();
+        }
+        else
+        {
+            loadManifest(_json);
+        }
     }
 }
 
@@ -195,7 +586,16 @@ bool Manifest::isLoaded() const
 
 void Manifest::setUpdating(bool updating)
 {
-    if (_loaded && _json.IsObject())
+    if (_loaded && _binData)
+    {
+        BinaryHeader *header = (BinaryHeader*)_binData;
+        if (updating)
+            header->flags |= BINARY_MANIFEST_UPDATING;
+        else
+            header->flags &= ~BINARY_MANIFEST_UPDATING;
+        _updating = updating;
+    }
+    else if (_loaded && _json.IsObject())
     {
         if (_json.HasMember(KEY_UPDATING) && _json[KEY_UPDATING].IsBool())
         {
@@ -274,72 +674,103 @@ bool Manifest::versionGreater(const Manifest *b, const std::function<int(const s
 std::unordered_map<std::string, Manifest::AssetDiff> Manifest::genDiff(const Manifest *b) const
 {
     std::unordered_map<std::string, AssetDiff> diff_map;
-    const std::unordered_map<std::string, Asset> &bAssets = b->getAssets();
-    
-    std::string key;
-    Asset valueA;
-    Asset valueB;
     
-    std::unordered_map<std::string, Asset>::const_iterator valueIt, it;
-    for (it = _assets.begin(); it != _assets.end(); ++it)
+    if (_binData && b->_binData)
     {
-        key = it->first;
-        valueA = it->second;
-        
+        // Both assets lists are sorted by key, merge them in place
+        BinaryView viewA(_binData);
+        BinaryView viewB(b->_binData);
+        uint32_t i = 0, j = 0;
+        uint32_t countA = viewA.assetCount(), countB = viewB.assetCount();
+        while (i < countA || j < countB)
+        {
+            int cmp = 0;
+            if (i == countA)
+                cmp = 1;
+            else if (j == countB)
+                cmp = -1;
+            else
+                cmp = strcmp(viewA.string(viewA.asset(i).key), viewB.string(viewB.asset(j).key));
+            
+            AssetDiff diff;
+            if (cmp < 0)
+            {
+                // Deleted
+                const BinaryAsset &recordA = viewA.asset(i++);
+                diff.asset = viewA.toAsset(recordA);
+                diff.type = DiffType::DELETED;
+                diff_map.emplace(viewA.toString(recordA.key), diff);
+            }
+            else if (cmp > 0)
+            {
+                // Added
+                const BinaryAsset &recordB = viewB.asset(j++);
+                diff.asset = viewB.toAsset(recordB);
+                diff.type = DiffType::ADDED;
+                diff_map.emplace(viewB.toString(recordB.key), diff);
+            }
+            else
+            {
+                // Modified
+                const BinaryAsset &recordA = viewA.asset(i++);
+                const BinaryAsset &recordB = viewB.asset(j++);
+                if (!viewB.equals(recordB.md5, viewA.string(recordA.md5), viewA.length(recordA.md5)))
+                {
+                    diff.asset = viewB.toAsset(recordB);
+                    diff.type = DiffType::MODIFIED;
+                    diff_map.emplace(viewB.toString(recordB.key), diff);
+                }
+            }
+        }
+        return diff_map;
+    }
+    
+    Asset valueB;
+    forEachAsset([&](const std::string &key, const Asset &valueA) {
         // Deleted
-        valueIt = bAssets.find(key);
-        if (valueIt == bAssets.cend()) {
+        if (!b->findAsset(key, &valueB)) {
             AssetDiff diff;
             diff.asset = valueA;
             diff.type = DiffType::DELETED;
             diff_map.emplace(key, diff);
-            continue;
+            return;
         }
         
         // Modified
-        valueB = valueIt->second;
         if (valueA.md5 != valueB.md5) {
             AssetDiff diff;
             diff.asset = valueB;
             diff.type = DiffType::MODIFIED;
             diff_map.emplace(key, diff);
         }
-    }
+    });
     
-    for (it = bAssets.begin(); it != bAssets.end(); ++it)
-    {
-        key = it->first;
-        valueB = it->second;
-        
+    b->forEachAsset([&](const std::string &key, const Asset &value) {
         // Added
-        valueIt = _assets.find(key);
-        if (valueIt == _assets.cend()) {
+        if (!findAsset(key, nullptr)) {
             AssetDiff diff;
-            diff.asset = valueB;
+            diff.asset = value;
             diff.type = DiffType::ADDED;
             diff_map.emplace(key, diff);
         }
-    }
+    });
     
     return diff_map;
 }
 
 void Manifest::genResumeAssetsList(DownloadUnits *units) const
 {
-    for (auto it = _assets.begin(); it != _assets.end(); ++it)
-    {
-        Asset asset = it->second;
-        
+    forEachAsset([this, units](const std::string &key, const Asset &asset) {
         if (asset.downloadState != DownloadState::SUCCESSED && asset.downloadState != DownloadState::UNMARKED)
         {
             DownloadUnit unit;
-            unit.customId = it->first;
+            unit.customId = key;
             unit.srcUrl = _packageUrl + asset.path;
             unit.storagePath = _manifestRoot + asset.path;
             unit.size = asset.size;
             units->emplace(unit.customId, unit);
         }
-    }
+    });
 }
 
 std::vector<std::string> Manifest::getSearchPaths() const
@@ -423,11 +854,69 @@ const std::string& Manifest::getGroupVersion(const std::string &group) const
 
 const std::unordered_map<std::string, Manifest::Asset>& Manifest::getAssets() const
 {
+    if (_binData && _assets.empty())
+    {
+        _assets.reserve(BinaryView(_binData).assetCount());
+        forEachAsset([this](const std::string &key, const Asset &asset) {
+            _assets.emplace(key, asset);
+        });
+    }
     return _assets;
 }
 
+bool Manifest::findAsset(const std::string &key, Asset *asset) const
+{
+    if (_binData)
+    {
+        BinaryView view(_binData);
+        int index = view.find(key);
+        if (index < 0)
+            return false;
+        if (asset)
+            *asset = view.toAsset(view.asset(index));
+        return true;
+    }
+    
+    auto it = _assets.find(key);
+    if (it == _assets.end())
+        return false;
+    if (asset)
+        *asset = it->second;
+    return true;
+}
+
+void Manifest::forEachAsset(const std::function<void(const std::string &key, const Asset &asset)> &callback) const
+{
+    if (_binData)
+    {
+        BinaryView view(_binData);
+        for (uint32_t i = 0, count = view.assetCount(); i < count; ++i)
+        {
+            const BinaryAsset &record = view.asset(i);
+            callback(view.toString(record.key), view.toAsset(record));
+        }
+    }
+    else
+    {
+        for (auto it = _assets.begin(); it != _assets.end(); ++it)
+        {
+            callback(it->first, it->second);
+        }
+    }
+}
+
 void Manifest::setAssetDownloadState(const std::string &key, const Manifest::DownloadState &state)
 {
+    if (_binData)
+    {
+        BinaryView view(_binData);
+        int index = view.find(key);
+        if (index >= 0)
+        {
+            const_cast<BinaryAsset&>(view.asset(index)).downloadState = (int8_t)state;
+        }
+    }
+    
     auto valueIt = _assets.find(key);
     if (valueIt != _assets.end())
     {
@@ -480,6 +969,8 @@ void Manifest::clear()
         _searchPaths.clear();
         _loaded = false;
     }
+    
+    releaseBinary();
 }
 
 Manifest::Asset Manifest::parseAsset(const std::string &path, const rapidjson::Value &json)
@@ -622,8 +1113,61 @@ void Manifest::loadManifest(const rapidjson::Document &json)
     _loaded = true;
 }
 
+void Manifest::loadBinaryVersion()
+{
+    BinaryView view(_binData);
+    const BinaryHeader &header = view.header();
+    
+    _remoteManifestUrl = view.toString(header.manifestUrl);
+    _remoteVersionUrl = view.toString(header.versionUrl);
+    _version = view.toString(header.version);
+    
+    const uint32_t *groups = view.pairs(header.groups);
+    for (uint32_t i = 0; i < header.groupCount; ++i)
+    {
+        std::string group = view.toString(groups[i * 2]);
+        _groups.push_back(group);
+        _groupVer.emplace(group, view.toString(groups[i * 2 + 1]));
+    }
+    
+    _engineVer = view.toString(header.engineVersion);
+    _updating = (header.flags & BINARY_MANIFEST_UPDATING) != 0;
+    
+    _versionLoaded = true;
+}
+
+void Manifest::loadBinaryManifest()
+{
+    loadBinaryVersion();
+    
+    BinaryView view(_binData);
+    const BinaryHeader &header = view.header();
+    
+    _packageUrl = view.toString(header.packageUrl);
+    // Append automatically "/"
+    if (_packageUrl.size() > 0 && _packageUrl[_packageUrl.size() - 1] != '/')
+    {
+        _packageUrl.append("/");
+    }
+    
+    // Assets stay in the binary data, the map is only built by getAssets
+    const uint32_t *paths = view.pairs(header.searchPaths);
+    for (uint32_t i = 0; i < header.searchPathCount; ++i)
+    {
+        _searchPaths.push_back(view.toString(paths[i]));
+    }
+    
+    _loaded = true;
+}
+
 void Manifest::saveToFile(const std::string &filepath)
 {
+    if (_binData)
+    {
+        writeFile(filepath, _binData, _binSize);
+        return;
+    }
+    
     rapidjson::StringBuffer buffer;
     rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
     _json.Accept(writer);
@@ -634,4 +1178,224 @@ void Manifest::saveToFile(const std::string &filepath)
         output << buffer.GetString() << std::endl;
 }
 
+bool Manifest::saveToBinaryFile(const std::string &filepath) const
+{
+    if (_binData)
+    {
+        return writeFile(filepath, _binData, _binSize);
+    }
+    if (!_versionLoaded)
+    {
+        return false;
+    }
+    
+    std::vector<std::pair<std::string, Asset>> assets;
+    assets.reserve(_assets.size());
+    forEachAsset([&assets](const std::string &key, const Asset &asset) {
+        assets.emplace_back(key, asset);
+    });
+    std::sort(assets.begin(), assets.end(), [](const std::pair<std::string, Asset> &a, const std::pair<std::string, Asset> &b) {
+        return a.first < b.first;
+    });
+    
+    StringTable strings;
+    strings.add(_version);
+    strings.add(_packageUrl);
+    strings.add(_remoteManifestUrl);
+    strings.add(_remoteVersionUrl);
+    strings.add(_engineVer);
+    for (const auto &group : _groups)
+    {
+        strings.add(group);
+        strings.add(_groupVer.at(group));
+    }
+    for (const auto &path : _searchPaths)
+    {
+        strings.add(path);
+    }
+    for (const auto &it : assets)
+    {
+        strings.add(it.first);
+        strings.add(it.second.path);
+        strings.add(it.second.md5);
+    }
+    strings.build();
+    
+    uint32_t assetCount = (uint32_t)assets.size();
+    uint32_t bucketCount = 1;
+    while (bucketCount < assetCount * 2)
+    {
+        bucketCount <<= 1;
+    }
+    
+    BinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = BINARY_MANIFEST_MAGIC;
+    header.formatVersion = BINARY_MANIFEST_VERSION;
+    header.flags = _updating ? BINARY_MANIFEST_UPDATING : 0;
+    header.stringCount = strings.count();
+    header.stringDataSize = strings.dataSize();
+    header.assetCount = assetCount;
+    header.bucketCount = bucketCount;
+    header.groupCount = (uint32_t)_groups.size();
+    header.searchPathCount = (uint32_t)_searchPaths.size();
+    header.version = strings.id(_version);
+    header.packageUrl = strings.id(_packageUrl);
+    header.manifestUrl = strings.id(_remoteManifestUrl);
+    header.versionUrl = strings.id(_remoteVersionUrl);
+    header.engineVersion = strings.id(_engineVer);
+    
+    uint64_t offset = sizeof(BinaryHeader);
+    header.stringOffsets = (uint32_t)offset;
+    offset += ((uint64_t)header.stringCount + 1) * sizeof(uint32_t);
+    header.stringData = (uint32_t)offset;
+    offset = align4((uint32_t)(offset + header.stringDataSize));
+    header.assets = (uint32_t)offset;
+    offset += (uint64_t)assetCount * sizeof(BinaryAsset);
+    header.buckets = (uint32_t)offset;
+    offset += (uint64_t)bucketCount * sizeof(uint32_t);
+    header.groups = (uint32_t)offset;
+    offset += (uint64_t)header.groupCount * 2 * sizeof(uint32_t);
+    header.searchPaths = (uint32_t)offset;
+    offset += (uint64_t)header.searchPathCount * sizeof(uint32_t);
+    if (offset > UINT32_MAX)
+    {
+        CCLOG("Manifest is too large for the binary format\n");
+        return false;
+    }
+    header.size = (uint32_t)offset;
+    
+    std::vector<unsigned char> buffer(header.size, 0);
+    unsigned char *data = buffer.data();
+    memcpy(data, &header, sizeof(header));
+    memcpy(data + header.stringOffsets, strings.offsets().data(), strings.offsets().size() * sizeof(uint32_t));
+    strings.writeData(data + header.stringData);
+    
+    BinaryAsset *records = (BinaryAsset*)(data + header.assets);
+    uint32_t *buckets = (uint32_t*)(data + header.buckets);
+    for (uint32_t i = 0; i < assetCount; ++i)
+    {
+        const std::string &key = assets[i].first;
+        const Asset &asset = assets[i].second;
+        BinaryAsset &record = records[i];
+        record.key = strings.id(key);
+        record.path = strings.id(asset.path);
+        record.md5 = strings.id(asset.md5);
+        record.size = asset.size > 0 ? (uint32_t)asset.size : 0;
+        record.compressed = asset.compressed ? 1 : 0;
+        record.downloadState = (int8_t)asset.downloadState;
+        
+        uint32_t slot = hashKey(key.c_str(), key.size()) & (bucketCount - 1);
+        while (buckets[slot] != 0)
+        {
+            slot = (slot + 1) & (bucketCount - 1);
+        }
+        buckets[slot] = i + 1;
+    }
+    
+    uint32_t *groups = (uint32_t*)(data + header.groups);
+    for (uint32_t i = 0; i < header.groupCount; ++i)
+    {
+        groups[i * 2] = strings.id(_groups[i]);
+        groups[i * 2 + 1] = strings.id(_groupVer.at(_groups[i]));
+    }
+    uint32_t *paths = (uint32_t*)(data + header.searchPaths);
+    for (uint32_t i = 0; i < header.searchPathCount; ++i)
+    {
+        paths[i] = strings.id(_searchPaths[i]);
+    }
+    
+    return writeFile(filepath, data, buffer.size());
+}
+
+bool Manifest::saveToJSONFile(const std::string &filepath) const
+{
+    if (!_versionLoaded)
+    {
+        return false;
+    }
+    
+    rapidjson::Document json;
+    json.SetObject();
+    rapidjson::Document::AllocatorType &allocator = json.GetAllocator();
+    auto addString = [&allocator](rapidjson::Value &object, const std::string &name, const std::string &str) {
+        rapidjson::Value nameValue(name.c_str(), (rapidjson::SizeType)name.size(), allocator);
+        rapidjson::Value value(str.c_str(), (rapidjson::SizeType)str.size(), allocator);
+        object.AddMember(nameValue, value, allocator);
+    };
+    
+    addString(json, KEY_PACKAGE_URL, _packageUrl);
+    addString(json, KEY_MANIFEST_URL, _remoteManifestUrl);
+    addString(json, KEY_VERSION_URL, _remoteVersionUrl);
+    addString(json, KEY_VERSION, _version);
+    if (!_groups.empty())
+    {
+        rapidjson::Value groupVers(rapidjson::kObjectType);
+        for (const auto &group : _groups)
+        {
+            addString(groupVers, group, _groupVer.at(group));
+        }
+        json.AddMember(KEY_GROUP_VERSIONS, groupVers, allocator);
+    }
+    if (!_engineVer.empty())
+    {
+        addString(json, KEY_ENGINE_VERSION, _engineVer);
+    }
+    if (_updating)
+    {
+        json.AddMember<bool>(KEY_UPDATING, _updating, allocator);
+    }
+    
+    std::vector<std::pair<std::string, Asset>> assets;
+    forEachAsset([&assets](const std::string &key, const Asset &asset) {
+        assets.emplace_back(key, asset);
+    });
+    std::sort(assets.begin(), assets.end(), [](const std::pair<std::string, Asset> &a, const std::pair<std::string, Asset> &b) {
+        return a.first < b.first;
+    });
+    
+    rapidjson::Value assetsValue(rapidjson::kObjectType);
+    for (const auto &it : assets)
+    {
+        const Asset &asset = it.second;
+        rapidjson::Value entry(rapidjson::kObjectType);
+        addString(entry, KEY_MD5, asset.md5);
+        if (asset.path != it.first)
+        {
+            addString(entry, KEY_PATH, asset.path);
+        }
+        if (asset.compressed)
+        {
+            entry.AddMember<bool>(KEY_COMPRESSED, true, allocator);
+        }
+        if (asset.size > 0)
+        {
+            entry.AddMember<int>(KEY_SIZE, (int)asset.size, allocator);
+        }
+        if (asset.downloadState != DownloadState::UNMARKED)
+        {
+            entry.AddMember<int>(KEY_DOWNLOAD_STATE, asset.downloadState, allocator);
+        }
+        rapidjson::Value key(it.first.c_str(), (rapidjson::SizeType)it.first.size(), allocator);
+        assetsValue.AddMember(key, entry, allocator);
+    }
+    json.AddMember(KEY_ASSETS, assetsValue, allocator);
+    
+    if (!_searchPaths.empty())
+    {
+        rapidjson::Value paths(rapidjson::kArrayType);
+        for (const auto &path : _searchPaths)
+        {
+            rapidjson::Value value(path.c_str(), (rapidjson::SizeType)path.size(), allocator);
+            paths.PushBack(value, allocator);
+        }
+        json.AddMember(KEY_SEARCH_PATHS, paths, allocator);
+    }
+    
+    rapidjson::StringBuffer buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+    json.Accept(writer);
+    return writeFile(filepath, buffer.GetString(), buffer.GetSize());
+}
+
 NS_CC_EXT_END
@@ -30,6 +30,7 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include <functional>
 
 #include "extensions/ExtensionMacros.h"
 #include "extensions/ExtensionExport.h"
@@ -95,6 +96,10 @@ public:
      */
     bool isLoaded() const;
     
+    /** @brief Check whether the manifest is loaded from the binary format
+     */
+    bool isBinary() const { return _binData != nullptr; }
+    
     /** @brief Gets remote package url.
      */
     const std::string& getPackageUrl() const;
@@ -130,7 +135,9 @@ public:
      */
     Manifest(const std::string& content, const std::string& manifestRoot);
     
-    /** @brief Parse the manifest file information into this manifest
+    virtual ~Manifest();
+    
+    /** @brief Parse the manifest file information into this manifest, both json and binary formats are accepted
      * @param manifestUrl Url of the local manifest
      */
     void parseFile(const std::string& manifestUrl);
@@ -151,6 +158,25 @@ public:
      */
     void setUpdating(bool updating);
     
+    /** @brief Find an asset without building the full assets map
+     * @param key   Key of the asset
+     * @param asset The asset found, it could be nullptr if only the existence is needed
+     * @return Whether the asset exists
+     */
+    bool findAsset(const std::string &key, Asset *asset) const;
+    
+    /** @brief Save the manifest in the binary format, the binary manifest is sorted, indexed and can be memory mapped by parseFile
+     * @param filepath  The output file path
+     * @return Whether the file is written
+     */
+    bool saveToBinaryFile(const std::string &filepath) const;
+    
+    /** @brief Save the manifest in the json format
+     * @param filepath  The output file path
+     * @return Whether the file is written
+     */
+    bool saveToJSONFile(const std::string &filepath) const;
+    
 protected:
     
     /** @brief Load the json file into local json object
@@ -163,6 +189,29 @@ protected:
      */
     void loadJsonFromString(const std::string& content);
     
+    /** @brief Map the binary manifest file privately, so that download states can be modified in place
+     * @param url Url of the binary file
+     * @return Whether the file is a valid binary manifest
+     */
+    bool loadBinary(const std::string& url);
+    
+    /** @brief Take a binary manifest buffer allocated by malloc, it's released if invalid
+     * @param data  The buffer
+     * @param size  The buffer size
+     * @return Whether the buffer is a valid binary manifest
+     */
+    bool loadBinaryFromBuffer(unsigned char *data, size_t size);
+    
+    void releaseBinary();
+    
+    void loadBinaryVersion();
+    
+    void loadBinaryManifest();
+    
+    /** @brief Iterate all assets, in the binary format assets are visited in key order
+     */
+    void forEachAsset(const std::function<void(const std::string &key, const Asset &asset)> &callback) const;
+    
     /** @brief Parse the version file information into this manifest
      * @param versionUrl Url of the local version file
      */
@@ -226,7 +275,7 @@ protected:
     const std::string& getGroupVersion(const std::string &group) const;
     
     /** 
-     * @brief Gets assets.
+     * @brief Gets assets, for a binary manifest the map is built on the first call.
      * @lua NA
      */
     const std::unordered_map<std::string, Asset>& getAssets() const;
@@ -277,13 +326,22 @@ private:
     //! The version of local engine
     std::string _engineVer;
     
-    //! Full assets list
-    std::unordered_map<std::string, Asset> _assets;
+    //! Full assets list, built on demand for a binary manifest
+    mutable std::unordered_map<std::string, Asset> _assets;
     
     //! All search paths
     std::vector<std::string> _searchPaths;
     
     rapidjson::Document _json;
+    
+    //! Binary manifest data, nullptr for a json manifest
+    unsigned char *_binData;
+    
+    //! Binary manifest data size
+    size_t _binSize;
+    
+    //! Whether the binary data is memory mapped or allocated
+    bool _binMapped;
 };
 
 NS_CC_EXT_END
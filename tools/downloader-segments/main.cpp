@@ -0,0 +1,601 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+/*
+ * Checks the segmented range downloads of the curl Downloader against a local HTTP/1.1 server, on the headless linux
+ * platform. The server throttles every connection to the given rate and serves one file twice: under /ranges/ with
+ * Accept-Ranges and 206 answers to Range requests, under /plain/ without range support. It can cut the next range
+ * responses after a number of bytes to make a segment fail. The cases run one after another:
+ * - a single stream download from /plain/ and a segmented one from /ranges/, both timed;
+ * - a data task, which writes into a buffer sized from the content length;
+ * - a download whose segment is cut, which must fail and keep the temp file and its journal,
+ *   then the same download again, which must resume and fetch less than the whole file;
+ * - a resume from a temp file left by a single stream download, which must fetch only the missing bytes;
+ * - a resume from a corrupted journal, which must start over.
+ * Every download must be byte-identical to the served file, and no temp file or journal may be left after a success.
+ * Exits with 0 if all cases pass, 1 on any failure or after a timeout.
+ *
+ *   downloader_segments [--size MB] [--rate MB/s] [--port P] [--dir DIR]
+ */
+
+#include "platform/CCApplication.h"
+#include "base/CCScheduler.h"
+#include "network/CCDownloader.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cocos2d;
+using namespace cocos2d::network;
+
+namespace
+{
+    const int DEFAULT_PORT = 18915;
+    const int DEFAULT_SIZE_MB = 24;
+    const int DEFAULT_RATE_MB = 16;
+    const char* DEFAULT_DIR = "/tmp/downloader_segments/";
+    // bytes of a range response sent before the connection is cut
+    const int64_t CUT_AFTER = 1024 * 1024;
+    const size_t SEND_CHUNK = 64 * 1024;
+    const float TIMEOUT_SECONDS = 300.0f;
+    const char* TIMEOUT_KEY = "downloader_segments_timeout";
+    // DownloaderHints of the default Downloader and the journal of DownloaderCURL
+    const char* TEMP_SUFFIX = ".tmp";
+    const char* JOURNAL_SUFFIX = ".journal";
+
+    typedef std::chrono::steady_clock Clock;
+
+    int s_failures = 0;
+
+#define SEGMENTS_CHECK(cond, ...) \
+    do { \
+        if (!(cond)) { \
+            s_failures++; \
+            fprintf(stderr, "FAILED %s:%d: %s: ", __FILE__, __LINE__, #cond); \
+            fprintf(stderr, __VA_ARGS__); \
+            fprintf(stderr, "\n"); \
+        } \
+    } while (0)
+
+    std::vector<unsigned char> makeContent(size_t size)
+    {
+        std::vector<unsigned char> content(size);
+        uint32_t x = 2463534242u;
+        for (size_t i = 0; i < size; ++i)
+        {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            content[i] = (unsigned char)x;
+        }
+        return content;
+    }
+
+    bool readFile(const std::string& path, std::vector<unsigned char>& out)
+    {
+        FILE* fp = fopen(path.c_str(), "rb");
+        if (!fp)
+            return false;
+        unsigned char buf[65536];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+            out.insert(out.end(), buf, buf + n);
+        fclose(fp);
+        return true;
+    }
+
+    bool writeFile(const std::string& path, const unsigned char* data, size_t size)
+    {
+        FILE* fp = fopen(path.c_str(), "wb");
+        if (!fp)
+            return false;
+        bool ok = fwrite(data, 1, size, fp) == size;
+        fclose(fp);
+        return ok;
+    }
+
+    bool fileExists(const std::string& path)
+    {
+        struct stat st;
+        return stat(path.c_str(), &st) == 0;
+    }
+
+    // HTTP/1.1 server of one file, one thread per connection, every connection throttled to the same rate
+    class LocalServer
+    {
+    public:
+        LocalServer(const std::vector<unsigned char>& content, int64_t bytesPerSecond)
+        : _content(content)
+        , _bytesPerSecond(bytesPerSecond)
+        {
+        }
+
+        bool start(int port)
+        {
+            _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+            if (_listenFd < 0)
+                return false;
+
+            int on = 1;
+            setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            sockaddr_in addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons((uint16_t)port);
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (bind(_listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(_listenFd, 32) != 0)
+            {
+                close(_listenFd);
+                _listenFd = -1;
+                return false;
+            }
+
+            _acceptThread = std::thread([this]() { acceptLoop(); });
+            return true;
+        }
+
+        void stop()
+        {
+            if (_listenFd < 0)
+                return;
+
+            _quit = true;
+            shutdown(_listenFd, SHUT_RDWR);
+            _acceptThread.join();
+            close(_listenFd);
+            _listenFd = -1;
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (int fd : _connectionFds)
+                shutdown(fd, SHUT_RDWR);
+            for (auto& t : _connectionThreads)
+                t.join();
+            for (int fd : _connectionFds)
+                close(fd);
+            _connectionThreads.clear();
+            _connectionFds.clear();
+        }
+
+        void resetStats()
+        {
+            _rangeRequests = 0;
+            _fullRequests = 0;
+            _bodyBytes = 0;
+        }
+
+        // the next count range responses are cut after CUT_AFTER bytes
+        void cutNextRanges(int count) { _cutRanges = count; }
+
+        int getRangeRequests() const { return _rangeRequests; }
+        int getFullRequests() const { return _fullRequests; }
+        int64_t getBodyBytes() const { return _bodyBytes; }
+
+    private:
+        void acceptLoop()
+        {
+            while (!_quit)
+            {
+                int fd = accept(_listenFd, nullptr, nullptr);
+                if (fd < 0)
+                    break;
+
+                std::lock_guard<std::mutex> lock(_mutex);
+                _connectionFds.push_back(fd);
+                _connectionThreads.emplace_back([this, fd]() { serve(fd); });
+            }
+        }
+
+        static std::string headerValue(const std::string& request, const char* name)
+        {
+            std::string key = std::string("\r\n") + name + ":";
+            auto it = std::search(request.begin(), request.end(), key.begin(), key.end(), [](char a, char b) {
+                return tolower((unsigned char)a) == tolower((unsigned char)b);
+            });
+            if (it == request.end())
+                return "";
+            size_t begin = (it - request.begin()) + key.size();
+            size_t end = request.find("\r\n", begin);
+            std::string value = request.substr(begin, end - begin);
+            value.erase(0, value.find_first_not_of(' '));
+            return value;
+        }
+
+        bool sendAll(int fd, const char* data, size_t size)
+        {
+            while (size > 0)
+            {
+                ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+                if (n <= 0)
+                    return false;
+                data += n;
+                size -= n;
+            }
+            return true;
+        }
+
+        // sends [begin, end) of the content at the throttled rate, stops after limit bytes
+        bool sendBody(int fd, int64_t begin, int64_t end, int64_t limit)
+        {
+            auto start = Clock::now();
+            int64_t sent = 0;
+            int64_t total = std::min(end - begin, limit);
+            while (sent < total && !_quit)
+            {
+                size_t chunk = (size_t)std::min<int64_t>(SEND_CHUNK, total - sent);
+                if (!sendAll(fd, (const char*)_content.data() + begin + sent, chunk))
+                    return false;
+                sent += chunk;
+                _bodyBytes += chunk;
+
+                auto due = start + std::chrono::microseconds(sent * 1000000 / _bytesPerSecond);
+                std::this_thread::sleep_until(due);
+            }
+            return sent == end - begin;
+        }
+
+        void serve(int fd)
+        {
+            std::string buffer;
+            char chunk[4096];
+            int64_t size = (int64_t)_content.size();
+            while (!_quit)
+            {
+                size_t headerEnd = buffer.find("\r\n\r\n");
+                if (headerEnd == std::string::npos)
+                {
+                    ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                    if (n <= 0)
+                        break;
+                    buffer.append(chunk, n);
+                    continue;
+                }
+
+                std::string request = buffer.substr(0, headerEnd + 2);
+                buffer.erase(0, headerEnd + 4);
+                bool head = request.compare(0, 5, "HEAD ") == 0;
+                size_t pathStart = request.find(' ') + 1;
+                std::string path = request.substr(pathStart, request.find(' ', pathStart) - pathStart);
+                bool ranges = path.compare(0, 8, "/ranges/") == 0;
+                if (!ranges && path.compare(0, 7, "/plain/") != 0)
+                {
+                    std::string notFound = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+                    sendAll(fd, notFound.data(), notFound.size());
+                    continue;
+                }
+
+                // "bytes=begin-" or "bytes=begin-last"
+                int64_t begin = 0;
+                int64_t end = size;
+                std::string range = headerValue(request, "Range");
+                bool partial = ranges && range.compare(0, 6, "bytes=") == 0;
+                if (partial)
+                {
+                    char* next = nullptr;
+                    begin = strtoll(range.c_str() + 6, &next, 10);
+                    if (next && *next == '-' && next[1] != '\0')
+                        end = std::min<int64_t>(size, strtoll(next + 1, nullptr, 10) + 1);
+                }
+
+                std::string response = partial ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n";
+                response += "Content-Length: " + std::to_string(end - begin) + "\r\n";
+                if (ranges)
+                    response += "Accept-Ranges: bytes\r\n";
+                if (partial)
+                    response += "Content-Range: bytes " + std::to_string(begin) + "-" + std::to_string(end - 1) + "/" + std::to_string(size) + "\r\n";
+                response += "\r\n";
+                if (!sendAll(fd, response.data(), response.size()))
+                    break;
+                if (head)
+                    continue;
+
+                int64_t limit = end - begin;
+                if (partial)
+                {
+                    _rangeRequests++;
+                    if (_cutRanges.fetch_sub(1) > 0)
+                        limit = CUT_AFTER;
+                }
+                else
+                {
+                    _fullRequests++;
+                }
+                if (!sendBody(fd, begin, end, limit))
+                    break;
+            }
+            // closed by stop, so the descriptor is not reused while stop shuts the connections down
+            shutdown(fd, SHUT_RDWR);
+        }
+
+        const std::vector<unsigned char>& _content;
+        int64_t _bytesPerSecond;
+        int _listenFd = -1;
+        std::atomic<bool> _quit{false};
+        std::atomic<int> _cutRanges{0};
+        std::atomic<int> _rangeRequests{0};
+        std::atomic<int> _fullRequests{0};
+        std::atomic<int64_t> _bodyBytes{0};
+        std::thread _acceptThread;
+        std::mutex _mutex;
+        std::vector<int> _connectionFds;
+        std::vector<std::thread> _connectionThreads;
+    };
+
+    struct Case
+    {
+        const char* name;
+        const char* path;
+        bool dataTask;
+        bool expectSuccess;
+        // prepares files and the server before the download starts
+        std::function<void()> prepare;
+        // checks the server after the download
+        std::function<void()> verify;
+    };
+
+    class SegmentsApp : public Application
+    {
+    public:
+        SegmentsApp(int port, size_t size, int64_t bytesPerSecond, const std::string& dir)
+        : Application("downloader_segments", 1, 1)
+        , _port(port)
+        , _dir(dir)
+        , _content(makeContent(size))
+        , _server(_content, bytesPerSecond)
+        {
+            _storagePath = _dir + "file.bin";
+            _tempPath = _storagePath + TEMP_SUFFIX;
+            _journalPath = _tempPath + JOURNAL_SUFFIX;
+        }
+
+        virtual bool applicationDidFinishLaunching() override
+        {
+            setPreferredFramesPerSecond(1000);
+
+            mkdir(_dir.c_str(), 0755);
+            bool listening = _server.start(_port);
+            SEGMENTS_CHECK(listening, "can not listen on port %d", _port);
+            if (!listening)
+            {
+                end();
+                return true;
+            }
+
+            addCases();
+
+            _downloader.reset(new Downloader());
+            _downloader->onFileTaskSuccess = [this](const DownloadTask& task) {
+                finishCase(true, nullptr, "");
+            };
+            _downloader->onDataTaskSuccess = [this](const DownloadTask& task, std::vector<unsigned char>& data) {
+                finishCase(true, &data, "");
+            };
+            _downloader->onTaskError = [this](const DownloadTask& task, int errorCode, int errorCodeInternal, const std::string& errorStr) {
+                finishCase(false, nullptr, errorStr);
+            };
+
+            getScheduler()->schedule([](float) {
+                SEGMENTS_CHECK(false, "timed out");
+                Application::getInstance()->end();
+            }, this, TIMEOUT_SECONDS, 0, 0.0f, false, TIMEOUT_KEY);
+
+            startCase();
+            return true;
+        }
+
+        void finish()
+        {
+            getScheduler()->unscheduleAll();
+            _downloader.reset();
+            _server.stop();
+            removeFiles();
+
+            printf("downloader segments: %d of %d cases, %d failures\n", _current, (int)_cases.size(), s_failures);
+            if (_singleSeconds > 0.0 && _segmentedSeconds > 0.0)
+            {
+                printf("%zu bytes: single stream %.3f s, segmented %.3f s, %.2fx\n",
+                       _content.size(), _singleSeconds, _segmentedSeconds, _singleSeconds / _segmentedSeconds);
+            }
+        }
+
+    private:
+        void removeFiles()
+        {
+            remove(_storagePath.c_str());
+            remove(_tempPath.c_str());
+            remove(_journalPath.c_str());
+        }
+
+        void addCases()
+        {
+            int64_t size = (int64_t)_content.size();
+
+            _cases.push_back({"single stream", "/plain/", false, true, [this]() {
+                removeFiles();
+            }, [this]() {
+                SEGMENTS_CHECK(_server.getFullRequests() == 1 && _server.getRangeRequests() == 0,
+                               "%d full and %d range requests", _server.getFullRequests(), _server.getRangeRequests());
+                _singleSeconds = _caseSeconds;
+            }});
+
+            _cases.push_back({"segmented", "/ranges/", false, true, [this]() {
+                removeFiles();
+            }, [this]() {
+                SEGMENTS_CHECK(_server.getRangeRequests() >= 2, "%d range requests", _server.getRangeRequests());
+                _segmentedSeconds = _caseSeconds;
+            }});
+
+            _cases.push_back({"data task", "/ranges/", true, true, nullptr, nullptr});
+
+            _cases.push_back({"cut segment", "/ranges/", false, false, [this]() {
+                removeFiles();
+                _server.cutNextRanges(1);
+            }, [this]() {
+                _server.cutNextRanges(0);
+                SEGMENTS_CHECK(fileExists(_tempPath) && fileExists(_journalPath), "temp file or journal removed after the failure");
+                SEGMENTS_CHECK(!fileExists(_storagePath), "unfinished file renamed to the storage path");
+            }});
+
+            _cases.push_back({"resume segments", "/ranges/", false, true, nullptr, [this, size]() {
+                SEGMENTS_CHECK(_server.getBodyBytes() < size, "fetched %lld bytes again", (long long)_server.getBodyBytes());
+            }});
+
+            int64_t legacy = size / 3;
+            _cases.push_back({"legacy temp file", "/ranges/", false, true, [this, legacy]() {
+                removeFiles();
+                writeFile(_tempPath, _content.data(), (size_t)legacy);
+            }, [this, size, legacy]() {
+                SEGMENTS_CHECK(_server.getBodyBytes() == size - legacy, "fetched %lld bytes, %lld missing",
+                               (long long)_server.getBodyBytes(), (long long)(size - legacy));
+            }});
+
+            _cases.push_back({"corrupted journal", "/ranges/", false, true, [this, size]() {
+                removeFiles();
+                std::vector<unsigned char> garbage(_content.rbegin(), _content.rend());
+                writeFile(_tempPath, garbage.data(), garbage.size());
+                writeFile(_journalPath, garbage.data(), 40);
+            }, [this, size]() {
+                SEGMENTS_CHECK(_server.getBodyBytes() == size, "fetched %lld of %lld bytes",
+                               (long long)_server.getBodyBytes(), (long long)size);
+            }});
+        }
+
+        void startCase()
+        {
+            if (_current >= (int)_cases.size())
+            {
+                end();
+                return;
+            }
+
+            const Case& c = _cases[_current];
+            if (c.prepare)
+                c.prepare();
+            _server.resetStats();
+            _caseStart = Clock::now();
+
+            std::string url = "http://127.0.0.1:" + std::to_string(_port) + c.path + "file.bin";
+            if (c.dataTask)
+                _downloader->createDownloadDataTask(url, c.name);
+            else
+                _downloader->createDownloadFileTask(url, _storagePath, c.name);
+        }
+
+        void finishCase(bool success, const std::vector<unsigned char>* data, const std::string& error)
+        {
+            const Case& c = _cases[_current];
+            _caseSeconds = std::chrono::duration<double>(Clock::now() - _caseStart).count();
+            SEGMENTS_CHECK(success == c.expectSuccess, "%s: %s %s", c.name, success ? "succeeded" : "failed", error.c_str());
+
+            if (success && c.dataTask)
+            {
+                SEGMENTS_CHECK(data && *data == _content, "%s: data differs", c.name);
+            }
+            else if (success)
+            {
+                std::vector<unsigned char> file;
+                SEGMENTS_CHECK(readFile(_storagePath, file) && file == _content, "%s: file differs", c.name);
+                SEGMENTS_CHECK(!fileExists(_tempPath) && !fileExists(_journalPath), "%s: temp file or journal left", c.name);
+            }
+            if (c.verify)
+                c.verify();
+
+            printf("%-18s %s in %.3f s, %d range and %d full requests, %lld bytes\n", c.name, success ? "succeeded" : "failed",
+                   _caseSeconds, _server.getRangeRequests(), _server.getFullRequests(), (long long)_server.getBodyBytes());
+
+            // the next task is created outside of the callback of this one
+            _current++;
+            getScheduler()->performFunctionInCocosThread([this]() { startCase(); });
+        }
+
+        int _port;
+        std::string _dir;
+        std::string _storagePath;
+        std::string _tempPath;
+        std::string _journalPath;
+        std::vector<unsigned char> _content;
+        LocalServer _server;
+        std::unique_ptr<Downloader> _downloader;
+        std::vector<Case> _cases;
+        int _current = 0;
+        Clock::time_point _caseStart;
+        double _caseSeconds = 0.0;
+        double _singleSeconds = 0.0;
+        double _segmentedSeconds = 0.0;
+    };
+}
+
+int main(int argc, char** argv)
+{
+    int port = DEFAULT_PORT;
+    int sizeMB = DEFAULT_SIZE_MB;
+    int rateMB = DEFAULT_RATE_MB;
+    std::string dir = DEFAULT_DIR;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+        {
+            sizeMB = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+        {
+            rateMB = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+        {
+            port = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc)
+        {
+            dir = argv[++i];
+            if (dir.back() != '/')
+                dir += '/';
+        }
+        else
+        {
+            printf("usage: downloader_segments [--size MB] [--rate MB/s] [--port P] [--dir DIR]\n");
+            return 1;
+        }
+    }
+
+    SegmentsApp* app = new SegmentsApp(port, (size_t)sizeMB * 1024 * 1024, (int64_t)rateMB * 1024 * 1024, dir);
+    app->start();
+    app->finish();
+    delete app;
+
+    return s_failures == 0 ? 0 : 1;
+}
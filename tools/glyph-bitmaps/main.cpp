@@ -0,0 +1,208 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+/*
+ * Compares the glyph bitmaps FontFreeType::getGlyphBitmaps rasterizes on the job system, with the pooled faces,
+ * against the ones getGlyphBitmap renders one by one with the face of the cocos thread, on the headless linux
+ * platform. Plain and SDF bitmaps are compared for every font, pixels, size, rect, advance, outline and pixel mode
+ * included, and a letter without a glyph has to be missing in both. Every round loads the font again, so faces
+ * are created, reused and freed with their libraries. Prints the time of both paths per font and mode.
+ * Exits with 0 if every bitmap matched, 1 otherwise. Run it under TSan or ASan to check the face pool.
+ *
+ *   glyph_bitmaps [--workers N] [--size PX] [--rounds N] [--cjk] font.ttf [font.ttf ...]
+ */
+
+#include "2d/CCFontFreetype.h"
+#include "2d/CCTTFTypes.h"
+#include "renderer/scene/JobSystem.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace cocos2d;
+
+namespace
+{
+    const int DEFAULT_WORKERS = 4;
+    const float DEFAULT_FONT_SIZE = 32.0f;
+    const int DEFAULT_ROUNDS = 3;
+
+    const char32_t* CJK_TEXT = U"的一是不了人我在有他这中大来上国个到说们为子和你地出道也时年得就那要下以生会自着去之过家学对可她里后小么心多天而能好都然没日于起还发成事只作当想看文无开手十用主行方又如前所本见经头面公同三已老从动两长知民样现分将外但身些与高意进把法此实回二理美点月明其种声全工己话儿者向情部正名定女问力机给等几很业最间新什打便位因重被走电四第门相次东政海口使教西再平真听世气信北少关并内加化由却代军产入先山五太水万市眼体别处总才场师书比住员九笑性通目华报立马命张活难神数件安表原车白应路期叫死常提感金何更反合放做系计或司利受光王果亲界及今京务制解各任至清物台象记边共风战干接它许八特觉望直服毛林题建南度统色字请交爱让认算论百吃义科怎元社术结六功指思非流每青管夫连远资队跟带花快条院变联言权往展该领传近留红治决周保达办运武半候七必城父强步完革深区即求品士转量空甚众技轻程告江语英基派满式李息写呢识极令黄德收脸钱党倒未持取设始版双历越史商千片容研像找友孩站广改议形委早房音火际则首单据导影失拿网香似斯专石若兵弟谁校读志飞观争究包组造落视济喜离虽坐集编宝谈府拉黑且随格尽剑讲布杀微怕母调局根曾准团段终乐切级克精哪官示冷域あいうえおかきくけこさしすせそアイウエオカキクケコ";
+
+    struct Result
+    {
+        int glyphs = 0;
+        int missing = 0;
+        int mismatches = 0;
+        double serialMs = 0.0;
+        double parallelMs = 0.0;
+    };
+
+    double elapsedMs(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool sameBitmap(const std::shared_ptr<GlyphBitmap>& a, const std::shared_ptr<GlyphBitmap>& b)
+    {
+        if (!a || !b)
+        {
+            return !a && !b;
+        }
+        return a->getWidth() == b->getWidth() && a->getHeight() == b->getHeight()
+            && a->getRect().equals(b->getRect()) && a->getXAdvance() == b->getXAdvance()
+            && a->getOutline() == b->getOutline() && a->getPixelMode() == b->getPixelMode()
+            && a->getData() == b->getData();
+    }
+
+    bool compareFont(const char* path, float fontSize, const std::vector<unsigned long>& chars, bool sdf, int rounds, Result& result)
+    {
+        LabelLayoutInfo info;
+        for (int round = 0; round < rounds; round++)
+        {
+            FontFreeType font(path, fontSize, &info);
+            if (!font.loadFont())
+            {
+                return false;
+            }
+
+            // twice per font, the second batch runs on the faces the first one left in the pool
+            for (int batch = 0; batch < 2; batch++)
+            {
+                std::vector<std::shared_ptr<GlyphBitmap>> parallel;
+                auto start = std::chrono::steady_clock::now();
+                font.getGlyphBitmaps(chars, sdf, parallel);
+                result.parallelMs += elapsedMs(start);
+
+                std::vector<std::shared_ptr<GlyphBitmap>> serial;
+                serial.reserve(chars.size());
+                start = std::chrono::steady_clock::now();
+                for (unsigned long ch : chars)
+                {
+                    serial.push_back(font.getGlyphBitmap(ch, sdf));
+                }
+                result.serialMs += elapsedMs(start);
+
+                if (parallel.size() != serial.size())
+                {
+                    printf("  %zu bitmaps, %zu expected\n", parallel.size(), serial.size());
+                    result.mismatches++;
+                    continue;
+                }
+                for (size_t i = 0; i < chars.size(); i++)
+                {
+                    if (round == 0 && batch == 0)
+                    {
+                        result.glyphs += serial[i] ? 1 : 0;
+                        result.missing += serial[i] ? 0 : 1;
+                    }
+                    if (!sameBitmap(parallel[i], serial[i]) && result.mismatches++ == 0)
+                    {
+                        printf("  U+%04X differs in round %d\n", (unsigned)chars[i], round);
+                    }
+                }
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int workers = DEFAULT_WORKERS;
+    float fontSize = DEFAULT_FONT_SIZE;
+    int rounds = DEFAULT_ROUNDS;
+    bool cjk = false;
+    std::vector<const char*> fonts;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+        {
+            workers = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+        {
+            fontSize = std::max(1.0f, (float)atof(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+        {
+            rounds = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--cjk") == 0)
+        {
+            cjk = true;
+        }
+        else
+        {
+            fonts.push_back(argv[i]);
+        }
+    }
+    if (fonts.empty())
+    {
+        printf("usage: glyph_bitmaps [--workers N] [--size PX] [--rounds N] [--cjk] font.ttf [font.ttf ...]\n");
+        return 1;
+    }
+
+    std::vector<unsigned long> chars;
+    for (unsigned long ch = 0x21; ch < 0x7f; ch++) chars.push_back(ch);
+    for (unsigned long ch = 0xc0; ch < 0x100; ch++) chars.push_back(ch);
+    if (cjk)
+    {
+        for (const char32_t* p = CJK_TEXT; *p; p++) chars.push_back(*p);
+    }
+
+    // without a job system getGlyphBitmaps would rasterize serially on this thread
+    renderer::JobSystem jobSystem(workers);
+
+    bool ok = true;
+    for (const char* path : fonts)
+    {
+        const char* name = strrchr(path, '/') ? strrchr(path, '/') + 1 : path;
+        for (bool sdf : { false, true })
+        {
+            Result result;
+            if (!compareFont(path, fontSize, chars, sdf, rounds, result))
+            {
+                printf("%s: can not load font\n", path);
+                ok = false;
+                break;
+            }
+
+            ok &= result.mismatches == 0;
+            printf("%-26s %2.0fpx %-5s glyphs %4d  missing %3d  mismatches %3d  serial %8.2fms  %d workers %8.2fms  %.2fx  %s\n",
+                   name, fontSize, sdf ? "sdf" : "plain", result.glyphs, result.missing, result.mismatches,
+                   result.serialMs, workers, result.parallelMs,
+                   result.parallelMs > 0.0 ? result.serialMs / result.parallelMs : 0.0,
+                   result.mismatches == 0 ? "ok" : "FAILED");
+        }
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,333 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+/*
+ * Throughput of the curl HttpClient against a local keep-alive HTTP/1.1 server, on the headless linux platform.
+ * The server answers every GET after the given latency with a body derived from the path, on one thread per connection,
+ * and counts the connections it accepts. All requests are sent at once, like the fan out at login, and every response
+ * is checked for its status and body. Prints the requests per second and how many requests each connection served.
+ * Exits with 0 if every request succeeded, 1 on any failure or after a timeout.
+ *
+ *   http_throughput [--requests N] [--connections N] [--latency MS] [--port P]
+ *
+ * --connections is HttpClient::setMaxConnectionsPerHost, with 1 the requests run one after another.
+ */
+
+#include "platform/CCApplication.h"
+#include "base/CCScheduler.h"
+#include "network/HttpClient.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cocos2d;
+using namespace cocos2d::network;
+
+namespace
+{
+    const int DEFAULT_PORT = 18914;
+    const int DEFAULT_REQUESTS = 300;
+    const int DEFAULT_CONNECTIONS = 6;
+    const int DEFAULT_LATENCY_MS = 20;
+    const float TIMEOUT_SECONDS = 120.0f;
+    const char* TIMEOUT_KEY = "http_throughput_timeout";
+
+    typedef std::chrono::steady_clock Clock;
+
+    int s_failures = 0;
+
+#define THROUGHPUT_CHECK(cond, ...) \
+    do { \
+        if (!(cond)) { \
+            s_failures++; \
+            fprintf(stderr, "FAILED %s:%d: %s: ", __FILE__, __LINE__, #cond); \
+            fprintf(stderr, __VA_ARGS__); \
+            fprintf(stderr, "\n"); \
+        } \
+    } while (0)
+
+    std::string makeBody(const std::string& path)
+    {
+        return "response of " + path;
+    }
+
+    // keep-alive HTTP/1.1 server answering GET requests, one thread per connection
+    class LocalServer
+    {
+    public:
+        bool start(int port, int latencyMs)
+        {
+            _latencyMs = latencyMs;
+            _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+            if (_listenFd < 0)
+                return false;
+
+            int on = 1;
+            setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            sockaddr_in addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons((uint16_t)port);
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (bind(_listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(_listenFd, 128) != 0)
+            {
+                close(_listenFd);
+                _listenFd = -1;
+                return false;
+            }
+
+            _acceptThread = std::thread([this]() { acceptLoop(); });
+            return true;
+        }
+
+        void stop()
+        {
+            if (_listenFd < 0)
+                return;
+
+            _quit = true;
+            shutdown(_listenFd, SHUT_RDWR);
+            _acceptThread.join();
+            close(_listenFd);
+            _listenFd = -1;
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (int fd : _connectionFds)
+                shutdown(fd, SHUT_RDWR);
+            for (auto& t : _connectionThreads)
+                t.join();
+            for (int fd : _connectionFds)
+                close(fd);
+            _connectionThreads.clear();
+            _connectionFds.clear();
+        }
+
+        int getConnectionCount() const { return _connectionCount; }
+        int getRequestCount() const { return _requestCount; }
+
+    private:
+        void acceptLoop()
+        {
+            while (!_quit)
+            {
+                int fd = accept(_listenFd, nullptr, nullptr);
+                if (fd < 0)
+                    break;
+
+                std::lock_guard<std::mutex> lock(_mutex);
+                _connectionCount++;
+                _connectionFds.push_back(fd);
+                _connectionThreads.emplace_back([this, fd]() { serve(fd); });
+            }
+        }
+
+        void serve(int fd)
+        {
+            std::string buffer;
+            char chunk[4096];
+            while (!_quit)
+            {
+                size_t headerEnd = buffer.find("\r\n\r\n");
+                if (headerEnd == std::string::npos)
+                {
+                    ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                    if (n <= 0)
+                        break;
+                    buffer.append(chunk, n);
+                    continue;
+                }
+
+                // "GET /path HTTP/1.1", requests carry no body
+                size_t pathStart = buffer.find(' ') + 1;
+                size_t pathEnd = buffer.find(' ', pathStart);
+                std::string path = buffer.substr(pathStart, pathEnd - pathStart);
+                buffer.erase(0, headerEnd + 4);
+
+                if (_latencyMs > 0)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(_latencyMs));
+
+                std::string body = makeBody(path);
+                std::string response = "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: "
+                    + std::to_string(body.size()) + "\r\nConnection: keep-alive\r\n\r\n" + body;
+                if (send(fd, response.data(), response.size(), MSG_NOSIGNAL) != (ssize_t)response.size())
+                    break;
+                _requestCount++;
+            }
+            // closed by stop, so the descriptor is not reused while stop shuts the connections down
+        }
+
+        int _listenFd = -1;
+        int _latencyMs = 0;
+        std::atomic<bool> _quit{false};
+        std::atomic<int> _connectionCount{0};
+        std::atomic<int> _requestCount{0};
+        std::thread _acceptThread;
+        std::mutex _mutex;
+        std::vector<int> _connectionFds;
+        std::vector<std::thread> _connectionThreads;
+    };
+
+    class ThroughputApp : public Application
+    {
+    public:
+        ThroughputApp(int port, int requests, int connections, int latencyMs)
+        : Application("http_throughput", 1, 1)
+        , _port(port)
+        , _requests(requests)
+        , _connections(connections)
+        , _latencyMs(latencyMs)
+        {
+        }
+
+        virtual bool applicationDidFinishLaunching() override
+        {
+            // responses are dispatched once per frame, a high frame rate keeps that out of the numbers
+            setPreferredFramesPerSecond(1000);
+
+            bool listening = _server.start(_port, _latencyMs);
+            THROUGHPUT_CHECK(listening, "can not listen on port %d", _port);
+            if (!listening)
+            {
+                end();
+                return true;
+            }
+
+            HttpClient* client = HttpClient::getInstance();
+            client->setMaxConnectionsPerHost(_connections);
+
+            _start = Clock::now();
+            for (int i = 0; i < _requests; ++i)
+            {
+                std::string path = "/item/" + std::to_string(i);
+                HttpRequest* request = new HttpRequest();
+                request->setUrl("http://127.0.0.1:" + std::to_string(_port) + path);
+                request->setRequestType(HttpRequest::Type::GET);
+                request->setResponseCallback([this, path](HttpClient* sender, HttpResponse* response) {
+                    onResponse(path, response);
+                });
+                client->send(request);
+                request->release();
+            }
+
+            getScheduler()->schedule([](float) {
+                THROUGHPUT_CHECK(false, "timed out");
+                Application::getInstance()->end();
+            }, this, TIMEOUT_SECONDS, 0, 0.0f, false, TIMEOUT_KEY);
+            return true;
+        }
+
+        void finish()
+        {
+            getScheduler()->unscheduleAll();
+            HttpClient::destroyInstance();
+            _server.stop();
+
+            double seconds = std::chrono::duration<double>(_end - _start).count();
+            int connections = _server.getConnectionCount();
+            printf("http throughput: %d of %d requests, %d per host, %d ms latency, %d failures\n",
+                   _received, _requests, _connections, _latencyMs, s_failures);
+            if (_received == _requests && seconds > 0.0)
+            {
+                printf("%.3f s, %.1f requests/s, %d connections, %.1f requests per connection\n",
+                       seconds, _requests / seconds, connections, connections > 0 ? (double)_server.getRequestCount() / connections : 0.0);
+            }
+        }
+
+    private:
+        void onResponse(const std::string& path, HttpResponse* response)
+        {
+            THROUGHPUT_CHECK(response->isSucceed(), "%s failed: %s", path.c_str(), response->getErrorBuffer());
+            THROUGHPUT_CHECK(response->getResponseCode() == 200, "%s answered %ld", path.c_str(), response->getResponseCode());
+            std::vector<char>* data = response->getResponseData();
+            std::string body(data->begin(), data->end());
+            THROUGHPUT_CHECK(body == makeBody(path), "%s has the wrong body: %s", path.c_str(), body.c_str());
+
+            if (++_received == _requests)
+            {
+                _end = Clock::now();
+                end();
+            }
+        }
+
+        int _port;
+        int _requests;
+        int _connections;
+        int _latencyMs;
+        int _received = 0;
+        Clock::time_point _start;
+        Clock::time_point _end;
+        LocalServer _server;
+    };
+}
+
+int main(int argc, char** argv)
+{
+    int port = DEFAULT_PORT;
+    int requests = DEFAULT_REQUESTS;
+    int connections = DEFAULT_CONNECTIONS;
+    int latencyMs = DEFAULT_LATENCY_MS;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--requests") == 0 && i + 1 < argc)
+        {
+            requests = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--connections") == 0 && i + 1 < argc)
+        {
+            connections = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--latency") == 0 && i + 1 < argc)
+        {
+            latencyMs = std::max(0, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+        {
+            port = atoi(argv[++i]);
+        }
+        else
+        {
+            printf("usage: http_throughput [--requests N] [--connections N] [--latency MS] [--port P]\n");
+            return 1;
+        }
+    }
+
+    ThroughputApp* app = new ThroughputApp(port, requests, connections, latencyMs);
+    app->start();
+    app->finish();
+    delete app;
+
+    return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,426 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+/*
+ * Checks the binary manifest format of the assets manager against the json one, on the headless linux platform.
+ * Two json project manifests are generated, the second one with modified, deleted and added assets, and converted
+ * with saveToBinaryFile. The binary manifests must give the same version, lookups, diffs, getAssets and resume
+ * lists as the json ones, in pure and mixed pairs. Download states and the updating flag are saved and reloaded,
+ * the mapped source file must stay untouched, a resave must be byte identical and a conversion back to json and
+ * again to binary must give the same file. Last, corrupted and truncated copies are loaded, they must either be
+ * rejected or stay usable. Prints the load times of both formats.
+ * Exits with 0 if every check passed, 1 otherwise.
+ *
+ *   manifest_binary [--assets N] [--corrupt N] [--dir DIR]
+ */
+
+#include "extensions/assets-manager/Manifest.h"
+
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+using namespace cocos2d;
+using namespace cocos2d::extension;
+
+namespace
+{
+    const int DEFAULT_ASSETS = 40000;
+    const int DEFAULT_CORRUPT = 300;
+    const char* DEFAULT_DIR = "/tmp/manifest_binary/";
+
+    // the second manifest modifies every MODIFY_EVERY asset, drops every DELETE_EVERY one and adds ADDED_ASSETS
+    const int MODIFY_EVERY = 10;
+    const int DELETE_EVERY = 33;
+    const int ADDED_ASSETS = 50;
+
+    typedef std::chrono::steady_clock Clock;
+
+    int s_failures = 0;
+
+#define MANIFEST_CHECK(cond, ...) \
+    do { \
+        if (!(cond)) { \
+            s_failures++; \
+            fprintf(stderr, "FAILED %s:%d: %s: ", __FILE__, __LINE__, #cond); \
+            fprintf(stderr, __VA_ARGS__); \
+            fprintf(stderr, "\n"); \
+        } \
+    } while (0)
+
+    // exposes the protected parts AssetsManagerEx uses
+    class ManifestProbe : public Manifest
+    {
+    public:
+        ManifestProbe(const std::string& manifestUrl = "")
+        : Manifest(manifestUrl)
+        {
+        }
+
+        using Manifest::parseVersion;
+        using Manifest::versionEquals;
+        using Manifest::genDiff;
+        using Manifest::genResumeAssetsList;
+        using Manifest::saveToFile;
+        using Manifest::getGroups;
+        using Manifest::getAssets;
+        using Manifest::setAssetDownloadState;
+    };
+
+    double millisecondsSince(const Clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::string assetKey(int i)
+    {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "res/import/%02x/%08x.json", i & 255, (unsigned)(i * 2654435761u));
+        return buffer;
+    }
+
+    std::string makeManifest(int assets, int seed)
+    {
+        std::string json = "{\n";
+        json += "    \"packageUrl\": \"http://127.0.0.1/remote-assets/\",\n";
+        json += "    \"remoteManifestUrl\": \"http://127.0.0.1/remote-assets/project.manifest\",\n";
+        json += "    \"remoteVersionUrl\": \"http://127.0.0.1/remote-assets/version.manifest\",\n";
+        json += "    \"version\": \"1.0." + std::to_string(seed) + "\",\n";
+        json += "    \"groupVersions\": {\"1\": \"1.0.1\", \"2\": \"1.0." + std::to_string(seed + 2) + "\"},\n";
+        json += "    \"engineVersion\": \"2.4\",\n";
+        json += "    \"assets\": {\n";
+
+        bool first = true;
+        auto addAsset = [&json, &first](const std::string& key, const std::string& path, const std::string& md5, bool compressed, int size, int state) {
+            json += first ? "        \"" : ",\n        \"";
+            first = false;
+            json += key + "\": {\"md5\": \"" + md5 + "\"";
+            if (path != key)
+                json += ", \"path\": \"" + path + "\"";
+            if (compressed)
+                json += ", \"compressed\": true";
+            if (size > 0)
+                json += ", \"size\": " + std::to_string(size);
+            if (state != Manifest::DownloadState::UNMARKED)
+                json += ", \"downloadState\": " + std::to_string(state);
+            json += "}";
+        };
+
+        for (int i = 0; i < assets; ++i)
+        {
+            if (seed > 0 && i % DELETE_EVERY == 0)
+                continue;
+
+            std::string key = assetKey(i);
+            // some assets are stored under another path than their key
+            std::string path = i % 17 == 0 ? key + ".bin" : key;
+            std::string md5 = std::to_string(seed > 0 && i % MODIFY_EVERY == 0 ? i * 7 + seed : i * 7);
+            md5.resize(32, 'a');
+            addAsset(key, path, md5, i % 13 == 0, i * 10, i % 4);
+        }
+        for (int i = 0; seed > 0 && i < ADDED_ASSETS; ++i)
+        {
+            std::string key = "res/added/" + std::to_string(i) + ".png";
+            addAsset(key, key, std::string(32, 'b'), false, i + 1, Manifest::DownloadState::UNSTARTED);
+        }
+
+        json += "\n    },\n";
+        json += "    \"searchPaths\": [\"res/\", \"src/\"]\n";
+        json += "}\n";
+        return json;
+    }
+
+    bool writeFile(const std::string& path, const std::string& data)
+    {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file)
+            return false;
+        bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+        fclose(file);
+        return written;
+    }
+
+    std::string readFile(const std::string& path)
+    {
+        std::string data;
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file)
+            return data;
+        char chunk[65536];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+            data.append(chunk, n);
+        fclose(file);
+        return data;
+    }
+
+    bool sameAsset(const Manifest::Asset& a, const Manifest::Asset& b)
+    {
+        return a.md5 == b.md5 && a.path == b.path && a.compressed == b.compressed && a.size == b.size && a.downloadState == b.downloadState;
+    }
+
+    void checkDiff(const std::unordered_map<std::string, Manifest::AssetDiff>& expected,
+                   const std::unordered_map<std::string, Manifest::AssetDiff>& diff, const char* name)
+    {
+        MANIFEST_CHECK(diff.size() == expected.size(), "%s has %d entries instead of %d", name, (int)diff.size(), (int)expected.size());
+        for (const auto& it : expected)
+        {
+            auto found = diff.find(it.first);
+            bool same = found != diff.end() && found->second.type == it.second.type && sameAsset(found->second.asset, it.second.asset);
+            MANIFEST_CHECK(same, "%s differs at %s", name, it.first.c_str());
+            if (!same)
+                return;
+        }
+    }
+
+    void checkLoaded(ManifestProbe* manifest, ManifestProbe* json, const std::string& path)
+    {
+        MANIFEST_CHECK(manifest->isLoaded() && manifest->isBinary(), "%s is not loaded as a binary manifest", path.c_str());
+        MANIFEST_CHECK(manifest->getVersion() == json->getVersion(), "%s has version %s", path.c_str(), manifest->getVersion().c_str());
+        MANIFEST_CHECK(manifest->versionEquals(json), "%s has other group versions", path.c_str());
+        MANIFEST_CHECK(manifest->getPackageUrl() == json->getPackageUrl(), "%s has package url %s", path.c_str(), manifest->getPackageUrl().c_str());
+        MANIFEST_CHECK(manifest->getManifestFileUrl() == json->getManifestFileUrl(), "%s has another manifest url", path.c_str());
+        MANIFEST_CHECK(manifest->getVersionFileUrl() == json->getVersionFileUrl(), "%s has another version url", path.c_str());
+        MANIFEST_CHECK(manifest->getGroups() == json->getGroups(), "%s has other groups", path.c_str());
+        MANIFEST_CHECK(manifest->getSearchPaths() == json->getSearchPaths(), "%s has other search paths", path.c_str());
+
+        int mismatches = 0;
+        for (const auto& it : json->getAssets())
+        {
+            Manifest::Asset asset;
+            if (!manifest->findAsset(it.first, &asset) || !sameAsset(asset, it.second))
+                mismatches++;
+        }
+        MANIFEST_CHECK(mismatches == 0, "%s has %d assets which differ from the json manifest", path.c_str(), mismatches);
+        MANIFEST_CHECK(!manifest->findAsset("res/missing.png", nullptr), "%s finds a missing asset", path.c_str());
+    }
+
+    void checkResumeList(ManifestProbe* manifest, ManifestProbe* json, const char* name)
+    {
+        DownloadUnits expected, units;
+        json->genResumeAssetsList(&expected);
+        manifest->genResumeAssetsList(&units);
+        MANIFEST_CHECK(units.size() == expected.size(), "%s resumes %d assets instead of %d", name, (int)units.size(), (int)expected.size());
+        for (const auto& it : expected)
+        {
+            auto found = units.find(it.first);
+            bool same = found != units.end() && found->second.srcUrl == it.second.srcUrl
+                && found->second.storagePath == it.second.storagePath && found->second.size == it.second.size;
+            MANIFEST_CHECK(same, "%s resumes %s differently", name, it.first.c_str());
+            if (!same)
+                return;
+        }
+    }
+
+    void checkCorrupted(const std::string& dir, ManifestProbe* json, ManifestProbe* other, int count)
+    {
+        std::string data = readFile(dir + "project.bin");
+        if (data.empty())
+            return;
+
+        std::string path = dir + "corrupted.bin";
+        std::mt19937 random(1);
+        int rejected = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            std::string corrupted = data;
+            if (i % 3 == 0)
+            {
+                corrupted.resize(random() % corrupted.size());
+            }
+            else
+            {
+                // flip bytes in the header and the start of the tables
+                size_t range = std::min<size_t>(corrupted.size(), 256);
+                for (int j = 0; j <= i % 4; ++j)
+                    corrupted[random() % range] ^= (char)(1 + random() % 255);
+            }
+            writeFile(path, corrupted);
+
+            ManifestProbe* manifest = new ManifestProbe(path);
+            if (manifest->isBinary())
+            {
+                // whatever passed the validation has to be safe to use
+                for (const auto& it : json->getAssets())
+                    manifest->findAsset(it.first, nullptr);
+                manifest->genDiff(other);
+                DownloadUnits units;
+                manifest->genResumeAssetsList(&units);
+            }
+            else
+            {
+                rejected++;
+            }
+            manifest->release();
+        }
+        printf("corrupted: %d of %d rejected, the rest stayed usable\n", rejected, count);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int assets = DEFAULT_ASSETS;
+    int corrupt = DEFAULT_CORRUPT;
+    std::string dir = DEFAULT_DIR;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--assets") == 0 && i + 1 < argc)
+        {
+            assets = std::max(DELETE_EVERY, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--corrupt") == 0 && i + 1 < argc)
+        {
+            corrupt = std::max(0, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc)
+        {
+            dir = argv[++i];
+            if (dir.back() != '/')
+                dir += '/';
+        }
+        else
+        {
+            printf("usage: manifest_binary [--assets N] [--corrupt N] [--dir DIR]\n");
+            return 1;
+        }
+    }
+
+    mkdir(dir.c_str(), 0755);
+    const std::string jsonPath = dir + "project.manifest";
+    const std::string otherJsonPath = dir + "remote.manifest";
+    const std::string binPath = dir + "project.bin";
+    const std::string otherBinPath = dir + "remote.bin";
+    if (!writeFile(jsonPath, makeManifest(assets, 0)) || !writeFile(otherJsonPath, makeManifest(assets, 5)))
+    {
+        fprintf(stderr, "can not write to %s\n", dir.c_str());
+        return 1;
+    }
+
+    Clock::time_point start = Clock::now();
+    ManifestProbe* json = new ManifestProbe(jsonPath);
+    double jsonMs = millisecondsSince(start);
+    ManifestProbe* otherJson = new ManifestProbe(otherJsonPath);
+    MANIFEST_CHECK(json->isLoaded() && !json->isBinary(), "%s is not loaded as a json manifest", jsonPath.c_str());
+    MANIFEST_CHECK(otherJson->isLoaded() && !otherJson->isBinary(), "%s is not loaded as a json manifest", otherJsonPath.c_str());
+    MANIFEST_CHECK(json->saveToBinaryFile(binPath), "can not save %s", binPath.c_str());
+    MANIFEST_CHECK(otherJson->saveToBinaryFile(otherBinPath), "can not save %s", otherBinPath.c_str());
+
+    start = Clock::now();
+    ManifestProbe* bin = new ManifestProbe(binPath);
+    double binMs = millisecondsSince(start);
+    ManifestProbe* otherBin = new ManifestProbe(otherBinPath);
+    checkLoaded(bin, json, binPath);
+    checkLoaded(otherBin, otherJson, otherBinPath);
+
+    // diffs, binary pairs are merged in key order, mixed pairs go through findAsset
+    auto expected = json->genDiff(otherJson);
+    start = Clock::now();
+    auto binDiff = bin->genDiff(otherBin);
+    double diffMs = millisecondsSince(start);
+    checkDiff(expected, binDiff, "binary diff");
+    checkDiff(expected, bin->genDiff(otherJson), "binary to json diff");
+    checkDiff(expected, json->genDiff(otherBin), "json to binary diff");
+
+    // getAssets builds the map of a binary manifest on demand
+    const auto& binAssets = otherBin->getAssets();
+    MANIFEST_CHECK(binAssets.size() == otherJson->getAssets().size(), "getAssets has %d assets instead of %d", (int)binAssets.size(), (int)otherJson->getAssets().size());
+    for (const auto& it : otherJson->getAssets())
+    {
+        auto found = binAssets.find(it.first);
+        bool same = found != binAssets.end() && sameAsset(found->second, it.second);
+        MANIFEST_CHECK(same, "getAssets differs at %s", it.first.c_str());
+        if (!same)
+            break;
+    }
+    checkResumeList(otherBin, otherJson, "binary manifest");
+
+    // a resave of an untouched binary manifest is byte identical
+    const std::string resavedPath = dir + "resaved.bin";
+    MANIFEST_CHECK(otherBin->saveToBinaryFile(resavedPath), "can not save %s", resavedPath.c_str());
+    MANIFEST_CHECK(readFile(resavedPath) == readFile(otherBinPath), "%s differs from %s", resavedPath.c_str(), otherBinPath.c_str());
+
+    // to json and back to binary gives the same file
+    const std::string roundTripJsonPath = dir + "roundtrip.manifest";
+    const std::string roundTripBinPath = dir + "roundtrip.bin";
+    MANIFEST_CHECK(otherBin->saveToJSONFile(roundTripJsonPath), "can not save %s", roundTripJsonPath.c_str());
+    ManifestProbe* roundTripJson = new ManifestProbe(roundTripJsonPath);
+    MANIFEST_CHECK(roundTripJson->isLoaded() && !roundTripJson->isBinary(), "%s is not loaded as a json manifest", roundTripJsonPath.c_str());
+    MANIFEST_CHECK(roundTripJson->saveToBinaryFile(roundTripBinPath), "can not save %s", roundTripBinPath.c_str());
+    MANIFEST_CHECK(readFile(roundTripBinPath) == readFile(otherBinPath), "%s differs from %s", roundTripBinPath.c_str(), otherBinPath.c_str());
+    roundTripJson->release();
+
+    // download states and the updating flag are written in place and saved, the mapped file stays untouched
+    const std::string key = otherJson->getAssets().begin()->first;
+    const int originalState = otherJson->getAssets().begin()->second.downloadState;
+    const int newState = originalState == Manifest::DownloadState::SUCCESSED ? Manifest::DownloadState::UNSTARTED : Manifest::DownloadState::SUCCESSED;
+    const std::string statePath = dir + "state.bin";
+    otherBin->setAssetDownloadState(key, (Manifest::DownloadState)newState);
+    otherBin->setUpdating(true);
+    otherBin->saveToFile(statePath);
+
+    Manifest::Asset asset;
+    ManifestProbe* saved = new ManifestProbe(statePath);
+    MANIFEST_CHECK(saved->findAsset(key, &asset) && asset.downloadState == newState, "%s lost the download state of %s", statePath.c_str(), key.c_str());
+    MANIFEST_CHECK(saved->isUpdating(), "%s lost the updating flag", statePath.c_str());
+
+    // and again over the mapped file itself
+    saved->setAssetDownloadState(key, (Manifest::DownloadState)originalState);
+    saved->saveToFile(statePath);
+    saved->release();
+    saved = new ManifestProbe(statePath);
+    MANIFEST_CHECK(saved->findAsset(key, &asset) && asset.downloadState == originalState, "%s lost the download state saved over itself", statePath.c_str());
+    saved->release();
+
+    ManifestProbe* reloaded = new ManifestProbe(otherBinPath);
+    MANIFEST_CHECK(reloaded->findAsset(key, &asset) && asset.downloadState == originalState, "%s was modified through the mapping", otherBinPath.c_str());
+    MANIFEST_CHECK(!reloaded->isUpdating(), "%s was modified through the mapping", otherBinPath.c_str());
+    checkResumeList(reloaded, otherJson, "reloaded binary manifest");
+    reloaded->release();
+
+    // the version part alone
+    ManifestProbe* version = new ManifestProbe();
+    version->parseVersion(binPath);
+    MANIFEST_CHECK(version->isVersionLoaded() && !version->isLoaded(), "%s is not loaded as a version manifest", binPath.c_str());
+    MANIFEST_CHECK(version->getVersion() == json->getVersion(), "%s has version %s", binPath.c_str(), version->getVersion().c_str());
+    version->release();
+
+    checkCorrupted(dir, json, otherBin, corrupt);
+
+    printf("manifest binary: %d assets, %d diff entries, %d failures\n", (int)json->getAssets().size(), (int)expected.size(), s_failures);
+    printf("load json %.2f ms, load binary %.2f ms, binary diff %.2f ms, %d bytes binary\n",
+           jsonMs, binMs, diffMs, (int)readFile(binPath).size());
+
+    json->release();
+    otherJson->release();
+    bin->release();
+    otherBin->release();
+
+    return s_failures == 0 ? 0 : 1;
+}
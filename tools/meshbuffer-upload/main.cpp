@@ -0,0 +1,349 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+/*
+ * Checks which ranges MeshBuffer uploads, without a GL context. VertexBuffer and IndexBuffer are replaced by stubs
+ * which record every orphan and sub data update and keep a copy of the bytes the GPU storage would hold.
+ * ModelBatcher and RenderFlow are replaced by the few members MeshBuffer uses, so MeshBuffer.cpp and the GL free
+ * sources it needs are compiled in instead of linking cocos2d.
+ * It checks that the first upload after reset orphans the storage, that later uploads of the frame only send the
+ * ranges requested since the previous one, that growing the memory data orphans the storage at the new size and
+ * uploads everything requested in the frame again, that every buffer of a switch is handled the same way, and that
+ * the GPU copy always holds the requested bytes. Exits with 0 if all checks pass, 1 otherwise.
+ *
+ *   meshbuffer_upload
+ */
+
+#include "renderer/scene/MeshBuffer.hpp"
+#include "renderer/scene/ModelBatcher.hpp"
+#include "renderer/scene/RenderFlow.hpp"
+#include "renderer/gfx/VertexBuffer.h"
+#include "renderer/gfx/IndexBuffer.h"
+#include "renderer/gfx/VertexFormat.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace cocos2d::renderer;
+
+namespace
+{
+    struct Op
+    {
+        bool orphan;
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    // what a GL buffer would hold, keyed by the fake GL id of the stub
+    struct FakeStorage
+    {
+        Usage usage = Usage::STATIC;
+        std::vector<uint8_t> bytes;
+        std::vector<Op> ops;
+    };
+
+    std::map<uint32_t, FakeStorage> s_storages;
+    uint32_t s_nextID = 1;
+    int s_failures = 0;
+
+    void check(bool ok, const std::string& what)
+    {
+        if (!ok)
+        {
+            printf("FAILED: %s\n", what.c_str());
+            s_failures++;
+        }
+    }
+
+    std::string describe(const std::vector<Op>& ops)
+    {
+        std::string text;
+        for (const auto& op : ops)
+        {
+            char buf[64];
+            snprintf(buf, sizeof(buf), op.orphan ? " orphan(%u)" : " sub(%u, %u)", op.orphan ? op.size : op.offset, op.size);
+            text += buf;
+        }
+        return text.empty() ? " none" : text;
+    }
+
+    void fakeOrphan(uint32_t glID, uint32_t bytes)
+    {
+        auto& storage = s_storages[glID];
+        // undefined content, filled with a pattern so stale bytes are caught
+        storage.bytes.assign(bytes, 0xcd);
+        storage.ops.push_back({true, 0, bytes});
+    }
+
+    bool fakeUpdate(uint32_t glID, uint32_t offset, const void* data, size_t size)
+    {
+        auto& storage = s_storages[glID];
+        storage.ops.push_back({false, offset, (uint32_t)size});
+        if (offset + size > storage.bytes.size())
+        {
+            return false;
+        }
+        memcpy(storage.bytes.data() + offset, data, size);
+        return true;
+    }
+}
+
+// GL free stand-ins of the classes MeshBuffer talks to
+
+RENDERER_BEGIN
+
+bool VertexBuffer::init(DeviceGraphics* device, VertexFormat* format, Usage usage, const void* data, size_t dataByteLength, uint32_t numVertices)
+{
+    _usage = usage;
+    _bytes = 0;
+    _glID = s_nextID++;
+    s_storages[_glID].usage = usage;
+    return true;
+}
+
+VertexBuffer::VertexBuffer() {}
+VertexBuffer::~VertexBuffer() {}
+
+void VertexBuffer::update(uint32_t offset, const void* data, size_t dataByteLength)
+{
+    check(fakeUpdate(_glID, offset, data, dataByteLength), "vertex update out of the storage");
+}
+
+void VertexBuffer::orphan(uint32_t bytes)
+{
+    _bytes = bytes;
+    fakeOrphan(_glID, bytes);
+}
+
+void VertexBuffer::destroy()
+{
+    _glID = 0;
+}
+
+bool IndexBuffer::init(DeviceGraphics* device, IndexFormat format, Usage usage, const void* data, size_t dataByteLength, uint32_t numIndices)
+{
+    _usage = usage;
+    _bytes = 0;
+    _glID = s_nextID++;
+    s_storages[_glID].usage = usage;
+    return true;
+}
+
+IndexBuffer::IndexBuffer() {}
+IndexBuffer::~IndexBuffer() {}
+
+void IndexBuffer::update(uint32_t offset, const void* data, size_t dataByteLength)
+{
+    check(fakeUpdate(_glID, offset, data, dataByteLength), "index update out of the storage");
+}
+
+void IndexBuffer::orphan(uint32_t bytes)
+{
+    _bytes = bytes;
+    fakeOrphan(_glID, bytes);
+}
+
+void IndexBuffer::destroy()
+{
+    _glID = 0;
+}
+
+RenderFlow::RenderFlow(DeviceGraphics* device, Scene* scene, ForwardRenderer* forward)
+: _device(device)
+{
+}
+
+RenderFlow::~RenderFlow() {}
+
+ModelBatcher::ModelBatcher(RenderFlow* flow)
+: _flow(flow)
+{
+}
+
+ModelBatcher::~ModelBatcher() {}
+
+void ModelBatcher::flush() {}
+
+RENDERER_END
+
+namespace
+{
+    const uint32_t FLOATS_PER_VERTEX = 5;
+    const uint32_t QUAD_VERTICES = 4;
+    const uint32_t QUAD_INDICES = 6;
+
+    // requests quads and fills them with values unique to the frame and the quad
+    void requestQuads(MeshBuffer* buffer, uint32_t quads, uint32_t frame)
+    {
+        for (uint32_t q = 0; q < quads; q++)
+        {
+            const auto& offset = buffer->requestStatic(QUAD_VERTICES, QUAD_INDICES);
+            float* vertices = buffer->vData + offset.vByte / sizeof(float);
+            for (uint32_t i = 0; i < QUAD_VERTICES * FLOATS_PER_VERTEX; i++)
+            {
+                vertices[i] = (float)(frame * 100000 + offset.vertex * FLOATS_PER_VERTEX + i);
+            }
+            uint16_t* indices = buffer->iData + offset.index;
+            for (uint32_t i = 0; i < QUAD_INDICES; i++)
+            {
+                indices[i] = (uint16_t)(offset.vertex + i % QUAD_VERTICES);
+            }
+        }
+    }
+
+    uint32_t capacityOf(uint32_t glID)
+    {
+        return (uint32_t)s_storages[glID].bytes.size();
+    }
+
+    std::vector<Op> takeOps(uint32_t glID)
+    {
+        std::vector<Op> ops;
+        ops.swap(s_storages[glID].ops);
+        return ops;
+    }
+
+    void expectOps(uint32_t glID, const std::vector<Op>& expected, const std::string& what)
+    {
+        auto ops = takeOps(glID);
+        bool same = ops.size() == expected.size();
+        for (std::size_t i = 0; same && i < ops.size(); i++)
+        {
+            same = ops[i].orphan == expected[i].orphan && ops[i].size == expected[i].size && (ops[i].orphan || ops[i].offset == expected[i].offset);
+        }
+        check(same, what + ": expected" + describe(expected) + ", got" + describe(ops));
+    }
+
+    // the GPU copy must hold what the memory data holds for everything requested in the frame
+    void expectContent(MeshBuffer* buffer, const std::string& what)
+    {
+        uint32_t vBytes = buffer->getByteOffset();
+        uint32_t iBytes = buffer->getIndexOffset() * MeshBuffer::IDATA_BYTE;
+        const auto& vStorage = s_storages[buffer->getVertexBuffer()->getHandle()].bytes;
+        const auto& iStorage = s_storages[buffer->getIndexBuffer()->getHandle()].bytes;
+        check(vStorage.size() >= vBytes && memcmp(vStorage.data(), buffer->vData, vBytes) == 0, what + ": vertex content");
+        check(iStorage.size() >= iBytes && memcmp(iStorage.data(), buffer->iData, iBytes) == 0, what + ": index content");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    RenderFlow flow(nullptr, nullptr, nullptr);
+    ModelBatcher batcher(&flow);
+
+    VertexFormat* fmt = new VertexFormat({
+        {ATTRIB_NAME_POSITION, AttribType::FLOAT32, 2},
+        {ATTRIB_NAME_UV0, AttribType::FLOAT32, 2},
+        {ATTRIB_NAME_COLOR, AttribType::UINT8, 4, true},
+    });
+    const uint32_t vertexBytes = fmt->getBytes();
+    const uint32_t quadVBytes = QUAD_VERTICES * vertexBytes;
+    const uint32_t quadIBytes = QUAD_INDICES * MeshBuffer::IDATA_BYTE;
+    const uint32_t initQuads = 16;
+
+    MeshBuffer* buffer = new MeshBuffer(&batcher, fmt, initQuads);
+    uint32_t vb = buffer->getVertexBuffer()->getHandle();
+    uint32_t ib = buffer->getIndexBuffer()->getHandle();
+    check(s_storages[vb].usage == Usage::DYNAMIC, "vertex buffer is dynamic");
+    check(s_storages[ib].usage == Usage::STATIC, "index buffer is static");
+
+    // frame 1, one upload: orphan at capacity, then only the requested range
+    uint32_t vCapacity = initQuads * quadVBytes;
+    uint32_t iCapacity = initQuads * quadIBytes;
+    buffer->reset();
+    requestQuads(buffer, 3, 1);
+    buffer->uploadData();
+    expectOps(vb, {{true, 0, vCapacity}, {false, 0, 3 * quadVBytes}}, "frame 1 vertices");
+    expectOps(ib, {{true, 0, iCapacity}, {false, 0, 3 * quadIBytes}}, "frame 1 indices");
+    expectContent(buffer, "frame 1");
+    check(buffer->getUploadedBytes() == 3 * (quadVBytes + quadIBytes), "frame 1 uploaded bytes");
+
+    // frame 2, two uploads: the second one only sends the quads requested after the first
+    buffer->reset();
+    requestQuads(buffer, 2, 2);
+    buffer->uploadData();
+    requestQuads(buffer, 4, 2);
+    buffer->uploadData();
+    expectOps(vb, {{true, 0, vCapacity}, {false, 0, 2 * quadVBytes}, {false, 2 * quadVBytes, 4 * quadVBytes}}, "frame 2 vertices");
+    expectOps(ib, {{true, 0, iCapacity}, {false, 0, 2 * quadIBytes}, {false, 2 * quadIBytes, 4 * quadIBytes}}, "frame 2 indices");
+    expectContent(buffer, "frame 2");
+    check(buffer->getUploadedBytes() == 6 * (quadVBytes + quadIBytes), "frame 2 uploaded bytes");
+
+    // frame 3, nothing requested after the upload: the second upload sends nothing
+    buffer->reset();
+    requestQuads(buffer, 1, 3);
+    buffer->uploadData();
+    buffer->uploadData();
+    expectOps(vb, {{true, 0, vCapacity}, {false, 0, quadVBytes}}, "frame 3 vertices");
+    expectOps(ib, {{true, 0, iCapacity}, {false, 0, quadIBytes}}, "frame 3 indices");
+
+    // frame 4, the memory data grows after an upload: orphan at the new size and send the whole frame again
+    buffer->reset();
+    requestQuads(buffer, 10, 4);
+    buffer->uploadData();
+    requestQuads(buffer, 10, 4);
+    buffer->uploadData();
+    uint32_t grownVCapacity = capacityOf(vb);
+    uint32_t grownICapacity = capacityOf(ib);
+    check(grownVCapacity >= 20 * quadVBytes && grownVCapacity > vCapacity, "frame 4 vertex storage grew");
+    check(grownICapacity >= 20 * quadIBytes && grownICapacity > iCapacity, "frame 4 index storage grew");
+    expectOps(vb, {{true, 0, vCapacity}, {false, 0, 10 * quadVBytes}, {true, 0, grownVCapacity}, {false, 0, 20 * quadVBytes}}, "frame 4 vertices");
+    expectOps(ib, {{true, 0, iCapacity}, {false, 0, 10 * quadIBytes}, {true, 0, grownICapacity}, {false, 0, 20 * quadIBytes}}, "frame 4 indices");
+    expectContent(buffer, "frame 4");
+
+    // frame 5, more vertices than one index buffer addresses: every GPU buffer is orphaned once and gets its own quads
+    buffer->reset();
+    uint32_t quadsPerBuffer = 65535 / QUAD_VERTICES;
+    requestQuads(buffer, quadsPerBuffer + 5, 5);
+    uint32_t vb2 = buffer->getVertexBuffer()->getHandle();
+    uint32_t ib2 = buffer->getIndexBuffer()->getHandle();
+    check(vb2 != vb && ib2 != ib, "frame 5 switched to a second buffer");
+    buffer->uploadData();
+    auto firstOps = takeOps(vb);
+    check(firstOps.size() >= 2 && firstOps[0].orphan && firstOps.back().offset == 0 && firstOps.back().size == quadsPerBuffer * quadVBytes,
+          "frame 5 first buffer sends its quads once after orphaning:" + describe(firstOps));
+    takeOps(ib);
+    expectOps(vb2, {{true, 0, capacityOf(vb2)}, {false, 0, 5 * quadVBytes}}, "frame 5 second vertex buffer");
+    expectOps(ib2, {{true, 0, capacityOf(ib2)}, {false, 0, 5 * quadIBytes}}, "frame 5 second index buffer");
+    expectContent(buffer, "frame 5 second buffer");
+
+    // frame 6, back to the first buffer which is orphaned again, the second one is untouched
+    buffer->reset();
+    requestQuads(buffer, 2, 6);
+    buffer->uploadData();
+    check(buffer->getVertexBuffer()->getHandle() == vb, "frame 6 starts at the first buffer");
+    expectOps(vb, {{true, 0, capacityOf(vb)}, {false, 0, 2 * quadVBytes}}, "frame 6 vertices");
+    expectOps(vb2, {}, "frame 6 second vertex buffer");
+    expectContent(buffer, "frame 6");
+
+    delete buffer;
+    fmt->release();
+
+    printf(s_failures == 0 ? "all checks passed\n" : "%d checks failed\n", s_failures);
+    return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,246 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+/*
+ * Compares the distance fields of FontFreeType, a single pair of 8SSEDT sweeps on floats, with the converged
+ * double precision EDTAA3 of external/sources/edtaa3func, which makeDistanceMap used before, on the headless
+ * linux platform. Both start from the same coverage bitmap and use the same 8 bits quantization.
+ * For every font and size it prints the largest and mean difference of the 8 bits output and the time of both.
+ * Exits with 1 if any pixel differs by more than the max error, 0 otherwise.
+ *
+ *   sdf_compare [--max-error N] [--cjk] font.ttf [font.ttf ...]
+ *
+ * Printable ASCII and Latin-1 letters are always compared, --cjk adds common CJK ideographs and kana.
+ * Letters without a glyph in a font are skipped.
+ */
+
+#include "2d/CCFontFreetype.h"
+#include "2d/CCTTFTypes.h"
+#include "edtaa3func/edtaa3func.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+using namespace cocos2d;
+
+namespace
+{
+    // one level is 1/16 pixel of distance
+    const int DEFAULT_MAX_ERROR = 2;
+    const float FONT_SIZES[] = {16.0f, 24.0f, 32.0f, 48.0f, 64.0f};
+
+    const char32_t* CJK_TEXT =
+        U"的一是不了人我在有他这中大来上国个到说们为子和你地出道也时年得就那要下以生会自着去之过家学对可她里后小么心多天而能好都然没日于起还发成事只作当想看文无开手十用主行方又如前所本见经头面公同三已老从动两长知民样现分将外但身些与高意进把法此实回二理美点月明其种声全工己话儿者向情部正名定女问力机给等几很业最间新什打便位因重被走电四第门相次东政海口使教西再平真听世气信北少关并内加化由却代军产入先山五太水万市眼体别处总才场师书比住员九笑性通目华报立马命张活难神数件安表原车白应路期叫死常提感金何更反合放做系计或司利受光王果亲界及今京务制解各任至清物台象记边共风战干接它许八特觉望直服毛林题建南度统色字请交爱让认算论百吃义科怎元社术结六功指思非流每青管夫连远资队跟带花快条院变联言权往展该领传近留红治决周保达办运武半候七必城父强步完革深区即求品士转量空甚众技轻程告江语英基派满式李息写呢识极令黄德收脸钱党倒未持取设始版双历越史商千片容研像找友孩站广改议形委早房音火际则首单据导影失拿网香似斯专石若兵弟谁校读志飞观争究包组造落视济喜离虽坐集编宝谈府拉黑且随格尽剑讲布杀微怕母调局根曾准团段终乐切级克精哪官示冷域あいうえおかきくけこさしすせそアイウエオカキクケコ";
+
+    struct Result
+    {
+        int glyphs = 0;
+        int maxError = 0;
+        double sumError = 0.0;
+        long pixels = 0;
+        long differentPixels = 0;
+        double referenceMs = 0.0;
+        double engineMs = 0.0;
+    };
+
+    // makeDistanceMap before it was replaced, bipolar EDTAA3 of the padded coverage
+    std::vector<uint8_t> referenceDistanceMap(const uint8_t* img, int width, int height, int spread)
+    {
+        int outWidth = width + 2 * spread;
+        int outHeight = height + 2 * spread;
+        int pixelAmount = outWidth * outHeight;
+
+        std::vector<short> xdist(pixelAmount), ydist(pixelAmount);
+        std::vector<double> gx(pixelAmount, 0.0), gy(pixelAmount, 0.0), data(pixelAmount, 0.0), outside(pixelAmount, 0.0), inside(pixelAmount, 0.0);
+        for (int j = 0; j < height; j++)
+        {
+            for (int i = 0; i < width; i++)
+            {
+                data[(j + spread) * outWidth + spread + i] = img[j * width + i] / 255.0;
+            }
+        }
+
+        computegradient(data.data(), outWidth, outHeight, gx.data(), gy.data());
+        edtaa3(data.data(), gx.data(), gy.data(), outWidth, outHeight, xdist.data(), ydist.data(), outside.data());
+
+        std::fill(gx.begin(), gx.end(), 0.0);
+        std::fill(gy.begin(), gy.end(), 0.0);
+        for (int i = 0; i < pixelAmount; i++)
+        {
+            data[i] = 1.0 - data[i];
+        }
+        computegradient(data.data(), outWidth, outHeight, gx.data(), gy.data());
+        edtaa3(data.data(), gx.data(), gy.data(), outWidth, outHeight, xdist.data(), ydist.data(), inside.data());
+
+        std::vector<uint8_t> out(pixelAmount);
+        for (int i = 0; i < pixelAmount; i++)
+        {
+            double dist = std::max(outside[i], 0.0) - std::max(inside[i], 0.0);
+            dist = 128.0 - dist * 16;
+            out[i] = (uint8_t)std::min(255.0, std::max(0.0, dist));
+        }
+        return out;
+    }
+
+    double elapsedMs(std::chrono::steady_clock::time_point since)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+    }
+
+    bool compareFont(const char* path, float fontSize, const std::u32string& letters, Result& result)
+    {
+        LabelLayoutInfo info;
+        FontFreeType font(path, fontSize, &info);
+        if (!font.loadFont())
+        {
+            return false;
+        }
+
+        // missing letters would be rendered as the notdef glyph
+        FT_Face face = nullptr;
+        if (FT_New_Face(font.getFTLibrary(), path, 0, &face))
+        {
+            return false;
+        }
+
+        for (char32_t ch : letters)
+        {
+            if (FT_Get_Char_Index(face, ch) == 0)
+            {
+                continue;
+            }
+
+            // the coverage the distance field is made of, rendered with the same flags
+            auto start = std::chrono::steady_clock::now();
+            auto coverage = font.getGlyphBitmap(ch, false);
+            double rasterizeMs = elapsedMs(start);
+            if (!coverage || coverage->getWidth() == 0 || coverage->getHeight() == 0)
+            {
+                continue;
+            }
+
+            // the distance field alone, without rasterizing the glyph
+            start = std::chrono::steady_clock::now();
+            auto sdf = font.getGlyphBitmap(ch, true);
+            result.engineMs += std::max(0.0, elapsedMs(start) - rasterizeMs);
+            if (!sdf)
+            {
+                continue;
+            }
+
+            int spread = sdf->getOutline();
+            start = std::chrono::steady_clock::now();
+            std::vector<uint8_t> reference = referenceDistanceMap(coverage->getData().data(), coverage->getWidth(), coverage->getHeight(), spread);
+            result.referenceMs += elapsedMs(start);
+
+            const std::vector<uint8_t>& engine = sdf->getData();
+            if (engine.size() != reference.size())
+            {
+                printf("  U+%04X: size %zu, expected %zu\n", (unsigned)ch, engine.size(), reference.size());
+                result.maxError = 255;
+                continue;
+            }
+
+            for (size_t i = 0; i < engine.size(); i++)
+            {
+                int error = abs((int)engine[i] - (int)reference[i]);
+                result.maxError = std::max(result.maxError, error);
+                result.sumError += error;
+                result.differentPixels += error > 0;
+            }
+            result.pixels += (long)engine.size();
+            result.glyphs++;
+        }
+        FT_Done_Face(face);
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int maxError = DEFAULT_MAX_ERROR;
+    bool cjk = false;
+    std::vector<const char*> fonts;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--max-error") == 0 && i + 1 < argc)
+        {
+            maxError = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--cjk") == 0)
+        {
+            cjk = true;
+        }
+        else
+        {
+            fonts.push_back(argv[i]);
+        }
+    }
+    if (fonts.empty())
+    {
+        printf("usage: sdf_compare [--max-error N] [--cjk] font.ttf [font.ttf ...]\n");
+        return 1;
+    }
+
+    std::u32string letters;
+    for (char32_t ch = 0x21; ch < 0x7f; ch++) letters.push_back(ch);
+    for (char32_t ch = 0xc0; ch < 0x100; ch++) letters.push_back(ch);
+    if (cjk)
+    {
+        letters += CJK_TEXT;
+    }
+
+    bool ok = true;
+    for (const char* path : fonts)
+    {
+        const char* name = strrchr(path, '/') ? strrchr(path, '/') + 1 : path;
+        for (float fontSize : FONT_SIZES)
+        {
+            Result result;
+            if (!compareFont(path, fontSize, letters, result))
+            {
+                printf("%s: can not load font\n", path);
+                ok = false;
+                break;
+            }
+
+            bool passed = result.maxError <= maxError;
+            ok &= passed;
+            printf("%-26s %2.0fpx glyphs %4d  max error %3d  mean error %.4f  differing %6.3f%%  edtaa3 %8.2fms  8ssedt %8.2fms  %.2fx  %s\n",
+                   name, fontSize, result.glyphs, result.maxError,
+                   result.pixels ? result.sumError / result.pixels : 0.0,
+                   result.pixels ? 100.0 * result.differentPixels / result.pixels : 0.0,
+                   result.referenceMs, result.engineMs,
+                   result.engineMs > 0.0 ? result.referenceMs / result.engineMs : 0.0,
+                   passed ? "ok" : "FAILED");
+        }
+    }
+    return ok ? 0 : 1;
+}
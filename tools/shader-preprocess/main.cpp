@@ -0,0 +1,775 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+/*
+ * Checks the linear shader preprocessor of ProgramLib against the regex implementation it replaced, which is kept
+ * below as it was, and times both. No GPU is needed: ProgramLib exposes the variant preprocessing as test_preprocess.
+ * Templates come from three places:
+ * - a few templates written like the built-in effects (define injection, integer defines, "#pragma for" lighting loops),
+ *   each preprocessed with several define combinations;
+ * - vertex and fragment template files given on the command line, exported from the editor for instance, preprocessed
+ *   with the --define values;
+ * - with --random N, N random templates and define lists built from overlapping macro names, placeholders and
+ *   well formed and broken "#pragma for" blocks.
+ * Exits with 0 if every output is byte-identical, 1 otherwise.
+ *
+ *   shader_preprocess [--rounds N] [--random N] [--define NAME=VALUE]... [vert frag]...
+ *
+ * VALUE is an integer, true or false.
+ */
+
+#include "base/CCValue.h"
+#include "renderer/Macro.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <functional>
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace cocos2d;
+
+// defined in ProgramLib.cpp
+std::string test_replaceMacroNums(const std::string& text, const std::vector<const OrderedValueMap*>& definesList);
+std::string test_unrollLoops(const std::string& text);
+void test_preprocess(const std::string& vertTemplate, const std::string& fragTemplate,
+                     const std::vector<const OrderedValueMap*>& definesList,
+                     std::string& vert, std::string& frag);
+
+namespace regexpath
+{
+    // the former implementation of ProgramLib.cpp
+
+    std::string generateDefines(const std::vector<const cocos2d::OrderedValueMap*>& definesList)
+    {
+        std::string ret;
+        std::string v;
+        cocos2d::ValueMap cache;
+        for (int i = (int)definesList.size() - 1; i >= 0; i--)
+        {
+            const cocos2d::OrderedValueMap* defMap = definesList[i];
+            for (const auto& def : *defMap)
+            {
+                if (cache.find(def.first) != cache.end())
+                {
+                    continue;
+                }
+
+                if (def.second.getType() == cocos2d::Value::Type::BOOLEAN)
+                {
+                    v = def.second.asBool() ? "1" : "0";
+                }
+                else
+                {
+                    v = std::to_string(def.second.asUnsignedInt());
+                }
+
+                ret += "#define "  + def.first + " " + v + "\n";
+
+                cache.emplace(def.first, def.second);
+            }
+        }
+
+        return ret;
+    }
+
+    std::string replaceMacroNums(const std::string str, const std::vector<const cocos2d::OrderedValueMap*>& definesList)
+    {
+        cocos2d::OrderedValueMap cache;
+        std::string tmp = str;
+        for (int i = (int)definesList.size() - 1; i >= 0; i--)
+        {
+            const cocos2d::OrderedValueMap* defMap = definesList[i];
+
+            for (const auto& def : *defMap)
+            {
+                if (cache.find(def.first) != cache.end())
+                {
+                    continue;
+                }
+
+                if (def.second.getType() == cocos2d::Value::Type::INTEGER || def.second.getType() == cocos2d::Value::Type::UNSIGNED)
+                {
+                    cache.emplace(def.first, def.second);
+                }
+            }
+        }
+
+        for (const auto& def : cache)
+        {
+            std::regex pattern(def.first);
+            tmp = std::regex_replace(tmp, pattern, def.second.asString());
+        }
+
+        return tmp;
+    }
+
+    using RegexReplaceCallback = std::function<std::string(const std::match_results<std::string::const_iterator>&)>;
+
+    static std::string regexReplaceString(const std::string& text, const std::string& pattern, const RegexReplaceCallback& replaceCallback)
+    {
+        std::string ret = text;
+        std::regex re(pattern);
+
+        std::string::const_iterator text_iter = text.cbegin();
+        std::match_results<std::string::const_iterator> results;
+
+        size_t start = 0;
+        size_t offset = 0;
+        while (std::regex_search(text_iter, text.end(), results, re))
+        {
+            offset = start + results.position();
+            std::string replacement = replaceCallback(results);
+            ret = ret.replace(offset, results.length(), replacement);
+            start = offset + replacement.length();
+
+            text_iter = results[0].second;
+        }
+
+        return ret;
+    }
+
+    std::string unrollLoops(const std::string& text)
+    {
+        auto func = [](const std::match_results<std::string::const_iterator>& results) -> std::string {
+            std::string snippet = results[4].str();
+            std::string replacePatternStr = "\\{" + results[1].str() + "\\}";
+            std::regex replacePattern(replacePatternStr);
+
+            int32_t parsedBegin = atoi(results[2].str().c_str());
+            int32_t parsedEnd = atoi(results[3].str().c_str());
+            if (parsedBegin < 0 || parsedEnd < 0)
+            {
+                RENDERER_LOGE("Unroll For Loops Error: begin and end of range must be an int num.");
+            }
+
+            std::string unroll;
+            char tmp[256] = {0};
+            for (int32_t i = parsedBegin; i < parsedEnd; ++i)
+            {
+                snprintf(tmp, 256, "%d", i);
+                std::string replaceFormat(tmp);
+                unroll += std::regex_replace(snippet, replacePattern, replaceFormat);
+            }
+            return unroll;
+        };
+
+        return regexReplaceString(text, "#pragma for (\\w+) in range\\(\\s*(\\d+)\\s*,\\s*(\\d+)\\s*\\)([\\s\\S]+?)#pragma endFor", func);
+    }
+
+    void preprocess(const std::string& vertTemplate, const std::string& fragTemplate,
+                    const std::vector<const OrderedValueMap*>& definesList,
+                    std::string& vert, std::string& frag)
+    {
+        std::string customDef = generateDefines(definesList) + "\n";
+        vert = replaceMacroNums(vertTemplate, definesList);
+        vert = customDef + unrollLoops(vert);
+        frag = replaceMacroNums(fragTemplate, definesList);
+        frag = customDef + unrollLoops(frag);
+    }
+}
+
+namespace
+{
+    const int DEFAULT_ROUNDS = 200;
+
+    typedef std::chrono::high_resolution_clock Clock;
+
+    struct Case
+    {
+        std::string name;
+        std::string vert;
+        std::string frag;
+        // template defaults first, pass values last, like Pass::extractDefines
+        std::vector<OrderedValueMap> defines;
+    };
+
+    const char* SPRITE_VERT = R"(
+precision highp float;
+
+uniform mat4 cc_matViewProj;
+uniform mat4 cc_matWorld;
+
+attribute vec3 a_position;
+attribute vec4 a_color;
+varying vec4 v_color;
+
+#if USE_TEXTURE
+attribute vec2 a_uv0;
+varying vec2 v_uv0;
+#endif
+
+void main () {
+  vec4 pos = vec4(a_position, 1);
+
+  #if CC_USE_MODEL
+  pos = cc_matViewProj * cc_matWorld * pos;
+  #else
+  pos = cc_matViewProj * pos;
+  #endif
+
+  #if USE_TEXTURE
+  v_uv0 = a_uv0;
+  #endif
+
+  v_color = a_color;
+
+  gl_Position = pos;
+}
+)";
+
+    const char* SPRITE_FRAG = R"(
+precision highp float;
+
+uniform sampler2D texture;
+varying vec4 v_color;
+
+#if USE_TEXTURE
+varying vec2 v_uv0;
+#endif
+
+#if USE_ALPHA_TEST
+uniform float alphaThreshold;
+#endif
+
+void main () {
+  vec4 o = vec4(1, 1, 1, 1);
+
+  #if USE_TEXTURE
+  o *= texture2D(texture, v_uv0);
+    #if CC_USE_ALPHA_ATLAS_TEXTURE
+    o.a *= texture2D(texture, v_uv0 + vec2(0, 0.5)).r;
+    #endif
+  #endif
+
+  o *= v_color;
+
+  #if USE_ALPHA_TEST
+  if (o.a <= alphaThreshold) discard;
+  #endif
+
+  gl_FragColor = o;
+}
+)";
+
+    const char* LIT_VERT = R"(
+precision highp float;
+
+uniform mat4 cc_matViewProj;
+uniform mat4 cc_matWorld;
+uniform mat4 cc_matWorldIT;
+
+attribute vec3 a_position;
+attribute vec3 a_normal;
+varying vec3 v_worldNormal;
+varying vec3 v_worldPos;
+
+#if CC_USE_SKINNING
+attribute vec4 a_weights;
+attribute vec4 a_joints;
+  #if CC_USE_JOINTS_TEXTRUE
+  uniform sampler2D cc_jointsTexture;
+  uniform vec2 cc_jointsTextureSize;
+  #else
+  uniform mat4 cc_jointMatrices[CC_JOINTS_MAX];
+  #endif
+#endif
+
+#if CC_NUM_SHADOW_LIGHTS > 0
+  #pragma for id in range(0, CC_NUM_SHADOW_LIGHTS)
+  uniform mat4 cc_lightViewProjMatrix_{id};
+  varying vec4 v_posLightSpace{id};
+  #pragma endFor
+#endif
+
+void main () {
+  vec4 position = vec4(a_position, 1);
+  vec4 normal = vec4(a_normal, 0);
+
+  v_worldPos = (cc_matWorld * position).xyz;
+  v_worldNormal = (cc_matWorldIT * normal).xyz;
+
+  #if CC_NUM_SHADOW_LIGHTS > 0
+    #pragma for id in range(0, CC_NUM_SHADOW_LIGHTS)
+    v_posLightSpace{id} = cc_lightViewProjMatrix_{id} * vec4(v_worldPos, 1.0);
+    #pragma endFor
+  #endif
+
+  gl_Position = cc_matViewProj * cc_matWorld * position;
+}
+)";
+
+    const char* LIT_FRAG = R"(
+precision highp float;
+
+uniform vec4 diffuseColor;
+varying vec3 v_worldNormal;
+varying vec3 v_worldPos;
+
+#if CC_NUM_DIR_LIGHTS > 0
+  #pragma for id in range(0, CC_NUM_DIR_LIGHTS)
+  uniform vec3 cc_dirLightDirection_{id};
+  uniform vec3 cc_dirLightColor_{id};
+  #pragma endFor
+#endif
+
+#if CC_NUM_POINT_LIGHTS > 0
+  #pragma for id in range(0, CC_NUM_POINT_LIGHTS)
+  uniform vec3 cc_pointLightPositionAndRange_{id};
+  uniform vec4 cc_pointLightColor_{id};
+  #pragma endFor
+#endif
+
+#if CC_NUM_SHADOW_LIGHTS > 0
+  #pragma for id in range(0, CC_NUM_SHADOW_LIGHTS)
+  uniform sampler2D cc_shadowMap_{id};
+  varying vec4 v_posLightSpace{id};
+  #pragma endFor
+#endif
+
+void main () {
+  vec3 normal = normalize(v_worldNormal);
+  vec3 diffuse = vec3(0.0);
+
+  #if CC_NUM_DIR_LIGHTS > 0
+    #pragma for id in range(0, CC_NUM_DIR_LIGHTS)
+    diffuse += max(dot(normal, -cc_dirLightDirection_{id}), 0.0) * cc_dirLightColor_{id};
+    #pragma endFor
+  #endif
+
+  #if CC_NUM_POINT_LIGHTS > 0
+    #pragma for id in range( 0 , CC_NUM_POINT_LIGHTS )
+    {
+      vec3 toLight = cc_pointLightPositionAndRange_{id} - v_worldPos;
+      diffuse += max(dot(normal, normalize(toLight)), 0.0) * cc_pointLightColor_{id}.rgb;
+    }
+    #pragma endFor
+  #endif
+
+  #if CC_NUM_SHADOW_LIGHTS > 0
+    #pragma for id in range(0, CC_NUM_SHADOW_LIGHTS)
+    diffuse *= texture2D(cc_shadowMap_{id}, v_posLightSpace{id}.xy).r;
+    #pragma endFor
+  #endif
+
+  gl_FragColor = vec4(diffuseColor.rgb * diffuse, diffuseColor.a);
+}
+)";
+
+    OrderedValueMap makeDefines(std::initializer_list<std::pair<const char*, Value>> values)
+    {
+        OrderedValueMap defines;
+        for (const auto& value : values)
+        {
+            defines[value.first] = value.second;
+        }
+        return defines;
+    }
+
+    void addBuiltinCases(std::vector<Case>& cases)
+    {
+        OrderedValueMap spriteDefaults = makeDefines({
+            {"USE_TEXTURE", Value(false)}, {"USE_ALPHA_TEST", Value(false)},
+            {"CC_USE_MODEL", Value(false)}, {"CC_USE_ALPHA_ATLAS_TEXTURE", Value(false)},
+        });
+        cases.push_back({"sprite", SPRITE_VERT, SPRITE_FRAG, {spriteDefaults, OrderedValueMap()}});
+        cases.push_back({"sprite textured", SPRITE_VERT, SPRITE_FRAG, {spriteDefaults,
+            makeDefines({{"USE_TEXTURE", Value(true)}, {"CC_USE_MODEL", Value(true)}})}});
+        cases.push_back({"sprite alpha test", SPRITE_VERT, SPRITE_FRAG, {spriteDefaults,
+            makeDefines({{"USE_TEXTURE", Value(true)}, {"USE_ALPHA_TEST", Value(true)}, {"CC_USE_ALPHA_ATLAS_TEXTURE", Value(true)}})}});
+
+        OrderedValueMap litDefaults = makeDefines({
+            {"CC_USE_SKINNING", Value(false)}, {"CC_USE_JOINTS_TEXTRUE", Value(false)}, {"CC_JOINTS_MAX", Value(50)},
+            {"CC_NUM_DIR_LIGHTS", Value(0)}, {"CC_NUM_POINT_LIGHTS", Value(0)}, {"CC_NUM_SHADOW_LIGHTS", Value(0)},
+        });
+        cases.push_back({"lit unlit", LIT_VERT, LIT_FRAG, {litDefaults, OrderedValueMap()}});
+        cases.push_back({"lit 1 dir", LIT_VERT, LIT_FRAG, {litDefaults,
+            makeDefines({{"CC_NUM_DIR_LIGHTS", Value(1)}})}});
+        cases.push_back({"lit 2 dir 4 point", LIT_VERT, LIT_FRAG, {litDefaults,
+            makeDefines({{"CC_NUM_DIR_LIGHTS", Value(2)}, {"CC_NUM_POINT_LIGHTS", Value(4)}})}});
+        cases.push_back({"lit skinned shadows", LIT_VERT, LIT_FRAG, {litDefaults,
+            makeDefines({{"CC_USE_SKINNING", Value(true)}, {"CC_NUM_DIR_LIGHTS", Value(1)}, {"CC_NUM_SHADOW_LIGHTS", Value(2)}}),
+            makeDefines({{"CC_JOINTS_MAX", Value(30)}})}});
+    }
+
+    bool readFile(const char* path, std::string& out)
+    {
+        FILE* fp = fopen(path, "rb");
+        if (!fp)
+        {
+            return false;
+        }
+        char buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+        {
+            out.append(buf, n);
+        }
+        fclose(fp);
+        return true;
+    }
+
+    bool parseDefine(const char* arg, OrderedValueMap& defines)
+    {
+        const char* eq = strchr(arg, '=');
+        if (!eq || eq == arg)
+        {
+            return false;
+        }
+        std::string name(arg, eq - arg);
+        std::string value(eq + 1);
+        if (value == "true" || value == "false")
+        {
+            defines[name] = Value(value == "true");
+        }
+        else
+        {
+            char* end = nullptr;
+            long number = strtol(value.c_str(), &end, 10);
+            if (value.empty() || *end != '\0')
+            {
+                return false;
+            }
+            defines[name] = Value((int)number);
+        }
+        return true;
+    }
+
+    // macro names overlap and contain each other on purpose, the replacement order decides the output
+    const char* RANDOM_NAMES[] = {"N", "NUM", "NUM_LIGHTS", "LIGHTS", "CC_NUM_DIR_LIGHTS", "CC_NUM_POINT_LIGHTS", "USE_TEXTURE", "COUNT", "id", "i", "N1", "i2"};
+    const char* RANDOM_TEXT[] = {"vec4 ", "uniform ", ";\n", " ", "\n", "_", "(", ")", "{", "}", ",", "0", "1", "2", "#if ", "#endif\n"};
+
+    template <size_t N>
+    const char* pick(const char* (&items)[N])
+    {
+        return items[rand() % N];
+    }
+
+    std::string randomBound()
+    {
+        int kind = rand() % 4;
+        if (kind == 0)
+        {
+            return pick(RANDOM_NAMES);
+        }
+        return std::to_string(rand() % 5);
+    }
+
+    std::string randomText(int length)
+    {
+        std::string text;
+        for (int i = 0; i < length; i++)
+        {
+            int kind = rand() % 6;
+            if (kind == 0)
+            {
+                text += pick(RANDOM_NAMES);
+            }
+            else if (kind == 1)
+            {
+                text += std::string("{") + pick(RANDOM_NAMES) + "}";
+            }
+            else
+            {
+                text += pick(RANDOM_TEXT);
+            }
+        }
+        return text;
+    }
+
+    std::string randomTemplate()
+    {
+        std::string text;
+        int blocks = 1 + rand() % 4;
+        for (int b = 0; b < blocks; b++)
+        {
+            text += randomText(rand() % 12);
+            std::string space = (rand() % 3 == 0) ? "  " : (rand() % 2 ? " " : "");
+            // mostly well formed loops, sometimes broken ones the unrolling must leave alone
+            switch (rand() % 8)
+            {
+                case 0:
+                    text += "#pragma for id in range(" + randomBound() + ", " + randomBound() + ")";
+                    break;
+                case 1:
+                    text += "#pragma endFor\n";
+                    break;
+                case 2:
+                    text += "#pragma for  id in range(0, 2)";
+                    break;
+                default:
+                    text += std::string("#pragma for ") + pick(RANDOM_NAMES) + " in range(" + space + randomBound() + space + "," + space + randomBound() + space + ")";
+                    text += randomText(rand() % 8);
+                    text += "#pragma endFor";
+                    break;
+            }
+        }
+        text += randomText(rand() % 6);
+        return text;
+    }
+
+    OrderedValueMap randomDefines()
+    {
+        OrderedValueMap defines;
+        int count = rand() % 5;
+        for (int i = 0; i < count; i++)
+        {
+            const char* name = pick(RANDOM_NAMES);
+            switch (rand() % 3)
+            {
+                case 0:
+                    defines[name] = Value(rand() % 2 == 0);
+                    break;
+                case 1:
+                    defines[name] = Value(rand() % 6);
+                    break;
+                default:
+                    defines[name] = Value((unsigned int)(rand() % 6));
+                    break;
+            }
+        }
+        return defines;
+    }
+
+    std::vector<const OrderedValueMap*> definesList(const Case& c)
+    {
+        std::vector<const OrderedValueMap*> list;
+        for (const auto& defines : c.defines)
+        {
+            list.push_back(&defines);
+        }
+        return list;
+    }
+
+    void printFirstDifference(const std::string& name, const char* stage, const std::string& expected, const std::string& actual)
+    {
+        size_t i = 0;
+        while (i < expected.size() && i < actual.size() && expected[i] == actual[i])
+        {
+            i++;
+        }
+        size_t from = i > 40 ? i - 40 : 0;
+        printf("FAILED: %s %s differs at byte %zu\n  regex:  %s\n  linear: %s\n", name.c_str(), stage, i,
+               expected.substr(from, 80).c_str(), actual.substr(from, 80).c_str());
+    }
+
+    bool compare(const Case& c)
+    {
+        auto list = definesList(c);
+        std::string expectedVert, expectedFrag, vert, frag;
+        regexpath::preprocess(c.vert, c.frag, list, expectedVert, expectedFrag);
+        test_preprocess(c.vert, c.frag, list, vert, frag);
+
+        bool ok = true;
+        if (vert != expectedVert)
+        {
+            printFirstDifference(c.name, "vert", expectedVert, vert);
+            ok = false;
+        }
+        if (frag != expectedFrag)
+        {
+            printFirstDifference(c.name, "frag", expectedFrag, frag);
+            ok = false;
+        }
+        return ok;
+    }
+
+    // average microseconds of one variant, vertex and fragment
+    double timeVariants(const std::vector<Case>& cases, int rounds, bool regex)
+    {
+        std::vector<std::vector<const OrderedValueMap*>> lists;
+        for (const auto& c : cases)
+        {
+            lists.push_back(definesList(c));
+        }
+
+        std::string vert, frag;
+        size_t bytes = 0;
+        auto start = Clock::now();
+        for (int r = 0; r < rounds; r++)
+        {
+            for (size_t i = 0; i < cases.size(); i++)
+            {
+                if (regex)
+                {
+                    regexpath::preprocess(cases[i].vert, cases[i].frag, lists[i], vert, frag);
+                }
+                else
+                {
+                    test_preprocess(cases[i].vert, cases[i].frag, lists[i], vert, frag);
+                }
+                bytes += vert.size() + frag.size();
+            }
+        }
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        // keeps the work from being optimized away
+        if (bytes == 0)
+        {
+            printf("no output\n");
+        }
+        return us / ((double)rounds * cases.size());
+    }
+
+    enum class Step
+    {
+        MACRO_NUMS,
+        UNROLL_LOOPS
+    };
+
+    // average microseconds of one step for a variant, vertex and fragment, loops are unrolled in the replaced templates
+    double timeStep(const std::vector<Case>& cases, int rounds, Step step, bool regex)
+    {
+        std::vector<std::vector<const OrderedValueMap*>> lists;
+        std::vector<std::string> replaced;
+        for (const auto& c : cases)
+        {
+            lists.push_back(definesList(c));
+            replaced.push_back(regexpath::replaceMacroNums(c.vert, lists.back()));
+            replaced.push_back(regexpath::replaceMacroNums(c.frag, lists.back()));
+        }
+
+        size_t bytes = 0;
+        auto start = Clock::now();
+        for (int r = 0; r < rounds; r++)
+        {
+            for (size_t i = 0; i < cases.size(); i++)
+            {
+                for (size_t j = 0; j < 2; j++)
+                {
+                    std::string out;
+                    if (step == Step::MACRO_NUMS)
+                    {
+                        const std::string& text = j == 0 ? cases[i].vert : cases[i].frag;
+                        out = regex ? regexpath::replaceMacroNums(text, lists[i]) : test_replaceMacroNums(text, lists[i]);
+                    }
+                    else
+                    {
+                        const std::string& text = replaced[i * 2 + j];
+                        out = regex ? regexpath::unrollLoops(text) : test_unrollLoops(text);
+                    }
+                    bytes += out.size();
+                }
+            }
+        }
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        if (bytes == 0)
+        {
+            printf("no output\n");
+        }
+        return us / ((double)rounds * cases.size());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int rounds = DEFAULT_ROUNDS;
+    int randomCount = 0;
+    OrderedValueMap fileDefines;
+    std::vector<const char*> files;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+        {
+            rounds = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--random") == 0 && i + 1 < argc)
+        {
+            randomCount = std::max(0, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--define") == 0 && i + 1 < argc && parseDefine(argv[i + 1], fileDefines))
+        {
+            i++;
+        }
+        else if (argv[i][0] != '-')
+        {
+            files.push_back(argv[i]);
+        }
+        else
+        {
+            printf("usage: shader_preprocess [--rounds N] [--random N] [--define NAME=VALUE]... [vert frag]...\n");
+            return 1;
+        }
+    }
+    if (files.size() % 2 != 0)
+    {
+        printf("templates are given as vertex and fragment pairs\n");
+        return 1;
+    }
+
+    std::vector<Case> cases;
+    addBuiltinCases(cases);
+    for (size_t i = 0; i < files.size(); i += 2)
+    {
+        Case c;
+        c.name = files[i];
+        if (!readFile(files[i], c.vert) || !readFile(files[i + 1], c.frag))
+        {
+            printf("can not read %s or %s\n", files[i], files[i + 1]);
+            return 1;
+        }
+        c.defines.push_back(fileDefines);
+        cases.push_back(c);
+    }
+
+    bool ok = true;
+    for (const auto& c : cases)
+    {
+        ok = compare(c) && ok;
+    }
+
+    srand(1);
+    int randomFailures = 0;
+    for (int i = 0; i < randomCount; i++)
+    {
+        Case c;
+        c.name = "random " + std::to_string(i);
+        c.vert = randomTemplate();
+        c.frag = randomTemplate();
+        c.defines.push_back(randomDefines());
+        c.defines.push_back(randomDefines());
+        // only the first few differences are printed
+        if (!compare(c) && ++randomFailures >= 10)
+        {
+            break;
+        }
+    }
+    ok = ok && randomFailures == 0;
+
+    double regexUs = timeVariants(cases, rounds, true);
+    double linearUs = timeVariants(cases, rounds, false);
+    printf("%zu templates, %d random, %s\n", cases.size(), randomCount, ok ? "byte-identical" : "DIFFERENT");
+    printf("%-14s %12s %12s %8s\n", "step", "regex us", "linear us", "speedup");
+    const std::pair<const char*, Step> steps[] = {{"macro numbers", Step::MACRO_NUMS}, {"unroll loops", Step::UNROLL_LOOPS}};
+    for (const auto& step : steps)
+    {
+        double stepRegexUs = timeStep(cases, rounds, step.second, true);
+        double stepLinearUs = timeStep(cases, rounds, step.second, false);
+        printf("%-14s %12.3f %12.3f %7.2fx\n", step.first, stepRegexUs, stepLinearUs, stepRegexUs / stepLinearUs);
+    }
+    printf("%-14s %12.3f %12.3f %7.2fx\n", "variant", regexUs, linearUs, regexUs / linearUs);
+    return ok ? 0 : 1;
+}
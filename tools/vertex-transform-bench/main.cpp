@@ -0,0 +1,257 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+/*
+ * Microbenchmark of the batched MathUtil kernels Assembler::fillBuffers uses, against the per vertex loops they replaced:
+ * transformVertices2D against Mat4::transformPoint with the float after the position saved and restored,
+ * transformVertices3D against Vec3::transformMat4, and offsetIndices against the plain index copy loop.
+ * Every case runs on quads of sprite sized vertex layouts and prints the time per vertex or index of both and the speedup.
+ * Exits with 1 if a kernel's output differs from its loop by more than the max error, 0 otherwise.
+ *
+ *   vertex_transform_bench [--max-error E] [--rounds N]
+ *
+ * SSE and C kernels are expected to match the loops exactly, NEON may round differently by a few ulps.
+ */
+
+#include "math/Mat4.h"
+#include "math/Vec3.h"
+#include "math/Quaternion.h"
+#include "math/MathUtil.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+using namespace cocos2d;
+
+namespace
+{
+    const float DEFAULT_MAX_ERROR = 1e-4f;
+    const int DEFAULT_ROUNDS = 2000;
+    // vertices of one fillBuffers call, from a single quad to a large particle system
+    const size_t VERTEX_COUNTS[] = {4, 64, 1024, 16384};
+    // floats per vertex: x y u v color of 2D sprites, x y z u v color of 3D ones
+    const size_t STRIDE_2D = 5;
+    const size_t STRIDE_3D = 6;
+
+    typedef std::chrono::high_resolution_clock Clock;
+
+    struct Case
+    {
+        const char* name;
+        size_t count;
+        double loopNs = 0.0;
+        double kernelNs = 0.0;
+        float maxError = 0.0f;
+    };
+
+    float randomFloat(float range)
+    {
+        return ((float)rand() / RAND_MAX * 2.0f - 1.0f) * range;
+    }
+
+    Mat4 randomWorldMatrix(bool is3D)
+    {
+        Quaternion rotation(randomFloat(1.0f), randomFloat(1.0f), is3D ? randomFloat(1.0f) : 0.0f, randomFloat(1.0f));
+        rotation.normalize();
+        Mat4 m, tmp;
+        Mat4::createTranslation(randomFloat(500.0f), randomFloat(500.0f), is3D ? randomFloat(500.0f) : 0.0f, &m);
+        Mat4::createRotation(rotation, &tmp);
+        m.multiply(tmp);
+        Mat4::createScale(1.0f + randomFloat(0.5f), 1.0f + randomFloat(0.5f), 1.0f, &tmp);
+        m.multiply(tmp);
+        return m;
+    }
+
+    std::vector<float> randomVertices(size_t count, size_t stride)
+    {
+        std::vector<float> vertices(count * stride);
+        for (auto& v : vertices)
+        {
+            v = randomFloat(100.0f);
+        }
+        return vertices;
+    }
+
+    // the loops as they were in Assembler::fillBuffers
+    void loop2D(const Mat4& worldMat, float* ptrPos, size_t dataPerVertex, size_t vertexCount)
+    {
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            float z = ptrPos[2];
+            ptrPos[2] = 0;
+            worldMat.transformPoint((Vec3*)ptrPos);
+            ptrPos[2] = z;
+            ptrPos += dataPerVertex;
+        }
+    }
+
+    void loop3D(const Mat4& worldMat, float* ptrPos, size_t dataPerVertex, size_t vertexCount)
+    {
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            ((Vec3*)ptrPos)->transformMat4(*((Vec3*)ptrPos), worldMat);
+            ptrPos += dataPerVertex;
+        }
+    }
+
+    void loopIndices(const uint16_t* indices, size_t indexCount, uint16_t vertexOffset, uint16_t* dst)
+    {
+        for (size_t i = 0; i < indexCount; ++i)
+        {
+            dst[i] = vertexOffset + indices[i];
+        }
+    }
+
+    float maxDifference(const float* a, const float* b, size_t count)
+    {
+        float maxError = 0.0f;
+        for (size_t i = 0; i < count; i++)
+        {
+            maxError = std::max(maxError, fabsf(a[i] - b[i]));
+        }
+        return maxError;
+    }
+
+    // nanoseconds per element of the fastest round, every round calls func once per chunk of the buffer,
+    // like fillBuffers does once per node, the buffer is restored from source outside the timing
+    template <typename T, typename F>
+    double timeRounds(const std::vector<T>& source, std::vector<T>& buffer, size_t chunkSize, size_t elements, int rounds, F func)
+    {
+        size_t chunks = source.size() / chunkSize;
+        double best = 1e30;
+        for (int r = 0; r < rounds; r++)
+        {
+            memcpy(buffer.data(), source.data(), source.size() * sizeof(T));
+            auto start = Clock::now();
+            for (size_t c = 0; c < chunks; c++)
+            {
+                func(buffer.data() + c * chunkSize);
+            }
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            best = std::min(best, ns);
+        }
+        return best / (elements * chunks);
+    }
+
+    // small batches are repeated over distinct data until a round covers this many vertices
+    size_t chunkCount(size_t vertexCount)
+    {
+        return std::max<size_t>(1, 16384 / vertexCount);
+    }
+
+    Case runVertices(bool is3D, size_t count, int rounds)
+    {
+        size_t stride = is3D ? STRIDE_3D : STRIDE_2D;
+        Case result = { is3D ? "transformVertices3D" : "transformVertices2D", count };
+        Mat4 worldMat = randomWorldMatrix(is3D);
+        std::vector<float> source = randomVertices(count * chunkCount(count), stride);
+        std::vector<float> expected = source, actual = source;
+
+        auto loop = [&](float* v) { is3D ? loop3D(worldMat, v, stride, count) : loop2D(worldMat, v, stride, count); };
+        auto kernel = [&](float* v) {
+            is3D ? MathUtil::transformVertices3D(worldMat.m, v, stride, count) : MathUtil::transformVertices2D(worldMat.m, v, stride, count);
+        };
+        size_t chunkSize = count * stride;
+        result.loopNs = timeRounds(source, expected, chunkSize, count, rounds, loop);
+        result.kernelNs = timeRounds(source, actual, chunkSize, count, rounds, kernel);
+        result.maxError = maxDifference(expected.data(), actual.data(), source.size());
+        return result;
+    }
+
+    Case runIndices(size_t vertexCount, int rounds)
+    {
+        // 6 indices per quad, rebased like a batch written after other quads of the buffer
+        size_t count = vertexCount / 4 * 6;
+        Case result = { "offsetIndices", count };
+        std::vector<uint16_t> indices(count * chunkCount(vertexCount));
+        for (size_t i = 0; i < indices.size(); i++)
+        {
+            static const uint16_t QUAD[] = {0, 1, 2, 1, 3, 2};
+            indices[i] = (uint16_t)(i / 6 * 4 + QUAD[i % 6]);
+        }
+        uint16_t offset = (uint16_t)(65535 - vertexCount);
+        std::vector<uint16_t> expected(indices.size()), actual(indices.size());
+
+        // every chunk rebases its own part of the source into the same part of the destination
+        const uint16_t* src = indices.data();
+        uint16_t* expectedBase = expected.data();
+        uint16_t* actualBase = actual.data();
+        result.loopNs = timeRounds(indices, expected, count, count, rounds, [&](uint16_t* dst) {
+            loopIndices(src + (dst - expectedBase), count, offset, dst);
+        });
+        result.kernelNs = timeRounds(indices, actual, count, count, rounds, [&](uint16_t* dst) {
+            MathUtil::offsetIndices(src + (dst - actualBase), count, offset, dst);
+        });
+        for (size_t i = 0; i < indices.size(); i++)
+        {
+            result.maxError = std::max(result.maxError, (float)abs((int)expected[i] - (int)actual[i]));
+        }
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    float maxError = DEFAULT_MAX_ERROR;
+    int rounds = DEFAULT_ROUNDS;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--max-error") == 0 && i + 1 < argc)
+        {
+            maxError = (float)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc)
+        {
+            rounds = std::max(1, atoi(argv[++i]));
+        }
+        else
+        {
+            printf("usage: vertex_transform_bench [--max-error E] [--rounds N]\n");
+            return 1;
+        }
+    }
+
+    srand(1);
+    std::vector<Case> cases;
+    for (size_t count : VERTEX_COUNTS)
+    {
+        cases.push_back(runVertices(false, count, rounds));
+        cases.push_back(runVertices(true, count, rounds));
+        cases.push_back(runIndices(count, rounds));
+    }
+
+    bool ok = true;
+    printf("%-20s %8s %12s %12s %8s %10s\n", "kernel", "count", "loop ns", "kernel ns", "speedup", "max error");
+    for (const auto& c : cases)
+    {
+        printf("%-20s %8zu %12.3f %12.3f %7.2fx %10g\n", c.name, c.count, c.loopNs, c.kernelNs, c.loopNs / c.kernelNs, c.maxError);
+        ok = ok && c.maxError <= maxError;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,413 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+/*
+ * Loopback check of the libwebsockets client against a local WebSocketServer, on the headless linux platform.
+ * The server echoes every message back. The client checks that every echo arrives in order with its payload intact,
+ * that no message is delivered before onOpen or after onClose, and that messages retained by
+ * WebSocket::retainMessageData are still intact after later messages reused the receive buffers.
+ * Messages larger than the 64KB receive buffer of libwebsockets arrive in several fragments, every received message
+ * has to start at an 8 byte aligned address. Run under ASan with a few thousand messages to stress the receive path.
+ * With --burst the server instead pushes N small binary frames from several threads at once through
+ * WebSocketServerConnection::sendBinaryAsync, the client checks the order of every producer and the tool prints the
+ * messages per second and the send queue statistics of the connection, e.g. how many frames a writable callback drained.
+ * Exits with 0 once the connection is closed cleanly, 1 on any failure or after a timeout.
+ *
+ *   websocket_loopback [--messages N | --burst N] [--port P]
+ */
+
+#include "platform/CCApplication.h"
+#include "base/CCScheduler.h"
+#include "network/WebSocket.h"
+#include "network/WebSocketServer.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <memory>
+
+using namespace cocos2d;
+using namespace cocos2d::network;
+
+namespace
+{
+    const int DEFAULT_PORT = 18913;
+    const int DEFAULT_MESSAGES = 600;
+    const uintptr_t MESSAGE_ALIGN = 8;
+    // every RETAIN_INTERVAL-th binary echo is kept until the end
+    const int RETAIN_INTERVAL = 25;
+    // messages on the way at once, long runs don't queue all payloads up front
+    const int SEND_WINDOW = 64;
+    // --burst frames are pushed by BURST_PRODUCERS threads, each waits while BURST_MAX_QUEUED frames are queued
+    const int BURST_PRODUCERS = 4;
+    const size_t BURST_MAX_QUEUED = 1024;
+    const char* BURST_COMMAND = "burst";
+    const float TIMEOUT_SECONDS = 300.0f;
+    const char* TIMEOUT_KEY = "websocket_loopback_timeout";
+
+    typedef std::chrono::steady_clock Clock;
+
+    int s_failures = 0;
+
+#define LOOPBACK_CHECK(cond, ...) \
+    do { \
+        if (!(cond)) { \
+            s_failures++; \
+            fprintf(stderr, "FAILED %s:%d: %s: ", __FILE__, __LINE__, #cond); \
+            fprintf(stderr, __VA_ARGS__); \
+            fprintf(stderr, "\n"); \
+        } \
+    } while (0)
+
+    // from one byte to several pooled receive buffers, text and binary interleaved
+    std::string makePayload(int index)
+    {
+        static const size_t sizes[] = { 1, 17, 300, 4000, 20000, 65536, 70000, 131072, 200000, 300000 };
+        size_t len = sizes[index % (sizeof(sizes) / sizeof(sizes[0]))] + index % 13;
+        std::string payload(len, '\0');
+        for (size_t i = 0; i < len; ++i)
+        {
+            payload[i] = (char)('a' + (index * 31 + i) % 26);
+        }
+        return payload;
+    }
+
+    bool isBinaryMessage(int index)
+    {
+        return (index & 1) != 0;
+    }
+
+    struct RetainedMessage
+    {
+        int index;
+        const char* bytes;
+        ssize_t len;
+        void* ext;
+    };
+
+    class LoopbackClient : public WebSocket::Delegate
+    {
+    public:
+        std::shared_ptr<WebSocketServer> server;
+        WebSocket* ws = nullptr;
+        int messageCount = DEFAULT_MESSAGES;
+        bool burst = false;
+        bool opened = false;
+        bool closed = false;
+        int sent = 0;
+        int received = 0;
+        int retainedCount = 0;
+        std::vector<RetainedMessage> retained;
+        std::vector<uint32_t> burstNext = std::vector<uint32_t>(BURST_PRODUCERS, 0);
+        Clock::time_point start;
+        Clock::time_point end;
+
+        virtual void onOpen(WebSocket* socket) override
+        {
+            LOOPBACK_CHECK(!opened && !closed, "onOpen delivered twice or after onClose");
+            opened = true;
+            start = Clock::now();
+            if (burst)
+            {
+                socket->send(BURST_COMMAND);
+                return;
+            }
+            while (sent < std::min(SEND_WINDOW, messageCount))
+                sendNext(socket);
+        }
+
+        virtual void onMessage(WebSocket* socket, const WebSocket::Data& data) override
+        {
+            LOOPBACK_CHECK(opened, "message %d delivered before onOpen", received);
+            LOOPBACK_CHECK(!closed, "message %d delivered after onClose", received);
+            LOOPBACK_CHECK(received < messageCount, "unexpected message %d", received);
+            if (received >= messageCount)
+                return;
+            if (burst)
+            {
+                onBurstMessage(socket, data);
+                return;
+            }
+
+            std::string expected = makePayload(received);
+            LOOPBACK_CHECK(data.isBinary == isBinaryMessage(received), "message %d has the wrong type", received);
+            LOOPBACK_CHECK(data.len == (ssize_t)expected.size(), "message %d has %d bytes, %d expected", received, (int)data.len, (int)expected.size());
+            if (data.len == (ssize_t)expected.size())
+            {
+                LOOPBACK_CHECK(memcmp(data.bytes, expected.data(), expected.size()) == 0, "message %d is corrupted", received);
+            }
+            LOOPBACK_CHECK(((uintptr_t)data.bytes & (MESSAGE_ALIGN - 1)) == 0, "message %d isn't aligned", received);
+            if (!data.isBinary)
+            {
+                LOOPBACK_CHECK(data.bytes[data.len] == '\0', "text message %d isn't null terminated", received);
+            }
+
+            if (data.isBinary && received % RETAIN_INTERVAL == 1 && WebSocket::retainMessageData(data))
+            {
+                retained.push_back({ received, data.bytes, data.len, data.ext });
+            }
+
+            if (++received == messageCount)
+            {
+                end = Clock::now();
+                checkRetained();
+                socket->closeAsync();
+            }
+            else if (sent < messageCount)
+            {
+                sendNext(socket);
+            }
+        }
+
+        virtual void onClose(WebSocket* socket) override
+        {
+            LOOPBACK_CHECK(opened, "onClose delivered before onOpen");
+            LOOPBACK_CHECK(!closed, "onClose delivered twice");
+            LOOPBACK_CHECK(received == messageCount, "closed after %d of %d messages", received, messageCount);
+            closed = true;
+            server->closeAsync([](const std::string& errorMsg) {
+                Application::getInstance()->end();
+            });
+        }
+
+        virtual void onError(WebSocket* socket, const WebSocket::ErrorCode& error) override
+        {
+            LOOPBACK_CHECK(false, "websocket error %d", (int)error);
+            Application::getInstance()->end();
+        }
+
+    private:
+        // a burst frame is the producer index and its sequence number
+        void onBurstMessage(WebSocket* socket, const WebSocket::Data& data)
+        {
+            uint32_t frame[2] = { BURST_PRODUCERS, 0 };
+            LOOPBACK_CHECK(data.isBinary && data.len == sizeof(frame), "burst message %d has %d bytes", received, (int)data.len);
+            if (data.len == sizeof(frame))
+                memcpy(frame, data.bytes, sizeof(frame));
+            LOOPBACK_CHECK(frame[0] < BURST_PRODUCERS && frame[1] == burstNext[frame[0]], "burst message %d is %u of producer %u", received, frame[1], frame[0]);
+            if (frame[0] < BURST_PRODUCERS)
+                burstNext[frame[0]] = frame[1] + 1;
+
+            if (++received == messageCount)
+            {
+                end = Clock::now();
+                socket->closeAsync();
+            }
+        }
+
+        void sendNext(WebSocket* socket)
+        {
+            std::string payload = makePayload(sent);
+            if (isBinaryMessage(sent))
+                socket->send((const unsigned char*)payload.data(), (unsigned int)payload.size());
+            else
+                socket->send(payload);
+            sent++;
+        }
+
+        void checkRetained()
+        {
+            // large messages are shared with the receive buffer, at least some of them have to be retained
+            LOOPBACK_CHECK(!retained.empty(), "no message was retained");
+            for (auto& msg : retained)
+            {
+                std::string expected = makePayload(msg.index);
+                LOOPBACK_CHECK(msg.len == (ssize_t)expected.size() && memcmp(msg.bytes, expected.data(), expected.size()) == 0,
+                               "retained message %d was overwritten", msg.index);
+                WebSocket::releaseMessageData(msg.ext);
+            }
+            retainedCount = (int)retained.size();
+            retained.clear();
+        }
+    };
+
+    class LoopbackApp : public Application
+    {
+    public:
+        LoopbackApp(int port, int messages, bool burst)
+        : Application("websocket_loopback", 1, 1)
+        , _port(port)
+        {
+            _client.messageCount = messages;
+            _client.burst = burst;
+        }
+
+        virtual bool applicationDidFinishLaunching() override
+        {
+            setPreferredFramesPerSecond(60);
+
+            _client.server = std::make_shared<WebSocketServer>();
+            _client.server->setOnConnection([this](std::shared_ptr<WebSocketServerConnection> conn) {
+                std::weak_ptr<WebSocketServerConnection> weakConn = conn;
+                conn->setOnText([this, weakConn](std::shared_ptr<DataFrame> frame) {
+                    auto conn = weakConn.lock();
+                    if (!conn)
+                        return;
+                    if (_client.burst && frame->toString() == BURST_COMMAND)
+                        startBurst(conn);
+                    else
+                        conn->sendTextAsync(frame->toString(), nullptr);
+                });
+                conn->setOnBinary([weakConn](std::shared_ptr<DataFrame> frame) {
+                    auto conn = weakConn.lock();
+                    if (conn)
+                        conn->sendBinaryAsync(frame->getData(), frame->size(), nullptr);
+                });
+            });
+
+            int port = _port;
+            LoopbackClient* client = &_client;
+            WebSocketServer::listenAsync(_client.server, port, "127.0.0.1", [client, port](const std::string& errorMsg) {
+                LOOPBACK_CHECK(errorMsg.empty(), "listen failed: %s", errorMsg.c_str());
+                if (!errorMsg.empty())
+                {
+                    Application::getInstance()->end();
+                    return;
+                }
+                client->ws = new WebSocket();
+                bool ok = client->ws->init(*client, "ws://127.0.0.1:" + std::to_string(port));
+                LOOPBACK_CHECK(ok, "websocket init failed");
+            });
+
+            getScheduler()->schedule([](float) {
+                LOOPBACK_CHECK(false, "timed out");
+                Application::getInstance()->end();
+            }, this, TIMEOUT_SECONDS, 0, 0.0f, false, TIMEOUT_KEY);
+            return true;
+        }
+
+        void finish()
+        {
+            getScheduler()->unscheduleAll();
+            _stopProducers = true;
+            for (auto& producer : _producers)
+                producer.join();
+            _producers.clear();
+
+            if (_client.ws)
+            {
+                _client.ws->release();
+                _client.ws = nullptr;
+            }
+            WebSocket::closeAllConnections();
+
+            double seconds = std::chrono::duration<double>(_client.end - _client.start).count();
+            if (!_client.burst)
+            {
+                printf("websocket loopback: %d of %d messages echoed, %d retained, %d failures\n",
+                       _client.received, _client.messageCount, _client.retainedCount, s_failures);
+                if (_client.received == _client.messageCount && seconds > 0.0)
+                    printf("%.3f s, %.1f messages/s\n", seconds, _client.received / seconds);
+                return;
+            }
+
+            printf("websocket burst: %d of %d messages from %d producers, %d failures\n",
+                   _client.received, _client.messageCount, BURST_PRODUCERS, s_failures);
+            if (_client.received == _client.messageCount && seconds > 0.0)
+                printf("%.3f s, %.1f messages/s\n", seconds, _client.received / seconds);
+            if (_burstConnection)
+            {
+                WebSocketServerConnection::SendStats stats = _burstConnection->getSendStats();
+                printf("send queue: %llu frames sent, %llu writable callbacks, %.1f frames per callback, %d max queued bytes, %llu rejected\n",
+                       (unsigned long long)stats.sentFrames, (unsigned long long)stats.writableCallbacks,
+                       stats.writableCallbacks > 0 ? (double)stats.sentFrames / stats.writableCallbacks : 0.0,
+                       (int)stats.maxQueuedBytes, (unsigned long long)stats.rejectedFrames);
+                _burstConnection.reset();
+            }
+        }
+
+    private:
+        // pushes the frames from several threads, waiting while the queue of the connection is full enough
+        void startBurst(std::shared_ptr<WebSocketServerConnection> conn)
+        {
+            LOOPBACK_CHECK(_producers.empty(), "burst requested twice");
+            if (!_producers.empty())
+                return;
+
+            _burstConnection = conn;
+            for (int p = 0; p < BURST_PRODUCERS; ++p)
+            {
+                uint32_t count = (uint32_t)(_client.messageCount / BURST_PRODUCERS + (p < _client.messageCount % BURST_PRODUCERS ? 1 : 0));
+                _producers.emplace_back([this, conn, p, count]() {
+                    for (uint32_t seq = 0; seq < count && !_stopProducers; ++seq)
+                    {
+                        while (conn->getSendStats().queuedFrames >= BURST_MAX_QUEUED && !_stopProducers)
+                            std::this_thread::yield();
+                        uint32_t frame[2] = { (uint32_t)p, seq };
+                        conn->sendBinaryAsync(frame, sizeof(frame), nullptr);
+                    }
+                });
+            }
+        }
+
+        int _port;
+        LoopbackClient _client;
+        std::shared_ptr<WebSocketServerConnection> _burstConnection;
+        std::vector<std::thread> _producers;
+        std::atomic<bool> _stopProducers{false};
+    };
+}
+
+int main(int argc, char** argv)
+{
+    int port = DEFAULT_PORT;
+    int messages = DEFAULT_MESSAGES;
+    bool burst = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--messages") == 0 && i + 1 < argc)
+        {
+            messages = std::max(1, atoi(argv[++i]));
+            burst = false;
+        }
+        else if (strcmp(argv[i], "--burst") == 0 && i + 1 < argc)
+        {
+            messages = std::max(1, atoi(argv[++i]));
+            burst = true;
+        }
+        else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+        {
+            port = atoi(argv[++i]);
+        }
+        else
+        {
+            printf("usage: websocket_loopback [--messages N | --burst N] [--port P]\n");
+            return 1;
+        }
+    }
+
+    LoopbackApp* app = new LoopbackApp(port, messages, burst);
+    app->start();
+    app->finish();
+    delete app;
+
+    return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+/****************************************************************************
+ Copyright (c) 2019 Xiamen Yaji Software Co., Ltd.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+/*
+ * Stress check of the lock-free SendQueue of WebSocketServerConnection, without any socket.
+ * Several producer threads push numbered frames while the main thread pops them like the server thread does,
+ * a producer retries when the queue is full. Every frame has to arrive once and in the order of its producer.
+ * Also checks that a full queue rejects a frame and leaves it untouched, and that frames still queued are freed
+ * with the queue. Prints the frames per second and the rejected pushes. Build it with -fsanitize=thread or
+ * -fsanitize=address to check the memory ordering and the node lifetime.
+ * Exits with 0 if every check passed, 1 otherwise.
+ *
+ *   websocket_send_queue [--producers N] [--frames N] [--capacity N]
+ */
+
+#include "network/WebSocketServer.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace cocos2d::network;
+
+namespace
+{
+    const int DEFAULT_PRODUCERS = 4;
+    const int DEFAULT_FRAMES = 800000;
+    // SEND_QUEUE_SIZE of WebSocketServer.cpp
+    const int DEFAULT_CAPACITY = 4096;
+
+    typedef std::chrono::steady_clock Clock;
+
+    int s_failures = 0;
+
+#define SEND_QUEUE_CHECK(cond, ...) \
+    do { \
+        if (!(cond)) { \
+            s_failures++; \
+            fprintf(stderr, "FAILED %s:%d: %s: ", __FILE__, __LINE__, #cond); \
+            fprintf(stderr, __VA_ARGS__); \
+            fprintf(stderr, "\n"); \
+        } \
+    } while (0)
+
+    // a frame carries its producer index and sequence number
+    std::shared_ptr<DataFrame> makeFrame(uint32_t producer, uint32_t seq)
+    {
+        uint32_t payload[2] = { producer, seq };
+        return std::make_shared<DataFrame>(payload, (int)sizeof(payload));
+    }
+
+    bool readFrame(std::shared_ptr<DataFrame>& frame, uint32_t* producer, uint32_t* seq)
+    {
+        uint32_t payload[2];
+        if (!frame || frame->size() != (int)sizeof(payload))
+            return false;
+        memcpy(payload, frame->getData(), sizeof(payload));
+        *producer = payload[0];
+        *seq = payload[1];
+        return true;
+    }
+
+    void checkCapacity(int capacity)
+    {
+        SendQueue queue(capacity);
+        for (int i = 0; i < capacity; ++i)
+        {
+            std::shared_ptr<DataFrame> frame = makeFrame(0, i);
+            SEND_QUEUE_CHECK(queue.push(frame) && !frame, "push %d of %d failed", i, capacity);
+        }
+        SEND_QUEUE_CHECK(queue.size() == (size_t)capacity, "%d frames queued, %d expected", (int)queue.size(), capacity);
+
+        std::shared_ptr<DataFrame> rejected = makeFrame(0, capacity);
+        SEND_QUEUE_CHECK(!queue.push(rejected), "a full queue took another frame");
+        SEND_QUEUE_CHECK(rejected != nullptr, "a rejected frame was moved away");
+
+        std::shared_ptr<DataFrame> frame;
+        uint32_t producer = 0, seq = 0;
+        SEND_QUEUE_CHECK(queue.pop(frame) && readFrame(frame, &producer, &seq) && seq == 0, "the first frame didn't come first");
+        SEND_QUEUE_CHECK(queue.push(rejected), "no room after a pop");
+    }
+
+    void checkDestruction()
+    {
+        std::vector<std::weak_ptr<DataFrame>> queued;
+        {
+            SendQueue queue(DEFAULT_CAPACITY);
+            for (int i = 0; i < 10; ++i)
+            {
+                std::shared_ptr<DataFrame> frame = makeFrame(0, i);
+                queued.push_back(frame);
+                queue.push(frame);
+            }
+            std::shared_ptr<DataFrame> frame;
+            queue.pop(frame);
+        }
+        int alive = 0;
+        for (auto& frame : queued)
+            alive += frame.expired() ? 0 : 1;
+        SEND_QUEUE_CHECK(alive == 0, "%d frames outlived their queue", alive);
+    }
+
+    void checkProducers(int producers, int frames, int capacity)
+    {
+        SendQueue queue(capacity);
+        std::atomic<uint64_t> rejectedPushes{0};
+        std::vector<std::thread> threads;
+
+        Clock::time_point start = Clock::now();
+        for (int p = 0; p < producers; ++p)
+        {
+            uint32_t count = (uint32_t)(frames / producers + (p < frames % producers ? 1 : 0));
+            threads.emplace_back([&queue, &rejectedPushes, p, count]() {
+                uint64_t rejected = 0;
+                for (uint32_t seq = 0; seq < count; ++seq)
+                {
+                    std::shared_ptr<DataFrame> frame = makeFrame(p, seq);
+                    while (!queue.push(frame))
+                    {
+                        rejected++;
+                        std::this_thread::yield();
+                    }
+                }
+                rejectedPushes.fetch_add(rejected);
+            });
+        }
+
+        std::vector<uint32_t> next(producers, 0);
+        int received = 0;
+        int misordered = 0;
+        size_t maxSize = 0;
+        while (received < frames)
+        {
+            std::shared_ptr<DataFrame> frame;
+            maxSize = std::max(maxSize, queue.size());
+            if (!queue.pop(frame))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            uint32_t producer = 0, seq = 0;
+            if (!readFrame(frame, &producer, &seq) || producer >= (uint32_t)producers || seq != next[producer])
+            {
+                if (misordered++ == 0)
+                    fprintf(stderr, "frame %d is %u of producer %u\n", received, seq, producer);
+            }
+            else
+            {
+                next[producer]++;
+            }
+            received++;
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        for (auto& t : threads)
+            t.join();
+
+        SEND_QUEUE_CHECK(misordered == 0, "%d frames out of order", misordered);
+        SEND_QUEUE_CHECK(queue.empty(), "%d frames left", (int)queue.size());
+        SEND_QUEUE_CHECK(maxSize <= (size_t)capacity, "%d frames queued, capacity is %d", (int)maxSize, capacity);
+
+        printf("send queue: %d frames from %d producers, capacity %d, %d failures\n", received, producers, capacity, s_failures);
+        printf("%.3f s, %.0f frames/s, %llu rejected pushes, %d max queued\n",
+               seconds, seconds > 0.0 ? received / seconds : 0.0, (unsigned long long)rejectedPushes.load(), (int)maxSize);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int producers = DEFAULT_PRODUCERS;
+    int frames = DEFAULT_FRAMES;
+    int capacity = DEFAULT_CAPACITY;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--producers") == 0 && i + 1 < argc)
+        {
+            producers = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = std::max(1, atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--capacity") == 0 && i + 1 < argc)
+        {
+            capacity = std::max(1, atoi(argv[++i]));
+        }
+        else
+        {
+            printf("usage: websocket_send_queue [--producers N] [--frames N] [--capacity N]\n");
+            return 1;
+        }
+    }
+
+    checkCapacity(capacity);
+    checkDestruction();
+    checkProducers(producers, frames, capacity);
+
+    return s_failures == 0 ? 0 : 1;
+}